@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <sys/resource.h>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include "netlist_paths/DTypes.hpp"
+#include "netlist_paths/DeepestPaths.hpp"
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/Graph.hpp"
+#include "netlist_paths/Options.hpp"
+#include "netlist_paths/PathEnumerator.hpp"
+#include "netlist_paths/ReadVerilatorXML.hpp"
+
+namespace po = boost::program_options;
+
+namespace {
+
+/// The measurement of one benchmark.
+struct Result {
+  std::string netlist;
+  std::string name;
+  size_t count;
+  size_t found;
+  double seconds;
+  size_t peakRSS;
+};
+
+/// Return the peak resident set size of the process in bytes.
+size_t getPeakRSS() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+/// Return a string quoted as a JSON value.
+std::string quote(const std::string &value) {
+  std::string result = "\"";
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+
+/// Return up to count elements of a vector, evenly spaced through it.
+template<typename T>
+std::vector<T> sample(const std::vector<T> &values, size_t count) {
+  if (values.size() <= count) {
+    return values;
+  }
+  std::vector<T> result;
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back(values[i * values.size() / count]);
+  }
+  return result;
+}
+
+/// Run the benchmarks of a netlist, timing each phase of loading it and then
+/// each type of query over a sample of its vertices.
+class NetlistBenchmark {
+  std::string filename;
+  size_t numSamples;
+  size_t numRepeats;
+  size_t maxPaths;
+  std::string regex;
+  std::string wildcard;
+  std::vector<Result> &results;
+  netlist_paths::Graph graph;
+  std::vector<File> files;
+  std::vector<std::shared_ptr<netlist_paths::DType>> dtypes;
+
+  /// Time a function once, which returns the number of operations that
+  /// found a result out of count operations.
+  void time(const std::string &name, size_t count,
+            std::function<size_t()> function) {
+    auto start = std::chrono::steady_clock::now();
+    auto found = function();
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    results.push_back({filename, name, count, found, seconds.count(), getPeakRSS()});
+  }
+
+  /// Time a query, taking the fastest of a number of repeats.
+  void timeQuery(const std::string &name, size_t count,
+                 std::function<size_t()> function) {
+    time(name, count, function);
+    auto best = results.back();
+    for (size_t i = 1; i < numRepeats; ++i) {
+      time(name, count, function);
+      if (results.back().seconds < best.seconds) {
+        best = results.back();
+      }
+      results.pop_back();
+    }
+    results.back() = best;
+  }
+
+public:
+  NetlistBenchmark(const std::string &filename, size_t numSamples,
+                   size_t numRepeats, size_t maxPaths,
+                   const std::string &regex, const std::string &wildcard,
+                   std::vector<Result> &results) :
+    filename(filename), numSamples(numSamples), numRepeats(numRepeats),
+    maxPaths(maxPaths), regex(regex), wildcard(wildcard), results(results) {}
+
+  void runLoad(bool reachabilityIndex) {
+    // The count of reading the XML is its size, so its rate is in bytes per
+    // second.
+    size_t xmlBytes = boost::filesystem::file_size(filename);
+    time("read_xml", xmlBytes, [&]{
+      netlist_paths::ReadVerilatorXML(graph, files, dtypes, filename);
+      return xmlBytes; });
+    time("mark_alias_registers", 1, [&]{ graph.markAliasRegisters(); return 1; });
+    time("split_reg_vertices", 1, [&]{ graph.splitRegVertices(); return 1; });
+    time("update_var_aliases", 1, [&]{ graph.updateVarAliases(); return 1; });
+    time("build_indexes", 1, [&]{ graph.buildIndexes(); return 1; });
+    if (reachabilityIndex) {
+      time("build_reachability_indexes", 1, [&]{
+        graph.buildReachabilityIndexes();
+        return 1; });
+    }
+  }
+
+  void runQueries() {
+    using netlist_paths::VertexNetlistType;
+    netlist_paths::QueryOptions options;
+    auto named = sample(graph.getVerticesByType(VertexNetlistType::IS_NAMED, options), numSamples);
+    auto startPoints = sample(graph.getVerticesByType(VertexNetlistType::START_POINT, options), numSamples);
+    // Pair each start point with one of the end points of its fan out, or
+    // with any end point if it has no fan out.
+    auto endPoints = graph.getVerticesByType(VertexNetlistType::END_POINT, options);
+    std::vector<netlist_paths::VertexIDVec> pairs;
+    for (size_t i = 0; i < startPoints.size() && !endPoints.empty(); ++i) {
+      auto fanOut = graph.getFanOutEndPoints(startPoints[i], options);
+      auto endPoint = fanOut.empty() ? endPoints[i % endPoints.size()]
+                                     : fanOut[fanOut.size() / 2];
+      pairs.push_back({startPoints[i], endPoint});
+    }
+    std::vector<std::string> names;
+    for (auto vertex : named) {
+      names.emplace_back(graph.getVertex(vertex).getName());
+    }
+    netlist_paths::VertexIDVec noAvoidPoints;
+    // The widths and strings of the data types of every named vertex, as
+    // dumping the names does.
+    auto allNamed = graph.getVerticesByType(VertexNetlistType::IS_NAMED, options);
+    timeQuery("vertex_dtypes", allNamed.size(), [&]{
+      size_t found = 0;
+      for (auto vertex : allNamed) {
+        auto &v = graph.getVertex(vertex);
+        found += v.getDTypeWidth() > 0 && !v.getDTypeStr().empty();
+      }
+      return found; });
+    timeQuery("lookup_exact", names.size(), [&]{
+      size_t found = 0;
+      for (auto &name : names) {
+        found += graph.getVertexExact(name, VertexNetlistType::ANY, options) != graph.nullVertex();
+      }
+      return found; });
+    timeQuery("lookup_regex", 1, [&]{
+      return graph.getVerticesRegex(regex, VertexNetlistType::ANY, options).size(); });
+    timeQuery("lookup_wildcard", 1, [&]{
+      return graph.getVerticesWildcard(wildcard, VertexNetlistType::ANY, options).size(); });
+    timeQuery("path_exists", pairs.size(), [&]{
+      size_t found = 0;
+      for (auto &waypoints : pairs) {
+        found += graph.pathExists(waypoints, noAvoidPoints, options);
+      }
+      return found; });
+    timeQuery("any_path", pairs.size(), [&]{
+      size_t found = 0;
+      for (auto &waypoints : pairs) {
+        found += !graph.getAnyPointToPoint(waypoints, noAvoidPoints, options).empty();
+      }
+      return found; });
+    timeQuery("all_fan_out", startPoints.size(), [&]{
+      size_t found = 0;
+      for (auto vertex : startPoints) {
+        found += graph.getAllFanOut(vertex, options).size();
+      }
+      return found; });
+    auto limits = netlist_paths::PathLimits().withMaxPaths(maxPaths);
+    timeQuery("all_paths_bounded", pairs.size(), [&]{
+      size_t found = 0;
+      for (auto &waypoints : pairs) {
+        auto paths = graph.enumeratePointToPoint(waypoints, noAvoidPoints, options, limits);
+        while (paths.next()) {
+          ++found;
+        }
+      }
+      return found; });
+    netlist_paths::PathWeights weights;
+    timeQuery("deepest_paths", pairs.size(), [&]{
+      size_t found = 0;
+      for (auto &waypoints : pairs) {
+        found += graph.getDeepestPointToPoint(waypoints, noAvoidPoints, maxPaths,
+                                              weights, options).size();
+      }
+      return found; });
+    // Paths from each start point to a sample of the end points of its fan
+    // out, which search from the start point for every path unless its tree
+    // is cached. The cache is emptied before each repeat.
+    std::vector<netlist_paths::VertexIDVec> fanOutPairs;
+    for (auto vertex : startPoints) {
+      for (auto endPoint : sample(graph.getFanOutEndPoints(vertex, options), numSamples)) {
+        fanOutPairs.push_back({vertex, endPoint});
+      }
+    }
+    auto &traversalCache = graph.getTraversalCache();
+    for (bool cached : {false, true}) {
+      traversalCache.setMaxBytes(cached ? size_t(1) << 28 : 0);
+      timeQuery(cached ? "any_path_fan_out_cached" : "any_path_fan_out",
+                fanOutPairs.size(), [&]{
+        traversalCache.clear();
+        size_t found = 0;
+        for (auto &waypoints : fanOutPairs) {
+          found += !graph.getAnyPointToPoint(waypoints, noAvoidPoints, options).empty();
+        }
+        return found; });
+    }
+    traversalCache.setMaxBytes(0);
+  }
+
+  size_t numVertices() const { return graph.numVertices(); }
+  size_t numEdges() const { return graph.numEdges(); }
+};
+
+/// Write the results as a JSON object.
+void writeResults(std::ostream &os, const std::vector<Result> &results,
+                  const std::vector<std::tuple<std::string, size_t, size_t>> &netlists) {
+  os << "{\n  \"netlists\": [\n";
+  for (size_t i = 0; i < netlists.size(); ++i) {
+    os << "    {\"netlist\": " << quote(std::get<0>(netlists[i]))
+       << ", \"vertices\": " << std::get<1>(netlists[i])
+       << ", \"edges\": " << std::get<2>(netlists[i]) << "}"
+       << (i + 1 < netlists.size() ? ",\n" : "\n");
+  }
+  os << "  ],\n  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto &result = results[i];
+    auto rate = result.seconds > 0 ? result.count / result.seconds : 0.0;
+    os << "    {\"netlist\": " << quote(result.netlist)
+       << ", \"benchmark\": " << quote(result.name)
+       << ", \"count\": " << result.count
+       << ", \"found\": " << result.found
+       << ", \"seconds\": " << result.seconds
+       << ", \"per_second\": " << rate
+       << ", \"peak_rss_bytes\": " << result.peakRSS << "}"
+       << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  os << "  ],\n  \"peak_rss_bytes\": " << getPeakRSS() << "\n}\n";
+}
+
+} // End anonymous namespace.
+
+int main(int argc, char **argv) {
+  try {
+    // Command line options.
+    po::options_description hiddenOptions("Positional options");
+    po::options_description genericOptions("General options");
+    po::options_description allOptions("All options");
+    po::positional_options_description p;
+    po::variables_map vm;
+    std::vector<std::string> inputFiles;
+    std::string outputFilename;
+    std::string regex;
+    std::string wildcard;
+    size_t numSamples;
+    size_t numRepeats;
+    size_t maxPaths;
+    // Specify command line options.
+    hiddenOptions.add_options()
+      ("input-file",
+       po::value<std::vector<std::string>>(&inputFiles)->required());
+    p.add("input-file", -1);
+    genericOptions.add_options()
+      ("help,h",        "Display help")
+      ("samples",       po::value<size_t>(&numSamples)
+                          ->default_value(100)
+                          ->value_name("number"),
+                        "Number of vertices each query is made from")
+      ("repeats",       po::value<size_t>(&numRepeats)
+                          ->default_value(3)
+                          ->value_name("number"),
+                        "Number of times each query is timed, taking the fastest")
+      ("max-paths",     po::value<size_t>(&maxPaths)
+                          ->default_value(1000)
+                          ->value_name("number"),
+                        "Maximum number of paths enumerated between two points")
+      ("regex",         po::value<std::string>(&regex)
+                          ->default_value(".*_q[0-9]*")
+                          ->value_name("pattern"),
+                        "Regex pattern to look up")
+      ("wildcard",      po::value<std::string>(&wildcard)
+                          ->default_value("*_q*")
+                          ->value_name("pattern"),
+                        "Wildcard pattern to look up")
+      ("reachability-index", "Build and time the reachability index")
+      ("outfile,o",     po::value<std::string>(&outputFilename)
+                          ->value_name("filename"),
+                        "Write the results to a file instead of stdout")
+      ("verbose,v",     "Print information");
+    allOptions.add(genericOptions).add(hiddenOptions);
+
+    // Parse command line arguments.
+    po::store(po::command_line_parser(argc, argv).
+                  options(allOptions).positional(p).run(), vm);
+    if (vm.count("help") > 0) {
+      std::cout << "OVERVIEW: Benchmark loading and querying netlists\n\n";
+      std::cout << "USAGE: " << argv[0] << " [options] infile...\n\n";
+      std::cout << genericOptions << "\n";
+      return 1;
+    }
+    notify(vm);
+    if (vm.count("verbose") > 0) {
+      netlist_paths::Options::getInstance().setVerbose();
+    } else {
+      netlist_paths::Options::getInstance().setQuiet();
+    }
+
+    std::vector<Result> results;
+    std::vector<std::tuple<std::string, size_t, size_t>> netlists;
+    for (auto &filename : inputFiles) {
+      NetlistBenchmark benchmark(filename, numSamples, std::max<size_t>(numRepeats, 1),
+                                 maxPaths, regex, wildcard, results);
+      benchmark.runLoad(vm.count("reachability-index") > 0);
+      benchmark.runQueries();
+      netlists.emplace_back(filename, benchmark.numVertices(), benchmark.numEdges());
+    }
+    if (outputFilename.empty()) {
+      writeResults(std::cout, results, netlists);
+    } else {
+      std::ofstream os(outputFilename);
+      writeResults(os, results, netlists);
+    }
+    return 0;
+  } catch (std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+}
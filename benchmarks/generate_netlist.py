@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+
+"""
+Generate a synthetic flat netlist in the XML format that Verilator produces,
+for benchmarking. Each design is built from a repeated unit, which is
+replicated until the netlist has approximately the requested number of
+vertices:
+
+  adder     Ripple-carry adders with registered operands and sums, which have
+            long combinational carry chains.
+  pipeline  A deep pipeline of register stages with a shuffle of the lanes
+            between each stage.
+  crossbar  Crossbars in which every output is combinationally driven by
+            every input, which have a large number of edges.
+  mesh      A torus of registers, each driven by its four neighbours, so the
+            paths through registers form many cycles.
+
+All the registers are named with the suffix _q, so the same name patterns
+select registers of every design.
+"""
+
+import argparse
+import math
+import shutil
+import sys
+import tempfile
+
+DESIGNS = ('adder', 'pipeline', 'crossbar', 'mesh')
+
+# The approximate number of graph vertices of each unit of a design, which has
+# a vertex for each variable and statement, and two for each register once
+# they are split into source and destination vertices.
+VERTICES_PER_UNIT = {
+    'adder': 18,
+    'pipeline': 6,
+    'crossbar': 14,
+    'mesh': 6,
+}
+
+
+class NetlistWriter:
+    """
+    Write the elements of a flat netlist, with the TOP module, a top scope and
+    a single variable data type. The statements follow all the variables, so
+    they are held in a temporary file until the variables are written.
+    """
+
+    def __init__(self, fd, name):
+        self.fd = fd
+        self.name = name
+        self.line = 0
+        self.statements = tempfile.TemporaryFile(mode='w+')
+
+    def loc(self):
+        self.line += 1
+        return 'fl="c{0}" loc="c,{0},1,{0},2"'.format(self.line)
+
+    def ref(self, name):
+        return '<varref {} name="{}" dtype_id="1"/>'.format(self.loc(), name)
+
+    def expr(self, op, operands):
+        if len(operands) == 1:
+            return self.ref(operands[0])
+        return '<{0} {1} dtype_id="1">{2}</{0}>'.format(
+            op, self.loc(), ''.join(self.ref(x) for x in operands))
+
+    def var(self, name, direction=None):
+        if direction:
+            self.fd.write('      <var {} name="{}" dtype_id="1" dir="{}" vartype="logic" origName="{}" public="true"/>\n'
+                          .format(self.loc(), name, direction, name))
+        else:
+            self.fd.write('      <var {} name="{}" dtype_id="1" vartype="logic" origName="{}"/>\n'
+                          .format(self.loc(), name, name.split('.')[-1]))
+
+    def assign(self, lhs, op, operands):
+        self.statements.write('          <contassign {} dtype_id="1">{}{}</contassign>\n'
+                          .format(self.loc(), self.expr(op, operands), self.ref(lhs)))
+
+    def register(self, lhs, op, operands):
+        self.statements.write('          <always {0}><sentree {0}><senitem {0} edgeType="POS">{1}</senitem></sentree>'
+                          '<assigndly {0} dtype_id="1">{2}{3}</assigndly></always>\n'
+                          .format(self.loc(), self.ref('i_clk'), self.expr(op, operands), self.ref(lhs)))
+
+    def begin(self):
+        self.fd.write('<?xml version="1.0" ?>\n')
+        self.fd.write('<!-- DESCRIPTION: Verilator output: XML representation of netlist -->\n')
+        self.fd.write('<verilator_xml>\n')
+        self.fd.write('  <files>\n')
+        self.fd.write('    <file id="c" filename="{}.sv" language="1800-2017"/>\n'.format(self.name))
+        self.fd.write('  </files>\n')
+        self.fd.write('  <netlist>\n')
+        self.fd.write('    <module fl="c1" loc="c,1,8,1,14" name="TOP" origName="TOP" topModule="1" public="true">\n')
+        self.var('i_clk', 'input')
+
+    def end(self):
+        self.fd.write('      <topscope fl="c1" loc="c,1,8,1,14">\n')
+        self.fd.write('        <scope fl="c1" loc="c,1,8,1,14" name="TOP">\n')
+        self.statements.seek(0)
+        shutil.copyfileobj(self.statements, self.fd)
+        self.statements.close()
+        self.fd.write('        </scope>\n')
+        self.fd.write('      </topscope>\n')
+        self.fd.write('    </module>\n')
+        self.fd.write('    <typetable fl="a0" loc="a,0,0,0,0">\n')
+        self.fd.write('      <basicdtype fl="a0" loc="a,0,0,0,0" id="1" name="logic"/>\n')
+        self.fd.write('    </typetable>\n')
+        self.fd.write('  </netlist>\n')
+        self.fd.write('</verilator_xml>\n')
+
+
+def generate_adder(w, units, width):
+    """ Ripple-carry adders of width bits, with a unit for each bit. """
+    for i in range(width):
+        w.var('i_a{}'.format(i), 'input')
+        w.var('i_b{}'.format(i), 'input')
+    for k in range(max(1, units // width)):
+        p = '{}.add{}.'.format(w.name, k)
+        w.var(p+'c0')
+        w.assign(p+'c0', 'and', ['i_a0', 'i_b0'])
+        for i in range(width):
+            a, b, c, s = p+'a_q{}'.format(i), p+'b_q{}'.format(i), p+'c{}'.format(i), p+'s{}'.format(i)
+            x, n = p+'x{}'.format(i), p+'c{}'.format(i+1)
+            for name in (a, b, x, s, n, p+'sum_q{}'.format(i)):
+                w.var(name)
+            w.register(a, 'and', ['i_a{}'.format(i)])
+            w.register(b, 'and', ['i_b{}'.format(i)])
+            w.assign(x, 'xor', [a, b])
+            w.assign(s, 'xor', [x, c])
+            w.assign(n, 'or', [a, b, c])
+            w.register(p+'sum_q{}'.format(i), 'and', [s])
+        w.var('o_c{}'.format(k), 'output')
+        w.assign('o_c{}'.format(k), 'and', [p+'c{}'.format(width)])
+
+
+def generate_pipeline(w, units, width):
+    """ A pipeline of width lanes, with a unit for each lane of a stage. """
+    depth = max(1, units // width)
+    for i in range(width):
+        w.var('i_data{}'.format(i), 'input')
+        w.var('o_data{}'.format(i), 'output')
+    prev = ['i_data{}'.format(i) for i in range(width)]
+    for d in range(depth):
+        p = '{}.stage{}.'.format(w.name, d)
+        regs = []
+        for i in range(width):
+            n, q = p+'n{}'.format(i), p+'data_q{}'.format(i)
+            w.var(n)
+            w.var(q)
+            w.assign(n, 'xor', [prev[i], prev[(i * 7 + d + 1) % width]])
+            w.register(q, 'and', [n])
+            regs.append(q)
+        prev = regs
+    for i in range(width):
+        w.assign('o_data{}'.format(i), 'and', [prev[i]])
+
+
+def generate_crossbar(w, units, width):
+    """ Crossbars of width ports, with a unit for each port. """
+    for i in range(width):
+        w.var('i_data{}'.format(i), 'input')
+        w.var('i_sel{}'.format(i), 'input')
+    for k in range(max(1, units // width)):
+        p = '{}.xbar{}.'.format(w.name, k)
+        inputs = []
+        for i in range(width):
+            q, s = p+'in_q{}'.format(i), p+'sel_q{}'.format(i)
+            w.var(q)
+            w.var(s)
+            w.register(q, 'and', ['i_data{}'.format(i)])
+            w.register(s, 'and', ['i_sel{}'.format(i)])
+            inputs.append(q)
+        for j in range(width):
+            n, q = p+'out{}'.format(j), p+'out_q{}'.format(j)
+            w.var(n)
+            w.var(q)
+            w.assign(n, 'or', inputs + [p+'sel_q{}'.format(j)])
+            w.register(q, 'and', [n])
+        w.var('o_xbar{}'.format(k), 'output')
+        w.assign('o_xbar{}'.format(k), 'and', [p+'out_q0'])
+
+
+def generate_mesh(w, units, width):
+    """ A torus of registers width columns wide, with a unit for each. """
+    rows = max(1, units // width)
+    w.var('i_data', 'input')
+    w.var('o_data', 'output')
+    cell = lambda r, c: '{}.row{}.cell_q{}'.format(w.name, r % rows, c % width)
+    for r in range(rows):
+        for c in range(width):
+            n = '{}.row{}.n{}'.format(w.name, r, c)
+            w.var(n)
+            w.var(cell(r, c))
+            neighbours = [cell(r-1, c), cell(r, c-1), cell(r+1, c), cell(r, c+1)]
+            if r == 0 and c == 0:
+                neighbours.append('i_data')
+            w.assign(n, 'xor', neighbours)
+            w.register(cell(r, c), 'and', [n])
+    w.assign('o_data', 'and', [cell(rows-1, width-1)])
+
+
+GENERATORS = {
+    'adder': generate_adder,
+    'pipeline': generate_pipeline,
+    'crossbar': generate_crossbar,
+    'mesh': generate_mesh,
+}
+
+
+def generate(fd, design, vertices, width):
+    """
+    Write a netlist of a design with approximately a number of vertices.
+    """
+    units = max(1, math.ceil(vertices / VERTICES_PER_UNIT[design]))
+    w = NetlistWriter(fd, design)
+    w.begin()
+    GENERATORS[design](w, units, width)
+    w.end()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate a synthetic netlist for benchmarking')
+    parser.add_argument('design',
+                        choices=DESIGNS,
+                        help='The design to generate')
+    parser.add_argument('--vertices',
+                        type=int,
+                        default=10000,
+                        help='The approximate number of vertices of the netlist')
+    parser.add_argument('--width',
+                        type=int,
+                        default=32,
+                        help='The width of the adders, pipeline stages, crossbars or mesh rows')
+    parser.add_argument('-o', '--output',
+                        default=None,
+                        dest='output_file',
+                        metavar='output file',
+                        help='Specify an output file')
+    args = parser.parse_args()
+    if args.output_file:
+        with open(args.output_file, 'w', buffering=1 << 20) as fd:
+            generate(fd, args.design, args.vertices, args.width)
+    else:
+        generate(sys.stdout, args.design, args.vertices, args.width)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+
+"""
+Generate the benchmark netlists, run NetlistBenchmarks on each of them and
+write all the results to a single JSON file. With --baseline, compare the
+results with those of an earlier run and exit with an error if any benchmark
+is slower or uses more memory than the baseline allows.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import generate_netlist
+
+BENCHMARKS_BIN = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'NetlistBenchmarks')
+
+
+def generate_netlists(designs, sizes, width, directory):
+    """
+    Generate a netlist for each design and size, unless it already exists.
+    """
+    os.makedirs(directory, exist_ok=True)
+    paths = []
+    for design in designs:
+        for size in sizes:
+            path = os.path.join(directory, '{}_{}.xml'.format(design, size))
+            if not os.path.exists(path):
+                print('Generating {}'.format(path), file=sys.stderr)
+                with open(path + '.tmp', 'w', buffering=1 << 20) as fd:
+                    generate_netlist.generate(fd, design, size, width)
+                os.rename(path + '.tmp', path)
+            paths.append(path)
+    return paths
+
+
+def run_benchmarks(paths, args):
+    """
+    Run the benchmarks of each netlist in a separate process, so the peak
+    memory usage of each is measured separately.
+    """
+    report = {'netlists': [], 'results': []}
+    for path in paths:
+        print('Benchmarking {}'.format(path), file=sys.stderr)
+        command = [args.benchmarks_bin, path,
+                   '--samples', str(args.samples),
+                   '--repeats', str(args.repeats),
+                   '--max-paths', str(args.max_paths)]
+        if args.reachability_index:
+            command.append('--reachability-index')
+        proc = subprocess.run(command, stdout=subprocess.PIPE, check=True)
+        output = json.loads(proc.stdout.decode('utf-8'))
+        name = os.path.basename(path)
+        for netlist in output['netlists']:
+            netlist['netlist'] = name
+            netlist['peak_rss_bytes'] = output['peak_rss_bytes']
+            report['netlists'].append(netlist)
+        for result in output['results']:
+            result['netlist'] = name
+            report['results'].append(result)
+    return report
+
+
+def compare(report, baseline, tolerance, min_seconds):
+    """
+    Return a list of the benchmarks that regressed from the baseline by more
+    than the tolerance. Times shorter than min_seconds are too noisy to
+    compare.
+    """
+    regressions = []
+    previous = {(r['netlist'], r['benchmark']): r for r in baseline['results']}
+    for result in report['results']:
+        key = (result['netlist'], result['benchmark'])
+        if key not in previous:
+            continue
+        before = previous[key]
+        if max(before['seconds'], result['seconds']) >= min_seconds and \
+           result['seconds'] > before['seconds'] * (1 + tolerance):
+            regressions.append('{} {}: {:.4f}s, baseline {:.4f}s'.format(
+                key[0], key[1], result['seconds'], before['seconds']))
+    previous = {n['netlist']: n for n in baseline['netlists']}
+    for netlist in report['netlists']:
+        before = previous.get(netlist['netlist'])
+        if before and netlist['peak_rss_bytes'] > before['peak_rss_bytes'] * (1 + tolerance):
+            regressions.append('{} peak RSS: {} bytes, baseline {} bytes'.format(
+                netlist['netlist'], netlist['peak_rss_bytes'], before['peak_rss_bytes']))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the netlist benchmarks')
+    parser.add_argument('--designs',
+                        nargs='+',
+                        choices=generate_netlist.DESIGNS,
+                        default=list(generate_netlist.DESIGNS),
+                        help='The designs to benchmark')
+    parser.add_argument('--sizes',
+                        nargs='+',
+                        type=int,
+                        default=[10000, 100000],
+                        help='The approximate numbers of vertices of the netlists')
+    parser.add_argument('--width',
+                        type=int,
+                        default=32,
+                        help='The width of each design')
+    parser.add_argument('--netlist-dir',
+                        default='netlists',
+                        help='The directory of the generated netlists, which are reused')
+    parser.add_argument('--samples',
+                        type=int,
+                        default=100,
+                        help='The number of vertices each query is made from')
+    parser.add_argument('--repeats',
+                        type=int,
+                        default=3,
+                        help='The number of times each query is timed')
+    parser.add_argument('--max-paths',
+                        type=int,
+                        default=1000,
+                        help='The maximum number of paths enumerated between two points')
+    parser.add_argument('--reachability-index',
+                        action='store_true',
+                        help='Build and time the reachability index')
+    parser.add_argument('--benchmarks-bin',
+                        default=BENCHMARKS_BIN,
+                        help='The benchmark executable')
+    parser.add_argument('-o', '--output',
+                        default=None,
+                        dest='output_file',
+                        metavar='output file',
+                        help='Write the results to a file instead of stdout')
+    parser.add_argument('--baseline',
+                        default=None,
+                        metavar='file',
+                        help='Compare the results with those of an earlier run')
+    parser.add_argument('--tolerance',
+                        type=float,
+                        default=0.25,
+                        help='The fraction a result can exceed the baseline by')
+    parser.add_argument('--min-seconds',
+                        type=float,
+                        default=0.01,
+                        help='Times below which results are not compared with the baseline')
+    args = parser.parse_args()
+    paths = generate_netlists(args.designs, args.sizes, args.width, args.netlist_dir)
+    report = run_benchmarks(paths, args)
+    if args.output_file:
+        with open(args.output_file, 'w') as fd:
+            json.dump(report, fd, indent=2)
+    else:
+        json.dump(report, sys.stdout, indent=2)
+    if args.baseline:
+        with open(args.baseline) as fd:
+            baseline = json.load(fd)
+        regressions = compare(report, baseline, args.tolerance, args.min_seconds)
+        for regression in regressions:
+            print('Regression: ' + regression, file=sys.stderr)
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
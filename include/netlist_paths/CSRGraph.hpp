@@ -0,0 +1,95 @@
+#ifndef NETLIST_PATHS_CSR_GRAPH_HPP
+#define NETLIST_PATHS_CSR_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace netlist_paths {
+
+/// An immutable compressed-sparse-row representation of the netlist graph,
+/// used by the queries once the graph is complete.
+///
+/// The forward and reverse adjacency are each held as an array of offsets
+/// indexed by vertex ID and an array of neighbouring vertex IDs, so all the
+/// edges of a vertex are contiguous. The out edges and in edges of each vertex
+/// are kept in the same order as in the adjacency list the graph was built
+/// from, so searches visit them in the same order. The through-register flag
+/// of each edge is held in a packed bit array alongside each adjacency.
+class CSRGraph {
+public:
+  /// A compact vertex ID.
+  using Index = uint32_t;
+
+  /// The edges of one direction of the graph.
+  class Adjacency {
+    friend class CSRGraph;
+    std::vector<size_t> offsets;
+    std::vector<Index> vertices;
+    std::vector<uint64_t> throughRegister;
+
+    void setThroughRegister(size_t edge) {
+      throughRegister[edge / 64] |= uint64_t(1) << (edge % 64);
+    }
+
+  public:
+    /// Return the range of edge indices of a vertex.
+    std::pair<size_t, size_t> getEdges(size_t vertex) const {
+      return {offsets[vertex], offsets[vertex + 1]};
+    }
+
+    /// Return the neighbouring vertex of an edge.
+    size_t getVertex(size_t edge) const { return vertices[edge]; }
+
+    /// Return true if an edge passes through a register.
+    bool isThroughRegister(size_t edge) const {
+      return (throughRegister[edge / 64] >> (edge % 64)) & 1;
+    }
+
+    /// Return the number of edges of a vertex.
+    size_t degree(size_t vertex) const {
+      return offsets[vertex + 1] - offsets[vertex];
+    }
+  };
+
+private:
+  Adjacency outEdges;
+  Adjacency inEdges;
+
+public:
+  CSRGraph() {}
+
+  /// Build the CSR representation of a graph.
+  ///
+  /// \param graph The graph to convert, which is instantiated for
+  ///              InternalGraph.
+  ///
+  /// \throws Exception if the graph has too many vertices.
+  template<typename Graph>
+  void build(const Graph &graph);
+
+  /// Remove all vertices and edges.
+  void clear() {
+    outEdges = Adjacency();
+    inEdges = Adjacency();
+  }
+
+  /// Return the out edges of the graph.
+  const Adjacency &getOutEdges() const { return outEdges; }
+
+  /// Return the in edges of the graph, for traversals of the reverse graph.
+  const Adjacency &getInEdges() const { return inEdges; }
+
+  /// Return the number of vertices.
+  size_t numVertices() const {
+    return outEdges.offsets.empty() ? 0 : outEdges.offsets.size() - 1;
+  }
+
+  /// Return the number of edges.
+  size_t numEdges() const { return outEdges.vertices.size(); }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_CSR_GRAPH_HPP
@@ -0,0 +1,84 @@
+#ifndef NETLIST_PATHS_COMPILE_CACHE_HPP
+#define NETLIST_PATHS_COMPILE_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace netlist_paths {
+
+/// A content-addressed cache of the netlists produced by Verilator, held in a
+/// directory so it is shared between processes.
+///
+/// Each compilation is identified by a key, which is a hash of the Verilator
+/// version, its arguments and the paths and contents of the source files it
+/// is given. An entry holds the XML netlist, a manifest of every file
+/// Verilator read (including those found on the include paths) with the hash
+/// of its contents, and optionally a binary snapshot of the netlist. An entry
+/// is only used if none of the files of its manifest have changed. Files are
+/// added to the directory by renaming them into place, so concurrent
+/// compilations never see a partial entry, and once the size of the directory
+/// exceeds a limit, the least recently used entries are evicted.
+class CompileCache {
+  boost::filesystem::path directory;
+  uintmax_t maxBytes;
+
+  boost::filesystem::path getPath(const std::string &key,
+                                  const std::string &extension) const;
+
+  bool isValid(const std::string &key) const;
+
+  void insertFile(const std::string &key, const std::string &extension,
+                  const std::string &filename) const;
+
+public:
+  /// Create a cache in a directory, which is created if it does not exist.
+  ///
+  /// \param directory The directory of the cache.
+  /// \param maxBytes  The size the cache is reduced to when entries are
+  ///                  evicted, or zero for no limit.
+  CompileCache(const std::string &directory, uintmax_t maxBytes);
+
+  /// Return the key of a compilation.
+  ///
+  /// \param verilatorVersion The version string of the Verilator executable.
+  /// \param args             The arguments of Verilator, excluding the
+  ///                         source files and the output file.
+  /// \param inputFiles       The source files.
+  ///
+  /// \returns A string of hexadecimal digits.
+  static std::string getKey(const std::string &verilatorVersion,
+                            const std::vector<std::string> &args,
+                            const std::vector<std::string> &inputFiles);
+
+  /// Return the path of the cached XML of a compilation, or an empty path if
+  /// there is no valid entry for the key.
+  boost::filesystem::path findXML(const std::string &key) const;
+
+  /// Return the path of the cached snapshot of a compilation, or an empty
+  /// path if there is no valid entry with a snapshot for the key.
+  boost::filesystem::path findSnapshot(const std::string &key) const;
+
+  /// Add the XML of a compilation to the cache, with a manifest of the
+  /// source files it lists.
+  ///
+  /// \param key     The key of the compilation.
+  /// \param xmlFile The XML file produced by Verilator, which is copied.
+  void insertXML(const std::string &key, const std::string &xmlFile) const;
+
+  /// Add a snapshot of the netlist of a cached compilation.
+  ///
+  /// \param key          The key of the compilation.
+  /// \param snapshotFile The snapshot file, which is copied.
+  void insertSnapshot(const std::string &key,
+                      const std::string &snapshotFile) const;
+
+  /// Remove the least recently used entries until the cache is no larger
+  /// than its limit.
+  void evict() const;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_COMPILE_CACHE_HPP
@@ -0,0 +1,100 @@
+#ifndef NETLIST_PATHS_COMPONENT_GRAPH_HPP
+#define NETLIST_PATHS_COMPONENT_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "netlist_paths/CSRGraph.hpp"
+
+namespace netlist_paths {
+
+/// The condensation of a graph into a DAG of its strongly-connected
+/// components, for one setting of the traverse registers option.
+///
+/// The components are found by Tarjan's algorithm, which completes them in
+/// reverse topological order, so they are numbered such that a component's
+/// successors in the DAG all have lower numbers than it. The DAG is held in
+/// compressed-sparse-row form in both directions without duplicate edges,
+/// together with the vertices of each component, so the queries that need to
+/// handle cycles can work on the DAG instead.
+class ComponentGraph {
+  friend class WriteSnapshot;
+  friend class ReadSnapshot;
+
+public:
+  using Index = CSRGraph::Index;
+
+private:
+  std::vector<Index> components;
+  std::vector<size_t> outOffsets;
+  std::vector<Index> outComponents;
+  std::vector<size_t> inOffsets;
+  std::vector<Index> inComponents;
+  std::vector<size_t> memberOffsets;
+  std::vector<Index> members;
+  size_t componentCount;
+  bool traverseRegisters;
+
+  void buildComponents(const CSRGraph &graph);
+  void buildMembers();
+  void buildDAG(const CSRGraph &graph);
+
+public:
+  ComponentGraph() : componentCount(0), traverseRegisters(false) {}
+
+  /// Build the condensation of a graph.
+  ///
+  /// \param graph             The graph to condense.
+  /// \param traverseRegisters Whether paths can pass through registers.
+  void build(const CSRGraph &graph, bool traverseRegisters);
+
+  /// Remove the condensation.
+  void clear();
+
+  /// Return the number of vertices of the graph.
+  size_t numVertices() const { return components.size(); }
+
+  /// Return the number of strongly-connected components.
+  size_t numComponents() const { return componentCount; }
+
+  /// Return true if the edges through registers were followed.
+  bool shouldTraverseRegisters() const { return traverseRegisters; }
+
+  /// Return the number of edges of the DAG.
+  size_t numEdges() const { return outComponents.size(); }
+
+  /// Return the strongly-connected component of a vertex.
+  Index getComponent(size_t vertex) const { return components[vertex]; }
+
+  /// Return the successors of a component in the DAG, which all have lower
+  /// numbers than it.
+  std::pair<const Index*, const Index*> getSuccessors(Index component) const {
+    return {outComponents.data() + outOffsets[component],
+            outComponents.data() + outOffsets[component + 1]};
+  }
+
+  /// Return the predecessors of a component in the DAG, which all have
+  /// higher numbers than it.
+  std::pair<const Index*, const Index*> getPredecessors(Index component) const {
+    return {inComponents.data() + inOffsets[component],
+            inComponents.data() + inOffsets[component + 1]};
+  }
+
+  /// Return the vertices of a component, in ascending order.
+  std::pair<const Index*, const Index*> getMembers(Index component) const {
+    return {members.data() + memberOffsets[component],
+            members.data() + memberOffsets[component + 1]};
+  }
+
+  /// Return true if a component contains a cycle, which is the case if it
+  /// has more than one vertex or its vertex has an edge to itself.
+  ///
+  /// \param graph     The graph that was condensed.
+  /// \param component The component.
+  bool isCycle(const CSRGraph &graph, Index component) const;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_COMPONENT_GRAPH_HPP
@@ -0,0 +1,81 @@
+#ifndef NETLIST_PATHS_COMPRESSION_HPP
+#define NETLIST_PATHS_COMPRESSION_HPP
+
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace netlist_paths {
+
+/// The formats netlist files can be compressed with.
+enum class Compression {
+  NONE,
+  GZIP,
+  ZSTD
+};
+
+/// Return the compression of a file from the magic bytes at its start.
+///
+/// \param filename The path of the file.
+///
+/// \returns NONE if the file is not compressed or cannot be read.
+Compression detectCompression(const std::string &filename);
+
+/// Return the compression implied by the extension of a file name, which is
+/// GZIP for .gz and ZSTD for .zst.
+Compression getCompressionForFilename(const std::string &filename);
+
+/// Return true if this build can read and write files with a compression.
+/// Zstandard is only supported if the library was built with it, by the
+/// NETLIST_PATHS_ZSTD build option.
+bool isCompressionSupported(Compression compression);
+
+/// An input stream of a file, which is decompressed as it is read if it is
+/// compressed with gzip or Zstandard, as detected by its magic bytes.
+///
+/// The decompression runs on a background thread into a bounded queue of
+/// buffers, which the stream reads from, so a large netlist is decompressed
+/// while it is parsed and never held in memory or on disk in full. An error
+/// decompressing the file is thrown by the read that reaches it.
+class InputFile {
+  std::unique_ptr<std::streambuf> buffer;
+  std::istream stream;
+  Compression compression;
+
+public:
+  /// Open a file.
+  ///
+  /// \param filename The path of the file.
+  ///
+  /// \throws Exception if the file is compressed with a format that this
+  ///         build does not support.
+  explicit InputFile(const std::string &filename);
+
+  InputFile(const InputFile&) = delete;
+  InputFile &operator=(const InputFile&) = delete;
+
+  /// Return true if the file was opened.
+  bool isOpen() const { return buffer != nullptr; }
+
+  /// Return the compression of the file.
+  Compression getCompression() const { return compression; }
+
+  /// Return the stream of the decompressed contents of the file.
+  std::istream &get() { return stream; }
+};
+
+/// Compress a file, reading and writing it in fixed-size chunks.
+///
+/// \param inputFile   The path of the file to compress.
+/// \param outputFile  The path of the compressed file to write.
+/// \param compression The format to compress with.
+///
+/// \throws Exception if either file cannot be opened or the compression is
+///         not supported.
+void compressFile(const std::string &inputFile, const std::string &outputFile,
+                  Compression compression);
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_COMPRESSION_HPP
@@ -0,0 +1,83 @@
+#ifndef NETLIST_PATHS_CONNECTIVITY_MATRIX_HPP
+#define NETLIST_PATHS_CONNECTIVITY_MATRIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "netlist_paths/ReachabilityIndex.hpp"
+
+namespace netlist_paths {
+
+/// A sparse matrix of the pairs of start and end points that are connected by
+/// a path, held in compressed-sparse-row form with a row for each start
+/// point.
+///
+/// The matrix is computed in bulk rather than with a search from each start
+/// point: blocks of BLOCK_WIDTH start points are assigned a bit each, and the
+/// bit vectors are propagated over the component DAG of a ReachabilityIndex
+/// in topological order by ORing each component's vector into its
+/// successors, so every start point of a block is processed in one pass. The
+/// blocks are independent so they are processed in parallel.
+class ConnectivityMatrix {
+public:
+  /// The number of start points propagated together.
+  static constexpr size_t BLOCK_WIDTH = 256;
+
+  /// The memory of the bit vectors of all the threads, which use
+  /// BLOCK_WIDTH bits for every component of the DAG each, and which limits
+  /// the number of threads on large graphs.
+  static constexpr size_t MAX_BIT_VECTOR_BYTES = size_t(1) << 30;
+
+private:
+  std::vector<size_t> startPoints;
+  std::vector<size_t> endPoints;
+  std::vector<size_t> rowOffsets;
+  std::vector<uint32_t> columns;
+
+public:
+  ConnectivityMatrix() : rowOffsets(1, 0) {}
+
+  /// Compute the connectivity of a set of start and end points.
+  ///
+  /// \param index       The reachability index of the graph, for the setting
+  ///                    of traverse registers the paths should follow.
+  /// \param startPoints The start points, which become the rows.
+  /// \param endPoints   The end points, which become the columns.
+  /// \param numThreads  The maximum number of threads to compute the blocks
+  ///                    with, or zero for the hardware concurrency.
+  ///
+  /// \returns The matrix, which excludes a vertex that is both a start and an
+  ///          end point being connected to itself.
+  static ConnectivityMatrix build(const ReachabilityIndex &index,
+                                  const std::vector<size_t> &startPoints,
+                                  const std::vector<size_t> &endPoints,
+                                  size_t numThreads=0);
+
+  /// Return the start points, indexed by row.
+  const std::vector<size_t> &getStartPoints() const { return startPoints; }
+
+  /// Return the end points, indexed by column.
+  const std::vector<size_t> &getEndPoints() const { return endPoints; }
+
+  /// Return the columns of the end points connected to a start point, in
+  /// ascending order.
+  std::pair<const uint32_t*, const uint32_t*> getRow(size_t row) const {
+    return {columns.data() + rowOffsets[row],
+            columns.data() + rowOffsets[row + 1]};
+  }
+
+  /// Return true if a start point is connected to an end point.
+  bool test(size_t row, size_t column) const;
+
+  /// Return all the connected pairs of vertices, ordered by start point then
+  /// end point.
+  std::vector<std::pair<size_t, size_t>> getPairs() const;
+
+  /// Return the number of connected pairs.
+  size_t numPairs() const { return columns.size(); }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_CONNECTIVITY_MATRIX_HPP
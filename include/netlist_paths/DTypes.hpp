@@ -1,10 +1,15 @@
 #ifndef NETLIST_PATHS_DTYPES_HPP
 #define NETLIST_PATHS_DTYPES_HPP
 
-#include <numeric>
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <string>
+#include <tuple>
 #include <vector>
+#include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Location.hpp"
 
 namespace netlist_paths {
@@ -27,6 +32,7 @@ public:
   }
 
   const std::string getName() const { return name; }
+  const Location &getLocation() const { return location; }
   virtual size_t getWidth() const { return 0; }
   virtual ~DType() = default; // Make DType polymorphic to allow dynamic casts.
 
@@ -77,6 +83,10 @@ public:
   virtual size_t getWidth() const override {
     return ranged ? (left - right + 1) : 1;
   }
+
+  unsigned getLeft() const { return left; }
+  unsigned getRight() const { return right; }
+  bool isRanged() const { return ranged; }
 };
 
 /// Reference data type, wrapping a sub data type.
@@ -101,6 +111,8 @@ public:
   virtual size_t getWidth() const override {
     return subDType->getWidth();
   }
+
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
 };
 
 /// Array data type, with a range, packed flag and sub data type.
@@ -141,6 +153,11 @@ public:
   virtual size_t getWidth() const override {
     return packed ? (end - start + 1) * subDType->getWidth() : 0;
   }
+
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
+  size_t getStart() const { return start; }
+  size_t getEnd() const { return end; }
+  bool isPacked() const { return packed; }
 };
 
 /// Structure or union member data type, wrapping a sub data type.
@@ -161,6 +178,8 @@ public:
   virtual size_t getWidth() const override {
     return subDType->getWidth();
   }
+
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
 };
 
 /// Structure data type with a set of members.
@@ -194,6 +213,8 @@ public:
     auto sum = [](size_t result, const MemberDType &member) { return result + member.getWidth(); };
     return std::accumulate(std::begin(members), std::end(members), 0, sum);
   }
+
+  const std::vector<MemberDType> &getMembers() const { return members; }
 };
 
 /// Union data type with a set of members.
@@ -224,8 +245,10 @@ public:
   }
 
   virtual size_t getWidth() const override {
-    return members.front().getWidth();
+    return members.empty() ? 0 : members.front().getWidth();
   }
+
+  const std::vector<MemberDType> &getMembers() const { return members; }
 };
 
 /// Enumeration item data type, with a name and value.
@@ -272,6 +295,72 @@ public:
   virtual size_t getWidth() const override {
     return subDType->getWidth();
   }
+
+  const std::vector<EnumItem> &getItems() const { return items; }
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
+};
+
+/// A table of the data types of a netlist, which is owned by its graph,
+/// flattened so a vertex can refer to its data type by a compact index, and
+/// with the width and string of each type computed once when it is added
+/// rather than on each access through its sub data types. Types with the same
+/// name, string and width are held once.
+class DTypeTable {
+public:
+  /// A data type with its width and string.
+  class Entry {
+    std::shared_ptr<DType> dtype;
+    std::string str;
+    size_t width;
+
+  public:
+    Entry(std::shared_ptr<DType> dtype, std::string str, size_t width) :
+        dtype(std::move(dtype)), str(std::move(str)), width(width) {}
+
+    const std::shared_ptr<DType> &getDType() const { return dtype; }
+    const std::string &getStr() const { return str; }
+    size_t getWidth() const { return width; }
+  };
+
+  /// The index of no data type.
+  static constexpr uint32_t NO_DTYPE = UINT32_MAX;
+
+private:
+  std::deque<Entry> entries;
+  std::map<std::tuple<std::string, std::string, size_t>, uint32_t> indexes;
+
+public:
+  DTypeTable() {}
+  DTypeTable(const DTypeTable&) = delete;
+  DTypeTable &operator=(const DTypeTable&) = delete;
+
+  /// Return the index of a data type, adding it to the table if a type with
+  /// the same name, string and width is not already present. The sub data
+  /// types of the type must be set.
+  ///
+  /// \param dtype The data type to add.
+  ///
+  /// \returns The index of the data type.
+  uint32_t add(const std::shared_ptr<DType> &dtype) {
+    auto key = std::make_tuple(dtype->getName(), dtype->toString(), dtype->getWidth());
+    auto it = indexes.find(key);
+    if (it != indexes.end()) {
+      return it->second;
+    }
+    if (entries.size() == NO_DTYPE) {
+      throw Exception("too many data types");
+    }
+    auto index = static_cast<uint32_t>(entries.size());
+    entries.emplace_back(dtype, std::get<1>(key), std::get<2>(key));
+    indexes.emplace(std::move(key), index);
+    return index;
+  }
+
+  /// Return the data type with an index.
+  const Entry &get(uint32_t index) const { return entries[index]; }
+
+  /// Return the number of data types in the table.
+  size_t size() const { return entries.size(); }
 };
 
 } // End namespace.
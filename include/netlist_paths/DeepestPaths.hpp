@@ -0,0 +1,132 @@
+#ifndef NETLIST_PATHS_DEEPEST_PATHS_HPP
+#define NETLIST_PATHS_DEEPEST_PATHS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "netlist_paths/ComponentGraph.hpp"
+#include "netlist_paths/PathSearch.hpp"
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+/// The weight of each type of vertex, which the depth of a path is the sum
+/// of over its vertices. By default, logic vertices weigh one and variables
+/// weigh nothing, so the depth of a path is the number of its logic vertices.
+class PathWeights {
+  std::array<double, static_cast<size_t>(VertexAstType::INVALID) + 1> weights;
+
+public:
+  PathWeights();
+
+  /// Return the weight of a type of vertex.
+  double getWeight(VertexAstType type) const {
+    return weights[static_cast<size_t>(type)];
+  }
+
+  /// Return a copy with a different weight for a type of vertex.
+  PathWeights withWeight(VertexAstType type, double value) const {
+    auto copy = *this;
+    copy.weights[static_cast<size_t>(type)] = value;
+    return copy;
+  }
+
+  /// Return the depth of a path.
+  template<typename Path>
+  double getDepth(const Path &path) const {
+    double depth = 0;
+    for (auto vertex : path) {
+      depth += getWeight(vertex->getAstType());
+    }
+    return depth;
+  }
+};
+
+/// A search for the deepest paths from a vertex, by the sum of the weights of
+/// their vertices, which keeps only a number of the deepest paths to each
+/// vertex rather than enumerating all of them.
+///
+/// The paths are extended over the subgraphs selected by a PathSearch, with
+/// the vertices visited in the topological order of the components of the
+/// ComponentGraph. Since the deepest paths to a vertex of a DAG extend the
+/// deepest paths to its predecessors, the search finds the deepest paths
+/// exactly where the subgraph is acyclic, in time proportional to the number
+/// of edges and paths kept. Within a strongly-connected component, the paths
+/// are extended over its internal edges for as many rounds as it has
+/// vertices, without revisiting a vertex, so the paths through loops are
+/// simple but not guaranteed to be the deepest.
+///
+/// A query with waypoints extends the paths over the subgraph between each
+/// pair of adjacent waypoints in turn, starting each stage from the paths
+/// kept at the end of the last one, as PathEnumerator combines the paths of
+/// its stages. Paths are only required to be simple within a stage.
+class DeepestPaths {
+  static constexpr uint32_t NO_LABEL = UINT32_MAX;
+
+  /// A path found by the search, as its last vertex and the label of the
+  /// path without it.
+  struct Label {
+    double depth;
+    VertexID vertex;
+    uint32_t previous;
+    uint32_t stage;
+  };
+
+  const ComponentGraph &components;
+  size_t numPaths;
+  bool reverse;
+  std::vector<Label> labels;
+  // The labels of the deepest paths found so far, deepest first, all of
+  // which end at the start vertex of the next stage.
+  std::vector<uint32_t> paths;
+  uint32_t stage;
+
+  uint32_t insert(std::vector<uint32_t> &deepest, VertexID vertex,
+                  uint32_t previous, double depth);
+
+  bool isOnPath(uint32_t label, VertexID vertex, VertexID stageStart) const;
+
+public:
+  DeepestPaths() = delete;
+
+  /// Create a search.
+  ///
+  /// \param components The condensation of the graph, for the traverse
+  ///                   registers option of the query.
+  /// \param numPaths   The number of paths to find.
+  /// \param reverse    Extend the paths over in edges rather than out edges,
+  ///                   so they are found from their last vertex.
+  DeepestPaths(const ComponentGraph &components, size_t numPaths,
+               bool reverse=false);
+
+  /// Start the paths at a vertex.
+  ///
+  /// \param vertex The first vertex of the paths.
+  /// \param weight The weight of the vertex.
+  void start(VertexID vertex, double weight);
+
+  /// Extend the paths over the subgraph selected by a search, keeping the
+  /// deepest of them that end at any of a set of vertices.
+  ///
+  /// \param search         A search with a selection that includes the
+  ///                       vertex the paths end at.
+  /// \param weights        The weight of each selected vertex, in the order
+  ///                       of the selection.
+  /// \param finishVertices The vertices the paths can end at.
+  ///
+  /// \returns False if no path reaches any of the finish vertices.
+  bool extend(const PathSearch &search, const std::vector<double> &weights,
+              const VertexIDVec &finishVertices);
+
+  /// Return the deepest paths, deepest first, with their vertices in the
+  /// order of the graph's edges.
+  std::vector<VertexIDVec> getPaths() const;
+
+  /// Return the depth of each of the paths returned by getPaths().
+  std::vector<double> getDepths() const;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_DEEPEST_PATHS_HPP
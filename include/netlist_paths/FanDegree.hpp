@@ -0,0 +1,100 @@
+#ifndef NETLIST_PATHS_FAN_DEGREE_HPP
+#define NETLIST_PATHS_FAN_DEGREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "netlist_paths/ReachabilityIndex.hpp"
+
+namespace netlist_paths {
+
+/// The size of the fan out of a start point to the end points, or of the fan
+/// in of an end point from the start points, counted without enumerating the
+/// paths.
+///
+/// The paths are counted by dynamic programming over the component DAG of a
+/// ReachabilityIndex, so paths that only differ inside a strongly-connected
+/// component count once. On an acyclic graph this is the number of distinct
+/// paths getAllPaths() would return to all the points, which can repeat a
+/// path that follows parallel edges. The count saturates at MAX_PATHS.
+struct FanDegree {
+  /// The value of a path count that has saturated.
+  static constexpr uint64_t MAX_PATHS = std::numeric_limits<uint64_t>::max();
+
+  /// The number of points reached.
+  uint64_t numPoints;
+
+  /// The number of paths to all the points reached.
+  uint64_t numPaths;
+
+  /// The sum of the widths of the data types of the points reached.
+  uint64_t numBits;
+
+  FanDegree() : numPoints(0), numPaths(0), numBits(0) {}
+
+  /// Return true if the number of paths has saturated.
+  bool isSaturated() const { return numPaths == MAX_PATHS; }
+
+  /// Count the fan out or fan in of a single vertex, by searching the DAG
+  /// from its component.
+  ///
+  /// \param index   The reachability index of the graph, for the setting of
+  ///                traverse registers the paths should follow.
+  /// \param root    The vertex to count from.
+  /// \param points  The end points, or the start points for a fan in.
+  /// \param widths  The width of each point.
+  /// \param reverse Count the fan in, following the paths backwards.
+  ///
+  /// \returns The degree, which includes the root if it is one of the points.
+  static FanDegree count(const ReachabilityIndex &index,
+                         size_t root,
+                         const std::vector<size_t> &points,
+                         const std::vector<uint64_t> &widths,
+                         bool reverse=false);
+};
+
+/// The fan degrees of a list of vertices, held as a column for each field of
+/// FanDegree with a row for each vertex.
+struct FanDegreeColumns {
+  std::vector<uint64_t> vertices;
+  std::vector<uint64_t> numPoints;
+  std::vector<uint64_t> numPaths;
+  std::vector<uint64_t> numBits;
+
+  /// Count the fan out or fan in of many vertices together. The paths of all
+  /// the vertices are counted in a single pass of the DAG, and the points are
+  /// counted from the rows or columns of a ConnectivityMatrix.
+  ///
+  /// \param index   The reachability index of the graph.
+  /// \param roots   The vertices to count from.
+  /// \param points  The end points, or the start points for a fan in.
+  /// \param widths  The width of each point.
+  /// \param reverse Count the fan in, following the paths backwards.
+  /// \param numThreads The maximum number of threads to compute the matrix
+  ///                   with, or zero for the hardware concurrency.
+  ///
+  /// \returns The degree of each root, as FanDegree::count() returns them.
+  static FanDegreeColumns count(const ReachabilityIndex &index,
+                                const std::vector<size_t> &roots,
+                                const std::vector<size_t> &points,
+                                const std::vector<uint64_t> &widths,
+                                bool reverse=false,
+                                size_t numThreads=0);
+
+  /// Return the number of rows.
+  size_t size() const { return vertices.size(); }
+
+  /// Return the degree of a row.
+  FanDegree getRow(size_t row) const {
+    FanDegree degree;
+    degree.numPoints = numPoints[row];
+    degree.numPaths = numPaths[row];
+    degree.numBits = numBits[row];
+    return degree;
+  }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_FAN_DEGREE_HPP
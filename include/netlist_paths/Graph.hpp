@@ -2,19 +2,37 @@
 #define NETLIST_PATHS_GRAPH_HPP
 
 #include <algorithm>
+#include <array>
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/tokenizer.hpp>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/ComponentGraph.hpp"
+#include "netlist_paths/ConnectivityMatrix.hpp"
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Edge.hpp"
+#include "netlist_paths/FanDegree.hpp"
+#include "netlist_paths/NameIndex.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/Pattern.hpp"
+#include "netlist_paths/ReachabilityIndex.hpp"
+#include "netlist_paths/Stats.hpp"
+#include "netlist_paths/StringPool.hpp"
+#include "netlist_paths/TraversalCache.hpp"
 #include "netlist_paths/Vertex.hpp"
+#include "netlist_paths/VertexClasses.hpp"
 
 namespace netlist_paths {
 
+class PathEnumerator;
+class PathSearch;
+class PathWeights;
+
 using InternalGraph = boost::adjacency_list<boost::vecS,
                                             boost::vecS,
                                             boost::bidirectionalS,
@@ -22,22 +40,23 @@ using InternalGraph = boost::adjacency_list<boost::vecS,
                                             Edge>;
 using VertexID = boost::graph_traits<InternalGraph>::vertex_descriptor;
 using EdgeID = boost::graph_traits<InternalGraph>::edge_descriptor;
-using ParentMap = std::map<VertexID, std::vector<VertexID>>;
 using VertexIDVec = std::vector<VertexID>;
 
 /// An edge predicate for the filtered graph.
 struct EdgePredicate {
 
   const InternalGraph *graph;
+  bool traverseRegisters;
 
   EdgePredicate() {}
 
-  EdgePredicate(const InternalGraph *graph) : graph(graph) {}
+  EdgePredicate(const InternalGraph *graph, bool traverseRegisters) :
+      graph(graph), traverseRegisters(traverseRegisters) {}
 
   bool operator()(EdgeID edgeID) const {
     // Include all edges if traversal of registers is enabled, otherwise only
     // include edges that do not traverse a register.
-    if (Options::getInstance().shouldTraverseRegisters()) {
+    if (traverseRegisters) {
       return true;
     } else {
       return !(*graph)[edgeID].isThroughRegister();
@@ -70,29 +89,85 @@ using FilteredInternalGraph = boost::filtered_graph<InternalGraph,
                                                     VertexPredicate>;
 
 /// A class representing a netlist graph.
+///
+/// Once the graph and its indexes have been built, the const query methods do
+/// not modify any shared state, so they can be called concurrently by any
+/// number of threads. The options of each query are passed to it, so
+/// concurrent queries can use different options.
 class Graph {
 private:
+  friend class ReadSnapshot;
+  friend class WriteSnapshot;
+
+  StringPool names;
+  VertexTables tables;
   InternalGraph graph;
-  std::map<std::string, VertexID> aliasMap;
+  std::map<std::string_view, VertexID> aliasMap;
+  CSRGraph csrGraph;
+  // Indexed by the setting of the traverse registers option.
+  std::array<std::shared_ptr<const ComponentGraph>, 2> componentGraphs;
+  std::array<ReachabilityIndex, 2> reachabilityIndexes;
+  NameIndex nameIndex;
+  VertexClasses vertexClasses;
+  mutable PatternCache patternCache;
+  mutable TraversalCache traversalCache;
+  mutable Stats stats;
+
+  bool vertexTypeMatch(VertexID vertex, VertexNetlistType graphType,
+                       const QueryOptions &options) const {
+    return vertexClasses.test(vertex, graphType, options);
+  }
 
-  bool vertexTypeMatch(VertexID vertex, VertexNetlistType graphType) const;
+  std::shared_ptr<const Pattern> getPattern(const std::string &pattern,
+                                            const QueryOptions &options) const;
+
+  VertexIDVec matchVertices(const Pattern &pattern,
+                            VertexNetlistType graphType,
+                            const QueryOptions &options) const;
 
   bool isAliasPath(const VertexIDVec &waypointIDs) const;
 
-  VertexIDVec getAdjacentVerticesOutEdges(VertexID vertex) const;
+  /// Return the reachability index for the traverse registers option of a
+  /// query, or nullptr if it has not been built.
+  const ReachabilityIndex *getReachabilityIndex(const QueryOptions &options) const {
+    auto &index = reachabilityIndexes[options.shouldTraverseRegisters()];
+    return index.isBuilt() ? &index : nullptr;
+  }
+
+  /// Call a function with the reachability index for the traverse registers
+  /// option of a query, building a temporary index if it has not been built.
+  template<typename Function>
+  auto withReachabilityIndex(const QueryOptions &options,
+                             Function function) const {
+    if (auto index = getReachabilityIndex(options)) {
+      return function(*index);
+    }
+    ReachabilityIndex index;
+    index.build(componentGraphs[options.shouldTraverseRegisters()]);
+    return function(index);
+  }
+
+  std::shared_ptr<const TraversalTree>
+  getTraversalTree(VertexID rootVertex, bool reverse,
+                   const QueryOptions &options, SearchCounts *counts) const;
 
-  VertexIDVec getAdjacentVerticesInEdges(VertexID vertex) const;
+  std::vector<uint64_t> getDTypeWidths(const VertexIDVec &vertices) const;
 
-  VertexIDVec determinePath(ParentMap &parentMap,
-                            VertexIDVec path,
-                            VertexID startVertexId,
-                            VertexID endVertexId) const;
+  std::vector<double> getPathWeights(const VertexIDVec &vertices,
+                                     const PathWeights &weights) const;
 
-  void determineAllPaths(ParentMap &parentMap,
-                         std::vector<VertexIDVec> &result,
-                         VertexIDVec path,
-                         VertexID startVertex,
-                         VertexID endVertex) const;
+  void writeSelection(const PathSearch &search, std::ostream &os,
+                      ExportFormat format) const;
+
+  /// Call a function with each vertex of the graph and the buffer of edits of
+  /// its block of consecutive vertices, with the blocks analysed in parallel.
+  /// The buffers are returned in order of the vertices, so applying them in
+  /// order has the same effect as a serial pass over the vertices. The blocks
+  /// are shared by numThreads threads, where zero means one per hardware
+  /// thread.
+  template<typename Edit, typename Analyze>
+  std::vector<std::vector<Edit>> analyzeVertices(size_t numThreads,
+                                                 Analyze analyze) const;
 
 public:
   Graph() {}
@@ -104,6 +179,7 @@ public:
   /// Add a logic vertex to the graph.
   VertexID addLogicVertex(VertexAstType type, Location location) {
     auto vertex = Vertex(type, location);
+    vertex.setTables(&tables);
     return boost::add_vertex(vertex, graph);
   }
 
@@ -111,16 +187,34 @@ public:
   VertexID addVarVertex(VertexAstType type,
                         VertexDirection direction,
                         Location location,
-                        std::shared_ptr<DType> dtype,
+                        uint32_t dtype,
                         const std::string &name,
                         bool isParam,
                         const std::string &paramValue,
                         bool isPublic) {
-    auto vertex = Vertex(type, direction, location, dtype, name, isParam,
-                         paramValue, isPublic);
+    auto vertex = Vertex(type, direction, location, dtype, names.intern(name),
+                         isParam, names.intern(paramValue), isPublic);
+    vertex.setTables(&tables);
     return boost::add_vertex(vertex, graph);
   }
 
+  /// Add a source file to the table that locations refer to.
+  ///
+  /// \returns The index of the file in the table.
+  uint32_t addFile(const File &file) {
+    return tables.files.add(file);
+  }
+
+  /// Add a data type to the table that vertices refer to.
+  ///
+  /// \returns The index of the data type in the table.
+  uint32_t addDType(const std::shared_ptr<DType> &dtype) {
+    return tables.dtypes.add(dtype);
+  }
+
+  /// Return the table of the data types that vertices refer to.
+  const DTypeTable &getDTypeTable() const { return tables.dtypes; }
+
   /// Add an edge to the graph.
   void addEdge(VertexID src, VertexID dst) {
     boost::add_edge(src, dst, graph);
@@ -136,94 +230,302 @@ public:
     graph[vertex].setDirection(direction);
   }
 
+  /// Set the data type of the specified vertex, by its index in the
+  /// DTypeTable.
+  void setVertexDType(VertexID vertex, uint32_t dtype) {
+    graph[vertex].setDType(dtype);
+  }
+
+  /// Remove all vertices and edges from the graph.
+  void clear() {
+    graph.clear();
+    aliasMap.clear();
+    names.clear();
+    csrGraph.clear();
+    for (auto &components : componentGraphs) {
+      components.reset();
+    }
+    for (auto &index : reachabilityIndexes) {
+      index.clear();
+    }
+    nameIndex.clear();
+    vertexClasses.clear();
+    traversalCache.clear();
+  }
+
+  // Each of the passes below analyses the graph on a number of threads, where
+  // zero means one per hardware thread, and the result does not depend on it.
+
   /// Mark all variables that are aliases of registers.
-  void markAliasRegisters();
+  void markAliasRegisters(size_t numThreads=0);
 
   /// Split register vertices into source and destination parts.
-  void splitRegVertices();
+  void splitRegVertices(size_t numThreads=0);
 
   /// Add additional edges to variable aliases.
-  void updateVarAliases();
+  void updateVarAliases(size_t numThreads=0);
+
+  /// Build the CSR form of the graph, its condensation into components for
+  /// both settings of the traverse registers option, the index of vertex
+  /// names and the classification of the vertices by type, which are used by
+  /// all the queries, and the reachability indexes if the option is set. This
+  /// must be done once the graph is complete, after which it must not be
+  /// modified.
+  void buildIndexes();
+
+  /// Build the reachability indexes for both settings of the traverse
+  /// registers option, if they have not already been built.
+  void buildReachabilityIndexes();
+
+  /// Return the condensation of the graph into strongly-connected components
+  /// for the traverse registers option of a query.
+  const ComponentGraph &getComponentGraph(const QueryOptions &options) const {
+    return *componentGraphs[options.shouldTraverseRegisters()];
+  }
+
+  /// Return true if the reachability indexes have been built.
+  bool hasReachabilityIndexes() const {
+    return reachabilityIndexes[0].isBuilt() && reachabilityIndexes[1].isBuilt();
+  }
 
   /// Perform some checks on the final graph.
   void checkGraph() const;
 
-  /// Write a dot file of the graph to file.
-  void dumpDotFile(const std::string &outputFilename) const;
+  /// Write a dot file of the graph to file, with the edges followed by paths
+  /// with the traverse registers option of a query.
+  void dumpDotFile(const std::string &outputFilename,
+                   const QueryOptions &options) const;
+
+  /// Write the subgraph of the vertices reachable from a start vertex, and
+  /// the edges between them followed by paths, to a stream. The subgraph is
+  /// written as it is found, so neither it nor the output is held in memory.
+  ///
+  /// \param startVertex   The vertex to start from.
+  /// \param os            The stream to write to.
+  /// \param options       The options of the query.
+  /// \param exportOptions The format of the output and the limits on the
+  ///                      size of the subgraph.
+  void exportFanOutCone(VertexID startVertex, std::ostream &os,
+                        const QueryOptions &options,
+                        const ExportOptions &exportOptions) const;
+
+  /// Write the subgraph of the vertices that can reach an end vertex to a
+  /// stream, as exportFanOutCone() does.
+  void exportFanInCone(VertexID endVertex, std::ostream &os,
+                       const QueryOptions &options,
+                       const ExportOptions &exportOptions) const;
+
+  /// Write the subgraph of the vertices on the paths between each pair of
+  /// consecutive waypoints, avoiding the specified mid points, to a stream,
+  /// as exportFanOutCone() does. The depth limit applies to the distance of
+  /// each vertex from the preceding waypoint.
+  void exportPointToPoint(const VertexIDVec &waypointIDs,
+                          const VertexIDVec &avoidPointIDs,
+                          std::ostream &os,
+                          const QueryOptions &options,
+                          const ExportOptions &exportOptions) const;
 
   //===--------------------------------------------------------------------===//
   // Vertex access.
   //===--------------------------------------------------------------------===//
 
+  // The options of these queries determine how names are matched, and which
+  // vertices are start, end and mid points.
+
   /// Return a list of vertices matching a VertexGraphType.
-  VertexIDVec getVerticesByType(VertexNetlistType graphType) const;
+  VertexIDVec getVerticesByType(VertexNetlistType graphType,
+                                const QueryOptions &options) const {
+    return vertexClasses.getVertices(graphType, options);
+  }
 
   /// Lookup a vertex by matching its name exactly.
   VertexID getVertexExact(const std::string &name,
-                          VertexNetlistType graphType=VertexNetlistType::ANY) const;
+                          VertexNetlistType graphType,
+                          const QueryOptions &options) const;
 
   /// Return a list of vertices matching a regex pattern.
   VertexIDVec getVerticesRegex(const std::string &pattern,
-                               VertexNetlistType graphType=VertexNetlistType::ANY) const;
+                               VertexNetlistType graphType,
+                               const QueryOptions &options) const;
 
   /// Return a list of vertices matching a wildcard pattern.
   VertexIDVec getVerticesWildcard(const std::string &pattern,
-                                  VertexNetlistType graphType=VertexNetlistType::ANY) const;
+                                  VertexNetlistType graphType,
+                                  const QueryOptions &options) const;
 
   /// Return a list of vertices that match the pattern.
   VertexIDVec getVertices(const std::string &pattern,
-                          VertexNetlistType graphType=VertexNetlistType::ANY) const;
+                          VertexNetlistType graphType,
+                          const QueryOptions &options) const;
+
+  /// Return a list of vertices for each of a set of patterns, with a single
+  /// scan of the vertex names for all the wildcard or regex patterns.
+  ///
+  /// \param patterns A vector of pairs of a pattern and the type of vertex it
+  ///                 should match.
+  /// \param options  The options of the query.
+  ///
+  /// \returns A vector of the vertices matching each pattern, as
+  ///          getVertices() would return them.
+  std::vector<VertexIDVec>
+  getVertices(const std::vector<std::pair<std::string, VertexNetlistType>> &patterns,
+              const QueryOptions &options) const;
+
+  /// Return a list of vertices that match the pattern, sorted by name as
+  /// Vertex::compareLessThan() does.
+  VertexIDVec getVerticesSortedByName(const std::string &pattern,
+                                      VertexNetlistType graphType,
+                                      const QueryOptions &options) const;
 
   /// Specialisation of getVertices for startpoints.
-  VertexIDVec getStartVertices(const std::string &name) const {
-    return getVertices(name, VertexNetlistType::START_POINT);
+  VertexIDVec getStartVertices(const std::string &name,
+                               const QueryOptions &options) const {
+    return getVertices(name, VertexNetlistType::START_POINT, options);
   }
 
   /// Specialisation of getVertices for endpoints.
-  VertexIDVec getEndVertices(const std::string &name) const {
-    return getVertices(name, VertexNetlistType::END_POINT);
+  VertexIDVec getEndVertices(const std::string &name,
+                             const QueryOptions &options) const {
+    return getVertices(name, VertexNetlistType::END_POINT, options);
   }
 
   /// Specialisation of getVertices for midpoints.
-  VertexIDVec getMidVertices(const std::string &name) const {
-    return getVertices(name, VertexNetlistType::MID_POINT);
+  VertexIDVec getMidVertices(const std::string &name,
+                             const QueryOptions &options) const {
+    return getVertices(name, VertexNetlistType::MID_POINT, options);
   }
 
   /// Specialisation of getVertices for registers.
-  VertexIDVec getRegVertices(const std::string &name) const {
-    return getVertices(name, VertexNetlistType::REG);
+  VertexIDVec getRegVertices(const std::string &name,
+                             const QueryOptions &options) const {
+    return getVertices(name, VertexNetlistType::REG, options);
   }
 
   /// Specialisation of getVertices for register aliases.
-  VertexIDVec getRegAliasVertices(const std::string &name) const {
-    return getVertices(name, VertexNetlistType::DST_REG_ALIAS);
+  VertexIDVec getRegAliasVertices(const std::string &name,
+                                  const QueryOptions &options) const {
+    return getVertices(name, VertexNetlistType::DST_REG_ALIAS, options);
   }
 
   //===--------------------------------------------------------------------===//
   // Path access.
   //===--------------------------------------------------------------------===//
 
+  // The options of these queries determine whether paths traverse registers,
+  // which vertices are start and end points, and how searches are performed.
+
   /// Return a list of paths from a start vertex.
-  std::vector<VertexIDVec> getAllFanOut(VertexID startVertex) const;
+  std::vector<VertexIDVec> getAllFanOut(VertexID startVertex,
+                                        const QueryOptions &options) const;
 
   /// Return a list of paths to an end vertex.
-  std::vector<VertexIDVec> getAllFanIn(VertexID endVertex) const;
-
-  /// Count the fanout from a start vertex.
-  size_t getfanOutDegree(VertexID startVertex);
-
-  /// Count the fanin to an end vertex.
-  size_t getFanInDegree(VertexID endVertex);
+  std::vector<VertexIDVec> getAllFanIn(VertexID endVertex,
+                                       const QueryOptions &options) const;
+
+  /// Return the end points with a path from a start vertex, as the last
+  /// vertices of the paths of getAllFanOut(), using the reachability index if
+  /// it has been built.
+  VertexIDVec getFanOutEndPoints(VertexID startVertex,
+                                 const QueryOptions &options) const;
+
+  /// Return the start points with a path to an end vertex, as the last
+  /// vertices of the paths of getAllFanIn(), using the reachability index if
+  /// it has been built.
+  VertexIDVec getFanInStartPoints(VertexID endVertex,
+                                  const QueryOptions &options) const;
+
+  /// Return the connectivity of all the combinational start points
+  /// (Vertex::isCombStartPoint()) to all the combinational end points
+  /// (Vertex::isCombEndPoint()) by paths that do not traverse registers,
+  /// using the reachability index if it has been built. Only the number of
+  /// threads is taken from the options.
+  ConnectivityMatrix getCombConnectivity(const QueryOptions &options) const;
+
+  /// Return the combinational loops of the graph, which are the
+  /// strongly-connected components that contain a cycle without traversing
+  /// registers.
+  ///
+  /// \returns The vertices of each loop in ascending order, with the loops
+  ///          in topological order.
+  std::vector<VertexIDVec> getCombLoops() const;
+
+  /// Count the end points, paths and end point bits of the fan out from a
+  /// start vertex, using the reachability index if it has been built, or
+  /// otherwise a temporary one.
+  FanDegree getFanOutDegree(VertexID startVertex,
+                            const QueryOptions &options) const;
+
+  /// Count the start points, paths and start point bits of the fan in to an
+  /// end vertex, using the reachability index if it has been built, or
+  /// otherwise a temporary one.
+  FanDegree getFanInDegree(VertexID endVertex,
+                           const QueryOptions &options) const;
+
+  /// Count the fan out of every start point, in the order of
+  /// getVerticesByType().
+  FanDegreeColumns getFanOutDegrees(const QueryOptions &options) const;
+
+  /// Count the fan in of every end point, in the order of
+  /// getVerticesByType().
+  FanDegreeColumns getFanInDegrees(const QueryOptions &options) const;
 
   /// Return any path between the specified waypoints, avoiding the specified
   /// mid points.
   VertexIDVec getAnyPointToPoint(const VertexIDVec &waypointIDs,
-                                 const VertexIDVec &avoidPointIDs) const;
+                                 const VertexIDVec &avoidPointIDs,
+                                 const QueryOptions &options) const;
+
+  /// Return true if a path exists between the specified waypoints, avoiding
+  /// the specified mid points. Without avoid points, this is answered by the
+  /// reachability index if it has been built, and otherwise each search stops
+  /// as soon as the next waypoint is reached.
+  bool pathExists(const VertexIDVec &waypointIDs,
+                  const VertexIDVec &avoidPointIDs,
+                  const QueryOptions &options) const;
 
   /// Return all paths between the specified waypoints, avoiding the specified
   /// mid points.
   std::vector<VertexIDVec> getAllPointToPoint(const VertexIDVec &waypoints,
-                                              const VertexIDVec &avoidPointIDs) const;
+                                              const VertexIDVec &avoidPointIDs,
+                                              const QueryOptions &options) const;
+
+  /// Return an enumeration of the paths of getAllPointToPoint(), which
+  /// produces them one at a time until the limits are reached.
+  PathEnumerator enumeratePointToPoint(const VertexIDVec &waypoints,
+                                       const VertexIDVec &avoidPointIDs,
+                                       const QueryOptions &options,
+                                       const PathLimits &limits) const;
+
+  /// Return the deepest paths between the specified waypoints, avoiding the
+  /// specified mid points, with a DeepestPaths search.
+  ///
+  /// \param waypointIDs   The waypoints of the paths, in order.
+  /// \param avoidPointIDs The vertices the paths cannot pass through, sorted
+  ///                      by ID.
+  /// \param numPaths      The maximum number of paths to return.
+  /// \param weights       The weights of the vertices of the paths.
+  /// \param options       The options of the query.
+  ///
+  /// \returns The paths, deepest first.
+  std::vector<VertexIDVec> getDeepestPointToPoint(const VertexIDVec &waypointIDs,
+                                                  const VertexIDVec &avoidPointIDs,
+                                                  size_t numPaths,
+                                                  const PathWeights &weights,
+                                                  const QueryOptions &options) const;
+
+  /// Return the deepest paths from a start vertex to any end point, deepest
+  /// first.
+  std::vector<VertexIDVec> getDeepestFanOut(VertexID startVertex,
+                                            size_t numPaths,
+                                            const PathWeights &weights,
+                                            const QueryOptions &options) const;
+
+  /// Return the deepest paths from any start point to an end vertex, deepest
+  /// first.
+  std::vector<VertexIDVec> getDeepestFanIn(VertexID endVertex,
+                                           size_t numPaths,
+                                           const PathWeights &weights,
+                                           const QueryOptions &options) const;
 
   //===--------------------------------------------------------------------===//
   // Miscellaneous getters and setters.
@@ -236,6 +538,14 @@ public:
     return const_cast<Vertex*>(&(graph[vertexId]));
   }
 
+  /// Return the statistics of loading the graph and of its queries, which
+  /// the const queries record into.
+  Stats &getStats() const { return stats; }
+
+  /// Return the cache of the DFS trees of the fan out, fan in and any path
+  /// queries, which the const queries add to.
+  TraversalCache &getTraversalCache() const { return traversalCache; }
+
   VertexID nullVertex() const { return boost::graph_traits<InternalGraph>::null_vertex(); }
   std::size_t numVertices() const { return boost::num_vertices(graph); }
   std::size_t numEdges() const { return boost::num_edges(graph); }
@@ -0,0 +1,84 @@
+#ifndef NETLIST_PATHS_GRAPH_WRITER_HPP
+#define NETLIST_PATHS_GRAPH_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "netlist_paths/Options.hpp"
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+/// A writer of a graph to a stream in one of the export formats. Each vertex
+/// and edge is formatted into a fixed-size buffer that is written to the
+/// stream whenever it fills, so the output is never held in memory. All the
+/// vertices must be written before any of the edges, and the edges may only
+/// refer to vertices that have been written.
+class GraphWriter {
+  std::ostream &os;
+  ExportFormat format;
+  std::vector<char> buffer;
+  size_t size;
+  size_t numVertices;
+  size_t numEdges;
+  bool writingEdges;
+  bool finished;
+
+  void flush() {
+    os.write(buffer.data(), size);
+    size = 0;
+  }
+
+  void write(char c) {
+    if (size == buffer.size()) {
+      flush();
+    }
+    buffer[size++] = c;
+  }
+
+  void write(std::string_view value) {
+    for (auto c : value) {
+      write(c);
+    }
+  }
+
+  void write(uint64_t value);
+
+  void writeEscaped(std::string_view value);
+
+  void beginEdges();
+
+public:
+  /// Create a writer and write the header of the format.
+  ///
+  /// \param os     The stream to write to.
+  /// \param format The format to write.
+  GraphWriter(std::ostream &os, ExportFormat format);
+
+  GraphWriter(const GraphWriter&) = delete;
+  GraphWriter &operator=(const GraphWriter&) = delete;
+
+  ~GraphWriter() { finish(); }
+
+  /// Write a vertex, labelled with its name and type.
+  void writeVertex(uint64_t id, const Vertex &vertex);
+
+  /// Write an edge between two vertices that have been written.
+  void writeEdge(uint64_t source, uint64_t target);
+
+  /// Write the end of the format and flush the buffer to the stream. Nothing
+  /// can be written afterwards.
+  void finish();
+
+  /// Return the number of vertices written.
+  size_t getNumVertices() const { return numVertices; }
+
+  /// Return the number of edges written.
+  size_t getNumEdges() const { return numEdges; }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_GRAPH_WRITER_HPP
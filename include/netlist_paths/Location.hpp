@@ -1,8 +1,12 @@
 #ifndef NETLIST_PATHS_LOCATION_HPP
 #define NETLIST_PATHS_LOCATION_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <string>
-#include <memory>
+#include <utility>
 #include <boost/format.hpp>
 
 /// A class representing a source file.
@@ -24,40 +28,101 @@ public:
   const std::string &getLanguage() const { return language; }
 };
 
+/// A table of the source files referenced by the locations of a netlist,
+/// which is owned by its graph, so a location can refer to its file by a
+/// compact index. Each distinct file is held once.
+class FileTable {
+  std::deque<File> files;
+  std::map<std::pair<std::string, std::string>, uint32_t> indexes;
+
+public:
+  /// The index of no file.
+  static constexpr uint32_t NO_FILE = UINT32_MAX;
+
+  FileTable() {}
+  FileTable(const FileTable&) = delete;
+  FileTable &operator=(const FileTable&) = delete;
+
+  /// Return the index of a file, adding it to the table if it is not already
+  /// present.
+  ///
+  /// \param file The file to add.
+  ///
+  /// \returns The index of the file.
+  uint32_t add(const File &file) {
+    auto key = std::make_pair(file.getFilename(), file.getLanguage());
+    auto it = indexes.find(key);
+    if (it != indexes.end()) {
+      return it->second;
+    }
+    auto index = static_cast<uint32_t>(files.size());
+    files.push_back(file);
+    indexes.emplace(std::move(key), index);
+    return index;
+  }
+
+  /// Return the file with an index.
+  const File &getFile(uint32_t index) const { return files[index]; }
+};
+
 /// A class representing a file location.
+///
+/// The file is held as an index into the FileTable of the netlist and the
+/// columns are saturated to 16 bits, so a location occupies 16 bytes. The
+/// file is resolved through the table the index is from.
 class Location {
-  std::shared_ptr<File> file;
-  unsigned startLine;
-  unsigned startCol;
-  unsigned endLine;
-  unsigned endCol;
+  uint32_t fileIndex;
+  uint32_t startLine;
+  uint32_t endLine;
+  uint16_t startCol;
+  uint16_t endCol;
+
+  static uint16_t packColumn(unsigned column) {
+    return static_cast<uint16_t>(std::min<unsigned>(column, UINT16_MAX));
+  }
 
 public:
 
   /// Default construct a file location object.
-  Location() : file(nullptr) {}
+  Location() :
+      fileIndex(FileTable::NO_FILE), startLine(0), endLine(0),
+      startCol(0), endCol(0) {}
 
   /// Construct a file location object, identifying a source-level entity.
   ///
-  /// \param file      A shared pointer to the file which this location is in.
+  /// \param fileIndex The FileTable index of the file which this location is
+  ///                  in, or FileTable::NO_FILE.
   /// \param startLine The line number of the start of the entity.
   /// \param startCol  The column number of the start of the entity.
   /// \param endLine   The line number of the end of the entity.
   /// \param endCol    The column number of the end of the entity.
-  Location(std::shared_ptr<File> file,
+  Location(uint32_t fileIndex,
            unsigned startLine,
            unsigned startCol,
            unsigned endLine,
            unsigned endCol) :
-      file(file),
+      fileIndex(fileIndex),
       startLine(startLine),
-      startCol(startCol),
       endLine(endLine),
-      endCol(endCol) {}
+      startCol(packColumn(startCol)),
+      endCol(packColumn(endCol)) {}
+
+  /// Return the file, or nullptr if the location has no file.
+  const File *getFile(const FileTable &files) const {
+    if (fileIndex == FileTable::NO_FILE) {
+      return nullptr;
+    }
+    return &files.getFile(fileIndex);
+  }
+  uint32_t getFileIndex() const { return fileIndex; }
+  unsigned getStartLine() const { return startLine; }
+  unsigned getStartCol() const { return startCol; }
+  unsigned getEndLine() const { return endLine; }
+  unsigned getEndCol() const { return endCol; }
 
   /// Return the filename.
-  const std::string getFilename() const {
-    if (file) {
+  const std::string getFilename(const FileTable &files) const {
+    if (auto file = getFile(files)) {
       return file->getFilename();
     } else {
       return "unknown";
@@ -66,7 +131,7 @@ public:
 
   /// Equality comparison
   friend bool operator== (const Location &a, const Location &b) {
-    return a.file == b.file &&
+    return a.fileIndex == b.fileIndex &&
            a.startLine == b.startLine &&
            a.startCol == b.startCol &&
            a.endLine == b.endLine &&
@@ -74,15 +139,15 @@ public:
   }
 
   /// Return a string representing the exact location (using all location details).
-  std::string getLocationStrExact() const {
+  std::string getLocationStrExact(const FileTable &files) const {
     auto s = boost::format("%s %d:%d,%d:%d")
-               % getFilename() % startLine % startCol % endLine % endCol;
+               % getFilename(files) % startLine % startCol % endLine % endCol;
     return s.str();
   }
 
   /// Return a string representing a brief location (only filename and start line).
-  std::string getLocationStr() const {
-    auto s = boost::format("%s:%d") % getFilename() % startLine;
+  std::string getLocationStr(const FileTable &files) const {
+    auto s = boost::format("%s:%d") % getFilename(files) % startLine;
     return s.str();
   }
 };
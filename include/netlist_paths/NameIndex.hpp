@@ -0,0 +1,87 @@
+#ifndef NETLIST_PATHS_NAME_INDEX_HPP
+#define NETLIST_PATHS_NAME_INDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+/// An index of the vertices of a netlist graph by name.
+///
+/// The index provides a hash map from each name to the vertices with that
+/// name for exact lookups, and a table of all the vertices sorted by name.
+/// Since hierarchical names share their prefixes, the sorted table acts as a
+/// flattened trie: all the vertices below a point in the hierarchy, or
+/// sharing any other prefix, occupy a contiguous range of the table that can
+/// be found with a binary search.
+///
+/// The index holds views of the vertex names, so it must be rebuilt if the
+/// graph is modified.
+class NameIndex {
+public:
+  using VertexIDVec = std::vector<size_t>;
+  using Range = std::pair<size_t, size_t>;
+
+private:
+  std::unordered_map<std::string_view, VertexIDVec> exactNames;
+  VertexIDVec sortedVertices;
+  std::vector<std::string_view> sortedNames;
+  VertexIDVec noVertices;
+
+public:
+  NameIndex() {}
+
+  /// Build the index.
+  ///
+  /// \param vertices Pointers to all the vertices of a graph, indexed by
+  ///                 vertex ID.
+  void build(const std::vector<const Vertex*> &vertices);
+
+  /// Remove all entries from the index.
+  void clear();
+
+  /// Return the vertices with a name, in ascending order of vertex ID.
+  ///
+  /// \param name The name to lookup.
+  ///
+  /// \returns A reference to a vector of vertex IDs, which is empty if no
+  ///          vertex has the name.
+  const VertexIDVec &lookup(const std::string &name) const;
+
+  /// Return the range of the sorted table whose names start with a prefix.
+  ///
+  /// \param prefix The prefix to match, where an empty prefix matches the
+  ///               whole table.
+  ///
+  /// \returns A pair of the first and one-past-the-last table indexes.
+  Range getPrefixRange(const std::string &prefix) const;
+
+  /// Return all the vertices, sorted by name, then by type, direction and
+  /// deleted flag as Vertex::compareLessThan() does.
+  const VertexIDVec &getSortedVertices() const { return sortedVertices; }
+
+  /// Return the vertex at a position in the sorted table.
+  size_t getSortedVertex(size_t index) const { return sortedVertices[index]; }
+
+  /// Return the name at a position in the sorted table.
+  std::string_view getSortedName(size_t index) const { return sortedNames[index]; }
+
+  /// Return the number of entries in the sorted table.
+  size_t size() const { return sortedVertices.size(); }
+
+  /// Return the literal prefix that all names matching a wildcard pattern
+  /// must start with.
+  static std::string getWildcardPrefix(const std::string &pattern);
+
+  /// Return the literal prefix that all names matching a regular expression
+  /// must start with, which is only non-empty for patterns anchored with '^'.
+  static std::string getRegexPrefix(const std::string &pattern);
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_NAME_INDEX_HPP
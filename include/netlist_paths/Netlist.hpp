@@ -5,20 +5,32 @@
 #include <iostream>
 #include <ostream>
 #include <sstream>
+#include <unordered_map>
 #include <boost/format.hpp>
+#include "netlist_paths/DeepestPaths.hpp"
 #include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Graph.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/PathEnumerator.hpp"
+#include "netlist_paths/QueryResults.hpp"
 #include "netlist_paths/Waypoints.hpp"
 
 namespace netlist_paths {
 
 /// Wrapper for Python to manage the netlist object.
+///
+/// Each query takes the QueryOptions it should use, which default to the
+/// settings of the global Options object. Once a netlist has been loaded, its
+/// const query methods can be called concurrently from any number of threads,
+/// each with its own options.
 class Netlist {
   Graph graph;
   std::vector<File> files;
   std::vector<std::shared_ptr<DType>> dtypes;
+  // The indexes in the DTypeTable of the graph of the named dtypes, by name.
+  std::unordered_map<std::string, uint32_t> dtypeNames;
   std::vector<VertexID> waypoints;
+  size_t parserPeakMemory;
 
   //===--------------------------------------------------------------------===//
   // Utility functions.
@@ -26,10 +38,14 @@ class Netlist {
 
   std::vector<VertexID> getNamedVertexIds(const std::string &regex="") const;
 
-  std::vector<Vertex*> createVertexPtrVec(VertexIDVec vertices) const;
+  std::vector<Vertex*> createVertexPtrVec(const VertexIDVec &vertices) const;
 
   std::vector<std::vector<Vertex*> >
-  createVertexPtrVecVec(std::vector<VertexIDVec> paths) const;
+  createVertexPtrVecVec(const std::vector<VertexIDVec> &paths) const;
+
+  /// Return the vertex of an ID from outside the netlist, reporting an error
+  /// if it is not valid.
+  VertexID checkVertexID(PathArray::ID vertexID) const;
 
   //===--------------------------------------------------------------------===//
   // Vertex lookup, with error reporting.
@@ -39,46 +55,141 @@ class Netlist {
                                           const std::string name,
                                           const std::string patternType="") const;
 
+  /// Select a single vertex from a set of matches, reporting an error if
+  /// there are multiple matches and matchAny is false.
+  VertexID selectVertex(const VertexIDVec &vertices,
+                        const std::string &name,
+                        bool matchAny,
+                        const std::string &patternType) const;
+
   /// Lookup a single vertex and report an error if there are multiple matches.
   VertexID getVertex(const std::string &name,
-                     VertexNetlistType vertexType=VertexNetlistType::ANY) const;
+                     VertexNetlistType vertexType,
+                     const QueryOptions &options) const;
 
   /// Lookup a single vertex of type register.
-  VertexID getRegVertex(const std::string &name, bool matchAny) const;
+  VertexID getRegVertex(const std::string &name, bool matchAny,
+                        const QueryOptions &options) const;
 
   /// Lookup a single vertex of type register alias.
-  VertexID getRegAliasVertex(const std::string &name, bool matchAny) const;
+  VertexID getRegAliasVertex(const std::string &name, bool matchAny,
+                             const QueryOptions &options) const;
 
   /// Lookup a single vertex that is a startpoint.
-  VertexID getStartVertex(const std::string &name, bool matchAny) const;
+  VertexID getStartVertex(const std::string &name, bool matchAny,
+                          const QueryOptions &options) const;
 
   /// Lookup a single vertex that is an end point.
-  VertexID getEndVertex(const std::string &name, bool matchAny) const;
+  VertexID getEndVertex(const std::string &name, bool matchAny,
+                        const QueryOptions &options) const;
 
   /// Lookup a single vertex that is a mid point.
-  VertexID getMidVertex(const std::string &name, bool matchAny) const;
+  VertexID getMidVertex(const std::string &name, bool matchAny,
+                        const QueryOptions &options) const;
 
-  /// Lookup a DType by name.
-  const std::shared_ptr<DType> getDType(const std::string &name) const;
+  /// Index the dtypes by name, once the netlist is loaded.
+  void indexDTypes();
+
+  /// Lookup the index of a DType in the DTypeTable of the graph by name.
+  ///
+  /// \returns The index, or DTypeTable::NO_DTYPE if there is no DType with
+  ///          the name.
+  uint32_t getDType(const std::string &name) const;
 
   //===--------------------------------------------------------------------===//
   // Waypoints.
   //===--------------------------------------------------------------------===//
 
-  /// Read a set of path waypoints to constrain a path query.
-  VertexIDVec readWaypoints(Waypoints waypoints) const;
+  /// Read a set of path waypoints and avoid points to constrain a path query,
+  /// resolving all of their patterns together.
+  ///
+  /// \param waypoints     The waypoints of the query.
+  /// \param waypointIDs   The vertices of the waypoints, in order.
+  /// \param avoidPointIDs The vertices of the avoid points, sorted by ID.
+  /// \param options       The options of the query.
+  void readWaypoints(const Waypoints &waypoints,
+                     VertexIDVec &waypointIDs,
+                     VertexIDVec &avoidPointIDs,
+                     const QueryOptions &options) const;
+
+  /// Read the waypoints and avoid points of a batch of path queries,
+  /// resolving the distinct patterns of all of them together.
+  void readWaypoints(const std::vector<Waypoints> &waypoints,
+                     std::vector<VertexIDVec> &waypointIDs,
+                     std::vector<VertexIDVec> &avoidPointIDs,
+                     const QueryOptions &options) const;
+
+  //===--------------------------------------------------------------------===//
+  // Path querying, returning vertex IDs.
+  //===--------------------------------------------------------------------===//
+
+  VertexIDVec findAnyPath(const Waypoints &waypoints,
+                          const QueryOptions &options) const;
+
+  std::vector<VertexIDVec> findAllPaths(const Waypoints &waypoints,
+                                        const QueryOptions &options) const;
 
-  /// Read a set of avoid points to constrain a path query.
-  VertexIDVec readAvoidPoints(Waypoints waypoints) const;
+  std::vector<VertexIDVec> findAllFanOut(const std::string &startName,
+                                         const QueryOptions &options) const;
+
+  std::vector<VertexIDVec> findAllFanIn(const std::string &endName,
+                                        const QueryOptions &options) const;
 
 public:
   Netlist() = delete;
 
-  /// Construct a new netlist from an XML file.
+  /// Construct a new netlist from an XML file or a binary snapshot.
   ///
-  /// \param filename A path to the XML netlist file.
+  /// \param filename A path to the XML netlist or snapshot file.
   Netlist(const std::string &filename);
 
+  /// Write a binary snapshot of the netlist, which can be loaded in place of
+  /// the XML file to avoid parsing and post processing it again.
+  ///
+  /// \param filename A path to the snapshot file to write.
+  void writeSnapshot(const std::string &filename) const;
+
+  /// Return the peak memory used by the XML parser while reading the netlist,
+  /// to compare the streaming and document tree readers.
+  ///
+  /// \returns A number of bytes, or zero if the netlist was read from a
+  ///          snapshot.
+  size_t getParserPeakMemory() const { return parserPeakMemory; }
+
+  /// Return the statistics of loading the netlist and of the queries made on
+  /// it, which are only recorded if the library is built with the
+  /// NETLIST_PATHS_STATS option.
+  const Stats &getStats() const { return graph.getStats(); }
+
+  /// Reset the statistics of the netlist to zero.
+  void clearStats() const { graph.getStats().clear(); }
+
+  /// Build the reachability indexes, if they were not built when the netlist
+  /// was loaded or read from its snapshot. The indexes are included in any
+  /// snapshot written afterwards.
+  void buildReachabilityIndex() { graph.buildReachabilityIndexes(); }
+
+  /// Return true if the reachability indexes have been built.
+  bool hasReachabilityIndex() const { return graph.hasReachabilityIndexes(); }
+
+  /// Set the number of bytes of the cache of the DFS trees of queries, or
+  /// zero to disable it, which is the default. With the cache, the fan out
+  /// and fan in of a vertex and any path from it are found from its cached
+  /// tree, so the graph is only searched from each start or finish point
+  /// once, for queries without avoid points. The least recently used trees
+  /// are discarded to keep within the limit.
+  void setTraversalCacheMaxBytes(size_t value) const {
+    graph.getTraversalCache().setMaxBytes(value);
+  }
+
+  /// Return the number of bytes the traversal cache is limited to.
+  size_t getTraversalCacheMaxBytes() const {
+    return graph.getTraversalCache().getMaxBytes();
+  }
+
+  /// Empty the traversal cache.
+  void clearTraversalCache() const { graph.getTraversalCache().clear(); }
+
   //===--------------------------------------------------------------------===//
   // Reporting of names and types.
   //===--------------------------------------------------------------------===//
@@ -87,19 +198,23 @@ public:
   ///
   /// \param name       A pattern specifying a name to match.
   /// \param vertexType The type of the vertex to lookup.
+  /// \param options    The options of the query.
   ///
   /// \returns A string representing the data type.
   const std::string getVertexDTypeStr(const std::string &name,
-                                      VertexNetlistType vertexType=VertexNetlistType::ANY) const;
+                                      VertexNetlistType vertexType=VertexNetlistType::ANY,
+                                      const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Lookup the data type width of a single vertex.
   ///
   /// \param name       A pattern specifying a name to match.
   /// \param vertexType The type of the vertex to lookup.
+  /// \param options    The options of the query.
   ///
   /// \returns The width of the data type.
   size_t getVertexDTypeWidth(const std::string &name,
-                             VertexNetlistType vertexType=VertexNetlistType::ANY) const;
+                             VertexNetlistType vertexType=VertexNetlistType::ANY,
+                             const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Lookup the width of a data type by name.
   ///
@@ -114,80 +229,352 @@ public:
 
   /// Return true if a single startpoint matching a pattern exists.
   ///
-  /// \param name A pattern specifying a name to match.
+  /// \param name    A pattern specifying a name to match.
+  /// \param options The options of the query.
   ///
   /// \returns True if the startpoint exists.
-  bool startpointExists(const std::string &name) const;
+  bool startpointExists(const std::string &name,
+                        const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return true if a single endpoint matching a pattern 'name' exists.
   ///
-  /// \param name A pattern specifying a name to match.
+  /// \param name    A pattern specifying a name to match.
+  /// \param options The options of the query.
   ///
   /// \returns True if the endpoint exists.
-  bool endpointExists(const std::string &name) const;
+  bool endpointExists(const std::string &name,
+                      const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return true if any startpoint matching a pattern 'name' exists.
   ///
-  /// \param name A pattern specifying a name to match.
+  /// \param name    A pattern specifying a name to match.
+  /// \param options The options of the query.
   ///
   /// \returns True if any startpoint exists.
-  bool anyStartpointExists(const std::string &name) const;
+  bool anyStartpointExists(const std::string &name,
+                           const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return true if any endpoint matching a pattern 'name' exists.
   ///
-  /// \param name A pattern specifying a name to match.
+  /// \param name    A pattern specifying a name to match.
+  /// \param options The options of the query.
   ///
   /// \returns True if any endpoint exists.
-  bool anyEndpointExists(const std::string &name) const;
+  bool anyEndpointExists(const std::string &name,
+                         const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return true if a single register matching a pattern 'name' exists.
   ///
-  /// \param name A pattern specifying a name to match.
+  /// \param name    A pattern specifying a name to match.
+  /// \param options The options of the query.
   ///
   /// \returns True if the register exists.
-  bool regExists(const std::string &name) const;
+  bool regExists(const std::string &name,
+                 const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return true if any register matching a pattern 'name' exists.
   ///
-  /// \param name A pattern specifying a name to match.
+  /// \param name    A pattern specifying a name to match.
+  /// \param options The options of the query.
   ///
   /// \returns True if any register exists.
-  bool anyRegExists(const std::string &name) const;
+  bool anyRegExists(const std::string &name,
+                    const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return a Boolean to indicate whether any path exists between two points.
   ///
   /// \param waypoints A waypoints object constraining the path.
+  /// \param options   The options of the query.
   ///
   /// \returns True if a path exists.
-  bool pathExists(Waypoints waypoints) const;
+  bool pathExists(Waypoints waypoints,
+                  const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return any path between two points.
   ///
   /// \param waypoints A waypoints object constraining the path.
+  /// \param options   The options of the query.
   ///
   /// \returns A path if one exists, otherwise an empty vector.
-  std::vector<Vertex*> getAnyPath(Waypoints waypoints) const;
+  std::vector<Vertex*> getAnyPath(Waypoints waypoints,
+                                  const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return all paths between two points, useful for testing.
   ///
   /// \param waypoints A waypoints object constraining the path.
+  /// \param options   The options of the query.
   ///
   /// \returns All paths matching the waypoints, otherwise an empty vector.
-  std::vector<std::vector<Vertex*> > getAllPaths(Waypoints waypoints) const;
+  std::vector<std::vector<Vertex*> > getAllPaths(Waypoints waypoints,
+                                                 const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return an enumeration of all paths between two points, which produces
+  /// the paths of getAllPaths() one at a time, in the same order, so they are
+  /// not all held at once. The enumeration holds references to the netlist,
+  /// so it must not outlive it.
+  ///
+  /// \param waypoints A waypoints object constraining the path.
+  /// \param limits    The limits of the enumeration.
+  /// \param options   The options of the query.
+  ///
+  /// \returns An enumeration of the vertex IDs of the paths, which can be
+  ///          looked up with getVertexPtr().
+  PathEnumerator enumerateAllPaths(Waypoints waypoints,
+                                   const PathLimits &limits=PathLimits(),
+                                   const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the deepest paths between two points, by the sum of the weights
+  /// of their vertices, which are found without enumerating all the paths.
+  ///
+  /// \param waypoints A waypoints object constraining the paths.
+  /// \param numPaths  The maximum number of paths to return.
+  /// \param weights   The weight of each type of vertex.
+  /// \param options   The options of the query.
+  ///
+  /// \returns The deepest paths matching the waypoints, deepest first,
+  ///          otherwise an empty vector.
+  std::vector<std::vector<Vertex*> > getDeepestPaths(Waypoints waypoints,
+                                                     size_t numPaths,
+                                                     const PathWeights &weights=PathWeights(),
+                                                     const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the deepest paths fanning out from a particular start point to
+  /// any end point, as getDeepestPaths() does.
+  ///
+  /// \param startName A pattern matching a start point.
+  /// \param numPaths  The maximum number of paths to return.
+  /// \param weights   The weight of each type of vertex.
+  /// \param options   The options of the query.
+  ///
+  /// \returns The deepest paths, deepest first.
+  std::vector<std::vector<Vertex*> > getDeepestFanOut(const std::string startName,
+                                                      size_t numPaths,
+                                                      const PathWeights &weights=PathWeights(),
+                                                      const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the deepest paths fanning in to a particular end point from any
+  /// start point, as getDeepestPaths() does.
+  ///
+  /// \param endName  A pattern matching an end point.
+  /// \param numPaths The maximum number of paths to return.
+  /// \param weights  The weight of each type of vertex.
+  /// \param options  The options of the query.
+  ///
+  /// \returns The deepest paths, deepest first.
+  std::vector<std::vector<Vertex*> > getDeepestFanIn(const std::string endName,
+                                                     size_t numPaths,
+                                                     const PathWeights &weights=PathWeights(),
+                                                     const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return a vector of paths fanning out from a particular start point.
   ///
   /// \param startName A pattern matching a start point.
+  /// \param options   The options of the query.
   ///
   /// \returns All paths fanning out from the matching startpoint, otherwise an empty vector.
-  std::vector<std::vector<Vertex*> > getAllFanOut(const std::string startName) const;
+  std::vector<std::vector<Vertex*> > getAllFanOut(const std::string startName,
+                                                  const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return a vector of paths fanning out from a particular start point.
   ///
   /// \param endName A pattern matching an end point.
+  /// \param options The options of the query.
   ///
   /// \returns All paths fanning in to the matching endpoint, otherwise an empty vector.
-  std::vector<std::vector<Vertex*> > getAllFanIn(const std::string endName) const;
+  std::vector<std::vector<Vertex*> > getAllFanIn(const std::string endName,
+                                                 const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the end points of the paths fanning out from a particular start
+  /// point, which are found without constructing the paths.
+  ///
+  /// \param startName A pattern matching a start point.
+  /// \param options   The options of the query.
+  ///
+  /// \returns The end points, in the order of the paths of getAllFanOut().
+  std::vector<Vertex*> getFanOutEndPoints(const std::string startName,
+                                          const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the start points of the paths fanning in to a particular end
+  /// point, which are found without constructing the paths.
+  ///
+  /// \param endName A pattern matching an end point.
+  /// \param options The options of the query.
+  ///
+  /// \returns The start points, in the order of the paths of getAllFanIn().
+  std::vector<Vertex*> getFanInStartPoints(const std::string endName,
+                                           const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Count the end points, paths and end point bits of the fan out from a
+  /// particular start point, which are counted without enumerating the paths.
+  /// See FanDegree for how paths through cycles are counted.
+  ///
+  /// \param startName A pattern matching a start point.
+  /// \param options   The options of the query.
+  ///
+  /// \returns The degree of the fan out.
+  FanDegree getFanOutDegree(const std::string startName,
+                            const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Count the start points, paths and start point bits of the fan in to a
+  /// particular end point, which are counted without enumerating the paths.
+  ///
+  /// \param endName A pattern matching an end point.
+  /// \param options The options of the query.
+  ///
+  /// \returns The degree of the fan in.
+  FanDegree getFanInDegree(const std::string endName,
+                           const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return every pair of a combinational start point (a source register,
+  /// source register alias or top-level input) and a combinational end point
+  /// (a destination register, destination register alias or top-level output)
+  /// that are connected by a path not traversing registers. The pairs are
+  /// computed in bulk for all start points, which is much faster than a fan
+  /// out query from each one.
+  ///
+  /// \param options The options of the query, of which only the number of
+  ///                threads is used.
+  ///
+  /// \returns A vector of pairs of start and end points, ordered by start
+  ///          point then end point.
+  std::vector<std::vector<Vertex*> >
+  getCombConnectivity(const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return every combinational loop, which is a set of vertices that each
+  /// have a path to all the others, or a vertex with an edge to itself, that
+  /// does not traverse registers. The loops are found from the condensation
+  /// of the netlist into strongly-connected components that is made when it
+  /// is loaded, without searching for paths.
+  ///
+  /// \returns A vector of the named vertices of each loop, sorted by name,
+  ///          with the loops in topological order.
+  std::vector<std::vector<Vertex*> > getCombLoops() const;
+
+  //===--------------------------------------------------------------------===//
+  // Batch path querying.
+  //===--------------------------------------------------------------------===//
+
+  // The batch queries resolve the patterns of all their queries in one pass,
+  // then spread the searches over a pool of QueryOptions::getNumThreads()
+  // threads.
+  // The results are in the order of the queries.
+
+  /// Return whether a path exists for each of a batch of waypoints, as
+  /// pathExists() would.
+  ///
+  /// \param waypoints A vector of waypoints objects constraining each path.
+  /// \param options   The options of the queries.
+  ///
+  /// \returns A vector indicating whether each path exists.
+  std::vector<bool>
+  pathExistsBatch(const std::vector<Waypoints> &waypoints,
+                  const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return any path for each of a batch of waypoints, as getAnyPath()
+  /// would.
+  ///
+  /// \param waypoints A vector of waypoints objects constraining each path.
+  /// \param options   The options of the queries.
+  ///
+  /// \returns A vector of paths, which are empty where no path exists.
+  std::vector<std::vector<Vertex*> >
+  getAnyPathBatch(const std::vector<Waypoints> &waypoints,
+                  const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the paths fanning out from each of a batch of start points, as
+  /// getAllFanOut() would.
+  ///
+  /// \param startNames A vector of patterns matching start points.
+  /// \param options    The options of the queries.
+  ///
+  /// \returns A vector of the paths fanning out from each start point.
+  std::vector<std::vector<std::vector<Vertex*> > >
+  getAllFanOutBatch(const std::vector<std::string> &startNames,
+                    const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  //===--------------------------------------------------------------------===//
+  // Path querying by vertex ID.
+  //===--------------------------------------------------------------------===//
+
+  // These queries return paths as the IDs of their vertices in a PathArray,
+  // which avoids creating a vector for each path. The vertices of the IDs can
+  // be obtained individually with getVertexPtr(), or their attributes in bulk
+  // with getVertexColumns().
+
+  /// Return any path between two points, as getAnyPath() would.
+  ///
+  /// \param waypoints A waypoints object constraining the path.
+  /// \param options   The options of the query.
+  ///
+  /// \returns An array containing the path if one exists, otherwise an empty
+  ///          path.
+  PathArray getAnyPathArray(Waypoints waypoints,
+                            const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return all paths between two points, as getAllPaths() would.
+  ///
+  /// \param waypoints A waypoints object constraining the path.
+  /// \param options   The options of the query.
+  ///
+  /// \returns An array of the paths matching the waypoints.
+  PathArray getAllPathsArray(Waypoints waypoints,
+                             const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the paths fanning out from a start point, as getAllFanOut()
+  /// would.
+  ///
+  /// \param startName A pattern matching a start point.
+  /// \param options   The options of the query.
+  ///
+  /// \returns An array of the paths fanning out from the start point.
+  PathArray getAllFanOutArray(const std::string startName,
+                              const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Return the paths fanning in to an end point, as getAllFanIn() would.
+  ///
+  /// \param endName A pattern matching an end point.
+  /// \param options The options of the query.
+  ///
+  /// \returns An array of the paths fanning in to the end point.
+  PathArray getAllFanInArray(const std::string endName,
+                             const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Count the fan out of every start point in bulk, as getFanOutDegree()
+  /// would.
+  ///
+  /// \param options The options of the query.
+  ///
+  /// \returns The columns of the degrees, with a row for the ID of each
+  ///          start point.
+  FanDegreeColumns getFanOutDegrees(const QueryOptions &options=QueryOptions::getDefault()) const {
+    return graph.getFanOutDegrees(options);
+  }
+
+  /// Count the fan in of every end point in bulk, as getFanInDegree() would.
+  ///
+  /// \param options The options of the query.
+  ///
+  /// \returns The columns of the degrees, with a row for the ID of each end
+  ///          point.
+  FanDegreeColumns getFanInDegrees(const QueryOptions &options=QueryOptions::getDefault()) const {
+    return graph.getFanInDegrees(options);
+  }
+
+  /// Return the vertex of an ID.
+  ///
+  /// \param vertexID The ID of a vertex in a PathArray.
+  ///
+  /// \returns A pointer to the vertex.
+  Vertex *getVertexPtr(PathArray::ID vertexID) const {
+    return graph.getVertexPtr(checkVertexID(vertexID));
+  }
+
+  /// Return the attributes of a list of vertices.
+  ///
+  /// \param vertexIDs The IDs of vertices in a PathArray.
+  ///
+  /// \returns The columns of attributes, with a row for each ID.
+  VertexColumns getVertexColumns(const std::vector<PathArray::ID> &vertexIDs) const;
 
   //===--------------------------------------------------------------------===//
   // Netlist access.
@@ -196,50 +583,100 @@ public:
   /// Return a sorted list of unique named vertices in the netlist for searching.
   ///
   /// \param pattern A pattern to match vertices against.
+  /// \param options The options of the query.
   ///
   /// \returns A vector of Vertex references.
   std::vector<std::reference_wrapper<const Vertex>>
-  getNamedVertices(const std::string pattern=std::string()) const;
+  getNamedVertices(const std::string pattern=std::string(),
+                   const QueryOptions &options=QueryOptions::getDefault()) const;
 
   /// Return a vector of pointers to vertices that have names.
-  std::vector<Vertex*> getNamedVerticesPtr(const std::string pattern=std::string()) const {
-    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::IS_NAMED));
+  std::vector<Vertex*> getNamedVerticesPtr(const std::string pattern=std::string(),
+                                           const QueryOptions &options=QueryOptions::getDefault()) const {
+    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::IS_NAMED, options));
   }
 
   /// Return a vector of pointers to net vertices.
   ///
   /// \param pattern A pattern to match vertices against.
+  /// \param options The options of the query.
   ///
   /// \returns A vector of pointers to Vertex objects.
-  std::vector<Vertex*> getNetVerticesPtr(const std::string pattern=std::string()) const {
-    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::NET));
+  std::vector<Vertex*> getNetVerticesPtr(const std::string pattern=std::string(),
+                                         const QueryOptions &options=QueryOptions::getDefault()) const {
+    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::NET, options));
   }
 
   /// Return a vector of pointers to port vertices.
   ///
   /// \param pattern A pattern to match vertices against.
+  /// \param options The options of the query.
   ///
   /// \returns A vector of pointers to Vertex objects.
-  std::vector<Vertex*> getPortVerticesPtr(const std::string pattern=std::string()) const {
-    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::PORT));
+  std::vector<Vertex*> getPortVerticesPtr(const std::string pattern=std::string(),
+                                          const QueryOptions &options=QueryOptions::getDefault()) const {
+    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::PORT, options));
   }
 
   /// Return a vector of pointers to register vertices.
   ///
   /// \param pattern A pattern to match vertices against.
+  /// \param options The options of the query.
   ///
   /// \returns A vector of pointers to Vertex objects.
-  std::vector<Vertex*> getRegVerticesPtr(const std::string pattern=std::string()) const {
-    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::REG));
+  std::vector<Vertex*> getRegVerticesPtr(const std::string pattern=std::string(),
+                                         const QueryOptions &options=QueryOptions::getDefault()) const {
+    return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::REG, options));
   }
 
   /// Write a dot-file represenation of the netlist graph to a file.
   ///
   /// \param outputFilename The file to write the dot output to.
-  void dumpDotFile(const std::string &outputFilename) const {
-    graph.dumpDotFile(outputFilename);
+  /// \param options        The options of the query.
+  void dumpDotFile(const std::string &outputFilename,
+                   const QueryOptions &options=QueryOptions::getDefault()) const {
+    graph.dumpDotFile(outputFilename, options);
   }
 
+  /// Write the fan-out cone of a start point to a file, which is the
+  /// subgraph of the vertices reachable from it and the edges between them.
+  ///
+  /// \param startName      A pattern matching a start point.
+  /// \param outputFilename The file to write to.
+  /// \param exportOptions  The format of the file and the limits on the
+  ///                       depth and number of vertices of the cone.
+  /// \param options        The options of the query.
+  void exportFanOutCone(const std::string startName,
+                        const std::string &outputFilename,
+                        const ExportOptions &exportOptions=ExportOptions(),
+                        const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Write the fan-in cone of an end point to a file, which is the subgraph
+  /// of the vertices that can reach it and the edges between them.
+  ///
+  /// \param endName        A pattern matching an end point.
+  /// \param outputFilename The file to write to.
+  /// \param exportOptions  The format of the file and the limits on the
+  ///                       depth and number of vertices of the cone.
+  /// \param options        The options of the query.
+  void exportFanInCone(const std::string endName,
+                       const std::string &outputFilename,
+                       const ExportOptions &exportOptions=ExportOptions(),
+                       const QueryOptions &options=QueryOptions::getDefault()) const;
+
+  /// Write the subgraph of the vertices on the paths between waypoints to a
+  /// file.
+  ///
+  /// \param waypoints      The waypoints and avoid points of the paths.
+  /// \param outputFilename The file to write to.
+  /// \param exportOptions  The format of the file and the limits on the
+  ///                       depth and number of vertices of the subgraph.
+  /// \param options        The options of the query.
+  void exportPaths(Waypoints waypoints,
+                   const std::string &outputFilename,
+                   const ExportOptions &exportOptions=ExportOptions(),
+                   const QueryOptions &options=QueryOptions::getDefault()) const;
+
   /// Return true if the netlist is empty.
   bool isEmpty() const { return graph.numVertices() == 0; }
 };
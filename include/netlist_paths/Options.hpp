@@ -1,6 +1,9 @@
 #ifndef NETLIST_PATHS_OPTIONS_HPP
 #define NETLIST_PATHS_OPTIONS_HPP
 
+#include <cstdint>
+#include <cstdlib>
+#include <string>
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/expressions.hpp>
@@ -16,6 +19,195 @@ enum class MatchType {
   WILDCARD
 };
 
+/// The options that control a query, as an immutable value that is passed
+/// to each query. Queries with different options can therefore run at the
+/// same time, on any number of threads sharing a Netlist. The with* methods
+/// return a copy with one option changed. The settings of the global Options
+/// object are the default for queries that do not supply their own.
+class QueryOptions {
+  MatchType matchType;
+  bool ignoreHierarchyMarkers;
+  bool matchOneVertex;
+  bool traverseRegisters;
+  bool restrictStartPoints;
+  bool restrictEndPoints;
+  bool searchBidirectional;
+  size_t numThreads;
+
+public:
+  /// Create a set of query options with the initial settings of the global
+  /// Options object.
+  QueryOptions() :
+      matchType(MatchType::EXACT),
+      ignoreHierarchyMarkers(false),
+      matchOneVertex(true),
+      traverseRegisters(false),
+      restrictStartPoints(true),
+      restrictEndPoints(true),
+      searchBidirectional(false),
+      numThreads(0) {}
+
+  /// Return the current settings of the global Options object.
+  static QueryOptions getDefault();
+
+  bool isMatchExact() const { return matchType == MatchType::EXACT; }
+  bool isMatchRegex() const { return matchType == MatchType::REGEX; }
+  bool isMatchWildcard() const { return matchType == MatchType::WILDCARD; }
+  bool isMatchOneVertex() const { return matchOneVertex; }
+  bool isMatchAnyVertex() const { return !matchOneVertex; }
+  bool shouldIgnoreHierarchyMarkers() const { return ignoreHierarchyMarkers; }
+  bool shouldTraverseRegisters() const { return traverseRegisters; }
+  bool isRestrictStartPoints() const { return restrictStartPoints; }
+  bool isRestrictEndPoints() const { return restrictEndPoints; }
+  bool shouldSearchBidirectional() const { return searchBidirectional; }
+  size_t getNumThreads() const { return numThreads; }
+
+  /// Return a copy matching names with a type of pattern.
+  QueryOptions withMatchType(MatchType value) const {
+    auto options = *this;
+    options.matchType = value;
+    return options;
+  }
+
+  /// Return a copy that ignores (true) or respects (false) hierarchy markers
+  /// when matching wildcard or regular expression patterns.
+  QueryOptions withIgnoreHierarchyMarkers(bool value) const {
+    auto options = *this;
+    options.ignoreHierarchyMarkers = value;
+    return options;
+  }
+
+  /// Return a copy where it is an error (true) for a name to match more than
+  /// one vertex, or where one of them is chosen arbitrarily (false).
+  QueryOptions withMatchOneVertex(bool value) const {
+    auto options = *this;
+    options.matchOneVertex = value;
+    return options;
+  }
+
+  /// Return a copy enabling or disabling path traversal of registers.
+  QueryOptions withTraverseRegisters(bool value) const {
+    auto options = *this;
+    options.traverseRegisters = value;
+    return options;
+  }
+
+  /// Return a copy with the path start point restriction set or cleared.
+  QueryOptions withRestrictStartPoints(bool value) const {
+    auto options = *this;
+    options.restrictStartPoints = value;
+    return options;
+  }
+
+  /// Return a copy with the path end point restriction set or cleared.
+  QueryOptions withRestrictEndPoints(bool value) const {
+    auto options = *this;
+    options.restrictEndPoints = value;
+    return options;
+  }
+
+  /// Return a copy enabling or disabling bidirectional searches.
+  QueryOptions withBidirectionalSearch(bool value) const {
+    auto options = *this;
+    options.searchBidirectional = value;
+    return options;
+  }
+
+  /// Return a copy spreading batch queries over a number of threads, where
+  /// zero means one per hardware thread.
+  QueryOptions withNumThreads(size_t value) const {
+    auto options = *this;
+    options.numThreads = value;
+    return options;
+  }
+};
+
+/// Limits on an enumeration of paths, which ends once any of them is reached.
+/// A limit of zero means there is no limit.
+class PathLimits {
+  size_t maxPaths;
+  size_t maxLength;
+  double timeLimit;
+
+public:
+  PathLimits() : maxPaths(0), maxLength(0), timeLimit(0) {}
+
+  size_t getMaxPaths() const { return maxPaths; }
+  size_t getMaxLength() const { return maxLength; }
+  double getTimeLimit() const { return timeLimit; }
+
+  /// Return a copy limiting the number of paths produced.
+  PathLimits withMaxPaths(size_t value) const {
+    auto limits = *this;
+    limits.maxPaths = value;
+    return limits;
+  }
+
+  /// Return a copy limiting paths to a number of vertices, which excludes
+  /// longer paths rather than ending the enumeration.
+  PathLimits withMaxLength(size_t value) const {
+    auto limits = *this;
+    limits.maxLength = value;
+    return limits;
+  }
+
+  /// Return a copy limiting the time spent enumerating paths, in seconds.
+  PathLimits withTimeLimit(double value) const {
+    auto limits = *this;
+    limits.timeLimit = value;
+    return limits;
+  }
+};
+
+/// The file formats that subgraphs can be exported in.
+enum class ExportFormat {
+  DOT,
+  GRAPHML,
+  JSON
+};
+
+/// The format of an exported subgraph and limits on its size. The vertices
+/// are selected in order of their distance from the points the export starts
+/// from, so a limit keeps the nearest ones. A limit of zero means there is no
+/// limit.
+class ExportOptions {
+  ExportFormat format;
+  size_t maxDepth;
+  size_t maxVertices;
+
+public:
+  ExportOptions() : format(ExportFormat::DOT), maxDepth(0), maxVertices(0) {}
+
+  ExportFormat getFormat() const { return format; }
+  size_t getMaxDepth() const { return maxDepth; }
+  size_t getMaxVertices() const { return maxVertices; }
+
+  /// Return a copy with a different file format.
+  ExportOptions withFormat(ExportFormat value) const {
+    auto options = *this;
+    options.format = value;
+    return options;
+  }
+
+  /// Return a copy limiting the number of edges between the vertices and the
+  /// points the export starts from.
+  ExportOptions withMaxDepth(size_t value) const {
+    auto options = *this;
+    options.maxDepth = value;
+    return options;
+  }
+
+  /// Return a copy limiting the number of vertices exported.
+  ExportOptions withMaxVertices(size_t value) const {
+    auto options = *this;
+    options.maxVertices = value;
+    return options;
+  }
+};
+
+/// The default size of the compile cache.
+constexpr uintmax_t DEFAULT_COMPILE_CACHE_MAX_BYTES = uintmax_t(1) << 30;
+
 /// A class encapsulating options.
 class Options {
 
@@ -27,6 +219,12 @@ class Options {
   bool traverseRegisters;
   bool restrictStartPoints;
   bool restrictEndPoints;
+  bool streamXML;
+  bool searchBidirectional;
+  bool reachabilityIndex;
+  size_t numThreads;
+  std::string compileCacheDirectory;
+  uintmax_t compileCacheMaxBytes;
 
 public:
   bool isMatchExact() const { return matchType == MatchType::EXACT; }
@@ -38,9 +236,29 @@ public:
   bool shouldTraverseRegisters() const { return traverseRegisters; }
   bool isRestrictStartPoints() const { return restrictStartPoints; }
   bool isRestrictEndPoints() const { return restrictEndPoints; }
+  bool shouldStreamXML() const { return streamXML; }
+  bool shouldSearchBidirectional() const { return searchBidirectional; }
+  bool shouldBuildReachabilityIndex() const { return reachabilityIndex; }
+  size_t getNumThreads() const { return numThreads; }
+  bool shouldUseCompileCache() const { return !compileCacheDirectory.empty(); }
+  const std::string &getCompileCacheDirectory() const { return compileCacheDirectory; }
+  uintmax_t getCompileCacheMaxBytes() const { return compileCacheMaxBytes; }
   bool isVerboseMode() const { return verboseMode; }
   bool isDebugMode() const { return debugMode; }
 
+  /// Return the current settings of the options that control queries.
+  QueryOptions getQueryOptions() const {
+    return QueryOptions()
+        .withMatchType(matchType)
+        .withIgnoreHierarchyMarkers(ignoreHierarchyMarkers)
+        .withMatchOneVertex(matchOneVertex)
+        .withTraverseRegisters(traverseRegisters)
+        .withRestrictStartPoints(restrictStartPoints)
+        .withRestrictEndPoints(restrictEndPoints)
+        .withBidirectionalSearch(searchBidirectional)
+        .withNumThreads(numThreads);
+  }
+
   /// Set matching to use wildcards.
   void setMatchWildcard() { matchType = MatchType::WILDCARD; }
 
@@ -76,6 +294,37 @@ public:
   /// variable.
   void setRestrictEndPoints(bool value) { restrictEndPoints = value; }
 
+  /// Enable or disable the streaming XML reader. The streaming reader parses
+  /// the netlist in a single forward pass without building a document tree of
+  /// the whole file, so peak memory is bounded by the largest statement rather
+  /// than by the size of the file.
+  void setStreamXML(bool value) { streamXML = value; }
+
+  /// Enable or disable bidirectional searches when checking whether paths
+  /// exist. A bidirectional search expands from both ends of the path and
+  /// usually visits far fewer vertices than a search from the start alone.
+  void setBidirectionalSearch(bool value) { searchBidirectional = value; }
+
+  /// Enable or disable building reachability indexes when a netlist is
+  /// loaded. The indexes answer whether paths exist without searching the
+  /// graph, and select the end points of fan outs and the start points of fan
+  /// ins, for queries without avoid points.
+  void setReachabilityIndex(bool value) { reachabilityIndex = value; }
+
+  /// Set the number of threads that batch queries are spread over, or zero
+  /// to use the number of hardware threads.
+  void setNumThreads(size_t value) { numThreads = value; }
+
+  /// Set the directory of the cache of Verilator compilations, or an empty
+  /// string to compile every time. The defaults of the directory and its
+  /// size are set by the NETLIST_PATHS_COMPILE_CACHE and
+  /// NETLIST_PATHS_COMPILE_CACHE_SIZE environment variables.
+  void setCompileCacheDirectory(const std::string &value) { compileCacheDirectory = value; }
+
+  /// Set the size in bytes that the compile cache is limited to, or zero for
+  /// no limit.
+  void setCompileCacheMaxBytes(uintmax_t value) { compileCacheMaxBytes = value; }
+
   /// Enable verbose output.
   void setVerbose() {
     boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
@@ -113,7 +362,18 @@ private:
       matchOneVertex(true),
       traverseRegisters(false),
       restrictStartPoints(true),
-      restrictEndPoints(true) {
+      restrictEndPoints(true),
+      streamXML(false),
+      searchBidirectional(false),
+      reachabilityIndex(false),
+      numThreads(0),
+      compileCacheMaxBytes(DEFAULT_COMPILE_CACHE_MAX_BYTES) {
+    if (auto directory = std::getenv("NETLIST_PATHS_COMPILE_CACHE")) {
+      compileCacheDirectory = directory;
+    }
+    if (auto size = std::getenv("NETLIST_PATHS_COMPILE_CACHE_SIZE")) {
+      compileCacheMaxBytes = std::strtoull(size, nullptr, 10);
+    }
     // Setup logging.
     boost::log::add_console_log(std::clog, boost::log::keywords::format = "%Severity%: %Message%");
     setQuiet();
@@ -125,6 +385,10 @@ public:
   void operator=(Options const&) = delete;
 };
 
+inline QueryOptions QueryOptions::getDefault() {
+  return Options::getInstance().getQueryOptions();
+}
+
 } // End netlist_paths namespace.
 
 #endif // NETLIST_PATHS_OPTIONS_HPP
@@ -0,0 +1,132 @@
+#ifndef NETLIST_PATHS_PATH_ENUMERATOR_HPP
+#define NETLIST_PATHS_PATH_ENUMERATOR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/Options.hpp"
+#include "netlist_paths/PathSearch.hpp"
+
+namespace netlist_paths {
+
+/// An enumeration of the paths between a sequence of waypoints, which
+/// produces the paths one at a time rather than constructing them all.
+///
+/// The paths between each pair of adjacent waypoints are a stage, and the
+/// paths of the enumeration are all the combinations of a path from each
+/// stage, which are produced by advancing the stages like the digits of a
+/// counter, so only the current path of each stage is held. The paths are in
+/// the same order as Graph::getAllPointToPoint() returns them. The enumeration
+/// ends once all the paths have been produced or a PathLimits limit is
+/// reached.
+class PathEnumerator {
+  std::vector<SimplePaths> stages;
+  VertexID lastWaypoint;
+  PathLimits limits;
+  VertexIDVec path;
+  size_t numPaths;
+  std::chrono::steady_clock::duration elapsed;
+  bool started;
+  bool finished;
+  bool truncated;
+
+  bool finish(bool byLimit) {
+    finished = true;
+    truncated = byLimit;
+    return false;
+  }
+
+  bool advance(SimplePaths::Deadline deadline);
+  bool findNext();
+
+public:
+  /// An input iterator over the remaining paths of an enumeration.
+  class iterator {
+    PathEnumerator *enumerator;
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = VertexIDVec;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const VertexIDVec*;
+    using reference = const VertexIDVec&;
+
+    explicit iterator(PathEnumerator *enumerator=nullptr) :
+        enumerator(enumerator) {}
+
+    reference operator*() const { return enumerator->getPath(); }
+    pointer operator->() const { return &enumerator->getPath(); }
+
+    iterator &operator++() {
+      if (!enumerator->next()) {
+        enumerator = nullptr;
+      }
+      return *this;
+    }
+
+    bool operator==(const iterator &other) const { return enumerator == other.enumerator; }
+    bool operator!=(const iterator &other) const { return enumerator != other.enumerator; }
+  };
+
+  /// Create an enumeration with no paths.
+  PathEnumerator();
+
+  /// Create an enumeration of a single path.
+  ///
+  /// \param path   The path.
+  /// \param limits The limits of the enumeration.
+  PathEnumerator(const VertexIDVec &path, const PathLimits &limits);
+
+  /// Create an enumeration of the paths between waypoints. The searches for
+  /// the edges of each stage are made here, so the enumeration does not
+  /// depend on the TraversalWorkspace, and it can be resumed after other
+  /// queries or on another thread.
+  ///
+  /// \param graph         The graph to search.
+  /// \param waypointIDs   The waypoints of the paths, in order.
+  /// \param avoidPointIDs The vertices the paths cannot pass through, sorted
+  ///                      by ID.
+  /// \param options       The options of the query.
+  /// \param limits        The limits of the enumeration.
+  /// \param counts        The counts to add the work of the searches to, or
+  ///                      nullptr.
+  PathEnumerator(const CSRGraph &graph,
+                 const VertexIDVec &waypointIDs,
+                 const VertexIDVec &avoidPointIDs,
+                 const QueryOptions &options,
+                 const PathLimits &limits,
+                 SearchCounts *counts=nullptr);
+
+  /// Produce the next path.
+  ///
+  /// \returns True if there is another path, which getPath() returns, or
+  ///          false if the enumeration has ended.
+  bool next();
+
+  /// Return the path produced by the last call to next().
+  const VertexIDVec &getPath() const { return path; }
+
+  /// Return the number of paths produced so far.
+  size_t getNumPaths() const { return numPaths; }
+
+  /// Return true if the enumeration has ended.
+  bool isFinished() const { return finished; }
+
+  /// Return true if the enumeration was ended by a limit before it produced
+  /// all of its paths. Once the maximum number of paths is reached, the next
+  /// call to next() searches for one more path to determine this.
+  bool isTruncated() const { return truncated; }
+
+  /// Return an iterator at the next path, which resumes the enumeration from
+  /// where it was left.
+  iterator begin() { return ++iterator(this); }
+
+  /// Return the iterator at the end of the enumeration.
+  iterator end() { return iterator(); }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_PATH_ENUMERATOR_HPP
@@ -0,0 +1,359 @@
+#ifndef NETLIST_PATHS_PATH_SEARCH_HPP
+#define NETLIST_PATHS_PATH_SEARCH_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/Graph.hpp"
+#include "netlist_paths/Stats.hpp"
+#include "netlist_paths/TraversalCache.hpp"
+#include "netlist_paths/TraversalWorkspace.hpp"
+
+namespace netlist_paths {
+
+/// The simple paths between two vertices, which are enumerated one at a time
+/// by backtracking from the finish vertex over the edges examined by a
+/// depth-first search from the start vertex. The vertices reached by the
+/// search and the edges between them are copied out of the TraversalWorkspace,
+/// so the enumeration can be resumed after other searches, and a vertex is
+/// checked for being on the current path in constant time.
+class SimplePaths {
+  friend class PathSearch;
+  using Index = CSRGraph::Index;
+
+  /// A vertex on the path being extended, with the index of the next of its
+  /// predecessor edges to follow.
+  struct PathEntry {
+    Index vertex;
+    size_t nextEdge;
+  };
+
+  static constexpr Index NO_VERTEX = UINT32_MAX;
+
+  VertexID startVertex;
+  // The vertices reached by the search, numbered in the order they were
+  // reached, so the start vertex is zero.
+  std::vector<VertexID> vertices;
+  Index finishIndex;
+  // The sources of the examined edges, grouped by their targets in the order
+  // they were examined.
+  std::vector<size_t> edgeOffsets;
+  std::vector<Index> edgeSources;
+  std::vector<PathEntry> stack;
+  std::vector<uint8_t> onPath;
+  VertexIDVec path;
+  bool started;
+  size_t numSteps;
+
+public:
+  using Deadline = std::chrono::steady_clock::time_point;
+
+  /// The result of a step of the enumeration.
+  enum class Status {
+    FOUND,
+    EXHAUSTED,
+    STOPPED
+  };
+
+  SimplePaths() : finishIndex(NO_VERTEX), started(false), numSteps(0) {}
+
+  /// Return true if there are no paths.
+  bool isEmpty() const { return finishIndex == NO_VERTEX; }
+
+  /// Find the next path, in the order of PathSearch::findAllPaths().
+  ///
+  /// \param maxLength The maximum number of vertices of a path, or zero for
+  ///                  no limit.
+  /// \param deadline  The time to stop searching at.
+  ///
+  /// \returns FOUND if there is another path, which getPath() returns,
+  ///          EXHAUSTED if there are no more paths, or STOPPED if the deadline
+  ///          passed, in which case the search can be resumed.
+  Status next(size_t maxLength=0, Deadline deadline=Deadline::max());
+
+  /// Restart the enumeration from the first path.
+  void reset();
+
+  /// Return the path found by the last call to next(), from the start vertex
+  /// to the finish vertex.
+  const VertexIDVec &getPath() const { return path; }
+
+  /// Return the number of bytes allocated for the enumeration.
+  size_t numBytes() const {
+    return vertices.capacity() * sizeof(VertexID) +
+           edgeOffsets.capacity() * sizeof(size_t) +
+           edgeSources.capacity() * sizeof(Index) +
+           onPath.capacity() * sizeof(uint8_t);
+  }
+};
+
+/// The filter of the edges followed by a search, specialised on whether
+/// registers are traversed and whether there are avoid points, so that the
+/// search loops are compiled for each combination without tests of the
+/// options for each edge.
+template<bool TraverseRegisters, bool HasAvoidPoints>
+class EdgeFilter {
+  const VertexBitset &avoidPoints;
+
+public:
+  explicit EdgeFilter(const VertexBitset &avoidPoints) : avoidPoints(avoidPoints) {}
+
+  /// Return true if a vertex is an avoid point.
+  bool isAvoidPoint(VertexID vertex) const {
+    if constexpr (HasAvoidPoints) {
+      return avoidPoints.test(vertex);
+    } else {
+      return false;
+    }
+  }
+
+  /// Return true if an edge can be followed, ignoring the vertex it leads to.
+  bool isTraversed(const CSRGraph::Adjacency &edges, size_t edge) const {
+    if constexpr (TraverseRegisters) {
+      return true;
+    } else {
+      return !edges.isThroughRegister(edge);
+    }
+  }
+
+  /// Return true if an edge to a vertex can be followed.
+  bool follow(const CSRGraph::Adjacency &edges, size_t edge, VertexID vertex) const {
+    return isTraversed(edges, edge) && !isAvoidPoint(vertex);
+  }
+};
+
+/// Searches of the CSR form of a graph, filtered by the traverse registers
+/// option of a query and a set of avoid points.
+///
+/// The searches follow the same edges as a search of the FilteredInternalGraph
+/// with EdgePredicate and VertexPredicate: an edge is followed if it does not
+/// pass through a register (unless registers are traversed) and the vertex it
+/// leads to is not an avoid point. Their state is held in the
+/// TraversalWorkspace of the calling thread, so the results of a search (such
+/// as by isVisited() and getTreePath()) are only valid until the next search
+/// on the same thread, and only one PathSearch can be used at a time on each
+/// thread. The work done by the searches is added to a set of SearchCounts
+/// when the PathSearch is destroyed. Each search is instantiated with an
+/// EdgeFilter for each combination of the options, and the instantiation is
+/// chosen once for each search.
+class PathSearch {
+  using Adjacency = CSRGraph::Adjacency;
+
+  const CSRGraph &graph;
+  bool traverseRegisters;
+  bool searchBidirectional;
+  bool hasAvoidPoints;
+  TraversalWorkspace &workspace;
+  VertexID treeRoot;
+  SearchCounts counts;
+  SearchCounts *countsSink;
+  size_t initialWorkspaceBytes;
+
+  void countEdge() {
+    if constexpr (STATS_ENABLED) { ++counts.edgesExamined; }
+  }
+
+  void countVertex() {
+    if constexpr (STATS_ENABLED) { ++counts.verticesVisited; }
+  }
+
+  void countParent() {
+    if constexpr (STATS_ENABLED) { ++counts.parentMapEntries; }
+  }
+
+  /// Call a function with the edge filter of the options of the search.
+  template<typename Function>
+  auto withEdgeFilter(Function function) const {
+    auto &avoidPoints = workspace.avoidPoints;
+    if (traverseRegisters) {
+      return hasAvoidPoints ? function(EdgeFilter<true, true>(avoidPoints))
+                            : function(EdgeFilter<true, false>(avoidPoints));
+    }
+    return hasAvoidPoints ? function(EdgeFilter<false, true>(avoidPoints))
+                          : function(EdgeFilter<false, false>(avoidPoints));
+  }
+
+  template<typename Filter>
+  bool searchPath(const Filter &filter, VertexID startVertex, VertexID finishVertex);
+
+  template<typename Filter>
+  bool searchFrontiers(const Filter &filter, VertexID startVertex,
+                       VertexID finishVertex);
+
+  template<typename Filter>
+  void searchTree(const Filter &filter, VertexID rootVertex, const Adjacency &edges);
+
+  template<typename Filter>
+  void searchSimplePaths(const Filter &filter, SimplePaths &paths);
+
+  template<typename Filter>
+  bool markReverseReachable(const Filter &filter, VertexID startVertex,
+                            VertexID finishVertex);
+
+  bool select(VertexID vertex, size_t maxVertices);
+
+  template<typename Filter>
+  void selectBreadthFirst(const Filter &filter, VertexID rootVertex,
+                          const Adjacency &edges, size_t maxDepth,
+                          size_t maxVertices, const VisitedSet *within);
+
+public:
+  PathSearch() = delete;
+
+  /// Create a search of a graph.
+  ///
+  /// \param graph         The graph to search.
+  /// \param avoidPointIDs A list of vertices that paths cannot pass through,
+  ///                      or nullptr.
+  /// \param options       The options of the query, which determine whether
+  ///                      registers are traversed and how path existence is
+  ///                      determined.
+  /// \param counts        The counts to add the work of the searches to, or
+  ///                      nullptr.
+  PathSearch(const CSRGraph &graph, const VertexIDVec *avoidPointIDs,
+             const QueryOptions &options, SearchCounts *counts=nullptr);
+
+  PathSearch(const PathSearch&) = delete;
+  PathSearch &operator=(const PathSearch&) = delete;
+
+  ~PathSearch() {
+    if constexpr (STATS_ENABLED) {
+      if (countsSink) {
+        counts.allocatedBytes += workspace.numBytes() - initialWorkspaceBytes;
+        *countsSink += counts;
+      }
+    }
+  }
+
+  /// Find a path with a depth-first search from the start vertex, which stops
+  /// as soon as the finish vertex is reached. The edges are visited in the
+  /// same order as boost::depth_first_search, so the path is the one in the
+  /// DFS tree of the start vertex.
+  ///
+  /// \param startVertex  The vertex to start the search from.
+  /// \param finishVertex The vertex to search for.
+  ///
+  /// \returns The vertices of the path from start to finish inclusive, or an
+  ///          empty vector if there is no path.
+  VertexIDVec findPath(VertexID startVertex, VertexID finishVertex);
+
+  /// Determine whether a path exists with a bidirectional breadth-first
+  /// search, which expands the smaller of the frontiers from the start vertex
+  /// over the graph and from the finish vertex over the reverse graph, until
+  /// they meet.
+  ///
+  /// \param startVertex  The vertex to start the search from.
+  /// \param finishVertex The vertex to search for.
+  ///
+  /// \returns True if a path exists.
+  bool pathExistsBidirectional(VertexID startVertex, VertexID finishVertex);
+
+  /// Determine whether a path exists, using a bidirectional search if the
+  /// option is set and otherwise a depth-first search.
+  bool pathExists(VertexID startVertex, VertexID finishVertex) {
+    if (searchBidirectional) {
+      return pathExistsBidirectional(startVertex, finishVertex);
+    }
+    return !findPath(startVertex, finishVertex).empty();
+  }
+
+  /// Perform a depth-first search of all the vertices reachable from a root
+  /// vertex, recording the DFS tree.
+  ///
+  /// \param rootVertex The vertex to start the search from.
+  /// \param reverse    Search the reverse graph, following in edges.
+  void visitTree(VertexID rootVertex, bool reverse=false);
+
+  /// Return true if a vertex was reached by the last search.
+  bool isVisited(VertexID vertex) const {
+    return workspace.visited.test(vertex);
+  }
+
+  /// Return the path in the DFS tree of the last visitTree() from a vertex
+  /// back to the root vertex.
+  ///
+  /// \param vertex A vertex that was reached by the search.
+  ///
+  /// \returns The vertices of the path, starting with vertex and ending with
+  ///          the root.
+  VertexIDVec getTreePath(VertexID vertex) const;
+
+  /// Copy the DFS tree of the last visitTree() out of the workspace.
+  TraversalTree copyTree() const;
+
+  /// Prepare the enumeration of the simple paths between two vertices.
+  ///
+  /// \param startVertex  The vertex to start the paths from.
+  /// \param finishVertex The vertex to finish the paths at.
+  ///
+  /// \returns An enumeration of the paths, which is independent of the
+  ///          search.
+  SimplePaths findSimplePaths(VertexID startVertex, VertexID finishVertex);
+
+  /// Return all the simple paths between two vertices. This is not feasible
+  /// for large graphs since the number of paths grows exponentially.
+  ///
+  /// \param startVertex  The vertex to start the paths from.
+  /// \param finishVertex The vertex to finish the paths at.
+  ///
+  /// \returns The paths, each from finish to start.
+  std::vector<VertexIDVec> findAllPaths(VertexID startVertex,
+                                        VertexID finishVertex);
+
+  /// Empty the selection of vertices made by selectCone() and
+  /// selectBetween(), which is held in the TraversalWorkspace.
+  void clearSelection();
+
+  /// Add the vertices reachable from a root vertex to the selection, with a
+  /// breadth-first search so the nearest vertices are selected first.
+  ///
+  /// \param rootVertex  The vertex to start the search from.
+  /// \param reverse     Search the reverse graph, following in edges.
+  /// \param maxDepth    The maximum number of edges from the root vertex to
+  ///                    a selected vertex, or zero for no limit.
+  /// \param maxVertices The maximum number of vertices in the selection, or
+  ///                    zero for no limit.
+  void selectCone(VertexID rootVertex, bool reverse, size_t maxDepth,
+                  size_t maxVertices);
+
+  /// Add the vertices on the paths between two vertices to the selection,
+  /// which are those reachable from the start vertex that can reach the
+  /// finish vertex, selected in order of their distance from the start
+  /// vertex.
+  ///
+  /// \param startVertex  The vertex to start the paths from.
+  /// \param finishVertex The vertex to finish the paths at.
+  /// \param maxDepth     The maximum number of edges from the start vertex to
+  ///                     a selected vertex, or zero for no limit.
+  /// \param maxVertices  The maximum number of vertices in the selection, or
+  ///                     zero for no limit.
+  void selectBetween(VertexID startVertex, VertexID finishVertex,
+                     size_t maxDepth, size_t maxVertices);
+
+  /// Return the selected vertices, in the order they were selected.
+  const VertexIDVec &getSelection() const { return workspace.selection; }
+
+  /// Call a function with the source and target of each followed edge
+  /// between two selected vertices, grouped by source in the order of the
+  /// selection.
+  template<typename Function>
+  void forEachSelectedEdge(Function function) const {
+    withEdgeFilter([&](const auto &filter) {
+      auto &outEdges = graph.getOutEdges();
+      for (auto vertex : workspace.selection) {
+        auto range = outEdges.getEdges(vertex);
+        for (auto edge = range.first; edge != range.second; ++edge) {
+          auto target = outEdges.getVertex(edge);
+          if (filter.isTraversed(outEdges, edge) && workspace.selected.test(target)) {
+            function(vertex, target);
+          }
+        }
+      }
+    });
+  }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_PATH_SEARCH_HPP
@@ -0,0 +1,159 @@
+#ifndef NETLIST_PATHS_PATTERN_HPP
+#define NETLIST_PATHS_PATTERN_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "netlist_paths/Options.hpp"
+
+namespace netlist_paths {
+
+/// A wildcard pattern or regular expression compiled into an automaton that
+/// matches names in time linear in their length.
+///
+/// Wildcard patterns are compiled into a bit-parallel NFA with one state per
+/// literal or '?' character, where '*' characters become self loops. Regular
+/// expressions are parsed and compiled into an NFA program, which is then
+/// converted into a DFA by subset construction. If the DFA would be too large,
+/// the program is run directly by a Pike VM, which simulates all threads of
+/// the NFA in lock step. Regular expressions using syntax the program does not
+/// support (such as back references, assertions other than '^' and '$', or
+/// large repetition counts) fall back to std::regex.
+class Pattern {
+public:
+  /// An instruction of a compiled regular expression program.
+  struct Instruction {
+    enum class Op {
+      CHARS,
+      SPLIT,
+      JUMP,
+      BEGIN,
+      END,
+      MATCH
+    };
+    Op op;
+    size_t x;
+    size_t y;
+    std::bitset<256> chars;
+    Instruction(Op op, size_t x=0, size_t y=0) : op(op), x(x), y(y) {}
+  };
+
+private:
+  MatchType matchType;
+  std::string prefix;
+
+  // Wildcard NFA.
+  size_t numWords;
+  uint64_t acceptBit;
+  std::vector<uint64_t> charMasks;
+  std::vector<uint64_t> loopMask;
+
+  // Regular expression program.
+  std::vector<Instruction> program;
+  bool anchoredBegin;
+  bool useRegex;
+  std::regex fallbackRegex;
+
+  // Regular expression DFA, with the bytes grouped into classes that no
+  // instruction of the program distinguishes between.
+  static constexpr uint32_t DFA_MATCH = UINT32_MAX;
+  static constexpr uint32_t DFA_DEAD = UINT32_MAX - 1;
+  bool useDFA;
+  uint32_t dfaStart;
+  size_t numByteClasses;
+  std::vector<uint16_t> byteClasses;
+  std::vector<uint32_t> dfaTransitions;
+  std::vector<bool> dfaAcceptAtEnd;
+
+  void compileWildcard(const std::string &pattern);
+  bool compileRegex(const std::string &pattern);
+  bool buildDFA();
+  bool matchWildcard(std::string_view text) const;
+  bool matchDFA(std::string_view text) const;
+  bool matchProgram(std::string_view text) const;
+
+public:
+  Pattern() = delete;
+
+  /// Compile a pattern.
+  ///
+  /// \param pattern                A wildcard pattern or regular expression.
+  /// \param matchType              The type of the pattern, either wildcard
+  ///                               or regex.
+  /// \param ignoreHierarchyMarkers Allow any hierarchy marker ('.', '/' or
+  ///                               '_') in the pattern to match any other.
+  ///
+  /// \throws Exception if the regular expression is malformed.
+  Pattern(const std::string &pattern,
+          MatchType matchType,
+          bool ignoreHierarchyMarkers);
+
+  /// Match a name against the pattern. Wildcard patterns must match the
+  /// whole name and regular expressions may match any part of it.
+  ///
+  /// \param text The name to match.
+  ///
+  /// \returns True if the pattern matches.
+  bool match(std::string_view text) const {
+    if (matchType == MatchType::WILDCARD) {
+      return matchWildcard(text);
+    }
+    if (useDFA) {
+      return matchDFA(text);
+    }
+    if (useRegex) {
+      return std::regex_search(text.begin(), text.end(), fallbackRegex);
+    }
+    return matchProgram(text);
+  }
+
+  /// Return the literal prefix that all matching names start with.
+  const std::string &getPrefix() const { return prefix; }
+
+  /// Return true if the pattern is matched by a compiled automaton rather
+  /// than std::regex.
+  bool isCompiled() const { return matchType == MatchType::WILDCARD || !useRegex; }
+};
+
+/// A thread-safe cache of compiled patterns, keyed by the pattern string, its
+/// type and whether hierarchy markers are ignored.
+class PatternCache {
+  using Key = std::tuple<std::string, MatchType, bool>;
+
+  /// The maximum number of patterns held before the cache is emptied.
+  static constexpr size_t MAX_ENTRIES = 1024;
+
+  mutable std::mutex mutex;
+  std::map<Key, std::shared_ptr<const Pattern>> patterns;
+
+public:
+  PatternCache() {}
+
+  /// Return a compiled pattern, compiling it if it is not in the cache.
+  ///
+  /// \param pattern                A wildcard pattern or regular expression.
+  /// \param matchType              The type of the pattern.
+  /// \param ignoreHierarchyMarkers Whether hierarchy markers are ignored.
+  ///
+  /// \returns A shared pointer to the compiled pattern.
+  std::shared_ptr<const Pattern> get(const std::string &pattern,
+                                     MatchType matchType,
+                                     bool ignoreHierarchyMarkers);
+
+  /// Remove all patterns from the cache.
+  void clear();
+
+  /// Return the number of patterns in the cache.
+  size_t size() const;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_PATTERN_HPP
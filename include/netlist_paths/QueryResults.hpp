@@ -0,0 +1,83 @@
+#ifndef NETLIST_PATHS_QUERY_RESULTS_HPP
+#define NETLIST_PATHS_QUERY_RESULTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace netlist_paths {
+
+/// A list of paths held as vertex IDs in two flat arrays, rather than as a
+/// vector of vectors of vertices. The vertices of all the paths are
+/// concatenated, and path i is the range [offsets[i], offsets[i+1]) of them.
+/// The IDs are fixed-width so the arrays can be shared with other languages
+/// without conversion.
+class PathArray {
+public:
+  using ID = std::uint64_t;
+
+private:
+  std::vector<ID> vertices;
+  std::vector<ID> offsets;
+
+public:
+  PathArray() : offsets(1, 0) {}
+
+  /// Create an array from a list of paths.
+  template<typename PathList>
+  explicit PathArray(const PathList &paths) : offsets(1, 0) {
+    size_t numVertices = 0;
+    for (auto &path : paths) {
+      numVertices += path.size();
+    }
+    vertices.reserve(numVertices);
+    offsets.reserve(paths.size() + 1);
+    for (auto &path : paths) {
+      addPath(path);
+    }
+  }
+
+  /// Append a path.
+  template<typename Path>
+  void addPath(const Path &path) {
+    vertices.insert(vertices.end(), path.begin(), path.end());
+    offsets.push_back(vertices.size());
+  }
+
+  /// Return the number of paths.
+  size_t numPaths() const { return offsets.size() - 1; }
+
+  /// Return the vertices of a path.
+  std::pair<const ID*, const ID*> getPath(size_t index) const {
+    return {vertices.data() + offsets[index],
+            vertices.data() + offsets[index + 1]};
+  }
+
+  /// Return the vertices of all the paths, concatenated.
+  const std::vector<ID> &getVertices() const { return vertices; }
+
+  /// Return the offset of the first vertex of each path, followed by the
+  /// total number of vertices.
+  const std::vector<ID> &getOffsets() const { return offsets; }
+};
+
+/// The attributes of a list of vertices, held as a column for each attribute
+/// with a row for each vertex. The names view the interned names of the
+/// netlist and the type and direction names are static strings, so only the
+/// data types and locations, which are formatted on demand, are copied.
+struct VertexColumns {
+  std::vector<std::string_view> names;
+  std::vector<const char*> astTypes;
+  std::vector<const char*> directions;
+  std::vector<std::string> dtypes;
+  std::vector<std::uint64_t> widths;
+  std::vector<std::string> locations;
+  std::vector<bool> isLogic;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_QUERY_RESULTS_HPP
@@ -0,0 +1,130 @@
+#ifndef NETLIST_PATHS_REACHABILITY_INDEX_HPP
+#define NETLIST_PATHS_REACHABILITY_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/ComponentGraph.hpp"
+
+namespace netlist_paths {
+
+/// An index answering whether one vertex of a graph is reachable from
+/// another, for one setting of the traverse registers option.
+///
+/// The index labels each component of the ComponentGraph of the graph with
+/// two intervals from depth-first traversals of the DAG in different orders
+/// (as in GRAIL). If a component reaches another, both of its intervals
+/// contain the other's, so most unreachable pairs are rejected by comparing
+/// labels, and the searches of the DAG that remain are pruned to the
+/// components whose labels could reach the target. The components are
+/// numbered in reverse topological order, so a component only reaches
+/// components with lower numbers.
+///
+/// The index does not account for avoid points, which must be handled by
+/// searching the graph.
+class ReachabilityIndex {
+  friend class WriteSnapshot;
+  friend class ReadSnapshot;
+
+public:
+  using Index = ComponentGraph::Index;
+
+  /// The interval labels of a component. The post-order number of the first
+  /// traversal is the component number.
+  struct Label {
+    Index low0;
+    Index low1;
+    Index post1;
+  };
+
+private:
+  std::shared_ptr<const ComponentGraph> componentGraph;
+  std::vector<Label> labels;
+
+  /// Return true if the labels allow component a to reach component b.
+  bool mayReach(Index a, Index b) const {
+    auto &la = labels[a];
+    auto &lb = labels[b];
+    return b < a &&
+           la.low0 <= lb.low0 &&
+           la.low1 <= lb.low1 && lb.post1 < la.post1;
+  }
+
+  void buildLabels();
+
+public:
+  ReachabilityIndex() {}
+
+  /// Build the index of a graph.
+  ///
+  /// \param graph             The graph to index.
+  /// \param traverseRegisters Whether paths can pass through registers.
+  void build(const CSRGraph &graph, bool traverseRegisters);
+
+  /// Build the index of a graph from its condensation, which the index
+  /// shares.
+  ///
+  /// \param componentGraph The condensation of the graph.
+  void build(std::shared_ptr<const ComponentGraph> componentGraph);
+
+  /// Remove the index.
+  void clear();
+
+  /// Return true if the index has been built.
+  bool isBuilt() const { return componentGraph != nullptr; }
+
+  /// Return the condensation of the graph the index labels.
+  const std::shared_ptr<const ComponentGraph> &getComponentGraph() const {
+    return componentGraph;
+  }
+
+  /// Return the number of vertices indexed.
+  size_t numVertices() const { return componentGraph->numVertices(); }
+
+  /// Return the number of strongly-connected components.
+  size_t numComponents() const { return componentGraph->numComponents(); }
+
+  /// Return the strongly-connected component of a vertex.
+  Index getComponent(size_t vertex) const {
+    return componentGraph->getComponent(vertex);
+  }
+
+  /// Return the successors of a component in the DAG, which all have lower
+  /// numbers than it.
+  std::pair<const Index*, const Index*> getSuccessors(Index component) const {
+    return componentGraph->getSuccessors(component);
+  }
+
+  /// Return the predecessors of a component in the DAG, which all have
+  /// higher numbers than it.
+  std::pair<const Index*, const Index*> getPredecessors(Index component) const {
+    return componentGraph->getPredecessors(component);
+  }
+
+  /// Return true if a path exists between two vertices.
+  ///
+  /// \param startVertex  The vertex to start the path from.
+  /// \param finishVertex The vertex to finish the path at.
+  ///
+  /// \returns True if finishVertex is reachable from startVertex, which is
+  ///          always the case if they are the same vertex.
+  bool reaches(size_t startVertex, size_t finishVertex) const;
+
+  /// Select the vertices of a list that are reachable from a root vertex.
+  ///
+  /// \param rootVertex The vertex to search from.
+  /// \param vertices   The vertices to select from.
+  /// \param reverse    Select the vertices that reach the root vertex instead.
+  ///
+  /// \returns The selected vertices, in the order of the list.
+  std::vector<size_t> selectReachable(size_t rootVertex,
+                                      const std::vector<size_t> &vertices,
+                                      bool reverse=false) const;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_REACHABILITY_INDEX_HPP
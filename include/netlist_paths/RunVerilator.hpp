@@ -1,6 +1,7 @@
 #ifndef NETLIST_PATHS_RUN_VERILATOR_HPP
 #define NETLIST_PATHS_RUN_VERILATOR_HPP
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <boost/filesystem.hpp>
@@ -9,10 +10,35 @@ namespace fs = boost::filesystem;
 
 namespace netlist_paths {
 
+class CompileCache;
+class Netlist;
+
 /// A class that provides facilities to run Verilator and produce XML netlists.
+///
+/// If the compile cache option is set, the netlists are held in a
+/// CompileCache, and a compilation whose sources have not changed is not run
+/// again.
 class RunVerilator {
 private:
   fs::path verilatorExe;
+  mutable std::string verilatorVersion;
+
+  std::vector<std::string> getArgs(const std::vector<std::string> &includes,
+                                   const std::vector<std::string> &defines) const;
+
+  const std::string &getVerilatorVersion() const;
+
+  std::string getCacheKey(const std::vector<std::string> &args,
+                          const std::vector<std::string> &inputFiles) const;
+
+  int runVerilator(std::vector<std::string> args,
+                   const std::vector<std::string> &inputFiles,
+                   const std::string &outputFile) const;
+
+  int writeXML(const std::vector<std::string> &includes,
+               const std::vector<std::string> &defines,
+               const std::vector<std::string> &inputFiles,
+               const std::string &outputFile) const;
 
 public:
 
@@ -26,12 +52,15 @@ public:
   ///        executable (np-verilator_bin).
   RunVerilator(const std::string &verilatorLocation);
 
-  /// Run Verilator.
+  /// Run Verilator. If the output file name ends in .gz or .zst, the XML is
+  /// compressed with gzip or Zstandard once Verilator has written it.
   ///
   /// \param includes   A vector of search paths for include files.
   /// \param defines    A vector of macro definitions.
   /// \param inputFiles A vector of source file paths.
   /// \param outputFile A path specifying an output file.
+  ///
+  /// \throws Exception if the output compression is not supported.
   int run(const std::vector<std::string> &includes,
           const std::vector<std::string> &defines,
           const std::vector<std::string> &inputFiles,
@@ -43,6 +72,27 @@ public:
   /// \param outputFile A path specifying an output file.
   int run(const std::string& inputFile,
           const std::string& outputFile) const;
+
+  /// Compile source files and load the netlist. With the compile cache, the
+  /// netlist is loaded from a cached snapshot if there is one, and otherwise
+  /// a snapshot is added to the cache once it is loaded.
+  ///
+  /// \param includes   A vector of search paths for include files.
+  /// \param defines    A vector of macro definitions.
+  /// \param inputFiles A vector of source file paths.
+  ///
+  /// \returns The netlist.
+  ///
+  /// \throws Exception if Verilator fails.
+  std::unique_ptr<Netlist> compile(const std::vector<std::string> &includes,
+                                   const std::vector<std::string> &defines,
+                                   const std::vector<std::string> &inputFiles) const;
+
+  /// Compile a single source file with no other options and load the
+  /// netlist.
+  ///
+  /// \param inputFile A source file path.
+  std::unique_ptr<Netlist> compile(const std::string &inputFile) const;
 };
 
 } // End namespace.
@@ -0,0 +1,183 @@
+#ifndef NETLIST_PATHS_STATS_HPP
+#define NETLIST_PATHS_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace netlist_paths {
+
+/// True if statistics are recorded, which is set by the NETLIST_PATHS_STATS
+/// build option. Otherwise the timers and counters compile to nothing.
+#ifdef NETLIST_PATHS_STATS
+constexpr bool STATS_ENABLED = true;
+#else
+constexpr bool STATS_ENABLED = false;
+#endif
+
+/// The phases of loading a netlist and the types of query that are recorded.
+enum class StatsPhase {
+  READ_XML,
+  PARSE_XML,
+  TYPE_TABLE_PASS_1,
+  TYPE_TABLE_PASS_2,
+  VISIT_MODULES,
+  READ_SNAPSHOT,
+  MARK_ALIAS_REGISTERS,
+  SPLIT_REG_VERTICES,
+  UPDATE_VAR_ALIASES,
+  BUILD_INDEXES,
+  BUILD_REACHABILITY_INDEXES,
+  LOOKUP_VERTICES,
+  FAN_OUT,
+  FAN_IN,
+  FAN_DEGREE,
+  ANY_PATH,
+  PATH_EXISTS,
+  ALL_PATHS,
+  DEEPEST_PATHS,
+  EXPORT_SUBGRAPH,
+  NUM_PHASES
+};
+
+/// The work done by the searches of a query.
+struct SearchCounts {
+  /// The number of vertices reached.
+  uint64_t verticesVisited;
+
+  /// The number of edges examined.
+  uint64_t edgesExamined;
+
+  /// The number of entries recorded in the map of each vertex to the vertex
+  /// it was reached from.
+  uint64_t parentMapEntries;
+
+  /// The number of bytes allocated for the state of the searches.
+  uint64_t allocatedBytes;
+
+  SearchCounts() :
+    verticesVisited(0), edgesExamined(0), parentMapEntries(0), allocatedBytes(0) {}
+
+  SearchCounts &operator+=(const SearchCounts &other) {
+    verticesVisited += other.verticesVisited;
+    edgesExamined += other.edgesExamined;
+    parentMapEntries += other.parentMapEntries;
+    allocatedBytes += other.allocatedBytes;
+    return *this;
+  }
+};
+
+/// A registry of the time spent in each phase of loading a netlist and by
+/// each type of query, with the number of times each was performed and the
+/// work done by the searches of the queries, and the use of the traversal
+/// cache. Queries on different threads record into it at the same time, so
+/// the figures are held as atomics.
+class Stats {
+  struct Record {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> nanoseconds;
+    std::atomic<uint64_t> verticesVisited;
+    std::atomic<uint64_t> edgesExamined;
+    std::atomic<uint64_t> parentMapEntries;
+    std::atomic<uint64_t> allocatedBytes;
+  };
+
+  std::array<Record, static_cast<size_t>(StatsPhase::NUM_PHASES)> records;
+  std::atomic<uint64_t> traversalCacheHits;
+  std::atomic<uint64_t> traversalCacheMisses;
+  std::atomic<uint64_t> traversalCacheEvictions;
+
+  Record &getRecord(StatsPhase phase) {
+    return records[static_cast<size_t>(phase)];
+  }
+
+public:
+  Stats() { clear(); }
+
+  /// Record the time of one occurrence of a phase.
+  void addTime(StatsPhase phase, std::chrono::steady_clock::duration elapsed) {
+    if constexpr (STATS_ENABLED) {
+      auto &record = getRecord(phase);
+      auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+      record.count.fetch_add(1, std::memory_order_relaxed);
+      record.nanoseconds.fetch_add(nanoseconds.count(), std::memory_order_relaxed);
+    }
+  }
+
+  /// Record the work done by the searches of a query.
+  void addCounts(StatsPhase phase, const SearchCounts &counts) {
+    if constexpr (STATS_ENABLED) {
+      auto &record = getRecord(phase);
+      record.verticesVisited.fetch_add(counts.verticesVisited, std::memory_order_relaxed);
+      record.edgesExamined.fetch_add(counts.edgesExamined, std::memory_order_relaxed);
+      record.parentMapEntries.fetch_add(counts.parentMapEntries, std::memory_order_relaxed);
+      record.allocatedBytes.fetch_add(counts.allocatedBytes, std::memory_order_relaxed);
+    }
+  }
+
+  /// Record a lookup of a tree in the traversal cache, and the number of
+  /// trees discarded to add the tree if it was not found.
+  void addTraversalCacheLookup(bool hit, size_t evictions=0) {
+    if constexpr (STATS_ENABLED) {
+      auto &counter = hit ? traversalCacheHits : traversalCacheMisses;
+      counter.fetch_add(1, std::memory_order_relaxed);
+      traversalCacheEvictions.fetch_add(evictions, std::memory_order_relaxed);
+    }
+  }
+
+  /// Reset all the figures to zero.
+  void clear();
+
+  /// Return the name of a phase, as used by getValues().
+  static const char *getPhaseName(StatsPhase phase);
+
+  /// Return the figures of the phases that have occurred, as pairs of a name
+  /// of the form <phase>.<figure> and a value: count and seconds for every
+  /// phase, and vertices_visited, edges_examined, parent_map_entries and
+  /// allocated_bytes for the queries that search the graph. The hits, misses
+  /// and evictions of the traversal cache are named traversal_cache.<figure>
+  /// if it has been used.
+  std::vector<std::pair<std::string, double>> getValues() const;
+};
+
+/// A timer that records the time from its creation to its destruction as an
+/// occurrence of a phase, together with the counts of the searches of the
+/// phase.
+class ScopedTimer {
+  Stats &stats;
+  StatsPhase phase;
+  std::chrono::steady_clock::time_point start;
+  SearchCounts counts;
+
+public:
+  ScopedTimer(Stats &stats, StatsPhase phase) : stats(stats), phase(phase) {
+    if constexpr (STATS_ENABLED) {
+      start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer &operator=(const ScopedTimer&) = delete;
+
+  ~ScopedTimer() {
+    if constexpr (STATS_ENABLED) {
+      stats.addTime(phase, std::chrono::steady_clock::now() - start);
+      stats.addCounts(phase, counts);
+    }
+  }
+
+  /// Return the counts to accumulate the searches of the phase into, or
+  /// nullptr if statistics are not recorded.
+  SearchCounts *getCounts() {
+    return STATS_ENABLED ? &counts : nullptr;
+  }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_STATS_HPP
@@ -0,0 +1,57 @@
+#ifndef NETLIST_PATHS_STRING_POOL_HPP
+#define NETLIST_PATHS_STRING_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace netlist_paths {
+
+/// A pool of interned strings, held in large arena-allocated chunks.
+///
+/// Each distinct string is stored once, so the vertices of a netlist that
+/// share a name (such as the source and destination vertices of a register)
+/// share the storage of the name, and the per-string allocation overhead of
+/// std::string is avoided. The views returned by intern() remain valid until
+/// the pool is cleared or destroyed.
+class StringPool {
+  std::vector<std::unique_ptr<char[]>> chunks;
+  std::unordered_set<std::string_view> strings;
+  char *next;
+  size_t remaining;
+  size_t bytes;
+
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+  char *allocate(size_t size);
+
+public:
+  StringPool() : next(nullptr), remaining(0), bytes(0) {}
+  StringPool(const StringPool&) = delete;
+  StringPool &operator=(const StringPool&) = delete;
+  StringPool(StringPool&&) = default;
+  StringPool &operator=(StringPool&&) = default;
+
+  /// Return the pooled copy of a string, adding it to the pool if it is not
+  /// already present.
+  ///
+  /// \param value The string to intern.
+  ///
+  /// \returns A view of the pooled string.
+  std::string_view intern(std::string_view value);
+
+  /// Remove all strings from the pool, invalidating all views of them.
+  void clear();
+
+  /// Return the number of distinct strings in the pool.
+  size_t size() const { return strings.size(); }
+
+  /// Return the number of bytes of string data allocated by the pool.
+  size_t getBytes() const { return bytes; }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_STRING_POOL_HPP
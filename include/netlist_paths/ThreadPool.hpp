@@ -0,0 +1,79 @@
+#ifndef NETLIST_PATHS_THREAD_POOL_HPP
+#define NETLIST_PATHS_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace netlist_paths {
+
+/// A pool of threads that execute the iterations of a loop, balancing the
+/// load between them by work stealing.
+///
+/// Each thread starts with an equal contiguous range of the iterations, and
+/// takes iterations from the front of its own range. Once its range is empty,
+/// it steals the back half of the largest remaining range of another thread,
+/// so threads that are given quick iterations take over the work of threads
+/// that are given slow ones. The thread calling parallelFor() takes part as
+/// one of the threads of the pool.
+class ThreadPool {
+  /// The iterations remaining for one thread, as the interval [begin, end).
+  struct alignas(64) Range {
+    std::mutex mutex;
+    size_t begin;
+    size_t end;
+  };
+
+  std::vector<std::thread> workers;
+  std::unique_ptr<Range[]> ranges;
+  std::mutex mutex;
+  std::condition_variable startLoop;
+  std::condition_variable finishLoop;
+  const std::function<void(size_t)> *body;
+  size_t generation;
+  size_t numActive;
+  bool stopping;
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  bool takeIteration(size_t thread, size_t &iteration);
+  bool stealIterations(size_t thread);
+  void runIterations(size_t thread);
+  void runWorker(size_t thread);
+
+public:
+  /// Create a pool.
+  ///
+  /// \param numThreads The number of threads, including the calling thread,
+  ///                   or zero for the number of hardware threads.
+  explicit ThreadPool(size_t numThreads=0);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool &operator=(const ThreadPool&) = delete;
+
+  /// Return the number of threads, including the calling thread.
+  size_t getNumThreads() const { return workers.size() + 1; }
+
+  /// Call a function for each iteration of a loop, in parallel and in no
+  /// particular order, and wait for them all to complete. Only one loop can
+  /// run on a pool at a time.
+  ///
+  /// \param numIterations The number of iterations.
+  /// \param body          The function to call with the index of each
+  ///                      iteration.
+  ///
+  /// If any of the calls throws an exception, the remaining iterations are
+  /// still run, and the first exception is rethrown once they complete.
+  void parallelFor(size_t numIterations, const std::function<void(size_t)> &body);
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_THREAD_POOL_HPP
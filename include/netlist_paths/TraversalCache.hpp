@@ -0,0 +1,140 @@
+#ifndef NETLIST_PATHS_TRAVERSAL_CACHE_HPP
+#define NETLIST_PATHS_TRAVERSAL_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "netlist_paths/CSRGraph.hpp"
+
+namespace netlist_paths {
+
+/// The tree of a depth-first search from a root vertex, as copied out of the
+/// TraversalWorkspace by PathSearch::copyTree(), so it can be kept after
+/// other searches.
+///
+/// The vertices reached are held sorted by ID, with the position of the
+/// vertex each was reached from, so a vertex is found by a binary search and
+/// its path back to the root is followed in time proportional to its length.
+class TraversalTree {
+  using Index = CSRGraph::Index;
+
+  size_t rootVertex;
+  std::vector<Index> vertices;
+  // The position in vertices of the parent of each vertex, the root being its
+  // own parent.
+  std::vector<Index> parents;
+
+  /// Return the position of a vertex, or the number of vertices if it was not
+  /// reached.
+  size_t find(size_t vertex) const;
+
+public:
+  TraversalTree() = delete;
+
+  /// Create a tree.
+  ///
+  /// \param rootVertex The vertex the search started from.
+  /// \param vertices   The vertices reached, sorted by ID.
+  /// \param parents    The position of the parent of each vertex.
+  TraversalTree(size_t rootVertex, std::vector<Index> vertices,
+                std::vector<Index> parents) :
+      rootVertex(rootVertex), vertices(std::move(vertices)),
+      parents(std::move(parents)) {}
+
+  /// Return the root vertex.
+  size_t getRoot() const { return rootVertex; }
+
+  /// Return true if a vertex was reached by the search.
+  bool isVisited(size_t vertex) const { return find(vertex) != vertices.size(); }
+
+  /// Return the path in the tree from a vertex back to the root vertex, as
+  /// PathSearch::getTreePath() does.
+  ///
+  /// \param vertex A vertex that was reached by the search.
+  ///
+  /// \returns The vertices of the path, starting with vertex and ending with
+  ///          the root.
+  std::vector<size_t> getTreePath(size_t vertex) const;
+
+  /// Return the number of bytes allocated for the tree.
+  size_t numBytes() const {
+    return sizeof(TraversalTree) +
+           (vertices.capacity() + parents.capacity()) * sizeof(Index);
+  }
+};
+
+/// A thread-safe cache of the trees of depth-first searches, keyed by the
+/// root vertex, the direction of the search and the traverse registers
+/// option, with the least recently used trees discarded to keep the cache
+/// within a number of bytes. Searches with avoid points are not cached.
+///
+/// A query from a root vertex whose tree is cached reconstructs its paths
+/// from the tree without searching the graph, so a set of queries that share
+/// a start or finish point only search from it once.
+class TraversalCache {
+public:
+  using Key = std::tuple<size_t, bool, bool>;
+
+private:
+  using Entry = std::pair<Key, std::shared_ptr<const TraversalTree>>;
+
+  mutable std::mutex mutex;
+  size_t maxBytes;
+  size_t numBytes;
+  // The trees, most recently used first.
+  std::list<Entry> entries;
+  std::map<Key, std::list<Entry>::iterator> index;
+
+  size_t evict(size_t limit);
+
+public:
+  TraversalCache() : maxBytes(0), numBytes(0) {}
+
+  /// Return the key of the tree of a search.
+  ///
+  /// \param rootVertex        The vertex the search starts from.
+  /// \param reverse           Whether the search follows in edges.
+  /// \param traverseRegisters Whether the search traverses registers.
+  static Key getKey(size_t rootVertex, bool reverse, bool traverseRegisters) {
+    return Key(rootVertex, reverse, traverseRegisters);
+  }
+
+  /// Return true if trees are cached.
+  bool isEnabled() const;
+
+  /// Set the number of bytes the trees are limited to, discarding the least
+  /// recently used trees to fit, or zero to disable the cache.
+  void setMaxBytes(size_t value);
+
+  /// Return the number of bytes the trees are limited to.
+  size_t getMaxBytes() const;
+
+  /// Return a cached tree, making it the most recently used.
+  ///
+  /// \returns The tree, or nullptr if it is not in the cache.
+  std::shared_ptr<const TraversalTree> get(const Key &key);
+
+  /// Add a tree to the cache, unless it is larger than the limit.
+  ///
+  /// \returns The number of trees discarded to make room for it.
+  size_t insert(const Key &key, std::shared_ptr<const TraversalTree> tree);
+
+  /// Remove all the trees from the cache.
+  void clear();
+
+  /// Return the number of trees in the cache.
+  size_t size() const;
+
+  /// Return the number of bytes of the trees in the cache.
+  size_t getNumBytes() const;
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_TRAVERSAL_CACHE_HPP
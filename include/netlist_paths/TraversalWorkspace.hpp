@@ -0,0 +1,161 @@
+#ifndef NETLIST_PATHS_TRAVERSAL_WORKSPACE_HPP
+#define NETLIST_PATHS_TRAVERSAL_WORKSPACE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/Graph.hpp"
+
+namespace netlist_paths {
+
+/// A set of visited vertices that can be emptied in constant time by
+/// advancing a generation counter, so the same storage can be reused between
+/// searches without clearing it.
+class VisitedSet {
+  std::vector<uint32_t> marks;
+  uint32_t generation;
+
+public:
+  VisitedSet() : generation(0) {}
+
+  /// Empty the set and make sure it can hold a number of vertices.
+  void reset(size_t numVertices) {
+    if (marks.size() < numVertices) {
+      marks.resize(numVertices, 0);
+    }
+    if (++generation == 0) {
+      // The counter has wrapped, so the old marks must be cleared.
+      std::fill(marks.begin(), marks.end(), 0);
+      generation = 1;
+    }
+  }
+
+  /// Return true if a vertex is in the set.
+  bool test(VertexID vertex) const { return marks[vertex] == generation; }
+
+  /// Add a vertex to the set.
+  void set(VertexID vertex) { marks[vertex] = generation; }
+
+  /// Return the number of bytes allocated for the set.
+  size_t numBytes() const { return marks.capacity() * sizeof(uint32_t); }
+};
+
+/// A set of vertices with one bit for each vertex. The vertices in the set are
+/// also listed, so it is emptied in time proportional to its size rather than
+/// to the number of vertices.
+class VertexBitset {
+  std::vector<uint64_t> words;
+  VertexIDVec members;
+
+  static uint64_t getBit(VertexID vertex) { return uint64_t(1) << (vertex & 63); }
+
+public:
+  /// Empty the set and make sure it can hold a number of vertices.
+  void reset(size_t numVertices) {
+    for (auto vertex : members) {
+      words[vertex >> 6] &= ~getBit(vertex);
+    }
+    members.clear();
+    if (words.size() * 64 < numVertices) {
+      words.resize((numVertices + 63) / 64, 0);
+    }
+  }
+
+  /// Return true if a vertex is in the set.
+  bool test(VertexID vertex) const { return words[vertex >> 6] & getBit(vertex); }
+
+  /// Add a vertex to the set.
+  void set(VertexID vertex) {
+    if (!test(vertex)) {
+      words[vertex >> 6] |= getBit(vertex);
+      members.push_back(vertex);
+    }
+  }
+
+  /// Return the number of bytes allocated for the set.
+  size_t numBytes() const {
+    return words.capacity() * sizeof(uint64_t) +
+           members.capacity() * sizeof(VertexID);
+  }
+};
+
+/// The state of graph traversals, held in contiguous buffers indexed by
+/// vertex ID. There is one workspace per thread, which is reused by each
+/// traversal on that thread, so once the buffers have grown to the size of
+/// the graph, traversals do not allocate.
+///
+/// Entries of the vertex-indexed arrays are only meaningful for vertices in
+/// the corresponding visited set, so the arrays are never cleared.
+struct TraversalWorkspace {
+  /// A vertex on a DFS stack with the range of its edges that are yet to be
+  /// examined.
+  struct StackEntry {
+    VertexID vertex;
+    size_t nextEdge;
+    size_t endEdge;
+  };
+
+  // Depth-first and breadth-first searches.
+  VertexBitset avoidPoints;
+  VisitedSet visited;
+  VisitedSet reverseVisited;
+  std::vector<VertexID> parents;
+  std::vector<StackEntry> stack;
+  // The vertices reached by a search of a whole DFS tree, in the order they
+  // were reached.
+  VertexIDVec treeVertices;
+  VertexIDVec frontier;
+  VertexIDVec reverseFrontier;
+  VertexIDVec nextFrontier;
+
+  // The vertices reached by a search for simple paths, numbered in the order
+  // they were reached, and the examined edges between them, as pairs of the
+  // numbers of the target and source.
+  std::vector<CSRGraph::Index> vertexNumbers;
+  std::vector<std::pair<CSRGraph::Index, CSRGraph::Index>> examinedEdges;
+
+  // Searches of the component DAG of a reachability index, indexed by
+  // component.
+  VisitedSet components;
+  std::vector<uint32_t> componentStack;
+  std::vector<uint32_t> componentOrder;
+  std::vector<uint64_t> componentCounts;
+
+  // The vertices of a subgraph selected for export, in the order they were
+  // selected.
+  VisitedSet selected;
+  VertexIDVec selection;
+
+  /// Make sure the vertex-indexed arrays can hold a number of vertices.
+  void resize(size_t numVertices) {
+    if (parents.size() < numVertices) {
+      parents.resize(numVertices);
+      vertexNumbers.resize(numVertices);
+    }
+  }
+
+  /// Return the number of bytes allocated for the buffers.
+  size_t numBytes() const {
+    auto bytes = [](const auto &buffer) {
+      return buffer.capacity() * sizeof(buffer[0]);
+    };
+    return avoidPoints.numBytes() + visited.numBytes() + reverseVisited.numBytes() +
+           bytes(parents) + bytes(stack) + bytes(treeVertices) + bytes(frontier) +
+           bytes(reverseFrontier) + bytes(nextFrontier) + bytes(vertexNumbers) +
+           bytes(examinedEdges) + components.numBytes() + bytes(componentStack) +
+           bytes(componentOrder) + bytes(componentCounts) +
+           selected.numBytes() + bytes(selection);
+  }
+
+  /// Return the workspace of the calling thread.
+  static TraversalWorkspace &get() {
+    thread_local TraversalWorkspace workspace;
+    return workspace;
+  }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_TRAVERSAL_WORKSPACE_HPP
@@ -21,7 +21,7 @@ bool wildcardMatch(const char *text, const char *pattern) {
         return true;
       }
       // Try matching the * against the next largest suffix of the text.
-      if (wildcardMatch(text+1, pattern)) {
+      if (*text != '\0' && wildcardMatch(text+1, pattern)) {
         return true;
       }
       // No matches.
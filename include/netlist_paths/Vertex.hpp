@@ -1,10 +1,11 @@
 #ifndef NETLIST_PATHS_VERTEX_HPP
 #define NETLIST_PATHS_VERTEX_HPP
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_set>
-#include <boost/algorithm/string.hpp>
 #include "netlist_paths/Location.hpp"
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Options.hpp"
@@ -169,21 +170,36 @@ inline const char *getVertexDirectionStr(VertexDirection direction) {
 // Vertex
 //===----------------------------------------------------------------------===//
 
+/// The tables that the vertices of a graph refer to by index, which are owned
+/// by the graph.
+struct VertexTables {
+  FileTable files;
+  DTypeTable dtypes;
+};
+
 /// A class representing a vertex in the netlist graph.
+///
+/// The name and parameter value of a vertex are views of strings interned in
+/// the StringPool of the graph that owns it, so vertices sharing a name share
+/// its storage and copying a vertex does not copy its strings. The file of
+/// its location and its data type are resolved through the tables of the
+/// graph.
 class Vertex {
   VertexAstType astType;
   VertexDirection direction;
   Location location;
-  std::shared_ptr<DType> dtype;
-  std::string name;
+  uint32_t dtype;
+  const VertexTables *tables;
+  std::string_view name;
+  std::string_view paramValue;
   bool isParam;
-  std::string paramValue;
   bool publicVisibility;
   bool top;
+  bool ignore;
   bool deleted;
 
 public:
-  Vertex() {}
+  Vertex() : dtype(DTypeTable::NO_DTYPE), tables(nullptr) {}
 
   /// Construct a logic vertex.
   ///
@@ -194,9 +210,12 @@ public:
       astType(type),
       direction(VertexDirection::NONE),
       location(location),
+      dtype(DTypeTable::NO_DTYPE),
+      tables(nullptr),
       isParam(false),
       publicVisibility(false),
       top(false),
+      ignore(false),
       deleted(false) {}
 
   /// Construct a variable vertex.
@@ -204,28 +223,33 @@ public:
   /// \param type             The AST type of the variable.
   /// \param direction        The direction of the variable type.
   /// \param location         The source location of the variable declaration.
-  /// \param dtype            The data type of the variable.
-  /// \param name             The name of the variable.
+  /// \param dtype            The index of the data type of the variable in
+  ///                         the DTypeTable of the graph.
+  /// \param name             The name of the variable, which must outlive
+  ///                         the vertex.
   /// \param isParam          A flag indicating the variable is a parameter.
-  /// \param paramValue       The value of the parameter variable.
+  /// \param paramValue       The value of the parameter variable, which must
+  ///                         outlive the vertex.
   /// \param publicVisibility A flag indicating the variable has public visibility.
   Vertex(VertexAstType type,
          VertexDirection direction,
          Location location,
-         std::shared_ptr<DType> dtype,
-         const std::string &name,
+         uint32_t dtype,
+         std::string_view name,
          bool isParam,
-         const std::string &paramValue,
+         std::string_view paramValue,
          bool publicVisibility) :
       astType(type),
       direction(direction),
       location(location),
       dtype(dtype),
+      tables(nullptr),
       name(name),
-      isParam(isParam),
       paramValue(paramValue),
+      isParam(isParam),
       publicVisibility(publicVisibility),
       top(determineIsTop(name)),
+      ignore(determineCanIgnore(name)),
       deleted(false) {}
 
   /// Copy constructor.
@@ -234,9 +258,13 @@ public:
       direction(v.direction),
       location(v.location),
       dtype(v.dtype),
+      tables(v.tables),
       name(v.name),
+      paramValue(v.paramValue),
       isParam(v.isParam),
+      publicVisibility(v.publicVisibility),
       top(v.top),
+      ignore(v.ignore),
       deleted(v.deleted) {}
 
   /// Return whether a variable name is in the top scope.
@@ -248,19 +276,28 @@ public:
   /// \param name The name of a variable.
   ///
   /// \returns Whether the variable is in the top scope.
-  static bool determineIsTop(const std::string &name) {
-    std::vector<std::string> tokens;
-    boost::split(tokens, name, boost::is_any_of("."));
-    return tokens.size() < 3;
+  static bool determineIsTop(std::string_view name) {
+    return std::count(name.begin(), name.end(), '.') < 2;
+  }
+
+  /// Return whether a variable has been introduced by Verilator.
+  ///
+  /// \param name The name of a variable.
+  ///
+  /// \returns Whether the variable can be ignored.
+  static bool determineCanIgnore(std::string_view name) {
+    return name.find("__Vdly") != std::string_view::npos ||
+           name.find("__Vcell") != std::string_view::npos ||
+           name.find("__Vconc") != std::string_view::npos ||
+           name.find("__Vfunc") != std::string_view::npos;
   }
 
   /// Given a hierarchical variable name, eg a.b.c, return the last component c.
   ///
   /// \returns The last heirarchical component of a variable name.
   std::string getBasename() const {
-    std::vector<std::string> tokens;
-    boost::split(tokens, name, boost::is_any_of("."));
-    return tokens.back();
+    auto pos = name.rfind('.');
+    return std::string(pos == std::string_view::npos ? name : name.substr(pos + 1));
   }
 
   /// Match this vertex against different graph types.
@@ -405,8 +442,11 @@ public:
   }
 
   /// Return true if the vertex is a valid start point for a path.
-  inline bool isStartPoint() const {
-    if (Options::getInstance().isRestrictStartPoints()) {
+  ///
+  /// \param restrictStartPoints Whether paths must start on top-level ports
+  ///                            or registers.
+  inline bool isStartPoint(bool restrictStartPoints) const {
+    if (restrictStartPoints) {
       return isCombStartPoint();
     } else {
       // Otherwise, a start point can be any non-destination vertex that is not
@@ -415,9 +455,18 @@ public:
     }
   }
 
+  /// Return true if the vertex is a valid start point for a path, with the
+  /// current options.
+  inline bool isStartPoint() const {
+    return isStartPoint(Options::getInstance().isRestrictStartPoints());
+  }
+
   /// Return true if the vertex is a valid end point for a path.
-  inline bool isEndPoint() const {
-    if (Options::getInstance().isRestrictEndPoints()) {
+  ///
+  /// \param restrictEndPoints Whether paths must end on top-level ports or
+  ///                          registers.
+  inline bool isEndPoint(bool restrictEndPoints) const {
+    if (restrictEndPoints) {
       return isCombEndPoint();
     } else {
       // Otherwise, an end point can be any non-destination vertex that is not
@@ -426,9 +475,17 @@ public:
     }
   }
 
+  /// Return true if the vertex is a valid end point for a path, with the
+  /// current options.
+  inline bool isEndPoint() const {
+    return isEndPoint(Options::getInstance().isRestrictEndPoints());
+  }
+
   /// Return true if the vertex is a valid mid point for a path.
-  inline bool isMidPoint() const {
-    if (Options::getInstance().shouldTraverseRegisters()) {
+  ///
+  /// \param traverseRegisters Whether paths can traverse registers.
+  inline bool isMidPoint(bool traverseRegisters) const {
+    if (traverseRegisters) {
       // Any node is a valid mid point if registers are traversed.
       return isNamed();
     } else {
@@ -438,18 +495,15 @@ public:
     }
   }
 
-  /// Return true if the vertex has been introduced by Verilator.
-  inline bool canIgnore() const {
-    if (!name.empty()) {
-      return name.find("__Vdly") != std::string::npos ||
-             name.find("__Vcell") != std::string::npos ||
-             name.find("__Vconc") != std::string::npos ||
-             name.find("__Vfunc") != std::string::npos;
-    } else {
-      return false;
-    }
+  /// Return true if the vertex is a valid mid point for a path, with the
+  /// current options.
+  inline bool isMidPoint() const {
+    return isMidPoint(Options::getInstance().shouldTraverseRegisters());
   }
 
+  /// Return true if the vertex has been introduced by Verilator.
+  inline bool canIgnore() const { return ignore; }
+
   /// Return true if the vertex has a name, ie is a variable of some description.
   inline bool isNamed() const {
     return !isLogic() &&
@@ -476,21 +530,41 @@ public:
   void setSrcRegAlias() { astType = VertexAstType::SRC_REG_ALIAS; }
   void setDstRegAlias() { astType = VertexAstType::DST_REG_ALIAS; }
   void setDirection(VertexDirection dir) { direction = dir; }
+  void setDType(uint32_t dt) { dtype = dt; }
+  void setTables(const VertexTables *t) { tables = t; }
 
   VertexAstType getAstType() const { return astType; }
   VertexDirection getDirection() const { return direction; }
-  size_t getDTypeWidth() const { return dtype != nullptr ? dtype->getWidth() : 0; }
+  size_t getDTypeWidth() const {
+    return dtype != DTypeTable::NO_DTYPE ? getTables().dtypes.get(dtype).getWidth() : 0;
+  }
   DType *getDTypePtr() const {
+    if (dtype == DTypeTable::NO_DTYPE) {
+      return nullptr;
+    }
     // Remove the const cast to make it compatible with the boost::python wrappers.
-    return const_cast<DType*>(dtype.get());
+    return const_cast<DType*>(getTables().dtypes.get(dtype).getDType().get());
   }
-  const std::string getName() const { return name; }
+  std::string_view getName() const { return name; }
+  std::string_view getParamValue() const { return paramValue; }
+  const Location &getLocation() const { return location; }
+  uint32_t getDType() const { return dtype; }
   const std::string getAstTypeStr() const { return getVertexAstTypeStr(astType); }
   const std::string getSimpleAstTypeStr() const { return getSimpleVertexAstTypeStr(astType); }
   const std::string getDirStr() const { return getVertexDirectionStr(direction); }
-  const std::string getDTypeStr() const { return dtype != nullptr ? dtype->toString() : "-"; }
-  const std::string getLocationStr() const { return location.getLocationStr(); }
+  const std::string &getDTypeStr() const {
+    static const std::string noDType("-");
+    return dtype != DTypeTable::NO_DTYPE ? getTables().dtypes.get(dtype).getStr() : noDType;
+  }
+  const std::string getLocationStr() const { return location.getLocationStr(getTables().files); }
   bool isDeleted() const { return deleted; }
+
+  /// Return the tables of the graph of the vertex, or empty tables if it has
+  /// not been added to a graph.
+  const VertexTables &getTables() const {
+    static const VertexTables noTables;
+    return tables != nullptr ? *tables : noTables;
+  }
 };
 
 } // End netlist_paths namespace.
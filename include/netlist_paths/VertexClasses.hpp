@@ -0,0 +1,103 @@
+#ifndef NETLIST_PATHS_VERTEX_CLASSES_HPP
+#define NETLIST_PATHS_VERTEX_CLASSES_HPP
+
+#include <cstdint>
+#include <vector>
+#include "netlist_paths/Options.hpp"
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+/// A set of vertices, represented both as a dense bitset for membership tests
+/// and as a list of vertex IDs in ascending order for iteration.
+class VertexSet {
+  std::vector<uint64_t> bits;
+  std::vector<size_t> vertices;
+
+public:
+  VertexSet() {}
+
+  /// Create an empty set with capacity for a number of vertices.
+  VertexSet(size_t numVertices) : bits((numVertices + 63) / 64, 0) {}
+
+  /// Add a vertex to the set, where vertices must be added in ascending order.
+  void add(size_t vertex) {
+    bits[vertex / 64] |= uint64_t(1) << (vertex % 64);
+    vertices.push_back(vertex);
+  }
+
+  /// Return true if the set contains a vertex.
+  bool test(size_t vertex) const {
+    return (bits[vertex / 64] >> (vertex % 64)) & 1;
+  }
+
+  /// Return the vertices of the set in ascending order.
+  const std::vector<size_t> &getVertices() const { return vertices; }
+
+  /// Return the number of vertices in the set.
+  size_t size() const { return vertices.size(); }
+};
+
+/// Classifications of the vertices of a graph, matching each
+/// VertexNetlistType. The classes are computed once the graph is complete,
+/// rather than evaluating the vertex predicates on every query. The start,
+/// end and mid-point classes depend on the restrictStartPoints,
+/// restrictEndPoints and traverseRegisters options, so they are kept for both
+/// settings of the option and selected by the options of each query.
+class VertexClasses {
+  std::vector<VertexSet> classes;
+
+  /// Return the index of a class for particular option settings.
+  static size_t getIndex(VertexNetlistType type,
+                         bool restrictStartPoints,
+                         bool restrictEndPoints,
+                         bool traverseRegisters);
+
+  /// Return the index of a class for the options of a query.
+  static size_t getIndex(VertexNetlistType type, const QueryOptions &options) {
+    return getIndex(type,
+                    options.isRestrictStartPoints(),
+                    options.isRestrictEndPoints(),
+                    options.shouldTraverseRegisters());
+  }
+
+public:
+  VertexClasses() {}
+
+  /// Classify the vertices of a graph.
+  ///
+  /// \param vertices Pointers to all the vertices of a graph, indexed by
+  ///                 vertex ID.
+  void build(const std::vector<const Vertex*> &vertices);
+
+  /// Remove all the classes.
+  void clear() { classes.clear(); }
+
+  /// Return the set of vertices of a type.
+  ///
+  /// \param type    The type of vertices.
+  /// \param options The options of the query.
+  ///
+  /// \returns A reference to the set of vertices.
+  const VertexSet &get(VertexNetlistType type,
+                       const QueryOptions &options) const {
+    return classes[getIndex(type, options)];
+  }
+
+  /// Return true if a vertex is of a type, given the options of a query.
+  bool test(size_t vertex, VertexNetlistType type,
+            const QueryOptions &options) const {
+    return get(type, options).test(vertex);
+  }
+
+  /// Return the vertices of a type in ascending order, given the options of a
+  /// query.
+  const std::vector<size_t> &getVertices(VertexNetlistType type,
+                                         const QueryOptions &options) const {
+    return get(type, options).getVertices();
+  }
+};
+
+} // End namespace.
+
+#endif // NETLIST_PATHS_VERTEX_CLASSES_HPP
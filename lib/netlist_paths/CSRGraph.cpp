@@ -0,0 +1,40 @@
+#include <boost/range/iterator_range.hpp>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/Graph.hpp"
+
+using namespace netlist_paths;
+
+template<typename Graph>
+void CSRGraph::build(const Graph &graph) {
+  clear();
+  auto numVertices = boost::num_vertices(graph);
+  auto numEdges = boost::num_edges(graph);
+  if (numVertices > UINT32_MAX) {
+    throw Exception("graph has too many vertices");
+  }
+  for (auto *adjacency : {&outEdges, &inEdges}) {
+    adjacency->offsets.reserve(numVertices + 1);
+    adjacency->vertices.reserve(numEdges);
+    adjacency->throughRegister.assign((numEdges + 63) / 64, 0);
+    adjacency->offsets.push_back(0);
+  }
+  for (size_t v = 0; v < numVertices; ++v) {
+    for (auto edge : boost::make_iterator_range(boost::out_edges(v, graph))) {
+      if (graph[edge].isThroughRegister()) {
+        outEdges.setThroughRegister(outEdges.vertices.size());
+      }
+      outEdges.vertices.push_back(static_cast<Index>(boost::target(edge, graph)));
+    }
+    outEdges.offsets.push_back(outEdges.vertices.size());
+    for (auto edge : boost::make_iterator_range(boost::in_edges(v, graph))) {
+      if (graph[edge].isThroughRegister()) {
+        inEdges.setThroughRegister(inEdges.vertices.size());
+      }
+      inEdges.vertices.push_back(static_cast<Index>(boost::source(edge, graph)));
+    }
+    inEdges.offsets.push_back(inEdges.vertices.size());
+  }
+}
+
+template void CSRGraph::build<InternalGraph>(const InternalGraph &graph);
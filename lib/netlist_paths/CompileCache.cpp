@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+#include "netlist_paths/CompileCache.hpp"
+
+namespace fs = boost::filesystem;
+
+using namespace netlist_paths;
+
+namespace {
+
+/// The extensions of the files of a cache entry.
+const char *XML_EXTENSION = ".xml";
+const char *MANIFEST_EXTENSION = ".deps";
+const char *SNAPSHOT_EXTENSION = ".snapshot";
+
+/// A 128-bit hash of a sequence of bytes, as two independent 64-bit
+/// multiplicative hashes.
+class ContentHash {
+  uint64_t a;
+  uint64_t b;
+
+public:
+  ContentHash() : a(0xcbf29ce484222325), b(0x84222325cbf29ce4) {}
+
+  void add(const char *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      auto byte = static_cast<unsigned char>(data[i]);
+      a = (a ^ byte) * 0x100000001b3;
+      b = (b ^ byte) * 0x9e3779b97f4a7c15;
+      b ^= b >> 29;
+    }
+  }
+
+  /// Add a string, preceded by its length so the boundaries of consecutive
+  /// strings are part of the hash.
+  void add(const std::string &value) {
+    uint64_t size = value.size();
+    add(reinterpret_cast<const char*>(&size), sizeof(size));
+    add(value.data(), value.size());
+  }
+
+  /// Add the contents of a file, returning false if it cannot be read.
+  bool addFile(const fs::path &path) {
+    std::ifstream file(path.string(), std::ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+    char buffer[1 << 16];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+      add(buffer, file.gcount());
+    }
+    return !file.bad();
+  }
+
+  /// Return the hash as 32 hexadecimal digits.
+  std::string getDigest() const {
+    return (boost::format("%016x%016x") % a % b).str();
+  }
+};
+
+/// Return the hash of the contents of a file, or an empty string if it
+/// cannot be read.
+std::string hashFile(const fs::path &path) {
+  ContentHash hash;
+  return hash.addFile(path) ? hash.getDigest() : std::string();
+}
+
+/// Return the paths of the source files listed at the start of a Verilator
+/// XML netlist, which are all the files that were read to produce it.
+std::vector<fs::path> readSourceFiles(const std::string &xmlFile) {
+  std::vector<fs::path> paths;
+  std::ifstream file(xmlFile);
+  std::regex filenameRegex("<file [^>]*filename=\"([^\"]*)\"");
+  std::string line;
+  while (std::getline(file, line)) {
+    std::smatch match;
+    if (std::regex_search(line, match, filenameRegex)) {
+      std::string filename = match[1];
+      // Skip the pseudo files, such as <built-in> and <command-line>.
+      if (filename.rfind("&lt;", 0) == 0) {
+        continue;
+      }
+      for (auto entity : {std::make_pair("&quot;", "\""),
+                          std::make_pair("&apos;", "'"),
+                          std::make_pair("&amp;", "&")}) {
+        size_t position = 0;
+        while ((position = filename.find(entity.first, position)) != std::string::npos) {
+          filename.replace(position, std::strlen(entity.first), entity.second);
+          position += 1;
+        }
+      }
+      paths.push_back(fs::absolute(filename));
+    } else if (line.find("</files>") != std::string::npos ||
+               line.find("<netlist>") != std::string::npos) {
+      break;
+    }
+  }
+  return paths;
+}
+
+/// Mark a file as recently used.
+void touch(const fs::path &path) {
+  boost::system::error_code error;
+  fs::last_write_time(path, std::time(nullptr), error);
+}
+
+} // End anonymous namespace.
+
+CompileCache::CompileCache(const std::string &directory, uintmax_t maxBytes) :
+    directory(directory), maxBytes(maxBytes) {
+  fs::create_directories(this->directory);
+}
+
+fs::path CompileCache::getPath(const std::string &key,
+                               const std::string &extension) const {
+  return directory / (key + extension);
+}
+
+std::string CompileCache::getKey(const std::string &verilatorVersion,
+                                 const std::vector<std::string> &args,
+                                 const std::vector<std::string> &inputFiles) {
+  ContentHash hash;
+  hash.add(verilatorVersion);
+  for (auto &arg : args) {
+    hash.add(arg);
+  }
+  for (auto &inputFile : inputFiles) {
+    hash.add(fs::absolute(inputFile).string());
+    hash.add(hashFile(inputFile));
+  }
+  return hash.getDigest();
+}
+
+bool CompileCache::isValid(const std::string &key) const {
+  std::ifstream manifest(getPath(key, MANIFEST_EXTENSION).string());
+  if (!manifest.is_open() || !fs::exists(getPath(key, XML_EXTENSION))) {
+    return false;
+  }
+  // Each line of the manifest is the hash of a file followed by its path.
+  std::string line;
+  while (std::getline(manifest, line)) {
+    auto separator = line.find(' ');
+    if (separator == std::string::npos ||
+        hashFile(line.substr(separator + 1)) != line.substr(0, separator)) {
+      BOOST_LOG_TRIVIAL(info) << "Cached compilation " << key << " is out of date";
+      return false;
+    }
+  }
+  return true;
+}
+
+fs::path CompileCache::findXML(const std::string &key) const {
+  if (!isValid(key)) {
+    return fs::path();
+  }
+  auto path = getPath(key, XML_EXTENSION);
+  touch(path);
+  return path;
+}
+
+fs::path CompileCache::findSnapshot(const std::string &key) const {
+  auto path = getPath(key, SNAPSHOT_EXTENSION);
+  if (!fs::exists(path) || !isValid(key)) {
+    return fs::path();
+  }
+  touch(path);
+  return path;
+}
+
+void CompileCache::insertFile(const std::string &key,
+                              const std::string &extension,
+                              const std::string &filename) const {
+  auto temporaryPath = directory / fs::unique_path(key + ".tmp-%%%%-%%%%-%%%%");
+  fs::copy_file(filename, temporaryPath);
+  fs::rename(temporaryPath, getPath(key, extension));
+}
+
+void CompileCache::insertXML(const std::string &key,
+                             const std::string &xmlFile) const {
+  auto sourceFiles = readSourceFiles(xmlFile);
+  auto manifestPath = directory / fs::unique_path(key + ".tmp-%%%%-%%%%-%%%%");
+  {
+    std::ofstream manifest(manifestPath.string());
+    for (auto &path : sourceFiles) {
+      auto digest = hashFile(path);
+      if (digest.empty()) {
+        // The manifest would be incomplete.
+        manifest.close();
+        fs::remove(manifestPath);
+        return;
+      }
+      manifest << digest << " " << path.string() << "\n";
+    }
+  }
+  // Replacing the manifest invalidates any snapshot of an earlier entry.
+  fs::remove(getPath(key, SNAPSHOT_EXTENSION));
+  fs::rename(manifestPath, getPath(key, MANIFEST_EXTENSION));
+  insertFile(key, XML_EXTENSION, xmlFile);
+}
+
+void CompileCache::insertSnapshot(const std::string &key,
+                                  const std::string &snapshotFile) const {
+  insertFile(key, SNAPSHOT_EXTENSION, snapshotFile);
+}
+
+void CompileCache::evict() const {
+  if (maxBytes == 0) {
+    return;
+  }
+  // Total the sizes of the files of each entry and find when each was last
+  // used.
+  struct Entry {
+    uintmax_t bytes;
+    std::time_t lastUsed;
+  };
+  std::map<std::string, Entry> entries;
+  uintmax_t totalBytes = 0;
+  for (auto &file : fs::directory_iterator(directory)) {
+    auto extension = file.path().extension().string();
+    if (extension != XML_EXTENSION && extension != MANIFEST_EXTENSION &&
+        extension != SNAPSHOT_EXTENSION) {
+      continue;
+    }
+    boost::system::error_code error;
+    auto bytes = fs::file_size(file.path(), error);
+    auto lastUsed = fs::last_write_time(file.path(), error);
+    if (error) {
+      // Removed by another process.
+      continue;
+    }
+    auto &entry = entries.emplace(file.path().stem().string(), Entry{0, 0}).first->second;
+    entry.bytes += bytes;
+    entry.lastUsed = std::max(entry.lastUsed, lastUsed);
+    totalBytes += bytes;
+  }
+  if (totalBytes <= maxBytes) {
+    return;
+  }
+  std::vector<std::pair<std::time_t, std::string>> order;
+  for (auto &entry : entries) {
+    order.emplace_back(entry.second.lastUsed, entry.first);
+  }
+  std::sort(order.begin(), order.end());
+  // Keep the most recently used entry, even if it exceeds the limit alone.
+  order.pop_back();
+  for (auto &entry : order) {
+    if (totalBytes <= maxBytes) {
+      break;
+    }
+    BOOST_LOG_TRIVIAL(info) << "Evicting cached compilation " << entry.second;
+    boost::system::error_code error;
+    for (auto extension : {XML_EXTENSION, MANIFEST_EXTENSION, SNAPSHOT_EXTENSION}) {
+      fs::remove(getPath(entry.second, extension), error);
+    }
+    totalBytes -= entries[entry.second].bytes;
+  }
+}
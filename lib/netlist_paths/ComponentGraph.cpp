@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <limits>
+#include <boost/log/trivial.hpp>
+#include "netlist_paths/ComponentGraph.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+constexpr ComponentGraph::Index UNVISITED =
+    std::numeric_limits<ComponentGraph::Index>::max();
+
+/// Return true if an edge is followed with a setting of traverse registers.
+inline bool isFollowed(const CSRGraph::Adjacency &edges, size_t edge,
+                       bool traverseRegisters) {
+  return traverseRegisters || !edges.isThroughRegister(edge);
+}
+
+} // End anonymous namespace.
+
+/// Number the strongly-connected components of the graph with an iterative
+/// version of Tarjan's algorithm, which completes the components in reverse
+/// topological order.
+void ComponentGraph::buildComponents(const CSRGraph &graph) {
+  struct Frame {
+    Index vertex;
+    size_t nextEdge;
+    size_t endEdge;
+  };
+  auto &edges = graph.getOutEdges();
+  auto numVertices = graph.numVertices();
+  std::vector<Index> order(numVertices, UNVISITED);
+  std::vector<Index> lowLink(numVertices);
+  std::vector<Index> stack;
+  std::vector<Frame> frames;
+  Index counter = 0;
+  Index numComponents = 0;
+  components.assign(numVertices, UNVISITED);
+  auto visit = [&](Index vertex) {
+    order[vertex] = lowLink[vertex] = counter++;
+    stack.push_back(vertex);
+    auto range = edges.getEdges(vertex);
+    frames.push_back({vertex, range.first, range.second});
+  };
+  for (size_t root = 0; root < numVertices; ++root) {
+    if (order[root] != UNVISITED) {
+      continue;
+    }
+    visit(static_cast<Index>(root));
+    while (!frames.empty()) {
+      auto &top = frames.back();
+      auto vertex = top.vertex;
+      if (top.nextEdge != top.endEdge) {
+        auto edge = top.nextEdge++;
+        if (!isFollowed(edges, edge, traverseRegisters)) {
+          continue;
+        }
+        auto target = static_cast<Index>(edges.getVertex(edge));
+        if (order[target] == UNVISITED) {
+          visit(target);
+        } else if (components[target] == UNVISITED) {
+          // The target is on the stack.
+          lowLink[vertex] = std::min(lowLink[vertex], order[target]);
+        }
+        continue;
+      }
+      frames.pop_back();
+      if (lowLink[vertex] == order[vertex]) {
+        Index member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          components[member] = numComponents;
+        } while (member != vertex);
+        ++numComponents;
+      }
+      if (!frames.empty()) {
+        auto parent = frames.back().vertex;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[vertex]);
+      }
+    }
+  }
+  componentCount = numComponents;
+}
+
+/// Group the vertices by component.
+void ComponentGraph::buildMembers() {
+  auto numVertices = components.size();
+  memberOffsets.assign(componentCount + 1, 0);
+  for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+    ++memberOffsets[components[vertex] + 1];
+  }
+  for (size_t c = 0; c < componentCount; ++c) {
+    memberOffsets[c + 1] += memberOffsets[c];
+  }
+  members.resize(numVertices);
+  auto next = memberOffsets;
+  for (size_t vertex = 0; vertex < numVertices; ++vertex) {
+    members[next[components[vertex]]++] = static_cast<Index>(vertex);
+  }
+}
+
+/// Build the forward and reverse adjacency of the condensed DAG, without
+/// duplicate edges.
+void ComponentGraph::buildDAG(const CSRGraph &graph) {
+  auto &edges = graph.getOutEdges();
+  // Collect the distinct out edges of each component.
+  std::vector<Index> lastSource(componentCount, UNVISITED);
+  outOffsets.assign(componentCount + 1, 0);
+  outComponents.clear();
+  for (size_t c = 0; c < componentCount; ++c) {
+    for (auto i = memberOffsets[c]; i != memberOffsets[c + 1]; ++i) {
+      auto range = edges.getEdges(members[i]);
+      for (auto edge = range.first; edge != range.second; ++edge) {
+        if (!isFollowed(edges, edge, traverseRegisters)) {
+          continue;
+        }
+        auto target = components[edges.getVertex(edge)];
+        if (target != c && lastSource[target] != c) {
+          lastSource[target] = static_cast<Index>(c);
+          outComponents.push_back(target);
+        }
+      }
+    }
+    outOffsets[c + 1] = outComponents.size();
+  }
+  // Reverse the edges.
+  inOffsets.assign(componentCount + 1, 0);
+  for (auto target : outComponents) {
+    ++inOffsets[target + 1];
+  }
+  for (size_t c = 0; c < componentCount; ++c) {
+    inOffsets[c + 1] += inOffsets[c];
+  }
+  inComponents.resize(outComponents.size());
+  auto next = inOffsets;
+  for (size_t c = 0; c < componentCount; ++c) {
+    for (auto i = outOffsets[c]; i != outOffsets[c + 1]; ++i) {
+      inComponents[next[outComponents[i]]++] = static_cast<Index>(c);
+    }
+  }
+}
+
+void ComponentGraph::build(const CSRGraph &graph, bool traverseRegisters) {
+  clear();
+  this->traverseRegisters = traverseRegisters;
+  buildComponents(graph);
+  buildMembers();
+  buildDAG(graph);
+  BOOST_LOG_TRIVIAL(info) << "Component graph"
+                          << (traverseRegisters ? " traversing registers" : "")
+                          << " has " << numComponents() << " components and "
+                          << numEdges() << " edges";
+}
+
+void ComponentGraph::clear() {
+  components.clear();
+  outOffsets.clear();
+  outComponents.clear();
+  inOffsets.clear();
+  inComponents.clear();
+  memberOffsets.clear();
+  members.clear();
+  componentCount = 0;
+  traverseRegisters = false;
+}
+
+bool ComponentGraph::isCycle(const CSRGraph &graph, Index component) const {
+  auto range = getMembers(component);
+  if (range.second - range.first > 1) {
+    return true;
+  }
+  auto vertex = *range.first;
+  auto &edges = graph.getOutEdges();
+  auto edgeRange = edges.getEdges(vertex);
+  for (auto edge = edgeRange.first; edge != edgeRange.second; ++edge) {
+    if (edges.getVertex(edge) == vertex &&
+        isFollowed(edges, edge, traverseRegisters)) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,447 @@
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/algorithm/string/predicate.hpp>
+#include <zlib.h>
+#ifdef NETLIST_PATHS_ZSTD
+#include <zstd.h>
+#endif
+#include "netlist_paths/Compression.hpp"
+#include "netlist_paths/Exception.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+/// The size of the chunks files are read, decompressed and compressed in.
+constexpr size_t CHUNK_SIZE = 1 << 20;
+
+/// The number of chunks of decompressed data that can be held for the reader
+/// of a file, which bounds how far decompression runs ahead of parsing.
+constexpr size_t MAX_CHUNKS = 4;
+
+//===----------------------------------------------------------------------===//
+// Decoders and encoders
+//===----------------------------------------------------------------------===//
+
+/// A gzip or zlib decoder, which also reads files of concatenated gzip
+/// members.
+class GzipDecoder {
+  z_stream stream;
+  bool finished;
+
+public:
+  GzipDecoder() : finished(false) {
+    std::memset(&stream, 0, sizeof(stream));
+    // Detect the gzip or zlib header.
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+      throw Exception("could not initialise gzip decompression");
+    }
+  }
+
+  ~GzipDecoder() { inflateEnd(&stream); }
+
+  /// Decompress input into a buffer, advancing the positions of both.
+  void step(const char *&in, const char *inEnd, char *&out, char *outEnd) {
+    if (finished) {
+      if (in == inEnd) {
+        return;
+      }
+      // Start the next member.
+      inflateReset(&stream);
+      finished = false;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+    stream.avail_in = static_cast<uInt>(inEnd - in);
+    stream.next_out = reinterpret_cast<Bytef*>(out);
+    stream.avail_out = static_cast<uInt>(outEnd - out);
+    auto status = inflate(&stream, Z_NO_FLUSH);
+    in = inEnd - stream.avail_in;
+    out = outEnd - stream.avail_out;
+    if (status == Z_STREAM_END) {
+      finished = true;
+    } else if (status != Z_OK && status != Z_BUF_ERROR) {
+      throw Exception(std::string("invalid gzip data: ") +
+                      (stream.msg ? stream.msg : "unknown error"));
+    }
+  }
+
+  /// Return true if the decompressed data is complete.
+  bool isFinished() const { return finished; }
+};
+
+/// A gzip encoder.
+class GzipEncoder {
+  z_stream stream;
+
+public:
+  GzipEncoder() {
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw Exception("could not initialise gzip compression");
+    }
+  }
+
+  ~GzipEncoder() { deflateEnd(&stream); }
+
+  /// Compress input into a buffer, advancing the positions of both.
+  ///
+  /// \returns True once all the input has been compressed, after the last
+  ///          input has been given with finish set.
+  bool step(const char *&in, const char *inEnd, char *&out, char *outEnd,
+            bool finish) {
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+    stream.avail_in = static_cast<uInt>(inEnd - in);
+    stream.next_out = reinterpret_cast<Bytef*>(out);
+    stream.avail_out = static_cast<uInt>(outEnd - out);
+    auto status = deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+    in = inEnd - stream.avail_in;
+    out = outEnd - stream.avail_out;
+    if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+      throw Exception("could not compress gzip data");
+    }
+    return status == Z_STREAM_END;
+  }
+};
+
+#ifdef NETLIST_PATHS_ZSTD
+
+/// A Zstandard decoder, which also reads files of concatenated frames.
+class ZstdDecoder {
+  ZSTD_DStream *stream;
+  size_t remaining;
+
+public:
+  ZstdDecoder() : stream(ZSTD_createDStream()), remaining(0) {
+    if (!stream) {
+      throw Exception("could not initialise zstd decompression");
+    }
+  }
+
+  ~ZstdDecoder() { ZSTD_freeDStream(stream); }
+
+  void step(const char *&in, const char *inEnd, char *&out, char *outEnd) {
+    ZSTD_inBuffer input = {in, static_cast<size_t>(inEnd - in), 0};
+    ZSTD_outBuffer output = {out, static_cast<size_t>(outEnd - out), 0};
+    remaining = ZSTD_decompressStream(stream, &output, &input);
+    if (ZSTD_isError(remaining)) {
+      throw Exception(std::string("invalid zstd data: ") +
+                      ZSTD_getErrorName(remaining));
+    }
+    in += input.pos;
+    out += output.pos;
+  }
+
+  bool isFinished() const { return remaining == 0; }
+};
+
+/// A Zstandard encoder.
+class ZstdEncoder {
+  ZSTD_CCtx *context;
+
+public:
+  ZstdEncoder() : context(ZSTD_createCCtx()) {
+    if (!context) {
+      throw Exception("could not initialise zstd compression");
+    }
+  }
+
+  ~ZstdEncoder() { ZSTD_freeCCtx(context); }
+
+  bool step(const char *&in, const char *inEnd, char *&out, char *outEnd,
+            bool finish) {
+    ZSTD_inBuffer input = {in, static_cast<size_t>(inEnd - in), 0};
+    ZSTD_outBuffer output = {out, static_cast<size_t>(outEnd - out), 0};
+    auto remaining = ZSTD_compressStream2(context, &output, &input,
+                                          finish ? ZSTD_e_end : ZSTD_e_continue);
+    if (ZSTD_isError(remaining)) {
+      throw Exception(std::string("could not compress zstd data: ") +
+                      ZSTD_getErrorName(remaining));
+    }
+    in += input.pos;
+    out += output.pos;
+    return finish && remaining == 0;
+  }
+};
+
+#endif
+
+//===----------------------------------------------------------------------===//
+// DecompressingBuffer
+//===----------------------------------------------------------------------===//
+
+/// A stream buffer of the decompressed contents of a file, which a
+/// background thread decompresses into chunks. The thread waits for the
+/// reader once MAX_CHUNKS are filled, and the chunks are reused once they
+/// have been read.
+class DecompressingBuffer : public std::streambuf {
+  std::mutex mutex;
+  // Signalled when a chunk is filled or the decompression finishes.
+  std::condition_variable filledCondition;
+  // Signalled when a chunk is read or the reader stops.
+  std::condition_variable emptyCondition;
+  std::deque<std::vector<char>> filledChunks;
+  std::vector<std::vector<char>> emptyChunks;
+  size_t numChunks;
+  std::vector<char> current;
+  bool hasCurrent;
+  bool finished;
+  bool stopped;
+  std::exception_ptr error;
+  std::thread thread;
+
+  /// Take an empty chunk to fill, waiting for one to be read if all of them
+  /// are in use.
+  ///
+  /// \returns False if the reader has stopped.
+  bool acquire(std::vector<char> &chunk) {
+    std::unique_lock<std::mutex> lock(mutex);
+    emptyCondition.wait(lock, [this] {
+      return stopped || !emptyChunks.empty() || numChunks < MAX_CHUNKS;
+    });
+    if (stopped) {
+      return false;
+    }
+    if (emptyChunks.empty()) {
+      ++numChunks;
+      chunk = std::vector<char>();
+    } else {
+      chunk = std::move(emptyChunks.back());
+      emptyChunks.pop_back();
+    }
+    chunk.resize(CHUNK_SIZE);
+    return true;
+  }
+
+  /// Pass a filled chunk to the reader.
+  void release(std::vector<char> &chunk, size_t size) {
+    chunk.resize(size);
+    std::lock_guard<std::mutex> lock(mutex);
+    filledChunks.push_back(std::move(chunk));
+    filledCondition.notify_one();
+  }
+
+  /// Decompress a file into chunks until its end, passing any error to the
+  /// reader.
+  template<typename Decoder>
+  void decompress(const std::string filename) {
+    try {
+      std::ifstream file(filename, std::ios::binary);
+      Decoder decoder;
+      std::vector<char> input(CHUNK_SIZE);
+      const char *inPos = input.data();
+      const char *inEnd = inPos;
+      std::vector<char> chunk;
+      if (!acquire(chunk)) {
+        return;
+      }
+      char *outPos = chunk.data();
+      // The decoder may hold more output once it has filled a chunk.
+      bool isPending = false;
+      while (true) {
+        if (inPos == inEnd && !isPending) {
+          file.read(input.data(), input.size());
+          if (file.gcount() == 0) {
+            break;
+          }
+          inPos = input.data();
+          inEnd = inPos + file.gcount();
+        }
+        decoder.step(inPos, inEnd, outPos, chunk.data() + chunk.size());
+        isPending = outPos == chunk.data() + chunk.size();
+        if (isPending) {
+          release(chunk, chunk.size());
+          if (!acquire(chunk)) {
+            return;
+          }
+          outPos = chunk.data();
+        }
+      }
+      if (file.bad()) {
+        throw Exception("could not read compressed file");
+      }
+      if (!decoder.isFinished()) {
+        throw Exception("unexpected end of compressed file");
+      }
+      release(chunk, outPos - chunk.data());
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+    filledCondition.notify_one();
+  }
+
+protected:
+  int_type underflow() override {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      if (hasCurrent) {
+        emptyChunks.push_back(std::move(current));
+        current = std::vector<char>();
+        hasCurrent = false;
+        emptyCondition.notify_one();
+      }
+      filledCondition.wait(lock, [this] {
+        return !filledChunks.empty() || finished;
+      });
+      if (filledChunks.empty()) {
+        if (error) {
+          std::rethrow_exception(error);
+        }
+        return traits_type::eof();
+      }
+      current = std::move(filledChunks.front());
+      filledChunks.pop_front();
+      hasCurrent = true;
+      if (!current.empty()) {
+        setg(current.data(), current.data(), current.data() + current.size());
+        return traits_type::to_int_type(*gptr());
+      }
+    }
+  }
+
+public:
+  DecompressingBuffer(const std::string &filename, Compression compression) :
+      numChunks(0), hasCurrent(false), finished(false), stopped(false) {
+    switch (compression) {
+#ifdef NETLIST_PATHS_ZSTD
+      case Compression::ZSTD:
+        thread = std::thread(&DecompressingBuffer::decompress<ZstdDecoder>, this, filename);
+        break;
+#endif
+      default:
+        thread = std::thread(&DecompressingBuffer::decompress<GzipDecoder>, this, filename);
+        break;
+    }
+  }
+
+  ~DecompressingBuffer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopped = true;
+    }
+    emptyCondition.notify_one();
+    thread.join();
+  }
+};
+
+/// Compress a stream into another with an encoder.
+template<typename Encoder>
+void compressStream(std::istream &in, std::ostream &out) {
+  Encoder encoder;
+  std::vector<char> input(CHUNK_SIZE);
+  std::vector<char> output(CHUNK_SIZE);
+  bool done = false;
+  while (!done) {
+    in.read(input.data(), input.size());
+    if (in.bad()) {
+      throw Exception("could not read file to compress");
+    }
+    bool finish = in.eof();
+    const char *inPos = input.data();
+    const char *inEnd = inPos + in.gcount();
+    do {
+      char *outPos = output.data();
+      done = encoder.step(inPos, inEnd, outPos, output.data() + output.size(), finish);
+      out.write(output.data(), outPos - output.data());
+    } while (inPos != inEnd || (finish && !done));
+  }
+}
+
+} // End anonymous namespace.
+
+Compression netlist_paths::detectCompression(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  unsigned char magic[4] = {0, 0, 0, 0};
+  file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  if (file.gcount() >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+    return Compression::GZIP;
+  }
+  if (file.gcount() == 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+      magic[2] == 0x2f && magic[3] == 0xfd) {
+    return Compression::ZSTD;
+  }
+  return Compression::NONE;
+}
+
+Compression netlist_paths::getCompressionForFilename(const std::string &filename) {
+  if (boost::algorithm::ends_with(filename, ".gz")) {
+    return Compression::GZIP;
+  }
+  if (boost::algorithm::ends_with(filename, ".zst")) {
+    return Compression::ZSTD;
+  }
+  return Compression::NONE;
+}
+
+bool netlist_paths::isCompressionSupported(Compression compression) {
+#ifdef NETLIST_PATHS_ZSTD
+  return true;
+#else
+  return compression != Compression::ZSTD;
+#endif
+}
+
+//===----------------------------------------------------------------------===//
+// InputFile
+//===----------------------------------------------------------------------===//
+
+InputFile::InputFile(const std::string &filename) :
+    stream(nullptr), compression(detectCompression(filename)) {
+  if (!isCompressionSupported(compression)) {
+    throw Exception("file is compressed with zstd, which this build does not support");
+  }
+  if (compression == Compression::NONE) {
+    auto file = std::make_unique<std::filebuf>();
+    if (!file->open(filename, std::ios::in | std::ios::binary)) {
+      return;
+    }
+    buffer = std::move(file);
+  } else {
+    buffer = std::make_unique<DecompressingBuffer>(filename, compression);
+  }
+  stream.rdbuf(buffer.get());
+  // Rethrow decompression errors from the reads of the stream.
+  stream.exceptions(std::ios::badbit);
+}
+
+void netlist_paths::compressFile(const std::string &inputFile,
+                                 const std::string &outputFile,
+                                 Compression compression) {
+  if (!isCompressionSupported(compression)) {
+    throw Exception("zstd compression is not supported by this build");
+  }
+  std::ifstream in(inputFile, std::ios::binary);
+  if (!in.is_open()) {
+    throw Exception(std::string("could not open file ")+inputFile);
+  }
+  std::ofstream out(outputFile, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    throw Exception(std::string("could not open file ")+outputFile);
+  }
+  switch (compression) {
+#ifdef NETLIST_PATHS_ZSTD
+    case Compression::ZSTD:
+      compressStream<ZstdEncoder>(in, out);
+      break;
+#endif
+    case Compression::GZIP:
+      compressStream<GzipEncoder>(in, out);
+      break;
+    default:
+      out << in.rdbuf();
+      break;
+  }
+  out.close();
+  if (!out) {
+    throw Exception(std::string("could not write file ")+outputFile);
+  }
+}
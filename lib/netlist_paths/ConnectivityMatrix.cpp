@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <array>
+#include <future>
+#include <thread>
+#include <boost/log/trivial.hpp>
+#include "netlist_paths/ConnectivityMatrix.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+constexpr size_t WORDS_PER_BLOCK = ConnectivityMatrix::BLOCK_WIDTH / 64;
+
+/// A bit vector with one bit for each start point of a block.
+using BitBlock = std::array<uint64_t, WORDS_PER_BLOCK>;
+
+/// OR one bit vector into another. The loop has a fixed trip count so the
+/// compiler can vectorise it.
+inline void orInto(BitBlock &target, const BitBlock &source) {
+  for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+    target[i] |= source[i];
+  }
+}
+
+inline bool isZero(const BitBlock &block) {
+  uint64_t any = 0;
+  for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+    any |= block[i];
+  }
+  return any == 0;
+}
+
+/// The rows of one block of start points.
+struct BlockRows {
+  std::array<size_t, ConnectivityMatrix::BLOCK_WIDTH> sizes;
+  std::vector<uint32_t> columns;
+};
+
+/// Compute the rows of a block of start points.
+///
+/// \param index          The reachability index of the graph.
+/// \param startPoints    All the start points.
+/// \param endPoints      All the end points.
+/// \param endComponents  The component of each end point.
+/// \param firstRow       The row of the first start point of the block.
+/// \param bits           Storage for a bit vector for each component.
+/// \param rows           The rows of the block.
+void computeBlock(const ReachabilityIndex &index,
+                  const std::vector<size_t> &startPoints,
+                  const std::vector<size_t> &endPoints,
+                  const std::vector<ReachabilityIndex::Index> &endComponents,
+                  size_t firstRow,
+                  std::vector<BitBlock> &bits,
+                  BlockRows &rows) {
+  auto numRows = std::min(ConnectivityMatrix::BLOCK_WIDTH,
+                          startPoints.size() - firstRow);
+  std::fill(bits.begin(), bits.end(), BitBlock{});
+  // Set the bit of each start point in its component.
+  ReachabilityIndex::Index maxComponent = 0;
+  for (size_t i = 0; i < numRows; ++i) {
+    auto component = index.getComponent(startPoints[firstRow + i]);
+    bits[component][i / 64] |= uint64_t(1) << (i % 64);
+    maxComponent = std::max(maxComponent, component);
+  }
+  // Propagate the bits in topological order, which is descending component
+  // number, starting from the first component with any bits set.
+  for (size_t c = maxComponent + 1; c-- > 0;) {
+    auto &block = bits[c];
+    if (isZero(block)) {
+      continue;
+    }
+    auto successors = index.getSuccessors(static_cast<ReachabilityIndex::Index>(c));
+    for (auto it = successors.first; it != successors.second; ++it) {
+      orInto(bits[*it], block);
+    }
+  }
+  // Count the end points of each row, then place the columns in row order.
+  auto forEachPair = [&](auto fn) {
+    for (size_t column = 0; column < endPoints.size(); ++column) {
+      auto &block = bits[endComponents[column]];
+      for (size_t w = 0; w < WORDS_PER_BLOCK; ++w) {
+        for (auto word = block[w]; word != 0; word &= word - 1) {
+          auto i = w * 64 + __builtin_ctzll(word);
+          if (startPoints[firstRow + i] != endPoints[column]) {
+            fn(i, column);
+          }
+        }
+      }
+    }
+  };
+  rows.sizes.fill(0);
+  forEachPair([&](size_t i, size_t) { ++rows.sizes[i]; });
+  std::array<size_t, ConnectivityMatrix::BLOCK_WIDTH> next;
+  size_t numColumns = 0;
+  for (size_t i = 0; i < ConnectivityMatrix::BLOCK_WIDTH; ++i) {
+    next[i] = numColumns;
+    numColumns += rows.sizes[i];
+  }
+  rows.columns.resize(numColumns);
+  forEachPair([&](size_t i, size_t column) {
+    rows.columns[next[i]++] = static_cast<uint32_t>(column); });
+}
+
+} // End anonymous namespace.
+
+ConnectivityMatrix
+ConnectivityMatrix::build(const ReachabilityIndex &index,
+                          const std::vector<size_t> &startPoints,
+                          const std::vector<size_t> &endPoints,
+                          size_t numThreads) {
+  ConnectivityMatrix matrix;
+  matrix.startPoints = startPoints;
+  matrix.endPoints = endPoints;
+  std::vector<ReachabilityIndex::Index> endComponents;
+  endComponents.reserve(endPoints.size());
+  for (auto vertex : endPoints) {
+    endComponents.push_back(index.getComponent(vertex));
+  }
+  auto numBlocks = (startPoints.size() + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+  std::vector<BlockRows> blocks(numBlocks);
+  // Each thread processes every numThreads-th block with its own bit
+  // vectors, so only as many threads run as have bit vectors that fit in
+  // MAX_BIT_VECTOR_BYTES, and always at least one.
+  if (numThreads == 0) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  auto threadBytes = std::max<size_t>(1, index.numComponents() * sizeof(BitBlock));
+  numThreads = std::min({numThreads, numBlocks,
+                         std::max<size_t>(1, MAX_BIT_VECTOR_BYTES / threadBytes)});
+  auto computeBlocks = [&](size_t first) {
+    std::vector<BitBlock> bits(index.numComponents());
+    for (auto block = first; block < numBlocks; block += numThreads) {
+      computeBlock(index, startPoints, endPoints, endComponents,
+                   block * BLOCK_WIDTH, bits, blocks[block]);
+    }
+  };
+  if (numThreads <= 1) {
+    computeBlocks(0);
+  } else {
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < numThreads; ++i) {
+      futures.push_back(std::async(std::launch::async, computeBlocks, i));
+    }
+    for (auto &future : futures) {
+      future.get();
+    }
+  }
+  // Concatenate the rows of the blocks.
+  matrix.rowOffsets.reserve(startPoints.size() + 1);
+  for (size_t row = 0; row < startPoints.size(); ++row) {
+    auto &block = blocks[row / BLOCK_WIDTH];
+    matrix.rowOffsets.push_back(matrix.rowOffsets.back() + block.sizes[row % BLOCK_WIDTH]);
+  }
+  matrix.columns.reserve(matrix.rowOffsets.back());
+  for (auto &block : blocks) {
+    matrix.columns.insert(matrix.columns.end(),
+                          block.columns.begin(), block.columns.end());
+  }
+  BOOST_LOG_TRIVIAL(info) << "Connectivity of " << startPoints.size()
+                          << " start points and " << endPoints.size()
+                          << " end points has " << matrix.numPairs() << " pairs";
+  return matrix;
+}
+
+bool ConnectivityMatrix::test(size_t row, size_t column) const {
+  auto range = getRow(row);
+  return std::binary_search(range.first, range.second, column);
+}
+
+std::vector<std::pair<size_t, size_t>> ConnectivityMatrix::getPairs() const {
+  std::vector<std::pair<size_t, size_t>> pairs;
+  pairs.reserve(columns.size());
+  for (size_t row = 0; row < startPoints.size(); ++row) {
+    auto range = getRow(row);
+    for (auto it = range.first; it != range.second; ++it) {
+      pairs.emplace_back(startPoints[row], endPoints[*it]);
+    }
+  }
+  return pairs;
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include "netlist_paths/DeepestPaths.hpp"
+
+using namespace netlist_paths;
+
+PathWeights::PathWeights() {
+  weights.fill(0);
+  for (auto type : {VertexAstType::LOGIC,
+                    VertexAstType::ASSIGN,
+                    VertexAstType::ASSIGN_ALIAS,
+                    VertexAstType::ASSIGN_DLY,
+                    VertexAstType::ASSIGN_W,
+                    VertexAstType::ALWAYS,
+                    VertexAstType::INITIAL,
+                    VertexAstType::SEN_GATE,
+                    VertexAstType::SEN_ITEM}) {
+    weights[static_cast<size_t>(type)] = 1;
+  }
+}
+
+DeepestPaths::DeepestPaths(const ComponentGraph &components, size_t numPaths,
+                           bool reverse) :
+    components(components), numPaths(numPaths), reverse(reverse), stage(0) {}
+
+/// Add a path to the deepest paths to a vertex if it is one of them, keeping
+/// paths of equal depth in the order they were found.
+///
+/// \returns The label of the path, or NO_LABEL if it is not kept.
+uint32_t DeepestPaths::insert(std::vector<uint32_t> &deepest, VertexID vertex,
+                              uint32_t previous, double depth) {
+  if (deepest.size() == numPaths &&
+      (numPaths == 0 || depth <= labels[deepest.back()].depth)) {
+    return NO_LABEL;
+  }
+  auto label = static_cast<uint32_t>(labels.size());
+  labels.push_back({depth, vertex, previous, stage});
+  auto position = std::upper_bound(deepest.begin(), deepest.end(), depth,
+                                   [this](double value, uint32_t other) {
+                                     return value > labels[other].depth; });
+  deepest.insert(position, label);
+  if (deepest.size() > numPaths) {
+    deepest.pop_back();
+  }
+  return label;
+}
+
+/// Return true if a vertex is already on a path of the current stage. Since
+/// the components are visited in topological order, a path cannot return to
+/// a component it has left, so only its vertices in the component of the
+/// vertex are checked.
+bool DeepestPaths::isOnPath(uint32_t label, VertexID vertex,
+                            VertexID stageStart) const {
+  if (vertex == stageStart) {
+    return true;
+  }
+  auto component = components.getComponent(vertex);
+  for (; label != NO_LABEL &&
+         labels[label].stage == stage &&
+         components.getComponent(labels[label].vertex) == component;
+       label = labels[label].previous) {
+    if (labels[label].vertex == vertex) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DeepestPaths::start(VertexID vertex, double weight) {
+  stage = 0;
+  labels.clear();
+  labels.push_back({weight, vertex, NO_LABEL, stage});
+  paths = {0};
+}
+
+bool DeepestPaths::extend(const PathSearch &search,
+                          const std::vector<double> &weights,
+                          const VertexIDVec &finishVertices) {
+  if (paths.empty()) {
+    return false;
+  }
+  ++stage;
+  auto stageStart = labels[paths.front()].vertex;
+  // Number the selected vertices in the topological order of their
+  // components in the direction of the search, with the vertices of each
+  // component consecutive.
+  auto &selection = search.getSelection();
+  std::vector<uint32_t> order(selection.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    auto componentA = components.getComponent(selection[a]);
+    auto componentB = components.getComponent(selection[b]);
+    if (componentA != componentB) {
+      return reverse ? componentA < componentB : componentA > componentB;
+    }
+    return a < b;
+  });
+  std::unordered_map<VertexID, uint32_t> numbers;
+  numbers.reserve(order.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    numbers.emplace(selection[order[i]], i);
+  }
+  auto getVertex = [&](uint32_t number) { return selection[order[number]]; };
+  auto getComponent = [&](uint32_t number) {
+    return components.getComponent(getVertex(number));
+  };
+  auto startNumber = numbers.find(stageStart);
+  if (startNumber == numbers.end()) {
+    paths.clear();
+    return false;
+  }
+  // Collect the edges in the direction of the search, without self loops or
+  // duplicates, grouped by their sources.
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  search.forEachSelectedEdge([&](VertexID source, VertexID target) {
+    auto sourceNumber = numbers.at(source);
+    auto targetNumber = numbers.at(target);
+    if (sourceNumber != targetNumber) {
+      edges.emplace_back(reverse ? targetNumber : sourceNumber,
+                         reverse ? sourceNumber : targetNumber);
+    }
+  });
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  std::vector<size_t> edgeOffsets(order.size() + 1, 0);
+  for (auto &edge : edges) {
+    ++edgeOffsets[edge.first + 1];
+  }
+  std::partial_sum(edgeOffsets.begin(), edgeOffsets.end(), edgeOffsets.begin());
+  // The deepest paths to each vertex, starting with the paths of the last
+  // stage.
+  std::vector<std::vector<uint32_t>> deepest(order.size());
+  deepest[startNumber->second] = paths;
+  std::vector<std::pair<uint32_t, uint32_t>> frontier, nextFrontier;
+  for (uint32_t begin = 0; begin < order.size();) {
+    auto component = getComponent(begin);
+    auto end = begin + 1;
+    while (end < order.size() && getComponent(end) == component) {
+      ++end;
+    }
+    auto isInComponent = [&](uint32_t number) {
+      return number >= begin && number < end;
+    };
+    // Extend the paths to the vertices of a cycle around it, by one edge in
+    // each round, which is enough rounds for any simple path.
+    frontier.clear();
+    if (end - begin > 1) {
+      for (auto vertex = begin; vertex < end; ++vertex) {
+        for (auto label : deepest[vertex]) {
+          frontier.emplace_back(vertex, label);
+        }
+      }
+    }
+    for (size_t round = 1; round < end - begin && !frontier.empty(); ++round) {
+      nextFrontier.clear();
+      for (auto &entry : frontier) {
+        for (auto edge = edgeOffsets[entry.first]; edge < edgeOffsets[entry.first + 1]; ++edge) {
+          auto target = edges[edge].second;
+          auto targetVertex = getVertex(target);
+          if (isInComponent(target) &&
+              !isOnPath(entry.second, targetVertex, stageStart)) {
+            auto label = insert(deepest[target], targetVertex, entry.second,
+                                labels[entry.second].depth + weights[order[target]]);
+            if (label != NO_LABEL) {
+              nextFrontier.emplace_back(target, label);
+            }
+          }
+        }
+      }
+      std::swap(frontier, nextFrontier);
+    }
+    // Extend the paths out of the component.
+    for (auto vertex = begin; vertex < end; ++vertex) {
+      for (auto label : deepest[vertex]) {
+        for (auto edge = edgeOffsets[vertex]; edge < edgeOffsets[vertex + 1]; ++edge) {
+          auto target = edges[edge].second;
+          if (!isInComponent(target)) {
+            insert(deepest[target], getVertex(target), label,
+                   labels[label].depth + weights[order[target]]);
+          }
+        }
+      }
+    }
+    begin = end;
+  }
+  // Keep the deepest of the paths to the finish vertices.
+  paths.clear();
+  for (auto vertex : finishVertices) {
+    auto number = numbers.find(vertex);
+    if (number != numbers.end() && vertex != stageStart) {
+      auto &found = deepest[number->second];
+      paths.insert(paths.end(), found.begin(), found.end());
+    }
+  }
+  std::stable_sort(paths.begin(), paths.end(), [this](uint32_t a, uint32_t b) {
+    return labels[a].depth > labels[b].depth;
+  });
+  if (paths.size() > numPaths) {
+    paths.resize(numPaths);
+  }
+  return !paths.empty();
+}
+
+std::vector<VertexIDVec> DeepestPaths::getPaths() const {
+  std::vector<VertexIDVec> result;
+  result.reserve(paths.size());
+  for (auto label : paths) {
+    VertexIDVec path;
+    for (; label != NO_LABEL; label = labels[label].previous) {
+      path.push_back(labels[label].vertex);
+    }
+    // The labels are followed from the last vertex found to the first.
+    if (!reverse) {
+      std::reverse(path.begin(), path.end());
+    }
+    result.push_back(std::move(path));
+  }
+  return result;
+}
+
+std::vector<double> DeepestPaths::getDepths() const {
+  std::vector<double> depths;
+  depths.reserve(paths.size());
+  for (auto label : paths) {
+    depths.push_back(labels[label].depth);
+  }
+  return depths;
+}
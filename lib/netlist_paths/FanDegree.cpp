@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <functional>
+#include "netlist_paths/ConnectivityMatrix.hpp"
+#include "netlist_paths/FanDegree.hpp"
+#include "netlist_paths/TraversalWorkspace.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+/// Add two path counts, saturating at FanDegree::MAX_PATHS.
+inline uint64_t addPaths(uint64_t a, uint64_t b) {
+  uint64_t sum;
+  return __builtin_add_overflow(a, b, &sum) ? FanDegree::MAX_PATHS : sum;
+}
+
+/// Return the successors of a component, or its predecessors if reverse.
+inline std::pair<const ReachabilityIndex::Index*, const ReachabilityIndex::Index*>
+getAdjacent(const ReachabilityIndex &index, ReachabilityIndex::Index component,
+            bool reverse) {
+  return reverse ? index.getPredecessors(component)
+                 : index.getSuccessors(component);
+}
+
+} // End anonymous namespace.
+
+FanDegree FanDegree::count(const ReachabilityIndex &index,
+                           size_t root,
+                           const std::vector<size_t> &points,
+                           const std::vector<uint64_t> &widths,
+                           bool reverse) {
+  auto &workspace = TraversalWorkspace::get();
+  auto &visited = workspace.components;
+  auto &stack = workspace.componentStack;
+  auto &order = workspace.componentOrder;
+  auto &paths = workspace.componentCounts;
+  visited.reset(index.numComponents());
+  if (paths.size() < index.numComponents()) {
+    paths.resize(index.numComponents());
+  }
+  // Find the components reachable from the root.
+  auto rootComponent = index.getComponent(root);
+  stack.assign(1, rootComponent);
+  visited.set(rootComponent);
+  order.clear();
+  while (!stack.empty()) {
+    auto c = stack.back();
+    stack.pop_back();
+    order.push_back(c);
+    paths[c] = 0;
+    auto adjacent = getAdjacent(index, c, reverse);
+    for (auto it = adjacent.first; it != adjacent.second; ++it) {
+      if (!visited.test(*it)) {
+        visited.set(*it);
+        stack.push_back(*it);
+      }
+    }
+  }
+  // Count the paths from the root to each component in topological order,
+  // which is descending component number, or ascending in reverse, so the
+  // count of a component is complete before it is added to the components
+  // it reaches.
+  if (reverse) {
+    std::sort(order.begin(), order.end());
+  } else {
+    std::sort(order.begin(), order.end(), std::greater<uint32_t>());
+  }
+  paths[rootComponent] = 1;
+  for (auto c : order) {
+    auto adjacent = getAdjacent(index, c, reverse);
+    for (auto it = adjacent.first; it != adjacent.second; ++it) {
+      paths[*it] = addPaths(paths[*it], paths[c]);
+    }
+  }
+  FanDegree degree;
+  for (size_t i = 0; i < points.size(); ++i) {
+    auto component = index.getComponent(points[i]);
+    if (visited.test(component)) {
+      ++degree.numPoints;
+      degree.numPaths = addPaths(degree.numPaths, paths[component]);
+      degree.numBits += widths[i];
+    }
+  }
+  return degree;
+}
+
+FanDegreeColumns FanDegreeColumns::count(const ReachabilityIndex &index,
+                                         const std::vector<size_t> &roots,
+                                         const std::vector<size_t> &points,
+                                         const std::vector<uint64_t> &widths,
+                                         bool reverse,
+                                         size_t numThreads) {
+  FanDegreeColumns columns;
+  columns.vertices.assign(roots.begin(), roots.end());
+  columns.numPoints.assign(roots.size(), 0);
+  columns.numBits.assign(roots.size(), 0);
+  // Count the paths from each component to all the points, which is the
+  // number of points in the component plus the counts of the components it
+  // reaches. Successors have lower numbers and predecessors higher ones, so
+  // they are complete first.
+  std::vector<uint64_t> paths(index.numComponents(), 0);
+  for (auto vertex : points) {
+    auto component = index.getComponent(vertex);
+    paths[component] = addPaths(paths[component], 1);
+  }
+  auto addAdjacent = [&](size_t c) {
+    auto component = static_cast<ReachabilityIndex::Index>(c);
+    auto adjacent = getAdjacent(index, component, reverse);
+    for (auto it = adjacent.first; it != adjacent.second; ++it) {
+      paths[c] = addPaths(paths[c], paths[*it]);
+    }
+  };
+  if (reverse) {
+    for (size_t c = index.numComponents(); c-- > 0;) {
+      addAdjacent(c);
+    }
+  } else {
+    for (size_t c = 0; c < index.numComponents(); ++c) {
+      addAdjacent(c);
+    }
+  }
+  columns.numPaths.reserve(roots.size());
+  for (auto vertex : roots) {
+    columns.numPaths.push_back(paths[index.getComponent(vertex)]);
+  }
+  // Count the points connected to each root, with the roots as the rows of
+  // the matrix for a fan out and as the columns for a fan in.
+  if (reverse) {
+    auto matrix = ConnectivityMatrix::build(index, points, roots, numThreads);
+    for (size_t row = 0; row < points.size(); ++row) {
+      auto range = matrix.getRow(row);
+      for (auto it = range.first; it != range.second; ++it) {
+        ++columns.numPoints[*it];
+        columns.numBits[*it] += widths[row];
+      }
+    }
+  } else {
+    auto matrix = ConnectivityMatrix::build(index, roots, points, numThreads);
+    for (size_t row = 0; row < roots.size(); ++row) {
+      auto range = matrix.getRow(row);
+      columns.numPoints[row] = range.second - range.first;
+      for (auto it = range.first; it != range.second; ++it) {
+        columns.numBits[row] += widths[*it];
+      }
+    }
+  }
+  // The matrix excludes a root that is also a point.
+  constexpr size_t NOT_A_POINT = std::numeric_limits<size_t>::max();
+  std::vector<size_t> pointIndexes(index.numVertices(), NOT_A_POINT);
+  for (size_t i = 0; i < points.size(); ++i) {
+    pointIndexes[points[i]] = i;
+  }
+  for (size_t row = 0; row < roots.size(); ++row) {
+    auto i = pointIndexes[roots[row]];
+    if (i != NOT_A_POINT) {
+      ++columns.numPoints[row];
+      columns.numBits[row] += widths[i];
+    }
+  }
+  return columns;
+}
@@ -2,98 +2,94 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <future>
+#include <thread>
 #include <unordered_set>
-#include <regex>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/iteration_macros.hpp>
-#include <boost/graph/reverse_graph.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/tokenizer.hpp>
+#include "netlist_paths/DeepestPaths.hpp"
 #include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Graph.hpp"
+#include "netlist_paths/GraphWriter.hpp"
 #include "netlist_paths/Options.hpp"
-#include "netlist_paths/Utilities.hpp"
+#include "netlist_paths/PathEnumerator.hpp"
+#include "netlist_paths/PathSearch.hpp"
+#include "netlist_paths/ThreadPool.hpp"
 
 using namespace netlist_paths;
 
-class DfsVisitor : public boost::default_dfs_visitor {
-private:
-  ParentMap &parentMap;
-  bool allPaths;
-public:
-  DfsVisitor(ParentMap &parentMap, bool allPaths) :
-      parentMap(parentMap), allPaths(allPaths) {}
-  // Visit only the edges of the DFS graph.
-  template<typename Edge, typename Graph>
-  void tree_edge(Edge edge, const Graph &graph) const {
-    if (!allPaths) {
-      VertexID src, dst;
-      src = boost::source(edge, graph);
-      dst = boost::target(edge, graph);
-      parentMap[dst].push_back(src);
-    }
-    return;
-  }
-  // Visit all edges of a vertex.
-  template<typename Edge, typename Graph>
-  void examine_edge(Edge edge, const Graph &graph) const {
-    if (allPaths) {
-      VertexID src, dst;
-      src = boost::source(edge, graph);
-      dst = boost::target(edge, graph);
-      parentMap[dst].push_back(src);
-    }
-    return;
-  }
-};
-
-/// Get all vertices connected by out edges from vertex.
-VertexIDVec Graph::getAdjacentVerticesOutEdges(VertexID vertex) const {
-  std::vector<VertexID> targets;
-  BGL_FORALL_OUTEDGES(vertex, outEdge, graph, InternalGraph) {
-    targets.push_back(boost::target(outEdge, graph));
-  }
-  return targets;
-}
+/// The number of vertices in each block of a parallel analysis of the graph.
+constexpr size_t ANALYSIS_BLOCK_SIZE = 4096;
 
-/// Get all vertices connected by in edges from vertex.
-VertexIDVec Graph::getAdjacentVerticesInEdges(VertexID vertex) const {
-  std::vector<VertexID> sources;
-  BGL_FORALL_INEDGES(vertex, outEdge, graph, InternalGraph) {
-    sources.push_back(boost::source(outEdge, graph));
-  }
-  return sources;
+template<typename Edit, typename Analyze>
+std::vector<std::vector<Edit>> Graph::analyzeVertices(size_t numThreads,
+                                                      Analyze analyze) const {
+  auto numVertices = boost::num_vertices(graph);
+  auto numBlocks = (numVertices + ANALYSIS_BLOCK_SIZE - 1) / ANALYSIS_BLOCK_SIZE;
+  std::vector<std::vector<Edit>> edits(numBlocks);
+  auto analyzeBlock = [&](size_t block) {
+    auto end = std::min(numVertices, (block + 1) * ANALYSIS_BLOCK_SIZE);
+    for (auto v = block * ANALYSIS_BLOCK_SIZE; v < end; ++v) {
+      analyze(static_cast<VertexID>(v), edits[block]);
+    }
+  };
+  if (numBlocks == 1) {
+    analyzeBlock(0);
+  } else if (numBlocks > 1) {
+    ThreadPool pool(numThreads);
+    pool.parallelFor(numBlocks, analyzeBlock);
+  }
+  return edits;
 }
 
 /// For any register vertex that is alias assigned to another variable, mark
 /// that variable as being an alias of the register. This fixes issues with the
 /// way that Verilator inlines modules, ensuring that the target variable of a
 /// delayed assignment is always correctly marked as a register.
-void Graph::markAliasRegisters() {
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
+///
+/// The aliases of each register are found in parallel, then marked in order of
+/// the registers, skipping a register that an earlier one has marked as its
+/// alias, as a serial pass would.
+void Graph::markAliasRegisters(size_t numThreads) {
+  ScopedTimer timer(stats, StatsPhase::MARK_ALIAS_REGISTERS);
+  struct AliasMark {
+    VertexID reg;
+    VertexID alias;
+  };
+  auto marks = analyzeVertices<AliasMark>(numThreads, [this](VertexID v, std::vector<AliasMark> &edits) {
     if (graph[v].isReg()) {
-      for (auto target : getAdjacentVerticesOutEdges(v)) {
+      BGL_FORALL_OUTEDGES(v, outEdge, graph, InternalGraph) {
+        auto target = boost::target(outEdge, graph);
         if (graph[target].getAstType() == VertexAstType::ASSIGN_ALIAS) {
-          VertexIDVec assignAliasTargets = getAdjacentVerticesOutEdges(target);
-          assert(assignAliasTargets.size() == 1);
-          if (assignAliasTargets.front() != v) {
-            graph[assignAliasTargets.front()].setDstRegAlias();
-            BOOST_LOG_TRIVIAL(debug) << boost::format("Marked %s as REG alias of %s")
-                % graph[assignAliasTargets.front()].getName() % graph[v].getName();
-            // Create a mapping of the alias name to the (destination) register vertex ID.
-            aliasMap[graph[assignAliasTargets.front()].getName()] = v;
+          assert(boost::out_degree(target, graph) == 1);
+          auto alias = boost::target(*boost::out_edges(target, graph).first, graph);
+          if (alias != v) {
+            edits.push_back({v, alias});
           }
         }
       }
     }
+  });
+  for (auto &block : marks) {
+    for (auto &mark : block) {
+      if (graph[mark.reg].isReg()) {
+        graph[mark.alias].setDstRegAlias();
+        BOOST_LOG_TRIVIAL(debug) << boost::format("Marked %s as REG alias of %s")
+            % graph[mark.alias].getName() % graph[mark.reg].getName();
+        // Create a mapping of the alias name to the (destination) register vertex ID.
+        aliasMap[graph[mark.alias].getName()] = mark.reg;
+      }
+    }
   }
 }
 
@@ -101,81 +97,124 @@ void Graph::markAliasRegisters() {
 /// and 'source' registers only with out edges. This implies graph connectivity
 /// follows combinatorial paths in the netlist and allows traversals of the
 /// graph to trace combinatorial timing paths.
-void Graph::splitRegVertices() {
-  // Create a list of vertices to iterate over since this transform adds new
-  // vertices and would invalidate a vertex iterator.
-  VertexIDVec regVertices;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (graph[v].isReg()) {
-      regVertices.push_back(v);
+///
+/// The out edges of the registers are classified in parallel, then the new
+/// vertices and edges are added, and the out edges marked, in order of the
+/// registers.
+void Graph::splitRegVertices(size_t numThreads) {
+  ScopedTimer timer(stats, StatsPhase::SPLIT_REG_VERTICES);
+  struct SplitEdit {
+    enum Kind { REG, ALIAS, EDGE } kind;
+    VertexID vertex;
+    VertexID aliasVar;
+    EdgeID edge;
+  };
+  auto splits = analyzeVertices<SplitEdit>(numThreads, [this](VertexID v, std::vector<SplitEdit> &edits) {
+    if (!graph[v].isReg()) {
+      return;
     }
-  }
-  for (auto v : regVertices) {
-    // Create a new 'source' reg vertex.
-    Vertex srcReg(graph[v]);
-    srcReg.setSrcReg();
-    auto srcRegVertex = boost::add_vertex(srcReg, graph);
-    // Collect all adjacent vertices (to which there are out edges).
-    std::vector<VertexID> adjacentVertices = getAdjacentVerticesOutEdges(v);
-    // Create or move edges to src register vertex.
-    for (auto target : adjacentVertices) {
-
+    edits.push_back({SplitEdit::REG, v, 0, {}});
+    BGL_FORALL_OUTEDGES(v, outEdge, graph, InternalGraph) {
+      auto target = boost::target(outEdge, graph);
       // Handle ASSIGN_ALIAS nodes.
       if (graph[target].getAstType() == VertexAstType::ASSIGN_ALIAS) {
-        VertexIDVec assignAliasTargets = getAdjacentVerticesOutEdges(target);
-        assert(assignAliasTargets.size() == 1);
-        if (assignAliasTargets.front() != v) {
+        assert(boost::out_degree(target, graph) == 1);
+        auto aliasVar = boost::target(*boost::out_edges(target, graph).first, graph);
+        if (aliasVar != v) {
+          edits.push_back({SplitEdit::ALIAS, target, aliasVar, {}});
+          continue;
+        }
+      }
+      edits.push_back({SplitEdit::EDGE, target, 0, outEdge});
+    }
+  });
+  VertexID srcRegVertex = 0;
+  for (auto &block : splits) {
+    for (auto &edit : block) {
+      switch (edit.kind) {
+        case SplitEdit::REG: {
+          // Create a new 'source' reg vertex.
+          Vertex srcReg(graph[edit.vertex]);
+          srcReg.setSrcReg();
+          srcRegVertex = boost::add_vertex(srcReg, graph);
+          break;
+        }
+        case SplitEdit::ALIAS: {
           // If we have REG -> ASSIGN_ALIAS -> VAR, then duplicate
           // ASSIGN_ALIAS and VAR, so there are:
           //   SRC_REG <- ASSIGN_ALIAS <- VAR
           //   DST_REG -> ASSIGN_ALIAS -> VAR
-          Vertex assignAlias(graph[target]);
-          Vertex aliasVar(graph[assignAliasTargets.front()]);
+          Vertex assignAlias(graph[edit.vertex]);
+          Vertex aliasVar(graph[edit.aliasVar]);
           aliasVar.setSrcRegAlias();
           auto assignAliasVertex = boost::add_vertex(assignAlias, graph);
           auto aliasVarVertex = boost::add_vertex(aliasVar, graph);
           boost::add_edge(aliasVarVertex, assignAliasVertex, graph);
           boost::add_edge(assignAliasVertex, srcRegVertex, graph);
-          continue;
+          break;
         }
+        case SplitEdit::EDGE:
+          // Mark edges from a DST_REG node to each node that is connected by
+          // an out edge, allowing paths through registered to be traversed.
+          // Then copy the out edge of the register to the new srcReg.
+          graph[edit.edge].setThroughRegister();
+          boost::add_edge(srcRegVertex, edit.vertex, graph);
+          break;
       }
-
-      // Otherwise, mark edges from a DST_REG node to each node that is
-      // connected by an out edge, allowing paths through registered to be
-      // traversed.
-      graph[boost::edge(v, target, graph).first].setThroughRegister();
-
-      // And copy the same out edge to the new srcReg.
-      boost::add_edge(srcRegVertex, target, graph);
     }
   }
 }
 
 /// Add additional edges from variable aliases, through the ASSIGN_ALIAS node,
 /// to allow the alias variable to act as a start point.
-void Graph::updateVarAliases() {
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (graph[v].getAstType() == VertexAstType::ASSIGN_ALIAS) {
-      VertexIDVec sourceVertices = getAdjacentVerticesInEdges(v);
-      VertexIDVec targetVertices = getAdjacentVerticesOutEdges(v);
-      assert(targetVertices.size() == 1);
-      VertexID assignAlias = v;
-      VertexID aliasVar = targetVertices.front();
-      for (auto sourceVertex : sourceVertices) {
-        VertexID sourceVar = sourceVertex;
-        if (!graph[sourceVar].isReg()) {
-          // We have VAR -> ASSIGN_ALIAS -> VAR (alias)
-          // Add back edges: VAR (alias) -> ASSIGN_ALIAS
-          //                 ASSIGN_ALIAS -> VAR
-          if (!boost::edge(aliasVar, assignAlias, graph).second) {
-            boost::add_edge(aliasVar, assignAlias, graph);
-          }
-          if (!boost::edge(assignAlias, sourceVar, graph).second) {
-            boost::add_edge(assignAlias, sourceVar, graph);
-          }
+///
+/// The edges that are missing are found in parallel, then added in order of
+/// the ASSIGN_ALIAS vertices.
+void Graph::updateVarAliases(size_t numThreads) {
+  ScopedTimer timer(stats, StatsPhase::UPDATE_VAR_ALIASES);
+  struct NewEdge {
+    VertexID source;
+    VertexID target;
+  };
+  auto newEdges = analyzeVertices<NewEdge>(numThreads, [this](VertexID v, std::vector<NewEdge> &edits) {
+    if (graph[v].getAstType() != VertexAstType::ASSIGN_ALIAS) {
+      return;
+    }
+    assert(boost::out_degree(v, graph) == 1);
+    VertexID assignAlias = v;
+    VertexID aliasVar = boost::target(*boost::out_edges(v, graph).first, graph);
+    // The only out edge of the ASSIGN_ALIAS is to the alias, and there is an
+    // edge from the alias if it is one of the sources.
+    bool hasAliasEdge = false;
+    BGL_FORALL_INEDGES(v, inEdge, graph, InternalGraph) {
+      hasAliasEdge |= boost::source(inEdge, graph) == aliasVar;
+    }
+    auto firstEdit = edits.size();
+    BGL_FORALL_INEDGES(v, inEdge, graph, InternalGraph) {
+      VertexID sourceVar = boost::source(inEdge, graph);
+      if (!graph[sourceVar].isReg()) {
+        // We have VAR -> ASSIGN_ALIAS -> VAR (alias)
+        // Add back edges: VAR (alias) -> ASSIGN_ALIAS
+        //                 ASSIGN_ALIAS -> VAR
+        if (!hasAliasEdge) {
+          edits.push_back({aliasVar, assignAlias});
+          hasAliasEdge = true;
+        }
+        bool hasSourceEdge = sourceVar == aliasVar ||
+            std::any_of(edits.begin() + firstEdit, edits.end(),
+                        [&](const NewEdge &edge) {
+                          return edge.source == assignAlias &&
+                                 edge.target == sourceVar; });
+        if (!hasSourceEdge) {
+          edits.push_back({assignAlias, sourceVar});
         }
       }
     }
+  });
+  for (auto &block : newEdges) {
+    for (auto &edge : block) {
+      boost::add_edge(edge.source, edge.target, graph);
+    }
   }
 }
 
@@ -204,112 +243,210 @@ void Graph::checkGraph() const {
 }
 
 /// Dump a Graphviz dotfile of the netlist graph for visualisation.
-void Graph::dumpDotFile(const std::string &outputFilename) const {
+void Graph::dumpDotFile(const std::string &outputFilename,
+                        const QueryOptions &options) const {
   std::ofstream outputFile(outputFilename);
   if (!outputFile.is_open()) {
     throw Exception(std::string("unable to open ")+outputFilename);
   }
   FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
+                                      EdgePredicate(&graph,
+                                                    options.shouldTraverseRegisters()),
                                       VertexPredicate({}));
+  GraphWriter writer(outputFile, ExportFormat::DOT);
   // Loop over all vertices and print properties.
-  outputFile << "digraph netlist {\n";
   BGL_FORALL_VERTICES(v, filteredGraph, FilteredInternalGraph) {
-    outputFile << v << boost::format(" [label=\"%s %s\"]\n")
-                    % graph[v].getName() % graph[v].getAstTypeStr();
+    writer.writeVertex(v, graph[v]);
   }
   // Loop over all edges.
   BGL_FORALL_EDGES(e, filteredGraph, FilteredInternalGraph) {
-    outputFile << boost::format("%d -> %d;\n")
-                    % boost::source(e, graph) % boost::target(e, graph);
+    writer.writeEdge(boost::source(e, graph), boost::target(e, graph));
   }
-  outputFile << "}\n";
+  writer.finish();
   outputFile.close();
   // Print command line to generate graph file.
   BOOST_LOG_TRIVIAL(info) << boost::format("dot -Tpdf %s -o graph.pdf") % outputFilename;
 }
 
-/// Match a VertexGraphType against a vertex.
-bool Graph::vertexTypeMatch(VertexID vertex, VertexNetlistType graphType) const {
-  if (graphType == VertexNetlistType::ANY) {
-    return true;
-  }
-  if ((graphType == VertexNetlistType::REG ||
-       graphType == VertexNetlistType::PORT ||
-       graphType == VertexNetlistType::IS_NAMED) &&
-      (graph[vertex].isSrcReg() ||
-       graph[vertex].isSrcRegAlias())) {
-    // Source registers and register aliases are duplicates of destination
-    // registers and their aliases, so exclude them from queries that can
-    // include registers.
-    return false;
-  }
-  // Anything else is handled by isGraphType().
-  return graph[vertex].isGraphType(graphType);
+void Graph::writeSelection(const PathSearch &search, std::ostream &os,
+                           ExportFormat format) const {
+  GraphWriter writer(os, format);
+  for (auto vertex : search.getSelection()) {
+    writer.writeVertex(vertex, graph[vertex]);
+  }
+  search.forEachSelectedEdge([&](VertexID source, VertexID target) {
+    writer.writeEdge(source, target);
+  });
+  writer.finish();
 }
 
-VertexIDVec Graph::getVerticesByType(VertexNetlistType graphType) const {
-  VertexIDVec vertexIDs;
+void Graph::exportFanOutCone(VertexID startVertex, std::ostream &os,
+                             const QueryOptions &options,
+                             const ExportOptions &exportOptions) const {
+  ScopedTimer timer(stats, StatsPhase::EXPORT_SUBGRAPH);
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.clearSelection();
+  search.selectCone(startVertex, false, exportOptions.getMaxDepth(),
+                    exportOptions.getMaxVertices());
+  writeSelection(search, os, exportOptions.getFormat());
+}
+
+void Graph::exportFanInCone(VertexID endVertex, std::ostream &os,
+                            const QueryOptions &options,
+                            const ExportOptions &exportOptions) const {
+  ScopedTimer timer(stats, StatsPhase::EXPORT_SUBGRAPH);
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.clearSelection();
+  search.selectCone(endVertex, true, exportOptions.getMaxDepth(),
+                    exportOptions.getMaxVertices());
+  writeSelection(search, os, exportOptions.getFormat());
+}
+
+void Graph::exportPointToPoint(const VertexIDVec &waypointIDs,
+                               const VertexIDVec &avoidPointIDs,
+                               std::ostream &os,
+                               const QueryOptions &options,
+                               const ExportOptions &exportOptions) const {
+  ScopedTimer timer(stats, StatsPhase::EXPORT_SUBGRAPH);
+  PathSearch search(csrGraph, &avoidPointIDs, options, timer.getCounts());
+  search.clearSelection();
+  for (size_t i = 0; i + 1 < waypointIDs.size(); ++i) {
+    search.selectBetween(waypointIDs[i], waypointIDs[i + 1],
+                         exportOptions.getMaxDepth(),
+                         exportOptions.getMaxVertices());
+  }
+  writeSelection(search, os, exportOptions.getFormat());
+}
+
+void Graph::buildIndexes() {
+  ScopedTimer timer(stats, StatsPhase::BUILD_INDEXES);
+  std::vector<const Vertex*> vertexPtrs;
+  vertexPtrs.reserve(boost::num_vertices(graph));
   BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType)) {
-      vertexIDs.push_back(v);
+    vertexPtrs.push_back(&graph[v]);
+  }
+  csrGraph.build(graph);
+  // Condense the graph for each setting of traverse registers in parallel,
+  // unless a reachability index read from a snapshot already has.
+  std::array<std::future<void>, 2> futures;
+  for (auto traverseRegisters : {false, true}) {
+    auto &index = reachabilityIndexes[traverseRegisters];
+    if (index.isBuilt()) {
+      componentGraphs[traverseRegisters] = index.getComponentGraph();
+      continue;
+    }
+    futures[traverseRegisters] = std::async(std::launch::async, [this, traverseRegisters] {
+      auto components = std::make_shared<ComponentGraph>();
+      components->build(csrGraph, traverseRegisters);
+      componentGraphs[traverseRegisters] = std::move(components);
+    });
+  }
+  nameIndex.build(vertexPtrs);
+  vertexClasses.build(vertexPtrs);
+  for (auto &future : futures) {
+    if (future.valid()) {
+      future.get();
     }
   }
-  return vertexIDs;
+  if (Options::getInstance().shouldBuildReachabilityIndex()) {
+    buildReachabilityIndexes();
+  }
 }
 
-/// This implementation will allow the name to contain other regular expression
-/// syntax, and should be improved to match the wildcards directly.
-VertexIDVec Graph::getVerticesWildcard(const std::string &name,
-                                       VertexNetlistType graphType) const {
-  auto nameStr(name);
-  if (Options::getInstance().shouldIgnoreHierarchyMarkers()) {
-    // Ignore '/', '.' and '_' characters.
-    std::replace(nameStr.begin(), nameStr.end(), '/', '?');
-    std::replace(nameStr.begin(), nameStr.end(), '.', '?');
-    std::replace(nameStr.begin(), nameStr.end(), '_', '?');
+void Graph::buildReachabilityIndexes() {
+  ScopedTimer timer(stats, StatsPhase::BUILD_REACHABILITY_INDEXES);
+  for (auto traverseRegisters : {false, true}) {
+    auto &index = reachabilityIndexes[traverseRegisters];
+    if (!index.isBuilt()) {
+      index.build(componentGraphs[traverseRegisters]);
+    }
   }
-  VertexIDVec vertexIDs;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType) &&
-        wildcardMatch(graph[v].getName(), nameStr)) {
-      vertexIDs.push_back(v);
+}
+
+/// The minimum number of names scanned by each thread matching a pattern.
+constexpr size_t MIN_NAMES_PER_THREAD = 1 << 14;
+
+/// Apply a function to consecutive chunks of a range of the name table in
+/// parallel, returning the result for each chunk in order.
+template<typename Result, typename ScanFn>
+static std::vector<Result> scanChunks(NameIndex::Range range, ScanFn scan) {
+  auto numNames = range.second - range.first;
+  size_t numChunks = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()),
+                                      numNames / MIN_NAMES_PER_THREAD);
+  if (numChunks <= 1) {
+    return {scan(range.first, range.second)};
+  }
+  std::vector<std::future<Result>> futures;
+  for (size_t i = 0; i < numChunks; ++i) {
+    auto begin = range.first + ((numNames * i) / numChunks);
+    auto end = range.first + ((numNames * (i + 1)) / numChunks);
+    futures.push_back(std::async(std::launch::async, scan, begin, end));
+  }
+  std::vector<Result> results;
+  for (auto &future : futures) {
+    results.push_back(future.get());
+  }
+  return results;
+}
+
+std::shared_ptr<const Pattern> Graph::getPattern(const std::string &pattern,
+                                                 const QueryOptions &options) const {
+  assert(!options.isMatchExact() && "exact names are not patterns");
+  return patternCache.get(pattern,
+                          options.isMatchRegex() ? MatchType::REGEX : MatchType::WILDCARD,
+                          options.shouldIgnoreHierarchyMarkers());
+}
+
+/// Return the matching vertices in the order of the name table. Only the
+/// names starting with the literal prefix of the pattern are scanned.
+VertexIDVec Graph::matchVertices(const Pattern &pattern,
+                                 VertexNetlistType graphType,
+                                 const QueryOptions &options) const {
+  auto range = nameIndex.getPrefixRange(pattern.getPrefix());
+  auto &typeVertices = vertexClasses.get(graphType, options);
+  auto chunks = scanChunks<VertexIDVec>(range, [&](size_t begin, size_t end) {
+    VertexIDVec vertexIDs;
+    for (auto i = begin; i < end; ++i) {
+      auto v = nameIndex.getSortedVertex(i);
+      if (typeVertices.test(v) &&
+          pattern.match(nameIndex.getSortedName(i))) {
+        vertexIDs.push_back(v);
+      }
     }
+    return vertexIDs;
+  });
+  VertexIDVec vertexIDs;
+  for (auto &chunk : chunks) {
+    vertexIDs.insert(vertexIDs.end(), chunk.begin(), chunk.end());
   }
   return vertexIDs;
 }
 
+VertexIDVec Graph::getVerticesWildcard(const std::string &name,
+                                       VertexNetlistType graphType,
+                                       const QueryOptions &options) const {
+  auto pattern = patternCache.get(name, MatchType::WILDCARD,
+                                  options.shouldIgnoreHierarchyMarkers());
+  auto vertexIDs = matchVertices(*pattern, graphType, options);
+  std::sort(vertexIDs.begin(), vertexIDs.end());
+  return vertexIDs;
+}
+
 VertexIDVec Graph::getVerticesRegex(const std::string &name,
-                                    VertexNetlistType graphType) const {
-  auto nameStr(name);
-  if (Options::getInstance().shouldIgnoreHierarchyMarkers()) {
-    // Ignore '/' or '_' ('.' already matches any character).
-    std::replace(nameStr.begin(), nameStr.end(), '/', '.');
-    std::replace(nameStr.begin(), nameStr.end(), '_', '.');
-  }
-  // Catch any errors in the regex string.
-  std::regex nameRegex;
-  try {
-    nameRegex.assign(nameStr);
-  } catch(std::regex_error const &e) {
-    throw Exception(std::string("malformed regular expression: ")+e.what());
-  }
-  // Search the vertices.
-  VertexIDVec vertexIDs;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType) &&
-        std::regex_search(graph[v].getName(), nameRegex)) {
-      vertexIDs.push_back(v);
-    }
-  }
+                                    VertexNetlistType graphType,
+                                    const QueryOptions &options) const {
+  auto pattern = patternCache.get(name, MatchType::REGEX,
+                                  options.shouldIgnoreHierarchyMarkers());
+  auto vertexIDs = matchVertices(*pattern, graphType, options);
+  std::sort(vertexIDs.begin(), vertexIDs.end());
   return vertexIDs;
 }
 
 VertexID Graph::getVertexExact(const std::string &name,
-                               VertexNetlistType graphType) const {
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType) &&
-        graph[v].getName() == name) {
+                               VertexNetlistType graphType,
+                               const QueryOptions &options) const {
+  for (auto v : nameIndex.lookup(name)) {
+    if (vertexTypeMatch(v, graphType, options)) {
       return v;
     }
   }
@@ -317,157 +454,324 @@ VertexID Graph::getVertexExact(const std::string &name,
 }
 
 VertexIDVec Graph::getVertices(const std::string &pattern,
-                               VertexNetlistType graphType) const {
+                               VertexNetlistType graphType,
+                               const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::LOOKUP_VERTICES);
   if (pattern.empty()) {
-    return getVerticesByType(graphType);
+    return getVerticesByType(graphType, options);
   }
-  if (Options::getInstance().isMatchExact()) {
-    auto vertex = getVertexExact(pattern, graphType);
+  if (options.isMatchExact()) {
+    auto vertex = getVertexExact(pattern, graphType, options);
     return vertex != nullVertex() ? VertexIDVec{vertex} : VertexIDVec{};
   }
-  if (Options::getInstance().isMatchRegex()) {
-    return getVerticesRegex(pattern, graphType);
+  if (options.isMatchRegex()) {
+    return getVerticesRegex(pattern, graphType, options);
   }
-  if (Options::getInstance().isMatchWildcard()) {
-    return getVerticesWildcard(pattern, graphType);
+  if (options.isMatchWildcard()) {
+    return getVerticesWildcard(pattern, graphType, options);
   }
   return {};
 }
 
-/// Given the tree structure from a DFS, traverse the tree from leaf to root to
-/// return a path.
-VertexIDVec Graph::determinePath(ParentMap &parentMap,
-                                 VertexIDVec path,
-                                 VertexID startVertex,
-                                 VertexID finishVertex) const {
-  path.push_back(finishVertex);
-  if (finishVertex == startVertex) {
-    return path;
+std::vector<VertexIDVec>
+Graph::getVertices(const std::vector<std::pair<std::string, VertexNetlistType>> &patterns,
+                   const QueryOptions &options) const {
+  std::vector<VertexIDVec> results(patterns.size());
+  // Compile the patterns, and resolve empty and exact patterns directly.
+  std::vector<size_t> scanIndexes;
+  std::vector<std::shared_ptr<const Pattern>> compiled;
+  std::vector<NameIndex::Range> ranges;
+  std::vector<const VertexSet*> typeVertices;
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    auto &pattern = patterns[i].first;
+    if (pattern.empty() || options.isMatchExact()) {
+      results[i] = getVertices(pattern, patterns[i].second, options);
+    } else {
+      scanIndexes.push_back(i);
+      compiled.push_back(getPattern(pattern, options));
+      ranges.push_back(nameIndex.getPrefixRange(compiled.back()->getPrefix()));
+      typeVertices.push_back(&vertexClasses.get(patterns[i].second, options));
+    }
   }
-  if (parentMap[finishVertex].empty()) {
-    return VertexIDVec();
-  }
-  assert(parentMap[finishVertex].size() == 1);
-  auto nextVertex = parentMap[finishVertex].front();
-  assert(std::find(std::begin(path),
-                   std::end(path),
-                   nextVertex) == std::end(path));
-  return determinePath(parentMap, path, startVertex, nextVertex);
-}
-
-/// Determine all paths between a start and an end point.
-/// This performs a DFS starting at the end point. It is not feasible for large
-/// graphs since the number of simple paths grows exponentially.
-void Graph::determineAllPaths(ParentMap &parentMap,
-                              std::vector<VertexIDVec> &result,
-                              VertexIDVec path,
-                              VertexID startVertex,
-                              VertexID finishVertex) const {
-  path.push_back(finishVertex);
-  if (finishVertex == startVertex) {
-    BOOST_LOG_TRIVIAL(debug) << "Found path";
-    result.push_back(path);
-    return;
-  }
-  BOOST_LOG_TRIVIAL(debug) << boost::format("length %d vertex %s")
-                                % path.size() % graph[finishVertex].toString();
-  // Dump path.
-  if (Options::getInstance().isDebugMode()) {
-    for (auto v : path) {
-      if (!graph[v].isLogic()) {
-        BOOST_LOG_TRIVIAL(debug) << " " << graph[v].getName();
+  if (scanIndexes.empty()) {
+    return results;
+  }
+  ScopedTimer timer(stats, StatsPhase::LOOKUP_VERTICES);
+  // Scan the part of the name table covering all the pattern prefixes once,
+  // matching each name against the patterns whose prefix ranges contain it.
+  NameIndex::Range range(nameIndex.size(), 0);
+  for (auto &patternRange : ranges) {
+    range.first = std::min(range.first, patternRange.first);
+    range.second = std::max(range.second, patternRange.second);
+  }
+  if (range.first < range.second) {
+    auto chunks = scanChunks<std::vector<VertexIDVec>>(range, [&](size_t begin, size_t end) {
+      std::vector<VertexIDVec> matches(scanIndexes.size());
+      for (auto i = begin; i < end; ++i) {
+        auto v = nameIndex.getSortedVertex(i);
+        auto name = nameIndex.getSortedName(i);
+        for (size_t j = 0; j < scanIndexes.size(); ++j) {
+          if (i >= ranges[j].first && i < ranges[j].second &&
+              typeVertices[j]->test(v) &&
+              compiled[j]->match(name)) {
+            matches[j].push_back(v);
+          }
+        }
+      }
+      return matches;
+    });
+    for (auto &chunk : chunks) {
+      for (size_t j = 0; j < scanIndexes.size(); ++j) {
+        auto &result = results[scanIndexes[j]];
+        result.insert(result.end(), chunk[j].begin(), chunk[j].end());
       }
     }
   }
-  BOOST_LOG_TRIVIAL(debug) << (parentMap[finishVertex].empty() ? "DEAD END" : "");
-  for (auto vertex : parentMap[finishVertex]) {
-    if (std::find(std::begin(path), std::end(path), vertex) == std::end(path)) {
-      determineAllPaths(parentMap, result, path, startVertex, vertex);
-    } else {
-      BOOST_LOG_TRIVIAL(debug) << "Cycle detected";
+  for (auto i : scanIndexes) {
+    std::sort(results[i].begin(), results[i].end());
+  }
+  return results;
+}
+
+VertexIDVec Graph::getVerticesSortedByName(const std::string &pattern,
+                                           VertexNetlistType graphType,
+                                           const QueryOptions &options) const {
+  if (pattern.empty()) {
+    VertexIDVec vertexIDs;
+    for (auto v : nameIndex.getSortedVertices()) {
+      if (vertexTypeMatch(v, graphType, options)) {
+        vertexIDs.push_back(v);
+      }
     }
+    return vertexIDs;
+  }
+  if (options.isMatchExact()) {
+    auto vertex = getVertexExact(pattern, graphType, options);
+    return vertex != nullVertex() ? VertexIDVec{vertex} : VertexIDVec{};
   }
+  return matchVertices(*getPattern(pattern, options), graphType, options);
 }
 
-/// Report all paths fanning out from a net/register/port.
-std::vector<VertexIDVec>
-Graph::getAllFanOut(VertexID startVertex) const {
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate());
-  BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[startVertex].getName();
-  ParentMap parentMap;
-  boost::depth_first_search(filteredGraph,
-      boost::visitor(DfsVisitor(parentMap, false))
-        .root_vertex(startVertex));
-  // Check for a path between startPoint and each register.
+/// Return the DFS tree of a search from a root vertex without avoid points,
+/// from the traversal cache if it holds it, otherwise searching the graph and
+/// adding the tree to the cache.
+std::shared_ptr<const TraversalTree>
+Graph::getTraversalTree(VertexID rootVertex, bool reverse,
+                        const QueryOptions &options, SearchCounts *counts) const {
+  auto key = TraversalCache::getKey(rootVertex, reverse,
+                                    options.shouldTraverseRegisters());
+  if (auto tree = traversalCache.get(key)) {
+    stats.addTraversalCacheLookup(true);
+    return tree;
+  }
+  PathSearch search(csrGraph, nullptr, options, counts);
+  search.visitTree(rootVertex, reverse);
+  auto tree = std::make_shared<const TraversalTree>(search.copyTree());
+  stats.addTraversalCacheLookup(false, traversalCache.insert(key, tree));
+  return tree;
+}
+
+namespace {
+
+/// Return the paths in a DFS tree to each of a list of vertices that it
+/// reached, as it was searched or reversed.
+template<typename Tree>
+std::vector<VertexIDVec> getTreePaths(const Tree &tree,
+                                      const VertexIDVec &vertices,
+                                      bool reverse) {
   std::vector<VertexIDVec> paths;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (graph[v].isEndPoint()) {
-      auto path = determinePath(parentMap,
-                                VertexIDVec(),
-                                startVertex,
-                                static_cast<VertexID>(v));
-      if (!path.empty()) {
+  for (auto v : vertices) {
+    if (tree.isVisited(v)) {
+      auto path = tree.getTreePath(v);
+      if (reverse) {
         std::reverse(std::begin(path), std::end(path));
-        paths.push_back(path);
       }
+      paths.push_back(std::move(path));
     }
   }
   return paths;
 }
 
+/// Return the vertices of a list that a DFS tree reached.
+template<typename Tree>
+VertexIDVec getTreeVertices(const Tree &tree, const VertexIDVec &vertices) {
+  VertexIDVec result;
+  std::copy_if(vertices.begin(), vertices.end(), std::back_inserter(result),
+               [&tree](VertexID v) { return tree.isVisited(v); });
+  return result;
+}
+
+} // End anonymous namespace.
+
+/// Report all paths fanning out from a net/register/port.
+std::vector<VertexIDVec>
+Graph::getAllFanOut(VertexID startVertex, const QueryOptions &options) const {
+  BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[startVertex].getName();
+  ScopedTimer timer(stats, StatsPhase::FAN_OUT);
+  // Check for a path between startPoint and each register.
+  auto &endPoints = vertexClasses.getVertices(VertexNetlistType::END_POINT, options);
+  if (traversalCache.isEnabled()) {
+    auto tree = getTraversalTree(startVertex, false, options, timer.getCounts());
+    return getTreePaths(*tree, endPoints, true);
+  }
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.visitTree(startVertex);
+  return getTreePaths(search, endPoints, true);
+}
+
 /// Report all paths fanning into a net/register/port.
 std::vector<VertexIDVec>
-Graph::getAllFanIn(VertexID finishVertex) const {
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate());
-  auto reverseGraph = boost::make_reverse_graph(filteredGraph);
+Graph::getAllFanIn(VertexID finishVertex, const QueryOptions &options) const {
   BOOST_LOG_TRIVIAL(debug) << "Performing DFS in reverse graph from " << graph[finishVertex].getName();
-  ParentMap parentMap;
-  boost::depth_first_search(reverseGraph,
-      boost::visitor(DfsVisitor(parentMap, false))
-        .root_vertex(finishVertex));
+  ScopedTimer timer(stats, StatsPhase::FAN_IN);
   // Check for a path between endPoint and each register.
-  std::vector<VertexIDVec> paths;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (graph[v].isStartPoint()) {
-      auto path = determinePath(parentMap,
-                                VertexIDVec(),
-                                finishVertex,
-                                static_cast<VertexID>(v));
-      if (!path.empty()) {
-        paths.push_back(path);
-      }
-    }
-  }
-  return paths;
+  auto &startPoints = vertexClasses.getVertices(VertexNetlistType::START_POINT, options);
+  if (traversalCache.isEnabled()) {
+    auto tree = getTraversalTree(finishVertex, true, options, timer.getCounts());
+    return getTreePaths(*tree, startPoints, false);
+  }
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.visitTree(finishVertex, true);
+  return getTreePaths(search, startPoints, false);
 }
 
-/// Given a vector of vectors of paths (the set of all paths between each
-/// through point), return a vector of paths that is the cartesian product of
-/// the paths in each stage. Based on code in:
-///   https://stackoverflow.com/questions/5279051/how-can-i-create-cartesian-product-of-vector-of-vectors
-std::vector<VertexIDVec>
-pathProduct(const std::vector<std::vector<VertexIDVec>>& intPaths) {
-  std::vector<VertexIDVec> resultPaths = {{}};
-  for (const auto& stagePaths : intPaths) {
-    std::vector<VertexIDVec> newPaths;
-    // Multiply each of the existing (sub) paths, with the next sub paths.
-    // Ie for each path create a new path with the next sub path appended.
-    for (const auto& resultPath : resultPaths) {
-      for (const auto &subPath : stagePaths) {
-        VertexIDVec path(subPath);
-        std::reverse(path.begin(), path.end());
-        // Append the new sub path to the existing 'resultPath'.
-        newPaths.push_back(resultPath);
-        newPaths.back().insert(newPaths.back().end(), path.begin(), path.end()-1);
+/// Report the end points of the paths fanning out from a vertex.
+VertexIDVec Graph::getFanOutEndPoints(VertexID startVertex,
+                                      const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::FAN_OUT);
+  auto &endPoints = vertexClasses.getVertices(VertexNetlistType::END_POINT, options);
+  if (auto index = getReachabilityIndex(options)) {
+    return index->selectReachable(startVertex, endPoints);
+  }
+  if (traversalCache.isEnabled()) {
+    auto tree = getTraversalTree(startVertex, false, options, timer.getCounts());
+    return getTreeVertices(*tree, endPoints);
+  }
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.visitTree(startVertex);
+  return getTreeVertices(search, endPoints);
+}
+
+/// Report the start points of the paths fanning in to a vertex.
+VertexIDVec Graph::getFanInStartPoints(VertexID finishVertex,
+                                       const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::FAN_IN);
+  auto &startPoints = vertexClasses.getVertices(VertexNetlistType::START_POINT, options);
+  if (auto index = getReachabilityIndex(options)) {
+    return index->selectReachable(finishVertex, startPoints, true);
+  }
+  if (traversalCache.isEnabled()) {
+    auto tree = getTraversalTree(finishVertex, true, options, timer.getCounts());
+    return getTreeVertices(*tree, startPoints);
+  }
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.visitTree(finishVertex, true);
+  return getTreeVertices(search, startPoints);
+}
+
+/// Return the data type width of each of a list of vertices.
+std::vector<uint64_t> Graph::getDTypeWidths(const VertexIDVec &vertices) const {
+  std::vector<uint64_t> widths;
+  widths.reserve(vertices.size());
+  for (auto v : vertices) {
+    widths.push_back(graph[v].getDTypeWidth());
+  }
+  return widths;
+}
+
+/// Return the weight of each of a list of vertices.
+std::vector<double> Graph::getPathWeights(const VertexIDVec &vertices,
+                                          const PathWeights &weights) const {
+  std::vector<double> result;
+  result.reserve(vertices.size());
+  for (auto v : vertices) {
+    result.push_back(weights.getWeight(graph[v].getAstType()));
+  }
+  return result;
+}
+
+/// Count the fan out from a vertex to the end points.
+FanDegree Graph::getFanOutDegree(VertexID startVertex,
+                                 const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::FAN_DEGREE);
+  auto &endPoints = vertexClasses.getVertices(VertexNetlistType::END_POINT, options);
+  auto widths = getDTypeWidths(endPoints);
+  return withReachabilityIndex(options, [&](const ReachabilityIndex &index) {
+    return FanDegree::count(index, startVertex, endPoints, widths);
+  });
+}
+
+/// Count the fan in to a vertex from the start points.
+FanDegree Graph::getFanInDegree(VertexID finishVertex,
+                                const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::FAN_DEGREE);
+  auto &startPoints = vertexClasses.getVertices(VertexNetlistType::START_POINT, options);
+  auto widths = getDTypeWidths(startPoints);
+  return withReachabilityIndex(options, [&](const ReachabilityIndex &index) {
+    return FanDegree::count(index, finishVertex, startPoints, widths, true);
+  });
+}
+
+/// Count the fan out of all the start points.
+FanDegreeColumns Graph::getFanOutDegrees(const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::FAN_DEGREE);
+  auto &startPoints = vertexClasses.getVertices(VertexNetlistType::START_POINT, options);
+  auto &endPoints = vertexClasses.getVertices(VertexNetlistType::END_POINT, options);
+  auto widths = getDTypeWidths(endPoints);
+  return withReachabilityIndex(options, [&](const ReachabilityIndex &index) {
+    return FanDegreeColumns::count(index, startPoints, endPoints, widths, false,
+                                   options.getNumThreads());
+  });
+}
+
+/// Count the fan in of all the end points.
+FanDegreeColumns Graph::getFanInDegrees(const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::FAN_DEGREE);
+  auto &startPoints = vertexClasses.getVertices(VertexNetlistType::START_POINT, options);
+  auto &endPoints = vertexClasses.getVertices(VertexNetlistType::END_POINT, options);
+  auto widths = getDTypeWidths(startPoints);
+  return withReachabilityIndex(options, [&](const ReachabilityIndex &index) {
+    return FanDegreeColumns::count(index, endPoints, startPoints, widths, true,
+                                   options.getNumThreads());
+  });
+}
+
+/// Compute the start and end point connectivity matrix.
+ConnectivityMatrix Graph::getCombConnectivity(const QueryOptions &options) const {
+  // The restricted start and end point classes are the combinational start
+  // and end points.
+  auto combOptions = options.withRestrictStartPoints(true)
+                            .withRestrictEndPoints(true)
+                            .withTraverseRegisters(false);
+  auto &startPoints = vertexClasses.getVertices(VertexNetlistType::START_POINT, combOptions);
+  auto &endPoints = vertexClasses.getVertices(VertexNetlistType::END_POINT, combOptions);
+  return withReachabilityIndex(combOptions, [&](const ReachabilityIndex &index) {
+    return ConnectivityMatrix::build(index, startPoints, endPoints,
+                                     options.getNumThreads());
+  });
+}
+
+/// Find the components of the graph without traversing registers that are
+/// loops. The back edges added between a variable and its aliases form cycles
+/// through ASSIGN_ALIAS vertices only, so a loop must also pass through
+/// another logic vertex.
+std::vector<VertexIDVec> Graph::getCombLoops() const {
+  auto &components = *componentGraphs[false];
+  auto isLoopLogic = [this](ComponentGraph::Index vertex) {
+    auto &v = graph[vertex];
+    return v.isLogic() && v.getAstType() != VertexAstType::ASSIGN_ALIAS;
+  };
+  std::vector<VertexIDVec> loops;
+  for (size_t c = components.numComponents(); c-- > 0;) {
+    auto component = static_cast<ComponentGraph::Index>(c);
+    if (components.isCycle(csrGraph, component)) {
+      auto members = components.getMembers(component);
+      if (std::any_of(members.first, members.second, isLoopLogic)) {
+        loops.emplace_back(members.first, members.second);
       }
     }
-    resultPaths = std::move(newPaths);
   }
-  return resultPaths;
+  return loops;
 }
 
 /// Return true if exactly two waypoints correspond to aliases of the same variable.
@@ -482,54 +786,41 @@ bool Graph::isAliasPath(const VertexIDVec &waypointIDs) const {
 }
 
 /// Report all paths between start and finish points.
-/// Though points currently unsupported.
 std::vector<VertexIDVec>
 Graph::getAllPointToPoint(const VertexIDVec &waypointIDs,
-                          const VertexIDVec &avoidPointIDs) const {
+                          const VertexIDVec &avoidPointIDs,
+                          const QueryOptions &options) const {
+  auto paths = enumeratePointToPoint(waypointIDs, avoidPointIDs, options, PathLimits());
+  return std::vector<VertexIDVec>(paths.begin(), paths.end());
+}
+
+/// Enumerate the paths between start and finish points.
+PathEnumerator
+Graph::enumeratePointToPoint(const VertexIDVec &waypointIDs,
+                             const VertexIDVec &avoidPointIDs,
+                             const QueryOptions &options,
+                             const PathLimits &limits) const {
+  ScopedTimer timer(stats, StatsPhase::ALL_PATHS);
   // Special case for paths between aliases of the same variable.
   if (isAliasPath(waypointIDs)) {
     BOOST_LOG_TRIVIAL(debug) << boost::format("%s is alias of %s")
                                   % graph[waypointIDs[0]].getName()
                                   % graph[waypointIDs[1]].getName();
-    return {{waypointIDs[0], waypointIDs[1]}};
+    return PathEnumerator({waypointIDs[0], waypointIDs[1]}, limits);
   }
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate(&avoidPointIDs));
-  std::vector<std::vector<VertexIDVec> > intPaths;
-  // Elaborate all paths between each adjacent waypoint.
   for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
-    auto beginVertex = waypointIDs[i];
-    auto endVertex = waypointIDs[i+1];
-    BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[beginVertex].getName();
-    ParentMap parentMap;
-    boost::depth_first_search(filteredGraph,
-        boost::visitor(DfsVisitor(parentMap, true))
-          .root_vertex(beginVertex));
-    BOOST_LOG_TRIVIAL(debug) << "Determining all paths to " << graph[endVertex].getName();
-    std::vector<VertexIDVec> paths;
-    determineAllPaths(parentMap,
-                      paths,
-                      VertexIDVec(),
-                      beginVertex,
-                      endVertex);
-    if (paths.empty()) {
-      // No paths exist.
-      return {};
-    }
-    intPaths.push_back(paths);
+    BOOST_LOG_TRIVIAL(debug) << "Determining all paths from " << graph[waypointIDs[i]].getName()
+                             << " to " << graph[waypointIDs[i+1]].getName();
   }
-  // Construct the final paths.
-  auto paths = pathProduct(intPaths);
-  for (auto &path : paths) {
-    path.push_back(waypointIDs.back());
-  }
-  return paths;
+  return PathEnumerator(csrGraph, waypointIDs, avoidPointIDs, options, limits,
+                        timer.getCounts());
 }
 
 /// Report a single path between a set of named points.
 VertexIDVec Graph::getAnyPointToPoint(const VertexIDVec &waypointIDs,
-                                      const VertexIDVec &avoidPointIDs) const {
+                                      const VertexIDVec &avoidPointIDs,
+                                      const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::ANY_PATH);
   // Special case for paths between aliases of the same variable.
   if (isAliasPath(waypointIDs)) {
     BOOST_LOG_TRIVIAL(debug) << boost::format("%s is alias of %s")
@@ -537,31 +828,127 @@ VertexIDVec Graph::getAnyPointToPoint(const VertexIDVec &waypointIDs,
                                   % graph[waypointIDs[1]].getName();
     return {waypointIDs[0], waypointIDs[1]};
   }
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate(&avoidPointIDs));
   std::vector<VertexID> path;
+  if (avoidPointIDs.empty() && traversalCache.isEnabled()) {
+    // The path found by a search from the start vertex that stops at the
+    // finish vertex is the path to it in the whole DFS tree of the start
+    // vertex, so each leg is taken from the cached tree of its start.
+    for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+      auto tree = getTraversalTree(waypointIDs[i], false, options,
+                                   timer.getCounts());
+      if (!tree->isVisited(waypointIDs[i+1])) {
+        return VertexIDVec();
+      }
+      auto subPath = tree->getTreePath(waypointIDs[i+1]);
+      path.insert(std::end(path), std::rbegin(subPath), std::rend(subPath)-1);
+    }
+    path.push_back(waypointIDs.back());
+    return path;
+  }
+  PathSearch search(csrGraph, &avoidPointIDs, options, timer.getCounts());
   // Construct the path between each adjacent waypoint.
   for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
     auto startVertex = waypointIDs[i];
     auto finishVertex = waypointIDs[i+1];
-    BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[startVertex].getName();
-    ParentMap parentMap;
-    boost::depth_first_search(filteredGraph,
-        boost::visitor(DfsVisitor(parentMap, false))
-          .root_vertex(startVertex));
-    BOOST_LOG_TRIVIAL(debug) << "Determining a path to " << graph[finishVertex].getName();
-    auto subPath = determinePath(parentMap,
-                                 VertexIDVec(),
-                                 startVertex,
-                                 finishVertex);
+    BOOST_LOG_TRIVIAL(debug) << "Searching for a path from " << graph[startVertex].getName()
+                             << " to " << graph[finishVertex].getName();
+    auto subPath = search.findPath(startVertex, finishVertex);
     if (subPath.empty()) {
       // No path exists.
       return VertexIDVec();
     }
-    std::reverse(std::begin(subPath), std::end(subPath));
     path.insert(std::end(path), std::begin(subPath), std::end(subPath)-1);
   }
   path.push_back(waypointIDs.back());
   return path;
 }
+
+/// Determine whether a path exists between a set of named points.
+bool Graph::pathExists(const VertexIDVec &waypointIDs,
+                       const VertexIDVec &avoidPointIDs,
+                       const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::PATH_EXISTS);
+  if (isAliasPath(waypointIDs)) {
+    return true;
+  }
+  auto index = getReachabilityIndex(options);
+  if (index && avoidPointIDs.empty()) {
+    for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+      if (!index->reaches(waypointIDs[i], waypointIDs[i+1])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  PathSearch search(csrGraph, &avoidPointIDs, options, timer.getCounts());
+  for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+    if (!search.pathExists(waypointIDs[i], waypointIDs[i+1])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Report the deepest paths between a set of named points.
+std::vector<VertexIDVec>
+Graph::getDeepestPointToPoint(const VertexIDVec &waypointIDs,
+                              const VertexIDVec &avoidPointIDs,
+                              size_t numPaths,
+                              const PathWeights &weights,
+                              const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::DEEPEST_PATHS);
+  // Special case for paths between aliases of the same variable.
+  if (isAliasPath(waypointIDs)) {
+    return {{waypointIDs[0], waypointIDs[1]}};
+  }
+  PathSearch search(csrGraph, &avoidPointIDs, options, timer.getCounts());
+  DeepestPaths paths(getComponentGraph(options), numPaths);
+  paths.start(waypointIDs.front(),
+              weights.getWeight(graph[waypointIDs.front()].getAstType()));
+  // Extend the paths over the subgraph between each adjacent waypoint.
+  for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+    BOOST_LOG_TRIVIAL(debug) << "Searching for the deepest paths from "
+                             << graph[waypointIDs[i]].getName()
+                             << " to " << graph[waypointIDs[i+1]].getName();
+    search.clearSelection();
+    search.selectBetween(waypointIDs[i], waypointIDs[i+1], 0, 0);
+    if (!paths.extend(search, getPathWeights(search.getSelection(), weights),
+                      {waypointIDs[i+1]})) {
+      // No path exists.
+      return {};
+    }
+  }
+  return paths.getPaths();
+}
+
+/// Report the deepest paths fanning out from a net/register/port.
+std::vector<VertexIDVec>
+Graph::getDeepestFanOut(VertexID startVertex, size_t numPaths,
+                        const PathWeights &weights,
+                        const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::DEEPEST_PATHS);
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.clearSelection();
+  search.selectCone(startVertex, false, 0, 0);
+  DeepestPaths paths(getComponentGraph(options), numPaths);
+  paths.start(startVertex, weights.getWeight(graph[startVertex].getAstType()));
+  paths.extend(search, getPathWeights(search.getSelection(), weights),
+               vertexClasses.getVertices(VertexNetlistType::END_POINT, options));
+  return paths.getPaths();
+}
+
+/// Report the deepest paths fanning into a net/register/port.
+std::vector<VertexIDVec>
+Graph::getDeepestFanIn(VertexID endVertex, size_t numPaths,
+                       const PathWeights &weights,
+                       const QueryOptions &options) const {
+  ScopedTimer timer(stats, StatsPhase::DEEPEST_PATHS);
+  PathSearch search(csrGraph, nullptr, options, timer.getCounts());
+  search.clearSelection();
+  search.selectCone(endVertex, true, 0, 0);
+  DeepestPaths paths(getComponentGraph(options), numPaths, true);
+  paths.start(endVertex, weights.getWeight(graph[endVertex].getAstType()));
+  paths.extend(search, getPathWeights(search.getSelection(), weights),
+               vertexClasses.getVertices(VertexNetlistType::START_POINT, options));
+  return paths.getPaths();
+}
@@ -0,0 +1,164 @@
+#include "netlist_paths/GraphWriter.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+/// The number of bytes formatted before each write to the stream.
+constexpr size_t BUFFER_SIZE = 1 << 16;
+
+} // End anonymous namespace.
+
+GraphWriter::GraphWriter(std::ostream &os, ExportFormat format) :
+    os(os), format(format), buffer(BUFFER_SIZE), size(0), numVertices(0),
+    numEdges(0), writingEdges(false), finished(false) {
+  switch (format) {
+    case ExportFormat::DOT:
+      write("digraph netlist {\n");
+      break;
+    case ExportFormat::GRAPHML:
+      write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+            "  <key id=\"name\" for=\"node\" attr.name=\"name\" attr.type=\"string\"/>\n"
+            "  <key id=\"type\" for=\"node\" attr.name=\"type\" attr.type=\"string\"/>\n"
+            "  <graph id=\"netlist\" edgedefault=\"directed\">\n");
+      break;
+    case ExportFormat::JSON:
+      write("{\"vertices\": [");
+      break;
+  }
+}
+
+void GraphWriter::write(uint64_t value) {
+  char digits[20];
+  size_t length = 0;
+  do {
+    digits[length++] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  while (length > 0) {
+    write(digits[--length]);
+  }
+}
+
+void GraphWriter::writeEscaped(std::string_view value) {
+  for (auto c : value) {
+    switch (format) {
+      case ExportFormat::DOT:
+      case ExportFormat::JSON:
+        if (c == '"' || c == '\\') {
+          write('\\');
+        } else if (format == ExportFormat::JSON &&
+                   static_cast<unsigned char>(c) < 0x20) {
+          const char *hex = "0123456789abcdef";
+          write("\\u00");
+          write(hex[c >> 4]);
+          write(hex[c & 0xf]);
+          continue;
+        }
+        write(c);
+        break;
+      case ExportFormat::GRAPHML:
+        switch (c) {
+          case '&': write("&amp;"); break;
+          case '<': write("&lt;"); break;
+          case '>': write("&gt;"); break;
+          case '"': write("&quot;"); break;
+          default:  write(c); break;
+        }
+        break;
+    }
+  }
+}
+
+void GraphWriter::writeVertex(uint64_t id, const Vertex &vertex) {
+  switch (format) {
+    case ExportFormat::DOT:
+      write(id);
+      write(" [label=\"");
+      writeEscaped(vertex.getName());
+      write(' ');
+      writeEscaped(vertex.getAstTypeStr());
+      write("\"]\n");
+      break;
+    case ExportFormat::GRAPHML:
+      write("    <node id=\"n");
+      write(id);
+      write("\"><data key=\"name\">");
+      writeEscaped(vertex.getName());
+      write("</data><data key=\"type\">");
+      writeEscaped(vertex.getAstTypeStr());
+      write("</data></node>\n");
+      break;
+    case ExportFormat::JSON:
+      write(numVertices == 0 ? "\n  " : ",\n  ");
+      write("{\"id\": ");
+      write(id);
+      write(", \"name\": \"");
+      writeEscaped(vertex.getName());
+      write("\", \"type\": \"");
+      writeEscaped(vertex.getAstTypeStr());
+      write("\"}");
+      break;
+  }
+  ++numVertices;
+}
+
+void GraphWriter::beginEdges() {
+  if (format == ExportFormat::JSON) {
+    write(numVertices == 0 ? "],\n \"edges\": [" : "\n ],\n \"edges\": [");
+  }
+  writingEdges = true;
+}
+
+void GraphWriter::writeEdge(uint64_t source, uint64_t target) {
+  if (!writingEdges) {
+    beginEdges();
+  }
+  switch (format) {
+    case ExportFormat::DOT:
+      write(source);
+      write(" -> ");
+      write(target);
+      write(";\n");
+      break;
+    case ExportFormat::GRAPHML:
+      write("    <edge source=\"n");
+      write(source);
+      write("\" target=\"n");
+      write(target);
+      write("\"/>\n");
+      break;
+    case ExportFormat::JSON:
+      write(numEdges == 0 ? "\n  [" : ",\n  [");
+      write(source);
+      write(", ");
+      write(target);
+      write(']');
+      break;
+  }
+  ++numEdges;
+}
+
+void GraphWriter::finish() {
+  if (finished) {
+    return;
+  }
+  if (!writingEdges) {
+    beginEdges();
+  }
+  switch (format) {
+    case ExportFormat::DOT:
+      write("}\n");
+      break;
+    case ExportFormat::GRAPHML:
+      write("  </graph>\n</graphml>\n");
+      break;
+    case ExportFormat::JSON:
+      write(numEdges == 0 ? "]}\n" : "\n ]}\n");
+      break;
+  }
+  flush();
+  os.flush();
+  finished = true;
+}
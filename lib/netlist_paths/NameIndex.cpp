@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cstring>
+#include "netlist_paths/NameIndex.hpp"
+
+using namespace netlist_paths;
+
+void NameIndex::build(const std::vector<const Vertex*> &vertices) {
+  clear();
+  // Sort the vertices, keeping equal vertices in order of vertex ID.
+  sortedVertices.reserve(vertices.size());
+  for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+    sortedVertices.push_back(vertex);
+  }
+  std::stable_sort(sortedVertices.begin(), sortedVertices.end(),
+                   [&vertices](size_t a, size_t b) {
+                     return vertices[a]->compareLessThan(*vertices[b]); });
+  sortedNames.reserve(sortedVertices.size());
+  for (auto vertex : sortedVertices) {
+    sortedNames.push_back(vertices[vertex]->getName());
+  }
+  // Map names to vertices, in ascending order of vertex ID.
+  exactNames.reserve(vertices.size());
+  for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+    auto name = vertices[vertex]->getName();
+    if (!name.empty()) {
+      exactNames[name].push_back(vertex);
+    }
+  }
+}
+
+void NameIndex::clear() {
+  exactNames.clear();
+  sortedVertices.clear();
+  sortedNames.clear();
+}
+
+const NameIndex::VertexIDVec &NameIndex::lookup(const std::string &name) const {
+  auto it = exactNames.find(name);
+  return it != exactNames.end() ? it->second : noVertices;
+}
+
+NameIndex::Range NameIndex::getPrefixRange(const std::string &prefix) const {
+  if (prefix.empty()) {
+    return std::make_pair(0, sortedNames.size());
+  }
+  std::string_view prefixView(prefix);
+  auto begin = std::lower_bound(sortedNames.begin(), sortedNames.end(), prefixView);
+  auto end = std::upper_bound(begin, sortedNames.end(), prefixView,
+                              [](std::string_view prefix, std::string_view name) {
+                                return name.substr(0, prefix.size()) > prefix; });
+  return std::make_pair(begin - sortedNames.begin(), end - sortedNames.begin());
+}
+
+std::string NameIndex::getWildcardPrefix(const std::string &pattern) {
+  return pattern.substr(0, pattern.find_first_of("*?"));
+}
+
+std::string NameIndex::getRegexPrefix(const std::string &pattern) {
+  // Searches are not anchored unless the pattern starts with '^', and any
+  // alternation may apply to the whole pattern.
+  if (pattern.empty() || pattern.front() != '^' ||
+      pattern.find('|') != std::string::npos) {
+    return std::string();
+  }
+  std::string prefix;
+  for (size_t i = 1; i < pattern.size(); ++i) {
+    if (std::strchr("\\.[](){}*+?^$", pattern[i])) {
+      // A quantifier can make the preceding character optional.
+      if (!prefix.empty() && std::strchr("*?{", pattern[i])) {
+        prefix.pop_back();
+      }
+      break;
+    }
+    prefix.push_back(pattern[i]);
+  }
+  return prefix;
+}
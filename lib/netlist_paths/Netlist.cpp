@@ -1,21 +1,46 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
 #include <regex>
 #include <boost/format.hpp>
 #include "netlist_paths/Netlist.hpp"
 #include "netlist_paths/ReadVerilatorXML.hpp"
+#include "netlist_paths/Snapshot.hpp"
+#include "netlist_paths/ThreadPool.hpp"
 
 using namespace netlist_paths;
 
-Netlist::Netlist(const std::string &filename) {
+Netlist::Netlist(const std::string &filename) :
+    parserPeakMemory(0) {
   Options::getInstance(); // Create singleton object.
-  ReadVerilatorXML(graph, files, dtypes, filename);
-  graph.markAliasRegisters();
-  graph.splitRegVertices();
-  graph.updateVarAliases();
+  if (ReadSnapshot::isSnapshot(filename)) {
+    // Snapshots are written after post processing.
+    {
+      ScopedTimer timer(graph.getStats(), StatsPhase::READ_SNAPSHOT);
+      ReadSnapshot(graph, files, dtypes, filename);
+    }
+    graph.buildIndexes();
+    indexDTypes();
+    return;
+  }
+  ReadVerilatorXML reader(graph, files, dtypes, filename);
+  parserPeakMemory = reader.getPeakMemory();
+  auto numThreads = Options::getInstance().getNumThreads();
+  graph.markAliasRegisters(numThreads);
+  graph.splitRegVertices(numThreads);
+  graph.updateVarAliases(numThreads);
+  graph.buildIndexes();
+  indexDTypes();
+}
+
+void Netlist::writeSnapshot(const std::string &filename) const {
+  WriteSnapshot(graph, files, dtypes, filename);
 }
 
 std::vector<Vertex*>
-Netlist::createVertexPtrVec(VertexIDVec vertices) const {
+Netlist::createVertexPtrVec(const VertexIDVec &vertices) const {
   auto result = std::vector<Vertex*>();
+  result.reserve(vertices.size());
   for (auto vertexId : vertices) {
     result.push_back(graph.getVertexPtr(vertexId));
   }
@@ -23,14 +48,22 @@ Netlist::createVertexPtrVec(VertexIDVec vertices) const {
 }
 
 std::vector<std::vector<Vertex*> >
-Netlist::createVertexPtrVecVec(std::vector<VertexIDVec> paths) const {
+Netlist::createVertexPtrVecVec(const std::vector<VertexIDVec> &paths) const {
   auto result = std::vector<std::vector<Vertex*> >();
-  for (auto vertexIdVec : paths) {
+  result.reserve(paths.size());
+  for (auto &vertexIdVec : paths) {
     result.push_back(createVertexPtrVec(vertexIdVec));
   }
   return result;
 }
 
+VertexID Netlist::checkVertexID(PathArray::ID vertexID) const {
+  if (vertexID >= graph.numVertices()) {
+    throw Exception(std::string("invalid vertex ID ")+std::to_string(vertexID));
+  }
+  return static_cast<VertexID>(vertexID);
+}
+
 const std::string
 Netlist::reportMultipleMatches(VertexIDVec vertices,
                                const std::string name,
@@ -45,8 +78,9 @@ Netlist::reportMultipleMatches(VertexIDVec vertices,
 }
 
 VertexID Netlist::getVertex(const std::string &name,
-                                 VertexNetlistType vertexType) const {
-  auto vertices = graph.getVertices(name, vertexType);
+                            VertexNetlistType vertexType,
+                            const QueryOptions &options) const {
+  auto vertices = graph.getVertices(name, vertexType, options);
   if (vertices.size() > 1) {
     throw Exception(reportMultipleMatches(vertices, name));
   }
@@ -56,11 +90,13 @@ VertexID Netlist::getVertex(const std::string &name,
   return graph.nullVertex();
 }
 
-VertexID Netlist::getRegVertex(const std::string &name, bool matchAny) const {
-  auto vertices = graph.getRegVertices(name);
+VertexID Netlist::selectVertex(const VertexIDVec &vertices,
+                               const std::string &name,
+                               bool matchAny,
+                               const std::string &patternType) const {
   if (!matchAny) {
     if (vertices.size() > 1) {
-      throw Exception(reportMultipleMatches(vertices, name, "register"));
+      throw Exception(reportMultipleMatches(vertices, name, patternType));
     }
     if (vertices.size() == 1) {
       return vertices.front();
@@ -73,78 +109,36 @@ VertexID Netlist::getRegVertex(const std::string &name, bool matchAny) const {
   return graph.nullVertex();
 }
 
-VertexID Netlist::getRegAliasVertex(const std::string &name, bool matchAny) const {
-  auto vertices = graph.getRegAliasVertices(name);
-  if (!matchAny) {
-    if (vertices.size() > 1) {
-      throw Exception(reportMultipleMatches(vertices, name, "register alias"));
-    }
-    if (vertices.size() == 1) {
-      return vertices.front();
-    }
-  } else {
-    if (vertices.size()) {
-      return vertices.front();
-    }
-  }
-  return graph.nullVertex();
+VertexID Netlist::getRegVertex(const std::string &name, bool matchAny,
+                               const QueryOptions &options) const {
+  return selectVertex(graph.getRegVertices(name, options), name, matchAny, "register");
 }
 
-VertexID Netlist::getStartVertex(const std::string &name, bool matchAny) const {
-  auto vertices = graph.getStartVertices(name);
-  if (!matchAny) {
-    if (vertices.size() > 1) {
-      throw Exception(reportMultipleMatches(vertices, name, "begin point"));
-    }
-    if (vertices.size() == 1) {
-      return vertices.front();
-    }
-  } else {
-    if (vertices.size()) {
-      return vertices.front();
-    }
-  }
-  return graph.nullVertex();
+VertexID Netlist::getRegAliasVertex(const std::string &name, bool matchAny,
+                                    const QueryOptions &options) const {
+  return selectVertex(graph.getRegAliasVertices(name, options), name, matchAny, "register alias");
 }
 
-VertexID Netlist::getEndVertex(const std::string &name, bool matchAny) const {
-  auto vertices = graph.getEndVertices(name);
-  if (!matchAny) {
-    if (vertices.size() > 1) {
-      throw Exception(reportMultipleMatches(vertices, name, "end point"));
-    }
-    if (vertices.size() == 1) {
-      return vertices.front();
-    }
-  } else {
-    if (vertices.size()) {
-      return vertices.front();
-    }
-  }
-  return graph.nullVertex();
+VertexID Netlist::getStartVertex(const std::string &name, bool matchAny,
+                                 const QueryOptions &options) const {
+  return selectVertex(graph.getStartVertices(name, options), name, matchAny, "begin point");
 }
 
-VertexID Netlist::getMidVertex(const std::string &name, bool matchAny) const {
-  auto vertices = graph.getMidVertices(name);
-  if (!matchAny) {
-    if (vertices.size() > 1) {
-      throw Exception(reportMultipleMatches(vertices, name, "mid point"));
-    }
-    if (vertices.size() == 1) {
-      return vertices.front();
-    }
-  } else {
-    if (vertices.size()) {
-      return vertices.front();
-    }
-  }
-  return graph.nullVertex();
+VertexID Netlist::getEndVertex(const std::string &name, bool matchAny,
+                               const QueryOptions &options) const {
+  return selectVertex(graph.getEndVertices(name, options), name, matchAny, "end point");
+}
+
+VertexID Netlist::getMidVertex(const std::string &name, bool matchAny,
+                               const QueryOptions &options) const {
+  return selectVertex(graph.getMidVertices(name, options), name, matchAny, "mid point");
 }
 
 const std::string
 Netlist::getVertexDTypeStr(const std::string &name,
-                           VertexNetlistType vertexType) const {
-  auto vertex = getVertex(name, vertexType);
+                           VertexNetlistType vertexType,
+                           const QueryOptions &options) const {
+  auto vertex = getVertex(name, vertexType, options);
   if (vertex == graph.nullVertex()) {
     throw Exception(std::string("could not find vertex "+name));
   }
@@ -153,151 +147,496 @@ Netlist::getVertexDTypeStr(const std::string &name,
 
 size_t
 Netlist::getVertexDTypeWidth(const std::string &name,
-                             VertexNetlistType vertexType) const {
-  auto vertex = getVertex(name, vertexType);
+                             VertexNetlistType vertexType,
+                             const QueryOptions &options) const {
+  auto vertex = getVertex(name, vertexType, options);
   if (vertex == graph.nullVertex()) {
     throw Exception(std::string("could not find vertex "+name));
   }
   return graph.getVertex(vertex).getDTypeWidth();
 }
 
-const std::shared_ptr<DType> Netlist::getDType(const std::string &name) const {
-  auto dtype = std::find_if(std::begin(dtypes), std::end(dtypes),
-                            [&name](const std::shared_ptr<DType> &dt) {
-                              return dt->getName() == name; });
-  if (dtype != std::end(dtypes)) {
-    return *dtype;
-  } else {
-    return std::shared_ptr<DType>();
+void Netlist::indexDTypes() {
+  dtypeNames.reserve(dtypes.size());
+  for (auto &dtype : dtypes) {
+    // The first dtype with a name is found, as in the order of the typetable.
+    if (dtypeNames.count(dtype->getName()) == 0) {
+      dtypeNames.emplace(dtype->getName(), graph.addDType(dtype));
+    }
   }
 }
 
+uint32_t Netlist::getDType(const std::string &name) const {
+  auto it = dtypeNames.find(name);
+  return it != dtypeNames.end() ? it->second : DTypeTable::NO_DTYPE;
+}
+
 size_t Netlist::getDTypeWidth(const std::string &name) const {
-  if (auto dtype = getDType(name)) {
-    return dtype->getWidth();
-  } else {
+  auto dtype = getDType(name);
+  if (dtype == DTypeTable::NO_DTYPE) {
     throw Exception(std::string("could not find dtype "+name));
   }
+  return graph.getDTypeTable().get(dtype).getWidth();
 }
 
-VertexIDVec Netlist::readWaypoints(Waypoints waypoints) const {
-  VertexIDVec waypointIDs;
-  for (auto it = waypoints.getWaypoints().begin();
-            it != waypoints.getWaypoints().end(); ++it) {
-    VertexID vertex;
-    // Start
-    if (it == waypoints.getWaypoints().begin()) {
-      vertex = getStartVertex(*it, Options::getInstance().isMatchAnyVertex());
-      if (vertex == graph.nullVertex()) {
-        throw Exception(std::string("could not find start vertex matching ")+*it);
+void Netlist::readWaypoints(const std::vector<Waypoints> &waypoints,
+                            std::vector<VertexIDVec> &waypointIDs,
+                            std::vector<VertexIDVec> &avoidPointIDs,
+                            const QueryOptions &options) const {
+  // Collect the distinct patterns and their vertex types so they are all
+  // matched in one scan of the vertex names.
+  using PatternKey = std::pair<std::string, VertexNetlistType>;
+  std::vector<PatternKey> patterns;
+  std::map<PatternKey, size_t> patternIndexes;
+  auto addPattern = [&](const std::string &name, VertexNetlistType type) {
+    auto result = patternIndexes.emplace(PatternKey(name, type), patterns.size());
+    if (result.second) {
+      patterns.emplace_back(name, type);
+    }
+  };
+  for (auto &query : waypoints) {
+    auto &names = query.getWaypoints();
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (i == 0) {
+        addPattern(names[i], VertexNetlistType::START_POINT);
+      } else if (i + 1 == names.size()) {
+        addPattern(names[i], VertexNetlistType::END_POINT);
+      } else {
+        addPattern(names[i], VertexNetlistType::MID_POINT);
       }
-    // Finish
-    } else if (it+1 == waypoints.getWaypoints().end()) {
-      vertex = getEndVertex(*it, Options::getInstance().isMatchAnyVertex());
-      if (vertex == graph.nullVertex()) {
-        throw Exception(std::string("could not find end vertex matching ")+*it);
+    }
+    for (auto &name : query.getAvoidPoints()) {
+      addPattern(name, VertexNetlistType::MID_POINT);
+    }
+  }
+  auto matches = graph.getVertices(patterns, options);
+  auto getMatches = [&](const std::string &name, VertexNetlistType type) -> const VertexIDVec& {
+    return matches[patternIndexes.at(PatternKey(name, type))];
+  };
+  auto matchAny = options.isMatchAnyVertex();
+  waypointIDs.assign(waypoints.size(), VertexIDVec());
+  avoidPointIDs.assign(waypoints.size(), VertexIDVec());
+  for (size_t q = 0; q < waypoints.size(); ++q) {
+    auto &names = waypoints[q].getWaypoints();
+    auto &avoidNames = waypoints[q].getAvoidPoints();
+    for (size_t i = 0; i < names.size(); ++i) {
+      VertexID vertex;
+      // Start
+      if (i == 0) {
+        vertex = selectVertex(getMatches(names[i], VertexNetlistType::START_POINT),
+                              names[i], matchAny, "begin point");
+        if (vertex == graph.nullVertex()) {
+          throw Exception(std::string("could not find start vertex matching ")+names[i]);
+        }
+      // Finish
+      } else if (i + 1 == names.size()) {
+        vertex = selectVertex(getMatches(names[i], VertexNetlistType::END_POINT),
+                              names[i], matchAny, "end point");
+        if (vertex == graph.nullVertex()) {
+          throw Exception(std::string("could not find end vertex matching ")+names[i]);
+        }
+      // Mid
+      } else {
+        vertex = selectVertex(getMatches(names[i], VertexNetlistType::MID_POINT),
+                              names[i], matchAny, "mid point");
+        if (vertex == graph.nullVertex()) {
+          throw Exception(std::string("could not find through vertex ")+names[i]);
+        }
       }
-    // Mid
-    } else {
-      vertex = getMidVertex(*it, Options::getInstance().isMatchAnyVertex());
+      waypointIDs[q].push_back(vertex);
+    }
+    for (auto &name : avoidNames) {
+      auto vertex = selectVertex(getMatches(name, VertexNetlistType::MID_POINT),
+                                 name, matchAny, "mid point");
       if (vertex == graph.nullVertex()) {
-        throw Exception(std::string("could not find through vertex ")+*it);
+        throw Exception(std::string("could not find vertex to avoid ")+name);
       }
+      avoidPointIDs[q].push_back(vertex);
     }
-    waypointIDs.push_back(vertex);
+    // Sort the IDs so they can be binary searched.
+    std::sort(avoidPointIDs[q].begin(), avoidPointIDs[q].end());
   }
-  return waypointIDs;
 }
 
-VertexIDVec Netlist::readAvoidPoints(Waypoints waypoints) const {
-  VertexIDVec avoidPointIDs;
-  for (auto name : waypoints.getAvoidPoints()) {
-    auto vertex = getMidVertex(name, Options::getInstance().isMatchAnyVertex());
-    if (vertex == graph.nullVertex()) {
-      throw Exception(std::string("could not find vertex to avoid ")+name);
-    }
-    avoidPointIDs.push_back(vertex);
-  }
-  // Sort the IDs so they can be binary searched.
-  std::sort(avoidPointIDs.begin(), avoidPointIDs.end());
-  return avoidPointIDs;
+void Netlist::readWaypoints(const Waypoints &waypoints,
+                            VertexIDVec &waypointIDs,
+                            VertexIDVec &avoidPointIDs,
+                            const QueryOptions &options) const {
+  std::vector<VertexIDVec> batchWaypointIDs, batchAvoidPointIDs;
+  readWaypoints(std::vector<Waypoints>{waypoints},
+                batchWaypointIDs, batchAvoidPointIDs, options);
+  waypointIDs = std::move(batchWaypointIDs.front());
+  avoidPointIDs = std::move(batchAvoidPointIDs.front());
 }
 
-bool Netlist::startpointExists(const std::string &name) const {
-  return getStartVertex(name, false) != graph.nullVertex();
+bool Netlist::startpointExists(const std::string &name,
+                               const QueryOptions &options) const {
+  return getStartVertex(name, false, options) != graph.nullVertex();
 }
 
-bool Netlist::endpointExists(const std::string &name) const {
-  return getEndVertex(name, false) != graph.nullVertex();
+bool Netlist::endpointExists(const std::string &name,
+                             const QueryOptions &options) const {
+  return getEndVertex(name, false, options) != graph.nullVertex();
 }
 
-bool Netlist::anyStartpointExists(const std::string &name) const {
-  return getStartVertex(name, true) != graph.nullVertex();
+bool Netlist::anyStartpointExists(const std::string &name,
+                                  const QueryOptions &options) const {
+  return getStartVertex(name, true, options) != graph.nullVertex();
 }
 
-bool Netlist::anyEndpointExists(const std::string &name) const {
-  return getEndVertex(name, true) != graph.nullVertex();
+bool Netlist::anyEndpointExists(const std::string &name,
+                                const QueryOptions &options) const {
+  return getEndVertex(name, true, options) != graph.nullVertex();
 }
 
-bool Netlist::anyRegExists(const std::string &name) const {
+bool Netlist::anyRegExists(const std::string &name,
+                           const QueryOptions &options) const {
   // Allow matching with register or register alias variables.
-  auto regVertices = graph.getRegVertices(name);
-  auto regAliasVertices = graph.getRegAliasVertices(name);
+  auto regVertices = graph.getRegVertices(name, options);
+  auto regAliasVertices = graph.getRegAliasVertices(name, options);
   return (regVertices.size() != 0) || (regAliasVertices.size() != 0);
 }
 
-bool Netlist::regExists(const std::string &name) const {
+bool Netlist::regExists(const std::string &name,
+                        const QueryOptions &options) const {
   // Allow matching with register or register alias variables.
-  return (getRegVertex(name, false) != graph.nullVertex()) ||
-         (getRegAliasVertex(name, false) != graph.nullVertex());
+  return (getRegVertex(name, false, options) != graph.nullVertex()) ||
+         (getRegAliasVertex(name, false, options) != graph.nullVertex());
 }
 
-bool Netlist::pathExists(Waypoints waypoints) const {
-  auto waypointIDs = readWaypoints(waypoints);
-  auto avoidPointIDs = readAvoidPoints(waypoints);
-  return !graph.getAnyPointToPoint(waypointIDs, avoidPointIDs).empty();
+bool Netlist::pathExists(Waypoints waypoints,
+                         const QueryOptions &options) const {
+  VertexIDVec waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  return graph.pathExists(waypointIDs, avoidPointIDs, options);
 }
 
-std::vector<Vertex*> Netlist::getAnyPath(Waypoints waypoints) const {
-  auto waypointIDs = readWaypoints(waypoints);
-  auto avoidPointIDs = readAvoidPoints(waypoints);
-  return createVertexPtrVec(graph.getAnyPointToPoint(waypointIDs,
-                                                       avoidPointIDs));
+VertexIDVec Netlist::findAnyPath(const Waypoints &waypoints,
+                                 const QueryOptions &options) const {
+  VertexIDVec waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  return graph.getAnyPointToPoint(waypointIDs, avoidPointIDs, options);
 }
 
-std::vector<std::vector<Vertex*> > Netlist::getAllPaths(Waypoints waypoints) const {
-  auto waypointIDs = readWaypoints(waypoints);
-  auto avoidPointIDs = readAvoidPoints(waypoints);
-  return createVertexPtrVecVec(graph.getAllPointToPoint(waypointIDs,
-                                                          avoidPointIDs));
+std::vector<VertexIDVec>
+Netlist::findAllPaths(const Waypoints &waypoints,
+                      const QueryOptions &options) const {
+  VertexIDVec waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  return graph.getAllPointToPoint(waypointIDs, avoidPointIDs, options);
 }
 
-std::vector<std::vector<Vertex*> > Netlist::getAllFanOut(const std::string startName) const {
-  auto vertex = getStartVertex(startName, Options::getInstance().isMatchAnyVertex());
+std::vector<VertexIDVec>
+Netlist::findAllFanOut(const std::string &startName,
+                       const QueryOptions &options) const {
+  auto vertex = getStartVertex(startName, options.isMatchAnyVertex(), options);
   if (vertex == graph.nullVertex()) {
     throw Exception(std::string("could not find start vertex "+startName));
   }
-  return createVertexPtrVecVec(graph.getAllFanOut(vertex));
+  return graph.getAllFanOut(vertex, options);
 }
 
-std::vector<std::vector<Vertex*> > Netlist::getAllFanIn(const std::string endName) const {
-  auto vertex = getEndVertex(endName, Options::getInstance().isMatchAnyVertex());
+std::vector<VertexIDVec>
+Netlist::findAllFanIn(const std::string &endName,
+                      const QueryOptions &options) const {
+  auto vertex = getEndVertex(endName, options.isMatchAnyVertex(), options);
   if (vertex == graph.nullVertex()) {
     throw Exception(std::string("could not find end vertex "+endName));
   }
-  return createVertexPtrVecVec(graph.getAllFanIn(vertex));
+  return graph.getAllFanIn(vertex, options);
+}
+
+std::vector<Vertex*> Netlist::getAnyPath(Waypoints waypoints,
+                                         const QueryOptions &options) const {
+  return createVertexPtrVec(findAnyPath(waypoints, options));
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getAllPaths(Waypoints waypoints, const QueryOptions &options) const {
+  return createVertexPtrVecVec(findAllPaths(waypoints, options));
+}
+
+PathEnumerator Netlist::enumerateAllPaths(Waypoints waypoints,
+                                          const PathLimits &limits,
+                                          const QueryOptions &options) const {
+  VertexIDVec waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  return graph.enumeratePointToPoint(waypointIDs, avoidPointIDs, options, limits);
+}
+
+/// Check the number of paths of a deepest paths query.
+static void checkNumPaths(size_t numPaths) {
+  if (numPaths == 0) {
+    throw Exception("the number of deepest paths must be at least one");
+  }
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getDeepestPaths(Waypoints waypoints, size_t numPaths,
+                         const PathWeights &weights,
+                         const QueryOptions &options) const {
+  checkNumPaths(numPaths);
+  VertexIDVec waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  return createVertexPtrVecVec(graph.getDeepestPointToPoint(waypointIDs,
+                                                            avoidPointIDs,
+                                                            numPaths, weights,
+                                                            options));
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getDeepestFanOut(const std::string startName, size_t numPaths,
+                          const PathWeights &weights,
+                          const QueryOptions &options) const {
+  checkNumPaths(numPaths);
+  auto vertex = getStartVertex(startName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find start vertex "+startName));
+  }
+  return createVertexPtrVecVec(graph.getDeepestFanOut(vertex, numPaths, weights,
+                                                      options));
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getDeepestFanIn(const std::string endName, size_t numPaths,
+                         const PathWeights &weights,
+                         const QueryOptions &options) const {
+  checkNumPaths(numPaths);
+  auto vertex = getEndVertex(endName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find end vertex "+endName));
+  }
+  return createVertexPtrVecVec(graph.getDeepestFanIn(vertex, numPaths, weights,
+                                                     options));
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getAllFanOut(const std::string startName,
+                      const QueryOptions &options) const {
+  return createVertexPtrVecVec(findAllFanOut(startName, options));
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getAllFanIn(const std::string endName,
+                     const QueryOptions &options) const {
+  return createVertexPtrVecVec(findAllFanIn(endName, options));
+}
+
+std::vector<Vertex*>
+Netlist::getFanOutEndPoints(const std::string startName,
+                            const QueryOptions &options) const {
+  auto vertex = getStartVertex(startName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find start vertex "+startName));
+  }
+  return createVertexPtrVec(graph.getFanOutEndPoints(vertex, options));
+}
+
+std::vector<Vertex*>
+Netlist::getFanInStartPoints(const std::string endName,
+                             const QueryOptions &options) const {
+  auto vertex = getEndVertex(endName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find end vertex "+endName));
+  }
+  return createVertexPtrVec(graph.getFanInStartPoints(vertex, options));
+}
+
+FanDegree Netlist::getFanOutDegree(const std::string startName,
+                                   const QueryOptions &options) const {
+  auto vertex = getStartVertex(startName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find start vertex "+startName));
+  }
+  return graph.getFanOutDegree(vertex, options);
+}
+
+FanDegree Netlist::getFanInDegree(const std::string endName,
+                                  const QueryOptions &options) const {
+  auto vertex = getEndVertex(endName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find end vertex "+endName));
+  }
+  return graph.getFanInDegree(vertex, options);
+}
+
+/// Open a file to export a subgraph to.
+static std::ofstream openExportFile(const std::string &outputFilename) {
+  std::ofstream outputFile(outputFilename);
+  if (!outputFile.is_open()) {
+    throw Exception(std::string("unable to open ")+outputFilename);
+  }
+  return outputFile;
+}
+
+void Netlist::exportFanOutCone(const std::string startName,
+                               const std::string &outputFilename,
+                               const ExportOptions &exportOptions,
+                               const QueryOptions &options) const {
+  auto vertex = getStartVertex(startName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find start vertex "+startName));
+  }
+  auto outputFile = openExportFile(outputFilename);
+  graph.exportFanOutCone(vertex, outputFile, options, exportOptions);
+}
+
+void Netlist::exportFanInCone(const std::string endName,
+                              const std::string &outputFilename,
+                              const ExportOptions &exportOptions,
+                              const QueryOptions &options) const {
+  auto vertex = getEndVertex(endName, options.isMatchAnyVertex(), options);
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find end vertex "+endName));
+  }
+  auto outputFile = openExportFile(outputFilename);
+  graph.exportFanInCone(vertex, outputFile, options, exportOptions);
+}
+
+void Netlist::exportPaths(Waypoints waypoints,
+                          const std::string &outputFilename,
+                          const ExportOptions &exportOptions,
+                          const QueryOptions &options) const {
+  VertexIDVec waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  auto outputFile = openExportFile(outputFilename);
+  graph.exportPointToPoint(waypointIDs, avoidPointIDs, outputFile, options,
+                           exportOptions);
+}
+
+std::vector<bool>
+Netlist::pathExistsBatch(const std::vector<Waypoints> &waypoints,
+                         const QueryOptions &options) const {
+  std::vector<VertexIDVec> waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  // Each result is written by a different thread, so they cannot be packed
+  // into a vector<bool> until all the searches have finished.
+  std::vector<char> results(waypoints.size());
+  ThreadPool pool(options.getNumThreads());
+  pool.parallelFor(waypoints.size(), [&](size_t i) {
+    results[i] = graph.pathExists(waypointIDs[i], avoidPointIDs[i], options);
+  });
+  return std::vector<bool>(results.begin(), results.end());
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getAnyPathBatch(const std::vector<Waypoints> &waypoints,
+                         const QueryOptions &options) const {
+  std::vector<VertexIDVec> waypointIDs, avoidPointIDs;
+  readWaypoints(waypoints, waypointIDs, avoidPointIDs, options);
+  std::vector<std::vector<Vertex*> > results(waypoints.size());
+  ThreadPool pool(options.getNumThreads());
+  pool.parallelFor(waypoints.size(), [&](size_t i) {
+    results[i] = createVertexPtrVec(graph.getAnyPointToPoint(waypointIDs[i],
+                                                             avoidPointIDs[i],
+                                                             options));
+  });
+  return results;
+}
+
+std::vector<std::vector<std::vector<Vertex*> > >
+Netlist::getAllFanOutBatch(const std::vector<std::string> &startNames,
+                           const QueryOptions &options) const {
+  std::vector<std::pair<std::string, VertexNetlistType>> patterns;
+  for (auto &name : startNames) {
+    patterns.emplace_back(name, VertexNetlistType::START_POINT);
+  }
+  auto matches = graph.getVertices(patterns, options);
+  VertexIDVec startVertices;
+  for (size_t i = 0; i < startNames.size(); ++i) {
+    auto vertex = selectVertex(matches[i], startNames[i],
+                               options.isMatchAnyVertex(), "begin point");
+    if (vertex == graph.nullVertex()) {
+      throw Exception(std::string("could not find start vertex "+startNames[i]));
+    }
+    startVertices.push_back(vertex);
+  }
+  std::vector<std::vector<std::vector<Vertex*> > > results(startNames.size());
+  ThreadPool pool(options.getNumThreads());
+  pool.parallelFor(startNames.size(), [&](size_t i) {
+    results[i] = createVertexPtrVecVec(graph.getAllFanOut(startVertices[i], options));
+  });
+  return results;
+}
+
+std::vector<std::vector<Vertex*> >
+Netlist::getCombConnectivity(const QueryOptions &options) const {
+  std::vector<std::vector<Vertex*> > pairs;
+  for (auto &pair : graph.getCombConnectivity(options).getPairs()) {
+    pairs.push_back({graph.getVertexPtr(pair.first), graph.getVertexPtr(pair.second)});
+  }
+  return pairs;
+}
+
+std::vector<std::vector<Vertex*> > Netlist::getCombLoops() const {
+  std::vector<std::vector<Vertex*> > loops;
+  for (auto &loop : graph.getCombLoops()) {
+    std::vector<Vertex*> vertices;
+    for (auto vertexID : loop) {
+      auto vertex = graph.getVertexPtr(vertexID);
+      if (!vertex->getName().empty()) {
+        vertices.push_back(vertex);
+      }
+    }
+    std::sort(vertices.begin(), vertices.end(),
+              [](const Vertex *a, const Vertex *b) { return a->compareLessThan(*b); });
+    loops.push_back(std::move(vertices));
+  }
+  return loops;
+}
+
+PathArray Netlist::getAnyPathArray(Waypoints waypoints,
+                                   const QueryOptions &options) const {
+  PathArray paths;
+  paths.addPath(findAnyPath(waypoints, options));
+  return paths;
+}
+
+PathArray Netlist::getAllPathsArray(Waypoints waypoints,
+                                    const QueryOptions &options) const {
+  return PathArray(findAllPaths(waypoints, options));
+}
+
+PathArray Netlist::getAllFanOutArray(const std::string startName,
+                                     const QueryOptions &options) const {
+  return PathArray(findAllFanOut(startName, options));
+}
+
+PathArray Netlist::getAllFanInArray(const std::string endName,
+                                    const QueryOptions &options) const {
+  return PathArray(findAllFanIn(endName, options));
+}
+
+VertexColumns
+Netlist::getVertexColumns(const std::vector<PathArray::ID> &vertexIDs) const {
+  VertexColumns columns;
+  columns.names.reserve(vertexIDs.size());
+  columns.astTypes.reserve(vertexIDs.size());
+  columns.directions.reserve(vertexIDs.size());
+  columns.dtypes.reserve(vertexIDs.size());
+  columns.widths.reserve(vertexIDs.size());
+  columns.locations.reserve(vertexIDs.size());
+  columns.isLogic.reserve(vertexIDs.size());
+  for (auto vertexID : vertexIDs) {
+    auto &vertex = graph.getVertex(checkVertexID(vertexID));
+    columns.names.push_back(vertex.getName());
+    columns.astTypes.push_back(getSimpleVertexAstTypeStr(vertex.getAstType()));
+    columns.directions.push_back(getVertexDirectionStr(vertex.getDirection()));
+    columns.dtypes.push_back(vertex.getDTypeStr());
+    columns.widths.push_back(vertex.getDTypeWidth());
+    columns.locations.push_back(vertex.getLocationStr());
+    columns.isLogic.push_back(vertex.isLogic());
+  }
+  return columns;
 }
 
 std::vector<std::reference_wrapper<const Vertex> >
-Netlist::getNamedVertices(const std::string pattern) const {
-  // Collect vertices.
+Netlist::getNamedVertices(const std::string pattern,
+                          const QueryOptions &options) const {
+  // Collect vertices, which the name index provides in sorted order.
   std::vector<std::reference_wrapper<const Vertex>> vertices;
-  for (auto vertexId : graph.getVertices(pattern, VertexNetlistType::IS_NAMED)) {
+  for (auto vertexId : graph.getVerticesSortedByName(pattern, VertexNetlistType::IS_NAMED, options)) {
     vertices.push_back(std::ref(graph.getVertex(vertexId)));
   }
-  // Sort them.
-  auto compare = [](const Vertex& a, const Vertex& b) {
-                   return a.compareLessThan(b); };
-  std::sort(vertices.begin(), vertices.end(), compare);
   return vertices;
 }
@@ -0,0 +1,121 @@
+#include "netlist_paths/PathEnumerator.hpp"
+
+using namespace netlist_paths;
+
+PathEnumerator::PathEnumerator() :
+    lastWaypoint(boost::graph_traits<InternalGraph>::null_vertex()),
+    numPaths(0), elapsed(0), started(false), finished(true), truncated(false) {}
+
+PathEnumerator::PathEnumerator(const VertexIDVec &path,
+                               const PathLimits &limits) :
+    lastWaypoint(path.back()), limits(limits), path(path),
+    numPaths(0), elapsed(0), started(false), finished(false), truncated(false) {}
+
+PathEnumerator::PathEnumerator(const CSRGraph &graph,
+                               const VertexIDVec &waypointIDs,
+                               const VertexIDVec &avoidPointIDs,
+                               const QueryOptions &options,
+                               const PathLimits &limits,
+                               SearchCounts *counts) :
+    lastWaypoint(waypointIDs.back()), limits(limits),
+    numPaths(0), elapsed(0), started(false), finished(false), truncated(false) {
+  PathSearch search(graph, &avoidPointIDs, options, counts);
+  for (size_t i = 0; i < waypointIDs.size() - 1; ++i) {
+    stages.push_back(search.findSimplePaths(waypointIDs[i], waypointIDs[i + 1]));
+    if (stages.back().isEmpty()) {
+      // No paths exist.
+      stages.clear();
+      finished = true;
+      return;
+    }
+  }
+}
+
+/// Advance the stages to the next combination of their paths.
+bool PathEnumerator::advance(SimplePaths::Deadline deadline) {
+  auto maxLength = limits.getMaxLength();
+  // The index of the first stage that needs to start again from its first
+  // path.
+  size_t first = 0;
+  if (started) {
+    // Advance the last stage that has another path.
+    first = stages.size();
+    while (true) {
+      if (first == 0) {
+        return finish(false);
+      }
+      auto status = stages[first - 1].next(maxLength, deadline);
+      if (status == SimplePaths::Status::FOUND) {
+        break;
+      }
+      if (status == SimplePaths::Status::STOPPED) {
+        return finish(true);
+      }
+      stages[first - 1].reset();
+      --first;
+    }
+  }
+  started = true;
+  for (size_t i = first; i < stages.size(); ++i) {
+    auto status = stages[i].next(maxLength, deadline);
+    if (status != SimplePaths::Status::FOUND) {
+      // A stage has no paths within the length limit, or time has run out.
+      return finish(status == SimplePaths::Status::STOPPED);
+    }
+  }
+  return true;
+}
+
+/// Find the next path, without counting it.
+bool PathEnumerator::findNext() {
+  if (stages.empty()) {
+    // A single path.
+    if (started || (limits.getMaxLength() != 0 && path.size() > limits.getMaxLength())) {
+      return finish(false);
+    }
+    started = true;
+    return true;
+  }
+  auto startTime = std::chrono::steady_clock::now();
+  auto deadline = SimplePaths::Deadline::max();
+  if (limits.getTimeLimit() > 0) {
+    auto timeLimit = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(limits.getTimeLimit()));
+    deadline = startTime + (timeLimit - elapsed);
+  }
+  bool found = false;
+  while (advance(deadline)) {
+    // Join the paths of the stages, which share their end waypoints.
+    path.clear();
+    for (auto &stage : stages) {
+      auto &stagePath = stage.getPath();
+      path.insert(path.end(), stagePath.begin(), stagePath.end() - 1);
+    }
+    path.push_back(lastWaypoint);
+    if (limits.getMaxLength() == 0 || path.size() <= limits.getMaxLength()) {
+      found = true;
+      break;
+    }
+  }
+  elapsed += std::chrono::steady_clock::now() - startTime;
+  return found;
+}
+
+bool PathEnumerator::next() {
+  if (finished) {
+    return false;
+  }
+  if (limits.getMaxPaths() != 0 && numPaths == limits.getMaxPaths()) {
+    // Look for one more path to determine whether the limit has truncated
+    // the enumeration.
+    bool more = findNext();
+    finished = true;
+    truncated = truncated || more;
+    return false;
+  }
+  if (!findNext()) {
+    return false;
+  }
+  ++numPaths;
+  return true;
+}
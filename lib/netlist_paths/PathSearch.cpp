@@ -0,0 +1,519 @@
+#include <algorithm>
+#include <utility>
+#include "netlist_paths/PathSearch.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+/// The action to take after examining an edge of a depth-first search.
+enum class Step {
+  SKIP,
+  DESCEND,
+  STOP
+};
+
+/// Perform a depth-first search from a root vertex, maintaining an explicit
+/// stack so the search visits the edges in the same order as a recursive one
+/// (and as boost::depth_first_search does).
+///
+/// \param stack   The stack storage to use.
+/// \param edges   The adjacency to follow.
+/// \param root    The vertex to start from.
+/// \param examine A function called with each edge, the vertex it was
+///                reached from and the vertex it leads to, which returns
+///                whether to descend into the vertex, skip it, or stop.
+///
+/// \returns True if the search was stopped.
+template<typename Examine>
+bool depthFirstSearch(std::vector<TraversalWorkspace::StackEntry> &stack,
+                      const CSRGraph::Adjacency &edges,
+                      VertexID root,
+                      Examine examine) {
+  stack.clear();
+  auto range = edges.getEdges(root);
+  stack.push_back({root, range.first, range.second});
+  while (!stack.empty()) {
+    auto &top = stack.back();
+    if (top.nextEdge == top.endEdge) {
+      stack.pop_back();
+      continue;
+    }
+    auto edge = top.nextEdge++;
+    auto vertex = edges.getVertex(edge);
+    switch (examine(edge, top.vertex, vertex)) {
+      case Step::SKIP:
+        break;
+      case Step::DESCEND:
+        range = edges.getEdges(vertex);
+        stack.push_back({vertex, range.first, range.second});
+        break;
+      case Step::STOP:
+        stack.clear();
+        return true;
+    }
+  }
+  return false;
+}
+
+} // End anonymous namespace.
+
+PathSearch::PathSearch(const CSRGraph &graph, const VertexIDVec *avoidPointIDs,
+                       const QueryOptions &options, SearchCounts *counts) :
+    graph(graph),
+    traverseRegisters(options.shouldTraverseRegisters()),
+    searchBidirectional(options.shouldSearchBidirectional()),
+    hasAvoidPoints(avoidPointIDs && !avoidPointIDs->empty()),
+    workspace(TraversalWorkspace::get()),
+    treeRoot(boost::graph_traits<InternalGraph>::null_vertex()),
+    countsSink(counts),
+    initialWorkspaceBytes(STATS_ENABLED && counts ? workspace.numBytes() : 0) {
+  if (hasAvoidPoints) {
+    workspace.avoidPoints.reset(graph.numVertices());
+    for (auto vertex : *avoidPointIDs) {
+      workspace.avoidPoints.set(vertex);
+    }
+  }
+}
+
+template<typename Filter>
+bool PathSearch::searchPath(const Filter &filter, VertexID startVertex,
+                            VertexID finishVertex) {
+  auto &visited = workspace.visited;
+  auto &parents = workspace.parents;
+  visited.reset(graph.numVertices());
+  workspace.resize(graph.numVertices());
+  visited.set(startVertex);
+  treeRoot = startVertex;
+  auto &outEdges = graph.getOutEdges();
+  return depthFirstSearch(workspace.stack, outEdges, startVertex,
+      [&](size_t edge, VertexID source, VertexID vertex) {
+        countEdge();
+        if (visited.test(vertex) || !filter.follow(outEdges, edge, vertex)) {
+          return Step::SKIP;
+        }
+        visited.set(vertex);
+        parents[vertex] = source;
+        countVertex();
+        countParent();
+        return vertex == finishVertex ? Step::STOP : Step::DESCEND;
+      });
+}
+
+VertexIDVec PathSearch::findPath(VertexID startVertex,
+                                 VertexID finishVertex) {
+  if (startVertex == finishVertex) {
+    return {startVertex};
+  }
+  auto found = withEdgeFilter([&](const auto &filter) {
+    return searchPath(filter, startVertex, finishVertex);
+  });
+  if (!found) {
+    return {};
+  }
+  auto path = getTreePath(finishVertex);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+template<typename Filter>
+bool PathSearch::searchFrontiers(const Filter &filter, VertexID startVertex,
+                                 VertexID finishVertex) {
+  // An avoided finish vertex is never the target of a followed edge.
+  if (filter.isAvoidPoint(finishVertex)) {
+    return false;
+  }
+  auto &forwardVisited = workspace.visited;
+  auto &reverseVisited = workspace.reverseVisited;
+  auto &forwardFrontier = workspace.frontier;
+  auto &reverseFrontier = workspace.reverseFrontier;
+  auto &nextFrontier = workspace.nextFrontier;
+  forwardVisited.reset(graph.numVertices());
+  reverseVisited.reset(graph.numVertices());
+  forwardVisited.set(startVertex);
+  reverseVisited.set(finishVertex);
+  forwardFrontier.assign(1, startVertex);
+  reverseFrontier.assign(1, finishVertex);
+  auto &outEdges = graph.getOutEdges();
+  auto &inEdges = graph.getInEdges();
+  while (!forwardFrontier.empty() && !reverseFrontier.empty()) {
+    nextFrontier.clear();
+    if (forwardFrontier.size() <= reverseFrontier.size()) {
+      // Expand the forward frontier along out edges.
+      for (auto vertex : forwardFrontier) {
+        auto range = outEdges.getEdges(vertex);
+        for (auto edge = range.first; edge != range.second; ++edge) {
+          auto target = outEdges.getVertex(edge);
+          countEdge();
+          if (forwardVisited.test(target) || !filter.follow(outEdges, edge, target)) {
+            continue;
+          }
+          if (reverseVisited.test(target)) {
+            return true;
+          }
+          forwardVisited.set(target);
+          nextFrontier.push_back(target);
+          countVertex();
+        }
+      }
+      std::swap(forwardFrontier, nextFrontier);
+    } else {
+      // Expand the reverse frontier along in edges. The start vertex is
+      // the only avoided vertex that the forward search can leave from.
+      for (auto vertex : reverseFrontier) {
+        auto range = inEdges.getEdges(vertex);
+        for (auto edge = range.first; edge != range.second; ++edge) {
+          auto source = inEdges.getVertex(edge);
+          countEdge();
+          if (reverseVisited.test(source) || !filter.isTraversed(inEdges, edge) ||
+              (source != startVertex && filter.isAvoidPoint(source))) {
+            continue;
+          }
+          if (forwardVisited.test(source)) {
+            return true;
+          }
+          reverseVisited.set(source);
+          nextFrontier.push_back(source);
+          countVertex();
+        }
+      }
+      std::swap(reverseFrontier, nextFrontier);
+    }
+  }
+  return false;
+}
+
+bool PathSearch::pathExistsBidirectional(VertexID startVertex,
+                                         VertexID finishVertex) {
+  if (startVertex == finishVertex) {
+    return true;
+  }
+  return withEdgeFilter([&](const auto &filter) {
+    return searchFrontiers(filter, startVertex, finishVertex);
+  });
+}
+
+template<typename Filter>
+void PathSearch::searchTree(const Filter &filter, VertexID rootVertex,
+                            const Adjacency &edges) {
+  auto &visited = workspace.visited;
+  auto &parents = workspace.parents;
+  auto &treeVertices = workspace.treeVertices;
+  visited.reset(graph.numVertices());
+  workspace.resize(graph.numVertices());
+  visited.set(rootVertex);
+  treeVertices.assign(1, rootVertex);
+  treeRoot = rootVertex;
+  depthFirstSearch(workspace.stack, edges, rootVertex,
+      [&](size_t edge, VertexID parent, VertexID vertex) {
+        countEdge();
+        if (visited.test(vertex) || !filter.follow(edges, edge, vertex)) {
+          return Step::SKIP;
+        }
+        visited.set(vertex);
+        treeVertices.push_back(vertex);
+        parents[vertex] = parent;
+        countVertex();
+        countParent();
+        return Step::DESCEND;
+      });
+}
+
+void PathSearch::visitTree(VertexID rootVertex, bool reverse) {
+  // The direction is chosen once, by the adjacency that is searched.
+  auto &edges = reverse ? graph.getInEdges() : graph.getOutEdges();
+  withEdgeFilter([&](const auto &filter) {
+    searchTree(filter, rootVertex, edges);
+  });
+}
+
+VertexIDVec PathSearch::getTreePath(VertexID vertex) const {
+  VertexIDVec path;
+  for (; vertex != treeRoot; vertex = workspace.parents[vertex]) {
+    path.push_back(vertex);
+  }
+  path.push_back(treeRoot);
+  return path;
+}
+
+TraversalTree PathSearch::copyTree() const {
+  using Index = CSRGraph::Index;
+  std::vector<Index> vertices(workspace.treeVertices.begin(),
+                              workspace.treeVertices.end());
+  std::sort(vertices.begin(), vertices.end());
+  // Number the vertices by their positions to find the positions of their
+  // parents.
+  auto &positions = workspace.vertexNumbers;
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    positions[vertices[i]] = static_cast<Index>(i);
+  }
+  std::vector<Index> parents(vertices.size());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    parents[i] = vertices[i] == treeRoot ? static_cast<Index>(i)
+                                         : positions[workspace.parents[vertices[i]]];
+  }
+  return TraversalTree(treeRoot, std::move(vertices), std::move(parents));
+}
+
+/// Record every edge examined by a DFS from the start vertex of the paths,
+/// in the order the edges are examined, numbering the vertices reached.
+template<typename Filter>
+void PathSearch::searchSimplePaths(const Filter &filter, SimplePaths &paths) {
+  auto startVertex = paths.startVertex;
+  auto &visited = workspace.visited;
+  auto &vertexNumbers = workspace.vertexNumbers;
+  auto &examinedEdges = workspace.examinedEdges;
+  visited.reset(graph.numVertices());
+  workspace.resize(graph.numVertices());
+  examinedEdges.clear();
+  visited.set(startVertex);
+  vertexNumbers[startVertex] = 0;
+  treeRoot = startVertex;
+  auto &outEdges = graph.getOutEdges();
+  depthFirstSearch(workspace.stack, outEdges, startVertex,
+      [&](size_t edge, VertexID source, VertexID vertex) {
+        countEdge();
+        if (!filter.follow(outEdges, edge, vertex)) {
+          return Step::SKIP;
+        }
+        auto descend = !visited.test(vertex);
+        if (descend) {
+          countVertex();
+          visited.set(vertex);
+          vertexNumbers[vertex] = paths.vertices.size();
+          paths.vertices.push_back(vertex);
+        }
+        examinedEdges.emplace_back(vertexNumbers[vertex], vertexNumbers[source]);
+        return descend ? Step::DESCEND : Step::SKIP;
+      });
+}
+
+SimplePaths PathSearch::findSimplePaths(VertexID startVertex,
+                                        VertexID finishVertex) {
+  SimplePaths paths;
+  paths.startVertex = startVertex;
+  paths.vertices.push_back(startVertex);
+  if (startVertex == finishVertex) {
+    paths.finishIndex = 0;
+    return paths;
+  }
+  withEdgeFilter([&](const auto &filter) {
+    searchSimplePaths(filter, paths);
+  });
+  auto &visited = workspace.visited;
+  auto &vertexNumbers = workspace.vertexNumbers;
+  auto &examinedEdges = workspace.examinedEdges;
+  if (!visited.test(finishVertex)) {
+    paths.vertices.clear();
+    return paths;
+  }
+  paths.finishIndex = vertexNumbers[finishVertex];
+  // Group the edges by their targets, keeping the order they were examined.
+  auto numVertices = paths.vertices.size();
+  paths.edgeOffsets.assign(numVertices + 1, 0);
+  for (auto &edge : examinedEdges) {
+    ++paths.edgeOffsets[edge.first + 1];
+  }
+  for (size_t i = 0; i < numVertices; ++i) {
+    paths.edgeOffsets[i + 1] += paths.edgeOffsets[i];
+  }
+  std::vector<size_t> nextEdge(paths.edgeOffsets.begin(), paths.edgeOffsets.end() - 1);
+  paths.edgeSources.resize(examinedEdges.size());
+  for (auto &edge : examinedEdges) {
+    paths.edgeSources[nextEdge[edge.first]++] = edge.second;
+  }
+  paths.onPath.assign(numVertices, 0);
+  if constexpr (STATS_ENABLED) {
+    counts.allocatedBytes += paths.numBytes();
+  }
+  return paths;
+}
+
+SimplePaths::Status SimplePaths::next(size_t maxLength, Deadline deadline) {
+  if (isEmpty()) {
+    return Status::EXHAUSTED;
+  }
+  if (finishIndex == 0) {
+    // The only path is the start vertex.
+    if (started) {
+      return Status::EXHAUSTED;
+    }
+    started = true;
+    path.assign(1, startVertex);
+    return Status::FOUND;
+  }
+  if (!started) {
+    started = true;
+    stack.push_back({finishIndex, edgeOffsets[finishIndex]});
+    onPath[finishIndex] = 1;
+  }
+  // Extend the path back from the finish vertex through the predecessors of
+  // each vertex, excluding those already on the path.
+  bool checkTime = deadline != Deadline::max();
+  while (!stack.empty()) {
+    if (checkTime && (++numSteps % 1024) == 0 &&
+        std::chrono::steady_clock::now() > deadline) {
+      return Status::STOPPED;
+    }
+    auto &top = stack.back();
+    if (top.nextEdge == edgeOffsets[top.vertex + 1]) {
+      onPath[top.vertex] = 0;
+      stack.pop_back();
+      continue;
+    }
+    auto source = edgeSources[top.nextEdge++];
+    if (onPath[source]) {
+      // The edge would create a cycle.
+      continue;
+    }
+    // The number of vertices of a path ending with the source.
+    auto length = stack.size() + 1;
+    if (source == 0) {
+      if (maxLength != 0 && length > maxLength) {
+        continue;
+      }
+      path.clear();
+      path.push_back(startVertex);
+      for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        path.push_back(vertices[it->vertex]);
+      }
+      return Status::FOUND;
+    }
+    if (maxLength != 0 && length >= maxLength) {
+      // Any path through the source would be too long.
+      continue;
+    }
+    stack.push_back({source, edgeOffsets[source]});
+    onPath[source] = 1;
+  }
+  return Status::EXHAUSTED;
+}
+
+void SimplePaths::reset() {
+  for (auto &entry : stack) {
+    onPath[entry.vertex] = 0;
+  }
+  stack.clear();
+  started = false;
+}
+
+std::vector<VertexIDVec> PathSearch::findAllPaths(VertexID startVertex,
+                                                  VertexID finishVertex) {
+  auto paths = findSimplePaths(startVertex, finishVertex);
+  std::vector<VertexIDVec> result;
+  while (paths.next() == SimplePaths::Status::FOUND) {
+    auto &path = paths.getPath();
+    result.emplace_back(path.rbegin(), path.rend());
+  }
+  return result;
+}
+
+void PathSearch::clearSelection() {
+  workspace.selected.reset(graph.numVertices());
+  workspace.selection.clear();
+}
+
+bool PathSearch::select(VertexID vertex, size_t maxVertices) {
+  if (workspace.selected.test(vertex)) {
+    return true;
+  }
+  if (maxVertices != 0 && workspace.selection.size() >= maxVertices) {
+    return false;
+  }
+  workspace.selected.set(vertex);
+  workspace.selection.push_back(vertex);
+  return true;
+}
+
+template<typename Filter>
+void PathSearch::selectBreadthFirst(const Filter &filter, VertexID rootVertex,
+                                    const Adjacency &edges, size_t maxDepth,
+                                    size_t maxVertices, const VisitedSet *within) {
+  auto &visited = workspace.visited;
+  auto &frontier = workspace.frontier;
+  auto &nextFrontier = workspace.nextFrontier;
+  visited.reset(graph.numVertices());
+  if (!select(rootVertex, maxVertices)) {
+    return;
+  }
+  visited.set(rootVertex);
+  countVertex();
+  frontier.assign(1, rootVertex);
+  for (size_t depth = 1; !frontier.empty(); ++depth) {
+    if (maxDepth != 0 && depth > maxDepth) {
+      return;
+    }
+    nextFrontier.clear();
+    for (auto vertex : frontier) {
+      auto range = edges.getEdges(vertex);
+      for (auto edge = range.first; edge != range.second; ++edge) {
+        auto target = edges.getVertex(edge);
+        countEdge();
+        if (visited.test(target) || !filter.follow(edges, edge, target) ||
+            (within && !within->test(target))) {
+          continue;
+        }
+        if (!select(target, maxVertices)) {
+          // The selection is full.
+          return;
+        }
+        visited.set(target);
+        nextFrontier.push_back(target);
+        countVertex();
+      }
+    }
+    std::swap(frontier, nextFrontier);
+  }
+}
+
+void PathSearch::selectCone(VertexID rootVertex, bool reverse,
+                            size_t maxDepth, size_t maxVertices) {
+  auto &edges = reverse ? graph.getInEdges() : graph.getOutEdges();
+  withEdgeFilter([&](const auto &filter) {
+    selectBreadthFirst(filter, rootVertex, edges, maxDepth, maxVertices, nullptr);
+  });
+}
+
+template<typename Filter>
+bool PathSearch::markReverseReachable(const Filter &filter, VertexID startVertex,
+                                      VertexID finishVertex) {
+  if (filter.isAvoidPoint(finishVertex)) {
+    return false;
+  }
+  // Mark the vertices that can reach the finish vertex. The start vertex is
+  // the only avoided vertex that a path can leave from.
+  auto &reverseVisited = workspace.reverseVisited;
+  auto &frontier = workspace.reverseFrontier;
+  auto &inEdges = graph.getInEdges();
+  reverseVisited.reset(graph.numVertices());
+  reverseVisited.set(finishVertex);
+  frontier.assign(1, finishVertex);
+  countVertex();
+  while (!frontier.empty()) {
+    auto vertex = frontier.back();
+    frontier.pop_back();
+    auto range = inEdges.getEdges(vertex);
+    for (auto edge = range.first; edge != range.second; ++edge) {
+      auto source = inEdges.getVertex(edge);
+      countEdge();
+      if (reverseVisited.test(source) || !filter.isTraversed(inEdges, edge) ||
+          (source != startVertex && filter.isAvoidPoint(source))) {
+        continue;
+      }
+      reverseVisited.set(source);
+      frontier.push_back(source);
+      countVertex();
+    }
+  }
+  return reverseVisited.test(startVertex);
+}
+
+void PathSearch::selectBetween(VertexID startVertex, VertexID finishVertex,
+                               size_t maxDepth, size_t maxVertices) {
+  withEdgeFilter([&](const auto &filter) {
+    if (markReverseReachable(filter, startVertex, finishVertex)) {
+      selectBreadthFirst(filter, startVertex, graph.getOutEdges(), maxDepth,
+                         maxVertices, &workspace.reverseVisited);
+    }
+  });
+}
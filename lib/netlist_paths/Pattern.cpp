@@ -0,0 +1,815 @@
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <limits>
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/NameIndex.hpp"
+#include "netlist_paths/Pattern.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+using CharSet = std::bitset<256>;
+
+/// The maximum count of a bounded repetition compiled into the program.
+constexpr unsigned MAX_REPEAT_COUNT = 256;
+
+/// The maximum length of a compiled program.
+constexpr size_t MAX_PROGRAM_SIZE = 1 << 16;
+
+/// The maximum length of a program converted into a DFA.
+constexpr size_t MAX_DFA_PROGRAM_SIZE = 1 << 12;
+
+/// The maximum number of states of a DFA built from a program.
+constexpr size_t MAX_DFA_STATES = 1 << 12;
+
+/// Marker for an unbounded repetition.
+constexpr unsigned REPEAT_UNBOUNDED = std::numeric_limits<unsigned>::max();
+
+/// Raised by the parser on syntax the compiled program does not support.
+struct UnsupportedRegex {};
+
+/// A node of a parsed regular expression.
+struct RegexNode {
+  enum class Kind {
+    CHARS,
+    CONCAT,
+    ALTERNATE,
+    REPEAT,
+    BEGIN,
+    END
+  };
+  Kind kind;
+  CharSet chars;
+  std::vector<std::unique_ptr<RegexNode>> children;
+  unsigned min;
+  unsigned max;
+  RegexNode(Kind kind) : kind(kind), min(0), max(0) {}
+};
+
+using RegexNodePtr = std::unique_ptr<RegexNode>;
+
+/// A recursive-descent parser for the subset of the ECMAScript regular
+/// expression grammar supported by the compiled program. The pattern has
+/// already been checked by std::regex, so any construct that is not
+/// understood is reported as unsupported rather than as an error.
+class RegexParser {
+  const std::string &pattern;
+  size_t pos;
+
+  bool atEnd() const { return pos >= pattern.size(); }
+  char peek() const { return pattern[pos]; }
+
+  static CharSet rangeSet(unsigned char first, unsigned char last) {
+    CharSet set;
+    for (unsigned c = first; c <= last; ++c) {
+      set.set(c);
+    }
+    return set;
+  }
+
+  static CharSet digitSet() { return rangeSet('0', '9'); }
+
+  static CharSet wordSet() {
+    auto set = rangeSet('a', 'z') | rangeSet('A', 'Z') | digitSet();
+    set.set('_');
+    return set;
+  }
+
+  static CharSet spaceSet() {
+    CharSet set;
+    for (auto c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+      set.set(static_cast<unsigned char>(c));
+    }
+    return set;
+  }
+
+  /// Parse the character following a backslash into a set.
+  CharSet parseEscape() {
+    if (atEnd()) {
+      throw UnsupportedRegex();
+    }
+    char c = pattern[pos++];
+    switch (c) {
+      case 'd': return digitSet();
+      case 'D': return ~digitSet();
+      case 'w': return wordSet();
+      case 'W': return ~wordSet();
+      case 's': return spaceSet();
+      case 'S': return ~spaceSet();
+      case 'n': return rangeSet('\n', '\n');
+      case 'r': return rangeSet('\r', '\r');
+      case 't': return rangeSet('\t', '\t');
+      case 'f': return rangeSet('\f', '\f');
+      case 'v': return rangeSet('\v', '\v');
+      default:
+        // Escaped punctuation is literal, other escapes (back references,
+        // word boundaries, hex and unicode escapes) are not supported.
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+          throw UnsupportedRegex();
+        }
+        return rangeSet(c, c);
+    }
+  }
+
+  /// Parse a single member of a bracket expression, which is either a single
+  /// character or an escaped class.
+  CharSet parseClassAtom(bool &isSingle, unsigned char &single) {
+    char c = pattern[pos++];
+    if (c == '[') {
+      // Character classes, collating elements and equivalence classes.
+      throw UnsupportedRegex();
+    }
+    if (c == '\\') {
+      if (atEnd()) {
+        throw UnsupportedRegex();
+      }
+      auto set = parseEscape();
+      isSingle = set.count() == 1;
+      if (isSingle) {
+        for (unsigned i = 0; i < set.size(); ++i) {
+          if (set.test(i)) {
+            single = static_cast<unsigned char>(i);
+          }
+        }
+      }
+      return set;
+    }
+    isSingle = true;
+    single = static_cast<unsigned char>(c);
+    return rangeSet(single, single);
+  }
+
+  RegexNodePtr parseClass() {
+    bool negate = false;
+    if (!atEnd() && peek() == '^') {
+      negate = true;
+      pos++;
+    }
+    // An empty class is not supported, since its meaning differs between
+    // grammars.
+    if (!atEnd() && peek() == ']') {
+      throw UnsupportedRegex();
+    }
+    CharSet set;
+    while (true) {
+      if (atEnd()) {
+        throw UnsupportedRegex();
+      }
+      if (peek() == ']') {
+        pos++;
+        break;
+      }
+      bool isSingle = false;
+      unsigned char low = 0;
+      auto atom = parseClassAtom(isSingle, low);
+      if (isSingle && pos + 1 < pattern.size() &&
+          peek() == '-' && pattern[pos+1] != ']') {
+        pos++;
+        bool isSingleHigh = false;
+        unsigned char high = 0;
+        parseClassAtom(isSingleHigh, high);
+        if (!isSingleHigh || high < low) {
+          throw UnsupportedRegex();
+        }
+        set |= rangeSet(low, high);
+      } else {
+        set |= atom;
+      }
+    }
+    auto node = std::make_unique<RegexNode>(RegexNode::Kind::CHARS);
+    node->chars = negate ? ~set : set;
+    return node;
+  }
+
+  /// Parse a decimal number, returning false if there are no digits.
+  bool parseNumber(unsigned &value) {
+    size_t start = pos;
+    value = 0;
+    while (!atEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+      value = value * 10 + (pattern[pos++] - '0');
+      if (value > MAX_REPEAT_COUNT) {
+        throw UnsupportedRegex();
+      }
+    }
+    return pos != start;
+  }
+
+  RegexNodePtr parseAtom() {
+    char c = pattern[pos++];
+    switch (c) {
+      case '^':
+        return std::make_unique<RegexNode>(RegexNode::Kind::BEGIN);
+      case '$':
+        return std::make_unique<RegexNode>(RegexNode::Kind::END);
+      case '.': {
+        auto node = std::make_unique<RegexNode>(RegexNode::Kind::CHARS);
+        node->chars.set();
+        node->chars.reset('\n');
+        node->chars.reset('\r');
+        return node;
+      }
+      case '[':
+        return parseClass();
+      case '(': {
+        if (!atEnd() && peek() == '?') {
+          if (pos + 1 < pattern.size() && pattern[pos+1] == ':') {
+            pos += 2;
+          } else {
+            // Lookahead assertions.
+            throw UnsupportedRegex();
+          }
+        }
+        auto node = parseAlternation();
+        if (atEnd() || peek() != ')') {
+          throw UnsupportedRegex();
+        }
+        pos++;
+        return node;
+      }
+      case '\\': {
+        auto node = std::make_unique<RegexNode>(RegexNode::Kind::CHARS);
+        node->chars = parseEscape();
+        return node;
+      }
+      case ')': case ']': case '{': case '}':
+      case '*': case '+': case '?':
+        throw UnsupportedRegex();
+      default: {
+        auto node = std::make_unique<RegexNode>(RegexNode::Kind::CHARS);
+        node->chars.set(static_cast<unsigned char>(c));
+        return node;
+      }
+    }
+  }
+
+  RegexNodePtr parseRepeat() {
+    auto node = parseAtom();
+    while (!atEnd()) {
+      unsigned min, max;
+      char c = peek();
+      if (c == '*') {
+        min = 0;
+        max = REPEAT_UNBOUNDED;
+        pos++;
+      } else if (c == '+') {
+        min = 1;
+        max = REPEAT_UNBOUNDED;
+        pos++;
+      } else if (c == '?') {
+        min = 0;
+        max = 1;
+        pos++;
+      } else if (c == '{') {
+        pos++;
+        if (!parseNumber(min)) {
+          throw UnsupportedRegex();
+        }
+        max = min;
+        if (!atEnd() && peek() == ',') {
+          pos++;
+          if (!parseNumber(max)) {
+            max = REPEAT_UNBOUNDED;
+          }
+        }
+        if (atEnd() || peek() != '}' || max < min) {
+          throw UnsupportedRegex();
+        }
+        pos++;
+      } else {
+        break;
+      }
+      // Laziness does not affect whether there is a match.
+      if (!atEnd() && peek() == '?') {
+        pos++;
+      }
+      if (node->kind == RegexNode::Kind::BEGIN ||
+          node->kind == RegexNode::Kind::END) {
+        throw UnsupportedRegex();
+      }
+      auto repeat = std::make_unique<RegexNode>(RegexNode::Kind::REPEAT);
+      repeat->min = min;
+      repeat->max = max;
+      repeat->children.push_back(std::move(node));
+      node = std::move(repeat);
+    }
+    return node;
+  }
+
+  RegexNodePtr parseConcat() {
+    auto node = std::make_unique<RegexNode>(RegexNode::Kind::CONCAT);
+    while (!atEnd() && peek() != '|' && peek() != ')') {
+      node->children.push_back(parseRepeat());
+    }
+    return node;
+  }
+
+  RegexNodePtr parseAlternation() {
+    auto node = std::make_unique<RegexNode>(RegexNode::Kind::ALTERNATE);
+    node->children.push_back(parseConcat());
+    while (!atEnd() && peek() == '|') {
+      pos++;
+      node->children.push_back(parseConcat());
+    }
+    return node;
+  }
+
+public:
+  RegexParser(const std::string &pattern) : pattern(pattern), pos(0) {}
+
+  RegexNodePtr parse() {
+    auto node = parseAlternation();
+    if (!atEnd()) {
+      throw UnsupportedRegex();
+    }
+    return node;
+  }
+};
+
+/// Compile a parsed regular expression into a Pike VM program.
+class RegexCompiler {
+  using Op = Pattern::Instruction::Op;
+  std::vector<Pattern::Instruction> &program;
+
+  size_t emit(Op op, size_t x=0, size_t y=0) {
+    if (program.size() >= MAX_PROGRAM_SIZE) {
+      throw UnsupportedRegex();
+    }
+    program.emplace_back(op, x, y);
+    return program.size() - 1;
+  }
+
+public:
+  RegexCompiler(std::vector<Pattern::Instruction> &program) : program(program) {}
+
+  void compile(const RegexNode &node) {
+    switch (node.kind) {
+      case RegexNode::Kind::CHARS:
+        program[emit(Op::CHARS)].chars = node.chars;
+        break;
+      case RegexNode::Kind::BEGIN:
+        emit(Op::BEGIN);
+        break;
+      case RegexNode::Kind::END:
+        emit(Op::END);
+        break;
+      case RegexNode::Kind::CONCAT:
+        for (auto &child : node.children) {
+          compile(*child);
+        }
+        break;
+      case RegexNode::Kind::ALTERNATE: {
+        // Each alternative but the last is preceded by a split to the next
+        // and followed by a jump to the end.
+        std::vector<size_t> jumps;
+        for (size_t i = 0; i < node.children.size(); ++i) {
+          if (i + 1 < node.children.size()) {
+            auto split = emit(Op::SPLIT);
+            program[split].x = split + 1;
+            compile(*node.children[i]);
+            jumps.push_back(emit(Op::JUMP));
+            program[split].y = program.size();
+          } else {
+            compile(*node.children[i]);
+          }
+        }
+        for (auto jump : jumps) {
+          program[jump].x = program.size();
+        }
+        break;
+      }
+      case RegexNode::Kind::REPEAT: {
+        auto &child = *node.children.front();
+        for (unsigned i = 0; i < node.min; ++i) {
+          compile(child);
+        }
+        if (node.max == REPEAT_UNBOUNDED) {
+          auto split = emit(Op::SPLIT);
+          program[split].x = split + 1;
+          compile(child);
+          emit(Op::JUMP, split);
+          program[split].y = program.size();
+        } else {
+          std::vector<size_t> splits;
+          for (unsigned i = node.min; i < node.max; ++i) {
+            auto split = emit(Op::SPLIT);
+            program[split].x = split + 1;
+            splits.push_back(split);
+            compile(child);
+          }
+          for (auto split : splits) {
+            program[split].y = program.size();
+          }
+        }
+        break;
+      }
+    }
+  }
+};
+
+/// Scratch state for running a program, reused between matches on the same
+/// thread.
+struct ProgramState {
+  std::vector<size_t> current;
+  std::vector<size_t> next;
+  std::vector<size_t> stack;
+  std::vector<size_t> marks;
+  size_t generation = 0;
+};
+
+} // End anonymous namespace.
+
+Pattern::Pattern(const std::string &pattern,
+                 MatchType matchType,
+                 bool ignoreHierarchyMarkers) :
+    matchType(matchType), numWords(0), acceptBit(0),
+    anchoredBegin(false), useRegex(false), useDFA(false), dfaStart(DFA_DEAD),
+    numByteClasses(0) {
+  assert(matchType != MatchType::EXACT && "exact names are not patterns");
+  auto patternStr(pattern);
+  if (matchType == MatchType::WILDCARD) {
+    if (ignoreHierarchyMarkers) {
+      // Ignore '/', '.' and '_' characters.
+      std::replace(patternStr.begin(), patternStr.end(), '/', '?');
+      std::replace(patternStr.begin(), patternStr.end(), '.', '?');
+      std::replace(patternStr.begin(), patternStr.end(), '_', '?');
+    }
+    prefix = NameIndex::getWildcardPrefix(patternStr);
+    compileWildcard(patternStr);
+  } else {
+    if (ignoreHierarchyMarkers) {
+      // Ignore '/' or '_' ('.' already matches any character).
+      std::replace(patternStr.begin(), patternStr.end(), '/', '.');
+      std::replace(patternStr.begin(), patternStr.end(), '_', '.');
+    }
+    // Catch any errors in the regex string.
+    try {
+      fallbackRegex.assign(patternStr);
+    } catch(std::regex_error const &e) {
+      throw Exception(std::string("malformed regular expression: ")+e.what());
+    }
+    prefix = NameIndex::getRegexPrefix(patternStr);
+    useRegex = !compileRegex(patternStr);
+  }
+}
+
+/// Each literal or '?' in the pattern is a state of the NFA, with an initial
+/// state before the first. State i is stored in bit i of the state vector, so
+/// a transition on a character shifts the vector left by one and masks it
+/// with the states whose character matches. A '*' adds a self loop to the
+/// state preceding it, which is kept on any character.
+void Pattern::compileWildcard(const std::string &pattern) {
+  size_t numStates = 1 + std::count_if(pattern.begin(), pattern.end(),
+                                       [](char c) { return c != '*'; });
+  numWords = (numStates + 63) / 64;
+  charMasks.assign(256 * numWords, 0);
+  loopMask.assign(numWords, 0);
+  size_t state = 0;
+  for (auto c : pattern) {
+    if (c == '*') {
+      loopMask[state / 64] |= uint64_t(1) << (state % 64);
+      continue;
+    }
+    state++;
+    auto bit = uint64_t(1) << (state % 64);
+    if (c == '?') {
+      for (size_t i = 0; i < 256; ++i) {
+        charMasks[(i * numWords) + (state / 64)] |= bit;
+      }
+    } else {
+      charMasks[(static_cast<unsigned char>(c) * numWords) + (state / 64)] |= bit;
+    }
+  }
+  acceptBit = uint64_t(1) << (state % 64);
+}
+
+bool Pattern::matchWildcard(std::string_view text) const {
+  if (numWords == 1) {
+    uint64_t states = 1;
+    auto loops = loopMask[0];
+    for (auto c : text) {
+      states = ((states << 1) & charMasks[static_cast<unsigned char>(c)]) |
+               (states & loops);
+      if (!states) {
+        return false;
+      }
+    }
+    return states & acceptBit;
+  }
+  std::vector<uint64_t> states(numWords, 0);
+  states[0] = 1;
+  for (auto c : text) {
+    auto masks = &charMasks[static_cast<unsigned char>(c) * numWords];
+    uint64_t carry = 0;
+    bool any = false;
+    for (size_t i = 0; i < numWords; ++i) {
+      auto shifted = (states[i] << 1) | carry;
+      carry = states[i] >> 63;
+      states[i] = (shifted & masks[i]) | (states[i] & loopMask[i]);
+      any |= states[i] != 0;
+    }
+    if (!any) {
+      return false;
+    }
+  }
+  return states[numWords-1] & acceptBit;
+}
+
+/// Return true if the program was compiled, or false if the expression uses
+/// unsupported syntax.
+bool Pattern::compileRegex(const std::string &pattern) {
+  try {
+    auto root = RegexParser(pattern).parse();
+    RegexCompiler compiler(program);
+    compiler.compile(*root);
+    program.emplace_back(Instruction::Op::MATCH);
+  } catch (UnsupportedRegex const &) {
+    program.clear();
+    return false;
+  }
+  anchoredBegin = program.front().op == Instruction::Op::BEGIN;
+  useDFA = buildDFA();
+  return true;
+}
+
+/// Follow the epsilon transitions of the program from a set of instructions,
+/// collecting the instructions that wait for a character, and those waiting
+/// for the end of the text when not at it. Return true if a match is reached.
+static bool programClosure(const std::vector<Pattern::Instruction> &program,
+                           const std::vector<size_t> &seeds,
+                           bool atBegin,
+                           bool atEnd,
+                           std::vector<size_t> &kernel) {
+  using Op = Pattern::Instruction::Op;
+  std::vector<bool> visited(program.size(), false);
+  std::vector<size_t> stack(seeds.rbegin(), seeds.rend());
+  kernel.clear();
+  while (!stack.empty()) {
+    auto pc = stack.back();
+    stack.pop_back();
+    if (visited[pc]) {
+      continue;
+    }
+    visited[pc] = true;
+    auto &instruction = program[pc];
+    switch (instruction.op) {
+      case Op::CHARS:
+        kernel.push_back(pc);
+        break;
+      case Op::SPLIT:
+        stack.push_back(instruction.y);
+        stack.push_back(instruction.x);
+        break;
+      case Op::JUMP:
+        stack.push_back(instruction.x);
+        break;
+      case Op::BEGIN:
+        if (atBegin) {
+          stack.push_back(pc + 1);
+        }
+        break;
+      case Op::END:
+        if (atEnd) {
+          stack.push_back(pc + 1);
+        } else {
+          kernel.push_back(pc);
+        }
+        break;
+      case Op::MATCH:
+        return true;
+    }
+  }
+  std::sort(kernel.begin(), kernel.end());
+  return false;
+}
+
+/// Convert the program into a DFA by subset construction, where each DFA
+/// state is the set of instructions of the threads waiting at a position. For
+/// an unanchored search a thread is started at every position, so the start
+/// of the program is added to every state. Since only the existence of a
+/// match is required, any state containing the match instruction is replaced
+/// by a single accepting state. Return false if the DFA has too many states.
+bool Pattern::buildDFA() {
+  using Op = Instruction::Op;
+  if (program.size() > MAX_DFA_PROGRAM_SIZE) {
+    return false;
+  }
+  // Group the bytes into classes with the same membership of every set.
+  std::map<std::vector<bool>, uint16_t> classIndexes;
+  std::vector<unsigned> classBytes;
+  byteClasses.assign(256, 0);
+  for (unsigned c = 0; c < 256; ++c) {
+    std::vector<bool> signature;
+    for (auto &instruction : program) {
+      if (instruction.op == Op::CHARS) {
+        signature.push_back(instruction.chars.test(c));
+      }
+    }
+    auto it = classIndexes.find(signature);
+    if (it == classIndexes.end()) {
+      it = classIndexes.emplace(signature, classBytes.size()).first;
+      classBytes.push_back(c);
+    }
+    byteClasses[c] = it->second;
+  }
+  numByteClasses = classBytes.size();
+  // Construct the states.
+  using StateKey = std::pair<bool, std::vector<size_t>>;
+  std::map<StateKey, uint32_t> stateIndexes;
+  std::vector<StateKey> states;
+  auto addState = [&](StateKey key) {
+    auto it = stateIndexes.find(key);
+    if (it != stateIndexes.end()) {
+      return it->second;
+    }
+    uint32_t index = states.size();
+    stateIndexes.emplace(key, index);
+    states.push_back(std::move(key));
+    return index;
+  };
+  std::vector<size_t> kernel;
+  if (programClosure(program, {0}, true, false, kernel)) {
+    dfaStart = DFA_MATCH;
+    return true;
+  }
+  if (kernel.empty()) {
+    dfaStart = DFA_DEAD;
+    return true;
+  }
+  dfaStart = addState(StateKey(true, kernel));
+  for (size_t index = 0; index < states.size(); ++index) {
+    if (states.size() > MAX_DFA_STATES) {
+      dfaTransitions.clear();
+      dfaAcceptAtEnd.clear();
+      return false;
+    }
+    // Copy the key since adding states can reallocate the vector.
+    auto key = states[index];
+    // Determine whether the state accepts at the end of the text.
+    std::vector<size_t> endSeeds;
+    for (auto pc : key.second) {
+      if (program[pc].op == Op::END) {
+        endSeeds.push_back(pc + 1);
+      }
+    }
+    dfaAcceptAtEnd.push_back(!endSeeds.empty() &&
+                             programClosure(program, endSeeds, key.first, true, kernel));
+    // Determine the transition for each class of byte.
+    for (size_t byteClass = 0; byteClass < numByteClasses; ++byteClass) {
+      std::vector<size_t> seeds;
+      for (auto pc : key.second) {
+        if (program[pc].op == Op::CHARS &&
+            program[pc].chars.test(classBytes[byteClass])) {
+          seeds.push_back(pc + 1);
+        }
+      }
+      if (!anchoredBegin) {
+        seeds.push_back(0);
+      }
+      uint32_t next;
+      if (programClosure(program, seeds, false, false, kernel)) {
+        next = DFA_MATCH;
+      } else if (kernel.empty()) {
+        next = DFA_DEAD;
+      } else {
+        next = addState(StateKey(false, kernel));
+      }
+      dfaTransitions.push_back(next);
+    }
+  }
+  return true;
+}
+
+bool Pattern::matchDFA(std::string_view text) const {
+  auto state = dfaStart;
+  for (auto c : text) {
+    if (state >= DFA_DEAD) {
+      break;
+    }
+    state = dfaTransitions[(state * numByteClasses) +
+                           byteClasses[static_cast<unsigned char>(c)]];
+  }
+  if (state == DFA_MATCH) {
+    return true;
+  }
+  if (state == DFA_DEAD) {
+    return false;
+  }
+  return dfaAcceptAtEnd[state];
+}
+
+/// Simulate the program with a Pike VM, advancing the set of threads through
+/// the text one character at a time. Since only the existence of a match is
+/// required, threads are not prioritised and the search stops as soon as any
+/// thread reaches the match instruction.
+bool Pattern::matchProgram(std::string_view text) const {
+  thread_local ProgramState state;
+  if (state.marks.size() < program.size()) {
+    state.marks.resize(program.size(), 0);
+  }
+  auto &marks = state.marks;
+  auto &stack = state.stack;
+  // Add a thread and follow its epsilon transitions, returning true if the
+  // match instruction is reached.
+  auto addThread = [&](std::vector<size_t> &list, size_t pc, size_t pos) {
+    stack.clear();
+    stack.push_back(pc);
+    while (!stack.empty()) {
+      pc = stack.back();
+      stack.pop_back();
+      if (marks[pc] == state.generation) {
+        continue;
+      }
+      marks[pc] = state.generation;
+      auto &instruction = program[pc];
+      switch (instruction.op) {
+        case Instruction::Op::CHARS:
+          list.push_back(pc);
+          break;
+        case Instruction::Op::SPLIT:
+          stack.push_back(instruction.y);
+          stack.push_back(instruction.x);
+          break;
+        case Instruction::Op::JUMP:
+          stack.push_back(instruction.x);
+          break;
+        case Instruction::Op::BEGIN:
+          if (pos == 0) {
+            stack.push_back(pc + 1);
+          }
+          break;
+        case Instruction::Op::END:
+          if (pos == text.size()) {
+            stack.push_back(pc + 1);
+          }
+          break;
+        case Instruction::Op::MATCH:
+          return true;
+      }
+    }
+    return false;
+  };
+  state.current.clear();
+  ++state.generation;
+  for (size_t pos = 0; ; ++pos) {
+    // Start a new thread at each position for an unanchored search.
+    if (!anchoredBegin || pos == 0) {
+      if (addThread(state.current, 0, pos)) {
+        return true;
+      }
+    }
+    if (pos == text.size()) {
+      return false;
+    }
+    state.next.clear();
+    ++state.generation;
+    auto c = static_cast<unsigned char>(text[pos]);
+    for (auto pc : state.current) {
+      if (program[pc].chars.test(c) &&
+          addThread(state.next, pc + 1, pos + 1)) {
+        return true;
+      }
+    }
+    std::swap(state.current, state.next);
+    if (anchoredBegin && state.current.empty()) {
+      return false;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// PatternCache
+//===----------------------------------------------------------------------===//
+
+std::shared_ptr<const Pattern>
+PatternCache::get(const std::string &pattern,
+                  MatchType matchType,
+                  bool ignoreHierarchyMarkers) {
+  Key key(pattern, matchType, ignoreHierarchyMarkers);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = patterns.find(key);
+    if (it != patterns.end()) {
+      return it->second;
+    }
+  }
+  // Compile outside the lock, any malformed pattern throws here.
+  auto compiled = std::make_shared<const Pattern>(pattern, matchType,
+                                                  ignoreHierarchyMarkers);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (patterns.size() >= MAX_ENTRIES) {
+    patterns.clear();
+  }
+  return patterns.emplace(key, compiled).first->second;
+}
+
+void PatternCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  patterns.clear();
+}
+
+size_t PatternCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return patterns.size();
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include "netlist_paths/ReachabilityIndex.hpp"
+#include "netlist_paths/TraversalWorkspace.hpp"
+
+using namespace netlist_paths;
+
+/// Label the components with the intervals of two traversals of the DAG. The
+/// first is the traversal of Tarjan's algorithm, whose post order is the
+/// component numbering. The second starts from the components in
+/// topological order and visits the successors of each in reverse order.
+void ReachabilityIndex::buildLabels() {
+  auto numComponents = componentGraph->numComponents();
+  labels.resize(numComponents);
+  // The successors of a component have lower numbers.
+  for (size_t c = 0; c < numComponents; ++c) {
+    auto low = static_cast<Index>(c);
+    auto successors = getSuccessors(static_cast<Index>(c));
+    for (auto it = successors.first; it != successors.second; ++it) {
+      low = std::min(low, labels[*it].low0);
+    }
+    labels[c].low0 = low;
+  }
+  struct Frame {
+    Index component;
+    const Index *nextSuccessor;
+  };
+  std::vector<Frame> frames;
+  std::vector<uint8_t> visited(numComponents, 0);
+  Index counter = 0;
+  for (size_t root = numComponents; root-- > 0;) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = 1;
+    auto rootComponent = static_cast<Index>(root);
+    frames.push_back({rootComponent, getSuccessors(rootComponent).second});
+    while (!frames.empty()) {
+      auto &top = frames.back();
+      auto c = top.component;
+      auto successors = getSuccessors(c);
+      if (top.nextSuccessor != successors.first) {
+        auto successor = *--top.nextSuccessor;
+        if (!visited[successor]) {
+          visited[successor] = 1;
+          frames.push_back({successor, getSuccessors(successor).second});
+        }
+        continue;
+      }
+      frames.pop_back();
+      // Since the graph is acyclic, all the successors have been labelled.
+      auto post = counter++;
+      auto low = post;
+      for (auto it = successors.first; it != successors.second; ++it) {
+        low = std::min(low, labels[*it].low1);
+      }
+      labels[c].low1 = low;
+      labels[c].post1 = post;
+    }
+  }
+}
+
+void ReachabilityIndex::build(const CSRGraph &graph, bool traverseRegisters) {
+  auto components = std::make_shared<ComponentGraph>();
+  components->build(graph, traverseRegisters);
+  build(components);
+}
+
+void ReachabilityIndex::build(std::shared_ptr<const ComponentGraph> componentGraph) {
+  clear();
+  this->componentGraph = std::move(componentGraph);
+  buildLabels();
+  BOOST_LOG_TRIVIAL(info) << "Reachability index"
+                          << (this->componentGraph->shouldTraverseRegisters()
+                                ? " traversing registers" : "")
+                          << " has " << numComponents() << " components and "
+                          << this->componentGraph->numEdges() << " edges";
+}
+
+void ReachabilityIndex::clear() {
+  componentGraph.reset();
+  labels.clear();
+}
+
+bool ReachabilityIndex::reaches(size_t startVertex, size_t finishVertex) const {
+  auto start = getComponent(startVertex);
+  auto finish = getComponent(finishVertex);
+  if (start == finish) {
+    return true;
+  }
+  if (!mayReach(start, finish)) {
+    return false;
+  }
+  // Search the DAG, only entering components that the labels allow to reach
+  // the finish component.
+  auto &workspace = TraversalWorkspace::get();
+  auto &visited = workspace.components;
+  auto &stack = workspace.componentStack;
+  visited.reset(numComponents());
+  stack.assign(1, start);
+  visited.set(start);
+  while (!stack.empty()) {
+    auto c = stack.back();
+    stack.pop_back();
+    auto successors = getSuccessors(c);
+    for (auto it = successors.first; it != successors.second; ++it) {
+      auto successor = *it;
+      if (successor == finish) {
+        return true;
+      }
+      if (!visited.test(successor) && mayReach(successor, finish)) {
+        visited.set(successor);
+        stack.push_back(successor);
+      }
+    }
+  }
+  return false;
+}
+
+std::vector<size_t>
+ReachabilityIndex::selectReachable(size_t rootVertex,
+                                   const std::vector<size_t> &vertices,
+                                   bool reverse) const {
+  auto &workspace = TraversalWorkspace::get();
+  auto &visited = workspace.components;
+  auto &stack = workspace.componentStack;
+  visited.reset(numComponents());
+  auto root = getComponent(rootVertex);
+  stack.assign(1, root);
+  visited.set(root);
+  while (!stack.empty()) {
+    auto c = stack.back();
+    stack.pop_back();
+    auto adjacent = reverse ? getPredecessors(c) : getSuccessors(c);
+    for (auto it = adjacent.first; it != adjacent.second; ++it) {
+      auto next = *it;
+      if (!visited.test(next)) {
+        visited.set(next);
+        stack.push_back(next);
+      }
+    }
+  }
+  std::vector<size_t> result;
+  for (auto vertex : vertices) {
+    if (visited.test(getComponent(vertex))) {
+      result.push_back(vertex);
+    }
+  }
+  return result;
+}
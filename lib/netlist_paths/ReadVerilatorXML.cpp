@@ -1,8 +1,14 @@
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <boost/format.hpp>
 
+#include "netlist_paths/Compression.hpp"
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Options.hpp"
@@ -10,6 +16,26 @@
 
 using namespace netlist_paths;
 
+/// Bytes currently allocated by rapidxml memory pools, for reporting the peak
+/// memory usage of the parser.
+static thread_local size_t xmlPoolBytes = 0;
+
+static void *xmlPoolAlloc(std::size_t size) {
+  auto block = static_cast<char*>(std::malloc(size + sizeof(std::max_align_t)));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<size_t*>(block) = size;
+  xmlPoolBytes += size;
+  return block + sizeof(std::max_align_t);
+}
+
+static void xmlPoolFree(void *pointer) {
+  auto block = static_cast<char*>(pointer) - sizeof(std::max_align_t);
+  xmlPoolBytes -= *reinterpret_cast<size_t*>(block);
+  std::free(block);
+}
+
 enum class AstNode {
   ALWAYS,
   ALWAYS_PUBLIC,
@@ -46,48 +72,88 @@ enum class AstNode {
   INVALID
 };
 
+/// Return a view of the name of a node.
+static std::string_view getName(const XMLNode *node) {
+  return std::string_view(node->name(), node->name_size());
+}
+
+/// Return a view of the value of an attribute of a node, which must exist.
+static std::string_view getAttribute(const XMLNode *node, const char *name) {
+  auto attribute = node->first_attribute(name);
+  return std::string_view(attribute->value(), attribute->value_size());
+}
+
+/// Parse the leading digits of an unsigned integer.
+static size_t parseUnsigned(std::string_view value, int base=10) {
+  size_t result = 0;
+  auto end = value.data() + value.size();
+  if (std::from_chars(value.data(), end, result, base).ec != std::errc()) {
+    throw XMLException(std::string("invalid integer ")+std::string(value));
+  }
+  return result;
+}
+
+/// An FNV-1a hash of a node name, which is evaluated at compile time for the
+/// names of the AST nodes so that they can be dispatched with a switch. The
+/// hashes of the names are the labels of the cases, so the compiler checks
+/// that none of them collide.
+static constexpr uint32_t hashNodeName(std::string_view name) {
+  uint32_t hash = 2166136261u;
+  for (auto c : name) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+/// Return a node type if a name matches the name of the type, since other
+/// names can have the same hash.
+static constexpr AstNode matchNode(std::string_view name,
+                                   std::string_view typeName,
+                                   AstNode type) {
+  return name == typeName ? type : AstNode::INVALID;
+}
+
 /// Convert a string name into an AstNode type.
-static AstNode resolveNode(const char *name) {
-  static std::map<std::string, AstNode> mappings {
-      { "always",           AstNode::ALWAYS },
-      { "alwayspublic",     AstNode::ALWAYS_PUBLIC },
-      { "assign",           AstNode::ASSIGN },
-      { "assignalias",      AstNode::ASSIGN_ALIAS },
-      { "assigndly",        AstNode::ASSIGN_DLY },
-      { "assignw",          AstNode::ASSIGN_W },
-      { "basicdtype",       AstNode::BASIC_DTYPE },
-      { "cfunc",            AstNode::C_FUNC },
-      { "const",            AstNode::CONST },
-      { "contassign",       AstNode::CONT_ASSIGN },
-      { "enumdtype",        AstNode::ENUM },
-      { "ifacerefdtype",    AstNode::IFACE_REF_DTYPE },
-      { "initial",          AstNode::INITIAL },
-      { "instance",         AstNode::INSTANCE },
-      { "intfref",          AstNode::INTF_REF },
-      { "memberdtype",      AstNode::MEMBER_DTYPE },
-      { "module",           AstNode::MODULE },
-      { "packarraydtype",   AstNode::PACKED_ARRAY },
-      { "refdtype",         AstNode::REF_DTYPE },
-      { "scope",            AstNode::SCOPE },
-      { "sengate",          AstNode::SEN_GATE },
-      { "senitem",          AstNode::SEN_ITEM },
-      { "structdtype",      AstNode::STRUCT_DTYPE },
-      { "topscope",         AstNode::TOP_SCOPE },
-      { "typedef",          AstNode::TYPEDEF },
-      { "typetable",        AstNode::TYPE_TABLE },
-      { "uniondtype",       AstNode::UNION_DTYPE },
-      { "unpackarraydtype", AstNode::UNPACKED_ARRAY },
-      { "var",              AstNode::VAR },
-      { "varref",           AstNode::VAR_REF },
-      { "varscope",         AstNode::VAR_SCOPE },
-  };
-  auto it = mappings.find(name);
-  return (it != mappings.end()) ? it->second : AstNode::INVALID;
+static AstNode resolveNode(std::string_view name) {
+  switch (hashNodeName(name)) {
+  case hashNodeName("always"):            return matchNode(name, "always",            AstNode::ALWAYS);
+  case hashNodeName("alwayspublic"):      return matchNode(name, "alwayspublic",      AstNode::ALWAYS_PUBLIC);
+  case hashNodeName("assign"):            return matchNode(name, "assign",            AstNode::ASSIGN);
+  case hashNodeName("assignalias"):       return matchNode(name, "assignalias",       AstNode::ASSIGN_ALIAS);
+  case hashNodeName("assigndly"):         return matchNode(name, "assigndly",         AstNode::ASSIGN_DLY);
+  case hashNodeName("assignw"):           return matchNode(name, "assignw",           AstNode::ASSIGN_W);
+  case hashNodeName("basicdtype"):        return matchNode(name, "basicdtype",        AstNode::BASIC_DTYPE);
+  case hashNodeName("cfunc"):             return matchNode(name, "cfunc",             AstNode::C_FUNC);
+  case hashNodeName("const"):             return matchNode(name, "const",             AstNode::CONST);
+  case hashNodeName("contassign"):        return matchNode(name, "contassign",        AstNode::CONT_ASSIGN);
+  case hashNodeName("enumdtype"):         return matchNode(name, "enumdtype",         AstNode::ENUM);
+  case hashNodeName("ifacerefdtype"):     return matchNode(name, "ifacerefdtype",     AstNode::IFACE_REF_DTYPE);
+  case hashNodeName("initial"):           return matchNode(name, "initial",           AstNode::INITIAL);
+  case hashNodeName("instance"):          return matchNode(name, "instance",          AstNode::INSTANCE);
+  case hashNodeName("intfref"):           return matchNode(name, "intfref",           AstNode::INTF_REF);
+  case hashNodeName("memberdtype"):       return matchNode(name, "memberdtype",       AstNode::MEMBER_DTYPE);
+  case hashNodeName("module"):            return matchNode(name, "module",            AstNode::MODULE);
+  case hashNodeName("packarraydtype"):    return matchNode(name, "packarraydtype",    AstNode::PACKED_ARRAY);
+  case hashNodeName("refdtype"):          return matchNode(name, "refdtype",          AstNode::REF_DTYPE);
+  case hashNodeName("scope"):             return matchNode(name, "scope",             AstNode::SCOPE);
+  case hashNodeName("sengate"):           return matchNode(name, "sengate",           AstNode::SEN_GATE);
+  case hashNodeName("senitem"):           return matchNode(name, "senitem",           AstNode::SEN_ITEM);
+  case hashNodeName("structdtype"):       return matchNode(name, "structdtype",       AstNode::STRUCT_DTYPE);
+  case hashNodeName("topscope"):          return matchNode(name, "topscope",          AstNode::TOP_SCOPE);
+  case hashNodeName("typedef"):           return matchNode(name, "typedef",           AstNode::TYPEDEF);
+  case hashNodeName("typetable"):         return matchNode(name, "typetable",         AstNode::TYPE_TABLE);
+  case hashNodeName("uniondtype"):        return matchNode(name, "uniondtype",        AstNode::UNION_DTYPE);
+  case hashNodeName("unpackarraydtype"):  return matchNode(name, "unpackarraydtype",  AstNode::UNPACKED_ARRAY);
+  case hashNodeName("var"):               return matchNode(name, "var",               AstNode::VAR);
+  case hashNodeName("varref"):            return matchNode(name, "varref",            AstNode::VAR_REF);
+  case hashNodeName("varscope"):          return matchNode(name, "varscope",          AstNode::VAR_SCOPE);
+  default:                                return AstNode::INVALID;
+  }
 }
 
 void ReadVerilatorXML::dispatchVisitor(XMLNode *node) {
   // Handle node by type.
-  switch (resolveNode(node->name())) {
+  switch (resolveNode(getName(node))) {
   case AstNode::ALWAYS:          visitAlways(node);                      break;
   case AstNode::ALWAYS_PUBLIC:   visitAlways(node);                      break;
   case AstNode::ASSIGN:          visitAssign(node);                      break;
@@ -166,39 +232,117 @@ std::string ReadVerilatorXML::removeTopPrefix(std::string name) {
   return name;
 }
 
-VertexID ReadVerilatorXML::lookupVarVertexExact(const std::string &name) {
-  // Lookup the vertex name directly.
-  if (vars.count(name)) {
-    return vars[name];
+/// Return a view of a name with a dotted prefix, which is held in a buffer
+/// that is reused by each call to avoid allocating a string for each lookup.
+std::string_view ReadVerilatorXML::prefixName(const std::string &prefix,
+                                              std::string_view name) {
+  nameBuffer.assign(prefix);
+  nameBuffer.push_back('.');
+  nameBuffer.append(name);
+  return nameBuffer;
+}
+
+/// Add a variable to the symbol table, unless one with the name exists.
+void ReadVerilatorXML::addVar(std::string_view name, VertexID vertex) {
+  if (vars.find(name) == vars.end()) {
+    vars.emplace(keys.intern(name), vertex);
   }
-  // Not found.
-  return netlist.nullVertex();
 }
 
-VertexID ReadVerilatorXML::lookupVarVertex(const std::string &name) {
+VertexID ReadVerilatorXML::lookupVarVertexExact(std::string_view name) {
   // Lookup the vertex name directly.
-  if (vars.count(name)) {
-    return vars[name];
+  auto it = vars.find(name);
+  return it != vars.end() ? it->second : netlist.nullVertex();
+}
+
+VertexID ReadVerilatorXML::lookupVarVertex(std::string_view name) {
+  // Lookup the vertex name directly.
+  auto vertex = lookupVarVertexExact(name);
+  if (vertex != netlist.nullVertex()) {
+    return vertex;
   }
-  // Try to add the top suffix.
-  auto extendedName = addTopPrefix(name);
-  if (vars.count(extendedName)) {
-    return vars[extendedName];
+  // Try to add the top prefix.
+  if (!topName.empty() && name.rfind(topName, 0) == std::string_view::npos) {
+    return lookupVarVertexExact(prefixName(topName, name));
   }
   // Not found.
   return netlist.nullVertex();
 }
 
-Location ReadVerilatorXML::parseLocation(const std::string location) {
-  std::vector<std::string> tokens;
-  boost::split(tokens, location, boost::is_any_of(","));
-  auto fileId    = tokens[0];
-  auto file      = fileIdMappings[fileId];
-  auto startLine = static_cast<unsigned>(std::stoul(tokens[1]));
-  auto endLine   = static_cast<unsigned>(std::stoul(tokens[3]));
-  auto startCol  = static_cast<unsigned>(std::stoul(tokens[2]));
-  auto endCol    = static_cast<unsigned>(std::stoul(tokens[4]));
-  return Location(file, startLine, startCol, endLine, endCol);
+/// Add a data type to the type table, by its ID.
+void ReadVerilatorXML::addDTypeMapping(std::string_view id,
+                                       std::shared_ptr<DType> dtype) {
+  dtypeMappings.emplace(keys.intern(id), dtype);
+  addDtype(dtype);
+}
+
+std::shared_ptr<DType> ReadVerilatorXML::lookupDType(std::string_view id) {
+  auto it = dtypeMappings.find(id);
+  return it != dtypeMappings.end() ? it->second : std::shared_ptr<DType>();
+}
+
+/// Return the index in the DTypeTable of the graph of a data type, or
+/// NO_DTYPE if the typetable has not been read or does not contain it.
+uint32_t ReadVerilatorXML::lookupDTypeIndex(std::string_view id) {
+  auto it = dtypeIndexes.find(id);
+  return it != dtypeIndexes.end() ? it->second : DTypeTable::NO_DTYPE;
+}
+
+/// Add the data types to the DTypeTable of the graph, once their sub DTypes
+/// are resolved, which computes their widths and strings.
+void ReadVerilatorXML::finalizeDTypes() {
+  for (auto &mapping : dtypeMappings) {
+    if (dtypeIndexes.count(mapping.first) == 0) {
+      dtypeIndexes.emplace(mapping.first, netlist.addDType(mapping.second));
+    }
+  }
+}
+
+/// Set the sub DType of a data type, once both have been declared.
+template<typename T>
+void ReadVerilatorXML::resolveSubDType(std::string_view id,
+                                       std::string_view subDTypeId,
+                                       const char *kind) {
+  auto subDType = lookupDType(subDTypeId);
+  if (!subDType) {
+    throw XMLException(std::string("could not find ")+kind+" sub dtype ID "+std::string(subDTypeId));
+  }
+  dynamic_cast<T*>(lookupDType(id).get())->setSubDType(subDType);
+}
+
+/// Resolve dtype references recorded by the streaming reader.
+void ReadVerilatorXML::resolvePendingDTypes() {
+  for (auto &resolve : pendingDTypeRefs) {
+    resolve();
+  }
+  pendingDTypeRefs.clear();
+  finalizeDTypes();
+  for (auto &varDType : pendingVarDTypes) {
+    netlist.setVertexDType(varDType.first, lookupDTypeIndex(varDType.second));
+  }
+  pendingVarDTypes.clear();
+}
+
+/// Parse a location of the form 'file,startLine,startCol,endLine,endCol'.
+Location ReadVerilatorXML::parseLocation(std::string_view location) {
+  auto separator = location.find(',');
+  auto it   = fileIdMappings.find(location.substr(0, separator));
+  auto file = it != fileIdMappings.end() ? it->second : FileTable::NO_FILE;
+  // Line and column numbers.
+  unsigned values[4];
+  auto next = location.data() + std::min(separator, location.size());
+  auto end = location.data() + location.size();
+  for (auto &value : values) {
+    std::from_chars_result result{next, std::errc::invalid_argument};
+    if (next != end && *next == ',') {
+      result = std::from_chars(next + 1, end, value);
+    }
+    if (result.ec != std::errc()) {
+      throw XMLException(std::string("invalid location ")+std::string(location));
+    }
+    next = result.ptr;
+  }
+  return Location(file, values[0], values[1], values[2], values[3]);
 }
 
 void ReadVerilatorXML::newVar(XMLNode *node) {
@@ -207,7 +351,7 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
   // followed by a <topscope>, <scope> and then <varscopes>. There is no other
   // scoping in the netlist.
   auto name = std::string(node->first_attribute("name")->value());
-  auto location = parseLocation(node->first_attribute("loc")->value());
+  auto location = parseLocation(getAttribute(node, "loc"));
   auto dtypeID = node->first_attribute("dtype_id")->value();
   auto direction = (node->first_attribute("dir")) ?
                      getVertexDirection(node->first_attribute("dir")->value()) :
@@ -241,11 +385,16 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
 
   // Canonicalise the variable name by adding a top prefix if it is known.
   auto canonicalName = addTopPrefix(name);
+  auto dtype = lookupDTypeIndex(dtypeID);
   auto vertex = netlist.addVarVertex(VertexAstType::VAR, direction, location,
-                                     dtypeMappings[dtypeID], canonicalName,
+                                     dtype, canonicalName,
                                      isParam, paramValue, isPublic);
-  if (vars.count(canonicalName) == 0) {
-    vars[canonicalName] = vertex;
+  if (dtype == DTypeTable::NO_DTYPE && deferDTypeRefs) {
+    // The typetable can follow the module.
+    pendingVarDTypes.emplace_back(vertex, dtypeID);
+  }
+  if (lookupVarVertexExact(canonicalName) == netlist.nullVertex()) {
+    addVar(canonicalName, vertex);
     BOOST_LOG_TRIVIAL(debug) << boost::format("Add var %s (canonical %s) to scope") % name % canonicalName;
   } else {
     BOOST_LOG_TRIVIAL(debug) << boost::format("Var %s (canonical %s) already exists") % name % canonicalName;
@@ -274,8 +423,7 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
 }
 
 void ReadVerilatorXML::newVarScope(XMLNode *node) {
-  auto name = node->first_attribute("name")->value();
-  auto existingVarVertex = lookupVarVertex(name);
+  auto existingVarVertex = lookupVarVertex(getAttribute(node, "name"));
   // newVar is called for 'var' and 'varscope' nodes since Verilator introduces
   // some nodes during its transformations on as 'varscope's.
   if (existingVarVertex == netlist.nullVertex()) {
@@ -289,7 +437,7 @@ void ReadVerilatorXML::newStatement(XMLNode *node, VertexAstType vertexType) {
   if (currentScope) {
     logicParents.push(std::move(currentLogic));
     // Create a vertex for this logic.
-    auto location = parseLocation(node->first_attribute("loc")->value());
+    auto location = parseLocation(getAttribute(node, "loc"));
     auto vertex = netlist.addLogicVertex(vertexType, location);
     currentLogic = std::make_unique<LogicNode>(node, *currentScope, vertex);
     // Create an edge from the parent logic to this one.
@@ -324,10 +472,10 @@ void ReadVerilatorXML::newVarRef(XMLNode *node) {
       auto name = std::string(node->first_attribute("name")->value());
       throw XMLException(std::string("var ")+name+" not under a logic block");
     }
-    auto varName = node->first_attribute("name")->value();
+    auto varName = getAttribute(node, "name");
     auto varVertex = lookupVarVertex(varName);
     if (varVertex == netlist.nullVertex()) {
-      throw XMLException(std::string("var ")+varName+" does not have a VAR_SCOPE");
+      throw XMLException(std::string("var ")+std::string(varName)+" does not have a VAR_SCOPE");
     }
     if (isLValue) {
       // Assignment to var
@@ -435,63 +583,70 @@ void ReadVerilatorXML::visitTypedef(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitBasicDtype(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
+  auto id = getAttribute(node, "id");
   if (dtypeMappings.count(id) == 0) {
     auto name = node->first_attribute("name")->value();
-    auto location = parseLocation(node->first_attribute("loc")->value());
+    auto location = parseLocation(getAttribute(node, "loc"));
     if (node->first_attribute("left") && node->first_attribute("right")) {
-      auto left = std::stoul(node->first_attribute("left")->value());
-      auto right = std::stoul(node->first_attribute("right")->value());
-      dtypeMappings[id] = std::make_shared<BasicDType>(name, location, left, right);
+      auto left = parseUnsigned(getAttribute(node, "left"));
+      auto right = parseUnsigned(getAttribute(node, "right"));
+      addDTypeMapping(id, std::make_shared<BasicDType>(name, location, left, right));
     } else {
-      dtypeMappings[id] = std::make_shared<BasicDType>(name, location);
+      addDTypeMapping(id, std::make_shared<BasicDType>(name, location));
     }
-    addDtype(dtypeMappings[id]);
   }
 }
 
 void ReadVerilatorXML::visitRefDtype(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
+  auto id = getAttribute(node, "id");
+  auto subDTypeId = getAttribute(node, "sub_dtype_id");
   if (dtypeMappings.count(id) == 0) {
     auto name = node->first_attribute("name")->value();
-    auto location = parseLocation(node->first_attribute("loc")->value());
-    dtypeMappings[id] = std::make_shared<RefDType>(name, location);
-    addDtype(dtypeMappings[id]);
+    auto location = parseLocation(getAttribute(node, "loc"));
+    addDTypeMapping(id, std::make_shared<RefDType>(name, location));
+    if (deferDTypeRefs) {
+      pendingDTypeRefs.push_back([this, id = keys.intern(id),
+                                  subDTypeId = keys.intern(subDTypeId)] {
+        resolveSubDType<RefDType>(id, subDTypeId, "ref");
+      });
+    }
   } else {
     // Second pass (sub DType declaration can occur after).
-    if (dtypeMappings.count(subDTypeId) == 0) {
-      throw XMLException(std::string("could not find ref sub dtype ID ")+subDTypeId);
-    }
-    dynamic_cast<RefDType*>(dtypeMappings[id].get())->setSubDType(dtypeMappings[subDTypeId]);
+    resolveSubDType<RefDType>(id, subDTypeId, "ref");
   }
 }
 
+MemberDType ReadVerilatorXML::newMemberDType(const std::string &name,
+                                             Location location,
+                                             std::string_view subDTypeId) {
+  auto subDType = lookupDType(subDTypeId);
+  if (!subDType) {
+    throw XMLException(std::string("could not find member sub dtype ID ")+std::string(subDTypeId));
+  }
+  return MemberDType(name, location, subDType);
+}
+
 MemberDType ReadVerilatorXML::visitMemberDType(XMLNode *node) {
   auto name = node->first_attribute("name")->value();
-  auto location = parseLocation(node->first_attribute("loc")->value());
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
-  if (dtypeMappings.count(subDTypeId) == 0) {
-    throw XMLException(std::string("could not find member sub dtype ID ")+subDTypeId);
-  }
-  return MemberDType(name, location, dtypeMappings[subDTypeId]);
+  auto location = parseLocation(getAttribute(node, "loc"));
+  return newMemberDType(name, location, getAttribute(node, "sub_dtype_id"));
 }
 
 size_t ReadVerilatorXML::visitConst(XMLNode *node) {
-  auto value = std::string(node->first_attribute("name")->value());
-  if (value.rfind("'") != std::string::npos) {
+  auto value = getAttribute(node, "name");
+  if (value.rfind("'") != std::string_view::npos) {
     // Drop any value type prefixes.
     auto pos = value.rfind("'sh");
-    if (pos != std::string::npos) {
-      return std::stoi(value.substr(pos+3), nullptr, 16);
+    if (pos != std::string_view::npos) {
+      return parseUnsigned(value.substr(pos+3), 16);
     }
     pos = value.rfind("'h");
-    if (pos != std::string::npos) {
-      return std::stoul(value.substr(pos+2), nullptr, 16);
+    if (pos != std::string_view::npos) {
+      return parseUnsigned(value.substr(pos+2), 16);
     }
     assert(0 && "Unexpected constant type prefix");
   }
-  return std::stoul(value);
+  return parseUnsigned(value);
 }
 
 std::pair<size_t, size_t>
@@ -503,32 +658,34 @@ ReadVerilatorXML::visitRange(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitArrayDType(XMLNode *node, bool packed) {
-  auto id = node->first_attribute("id")->value();
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
+  auto id = getAttribute(node, "id");
+  auto subDTypeId = getAttribute(node, "sub_dtype_id");
   if (dtypeMappings.count(id) == 0) {
-    auto location = parseLocation(node->first_attribute("loc")->value());
+    auto location = parseLocation(getAttribute(node, "loc"));
     assert(numChildren(node) == 1 && "arraydtype expects one range child");
     auto range = visitRange(node->first_node());
-    dtypeMappings[id] = std::make_shared<ArrayDType>(location,
+    addDTypeMapping(id, std::make_shared<ArrayDType>(location,
                                                      range.first,
                                                      range.second,
-                                                     packed);
-    addDtype(dtypeMappings[id]);
+                                                     packed));
+    if (deferDTypeRefs) {
+      pendingDTypeRefs.push_back([this, id = keys.intern(id),
+                                  subDTypeId = keys.intern(subDTypeId)] {
+        resolveSubDType<ArrayDType>(id, subDTypeId, "array");
+      });
+    }
   } else {
     // Second pass (sub DType declaration can occur after).
-    if (dtypeMappings.count(subDTypeId) == 0) {
-      throw XMLException(std::string("could not find array sub dtype ID ")+subDTypeId);
-    }
-    dynamic_cast<ArrayDType*>(dtypeMappings[id].get())->setSubDType(dtypeMappings[subDTypeId]);
+    resolveSubDType<ArrayDType>(id, subDTypeId, "array");
   }
 }
 
 /// Shared handling for structs and unions.
 template<typename T>
 void ReadVerilatorXML::visitAggregateDType(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
+  auto id = getAttribute(node, "id");
   if (dtypeMappings.count(id) == 0) {
-    auto location = parseLocation(node->first_attribute("loc")->value());
+    auto location = parseLocation(getAttribute(node, "loc"));
     std::shared_ptr<T> dtype;
     // Struct or union may not be named, and defined inline with a declaration.
     if (node->first_attribute("name")) {
@@ -537,15 +694,28 @@ void ReadVerilatorXML::visitAggregateDType(XMLNode *node) {
     } else {
       dtype = std::make_shared<T>(location);
     }
-    dtypeMappings[id] = dtype;
-    addDtype(dtype);
+    addDTypeMapping(id, dtype);
+    if (deferDTypeRefs) {
+      // Record the members to add once their sub DTypes are known.
+      for (XMLNode *child = node->first_node();
+           child; child = child->next_sibling()) {
+        assert(std::string(child->name()) == "memberdtype" &&
+               "aggregate dtype expects memberdtype children");
+        auto name = std::string(child->first_attribute("name")->value());
+        auto memberLocation = parseLocation(getAttribute(child, "loc"));
+        auto subDTypeId = keys.intern(getAttribute(child, "sub_dtype_id"));
+        pendingDTypeRefs.push_back([this, dtype, name, memberLocation, subDTypeId] {
+          dtype->addMemberDType(newMemberDType(name, memberLocation, subDTypeId));
+        });
+      }
+    }
   } else {
     // Second pass to resolve sub DTypes.
     for (XMLNode *child = node->first_node();
          child; child = child->next_sibling()) {
       assert(std::string(child->name()) == "memberdtype" &&
              "aggregate dtype expects memberdtype children");
-      dynamic_cast<T*>(dtypeMappings[id].get())->addMemberDType(visitMemberDType(child));
+      dynamic_cast<T*>(lookupDType(id).get())->addMemberDType(visitMemberDType(child));
     }
   }
 }
@@ -557,10 +727,10 @@ EnumItem ReadVerilatorXML::visitEnumItem(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitEnumDType(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
+  auto id = getAttribute(node, "id");
+  auto subDTypeId = getAttribute(node, "sub_dtype_id");
   if (dtypeMappings.count(id) == 0) {
-    auto location = parseLocation(node->first_attribute("loc")->value());
+    auto location = parseLocation(getAttribute(node, "loc"));
     auto name = node->first_attribute("name")->value();
     auto dtype = std::make_shared<EnumDType>(name, location);
     for (XMLNode *child = node->first_node();
@@ -569,14 +739,16 @@ void ReadVerilatorXML::visitEnumDType(XMLNode *node) {
              "enumdtype expects enumitem children");
       dtype->addItem(visitEnumItem(child));
     }
-    dtypeMappings[id] = dtype;
-    addDtype(dtype);
+    addDTypeMapping(id, dtype);
+    if (deferDTypeRefs) {
+      pendingDTypeRefs.push_back([this, id = keys.intern(id),
+                                  subDTypeId = keys.intern(subDTypeId)] {
+        resolveSubDType<EnumDType>(id, subDTypeId, "enum");
+      });
+    }
   } else {
     // Second pass (sub DType declaration can occur after).
-    if (dtypeMappings.count(subDTypeId) == 0) {
-      throw XMLException(std::string("could not find enum sub dtype ID ")+subDTypeId);
-    }
-    dynamic_cast<EnumDType*>(dtypeMappings[id].get())->setSubDType(dtypeMappings[subDTypeId]);
+    resolveSubDType<EnumDType>(id, subDTypeId, "enum");
   }
 }
 
@@ -584,28 +756,37 @@ void ReadVerilatorXML::visitInterfaceRefDType(XMLNode *node) {
  // To do.
 }
 
+void ReadVerilatorXML::newFile(XMLNode *node) {
+  auto fileId = getAttribute(node, "id");
+  auto filename = node->first_attribute("filename")->value();
+  auto language = node->first_attribute("language")->value();
+  fileIdMappings[keys.intern(fileId)] = addFile(File(filename, language));
+}
+
 void ReadVerilatorXML::readXML(const std::string &filename) {
   BOOST_LOG_TRIVIAL(info) << "Parsing input XML file";
-  std::fstream inputFile(filename);
-  if (!inputFile.is_open()) {
+  InputFile inputFile(filename);
+  if (!inputFile.isOpen()) {
     throw XMLException("could not open file");
   }
   // Parse the buffered XML.
   rapidxml::xml_document<> doc;
-  std::vector<char> buffer((std::istreambuf_iterator<char>(inputFile)),
+  doc.set_allocator(xmlPoolAlloc, xmlPoolFree);
+  std::vector<char> buffer((std::istreambuf_iterator<char>(inputFile.get())),
                             std::istreambuf_iterator<char>());
   buffer.push_back('\0');
-  doc.parse<0>(&buffer[0]);
+  {
+    ScopedTimer timer(netlist.getStats(), StatsPhase::PARSE_XML);
+    doc.parse<0>(&buffer[0]);
+  }
+  updatePeakMemory(buffer.capacity() + sizeof(doc) + xmlPoolBytes);
   // Find our root node
   XMLNode *rootNode = doc.first_node("verilator_xml");
   // Files section
   XMLNode *filesNode = rootNode->first_node("files");
   for (XMLNode *fileNode = filesNode->first_node("file");
        fileNode; fileNode = fileNode->next_sibling()) {
-    auto fileId = fileNode->first_attribute("id")->value();
-    auto filename = fileNode->first_attribute("filename")->value();
-    auto language = fileNode->first_attribute("language")->value();
-    fileIdMappings[fileId] = addFile(File(filename, language));
+    newFile(fileNode);
   }
   // Netlist section.
   XMLNode *netlistNode = rootNode->first_node("netlist");
@@ -624,12 +805,22 @@ void ReadVerilatorXML::readXML(const std::string &filename) {
   BOOST_LOG_TRIVIAL(info) << packageCount   << " packages in netlist";
   // Typetable (two passes to resolve forward dtype ID references).
   XMLNode *typeTableNode = netlistNode->first_node("typetable");
-  visitTypeTable(typeTableNode);
-  visitTypeTable(typeTableNode);
+  {
+    ScopedTimer timer(netlist.getStats(), StatsPhase::TYPE_TABLE_PASS_1);
+    visitTypeTable(typeTableNode);
+  }
+  {
+    ScopedTimer timer(netlist.getStats(), StatsPhase::TYPE_TABLE_PASS_2);
+    visitTypeTable(typeTableNode);
+    finalizeDTypes();
+  }
   BOOST_LOG_TRIVIAL(info) << boost::format("%d entries in type table") % dtypes.size();
-  // Module (single instance).
-  if (moduleCount == 1 && interfaceCount == 0) {
-    XMLNode *topModuleNode = netlistNode->first_node("module");
+  // Module (single instance). A flat netlist has a single module containing
+  // a top scope, whereas the modules of one that is not flat have no scopes.
+  ScopedTimer timer(netlist.getStats(), StatsPhase::VISIT_MODULES);
+  XMLNode *topModuleNode = netlistNode->first_node("module");
+  bool isFlat = topModuleNode && topModuleNode->first_node("topscope");
+  if (isFlat && moduleCount == 1 && interfaceCount == 0) {
     visitModule(topModuleNode);
     if (std::string(topModuleNode->first_attribute("name")->value()) != "TOP") {
       throw XMLException("unexpected top module name");
@@ -639,6 +830,376 @@ void ReadVerilatorXML::readXML(const std::string &filename) {
   } else {
     BOOST_LOG_TRIVIAL(info) << "Netlist is not flat, skipping modules";
   }
+  BOOST_LOG_TRIVIAL(info) << boost::format("Peak parser memory %d bytes") % peakMemory;
+}
+
+//===----------------------------------------------------------------------===//
+// Streaming reader.
+//===----------------------------------------------------------------------===//
+
+/// The elements of a flattened netlist that contain the nodes passed to the
+/// visitors. Any other element is read as a complete subtree.
+enum class XMLContainer {
+  DOCUMENT,
+  VERILATOR_XML,
+  FILES,
+  NETLIST,
+  MODULE,
+  TOP_SCOPE,
+  SCOPE,
+  TYPE_TABLE,
+  NONE
+};
+
+/// Determine whether an element opens a container, given its parent.
+static XMLContainer resolveContainer(XMLContainer parent, const std::string &name) {
+  switch (parent) {
+  case XMLContainer::DOCUMENT:
+    return name == "verilator_xml" ? XMLContainer::VERILATOR_XML : XMLContainer::NONE;
+  case XMLContainer::VERILATOR_XML:
+    if (name == "files")   { return XMLContainer::FILES; }
+    if (name == "netlist") { return XMLContainer::NETLIST; }
+    return XMLContainer::NONE;
+  case XMLContainer::NETLIST:
+    if (name == "module")    { return XMLContainer::MODULE; }
+    if (name == "typetable") { return XMLContainer::TYPE_TABLE; }
+    return XMLContainer::NONE;
+  case XMLContainer::MODULE:
+    return name == "topscope" ? XMLContainer::TOP_SCOPE : XMLContainer::NONE;
+  case XMLContainer::TOP_SCOPE:
+    return name == "scope" ? XMLContainer::SCOPE : XMLContainer::NONE;
+  default:
+    return XMLContainer::NONE;
+  }
+}
+
+namespace {
+
+enum class XMLTokenKind {
+  START,
+  END,
+  EMPTY,
+  OTHER
+};
+
+/// A markup token and any character data preceding it.
+struct XMLToken {
+  XMLTokenKind kind;
+  std::string data;
+  std::string markup;
+  std::string name;
+};
+
+/// Split an XML file into markup tokens, reading it in fixed-size chunks.
+class XMLTokenizer {
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+  std::istream &input;
+  std::string buffer;
+  size_t pos;
+
+  /// Discard consumed characters and read the next chunk of the file.
+  bool fill() {
+    buffer.erase(0, pos);
+    pos = 0;
+    auto size = buffer.size();
+    buffer.resize(size + CHUNK_SIZE);
+    input.read(&buffer[size], CHUNK_SIZE);
+    buffer.resize(size + input.gcount());
+    return input.gcount() > 0;
+  }
+
+  /// Return the character at an offset from the current position, reading
+  /// more of the file if required.
+  char peek(size_t offset) {
+    while (pos + offset >= buffer.size()) {
+      if (!fill()) {
+        throw XMLException("unexpected end of XML file");
+      }
+    }
+    return buffer[pos + offset];
+  }
+
+  /// Return the offset just past the first occurrence of a terminator.
+  size_t find(const char *terminator, size_t offset) {
+    auto length = std::strlen(terminator);
+    while (true) {
+      auto it = buffer.find(terminator, pos + offset);
+      if (it != std::string::npos) {
+        return it - pos + length;
+      }
+      // Keep a partial match across the chunk boundary.
+      offset = buffer.size() - pos >= length ? buffer.size() - pos - length + 1 : 0;
+      if (!fill()) {
+        throw XMLException("unexpected end of XML file");
+      }
+    }
+  }
+
+public:
+  XMLTokenizer(std::istream &input) : input(input), pos(0) {}
+
+  /// Read the next token, returning false at the end of the file.
+  bool next(XMLToken &token) {
+    token.data.clear();
+    // Character data.
+    while (true) {
+      auto it = buffer.find('<', pos);
+      if (it != std::string::npos) {
+        token.data.append(buffer, pos, it - pos);
+        pos = it;
+        break;
+      }
+      token.data.append(buffer, pos, std::string::npos);
+      pos = buffer.size();
+      if (!fill()) {
+        return false;
+      }
+    }
+    // Markup.
+    size_t length;
+    if (peek(1) == '?') {
+      // Processing instruction.
+      token.kind = XMLTokenKind::OTHER;
+      length = find("?>", 2);
+    } else if (peek(1) == '!') {
+      // Comment or declaration.
+      token.kind = XMLTokenKind::OTHER;
+      length = peek(2) == '-' && peek(3) == '-' ? find("-->", 4) : find(">", 2);
+    } else {
+      token.kind = peek(1) == '/' ? XMLTokenKind::END : XMLTokenKind::START;
+      // Find the end of the tag, skipping quoted attribute values.
+      char quote = '\0';
+      length = 1;
+      for (char c = peek(length); quote || c != '>'; c = peek(++length)) {
+        if (quote) {
+          quote = c == quote ? '\0' : quote;
+        } else if (c == '"' || c == '\'') {
+          quote = c;
+        }
+      }
+      length++;
+      if (token.kind == XMLTokenKind::START && buffer[pos + length - 2] == '/') {
+        token.kind = XMLTokenKind::EMPTY;
+      }
+    }
+    token.markup.assign(buffer, pos, length);
+    pos += length;
+    // Element name.
+    if (token.kind != XMLTokenKind::OTHER) {
+      auto start = token.kind == XMLTokenKind::END ? 2 : 1;
+      auto end = token.markup.find_first_of(" \t\r\n/>", start);
+      token.name.assign(token.markup, start, end - start);
+    }
+    return true;
+  }
+
+  /// Return the number of bytes held by the tokenizer.
+  size_t getMemory() const { return buffer.capacity(); }
+};
+
+/// Copy an element and its attributes, but not its children, into another
+/// document.
+XMLNode *copyElement(rapidxml::xml_document<> &doc, XMLNode *node) {
+  auto copy = doc.allocate_node(rapidxml::node_element,
+                                doc.allocate_string(node->name()));
+  for (auto attribute = node->first_attribute();
+       attribute; attribute = attribute->next_attribute()) {
+    copy->append_attribute(doc.allocate_attribute(doc.allocate_string(attribute->name()),
+                                                  doc.allocate_string(attribute->value())));
+  }
+  return copy;
+}
+
+} // End anonymous namespace.
+
+void ReadVerilatorXML::readXMLStream(const std::string &filename) {
+  BOOST_LOG_TRIVIAL(info) << "Streaming input XML file";
+  InputFile inputFile(filename);
+  if (!inputFile.isOpen()) {
+    throw XMLException("could not open file");
+  }
+  deferDTypeRefs = true;
+  XMLTokenizer tokenizer(inputFile.get());
+  // Open container elements, with their names for matching closing tags.
+  std::vector<std::pair<XMLContainer, std::string>> containers;
+  // Documents for the current subtree and for copies of the scope elements,
+  // which last as long as the scopes are open.
+  rapidxml::xml_document<> doc;
+  rapidxml::xml_document<> scopeDoc;
+  doc.set_allocator(xmlPoolAlloc, xmlPoolFree);
+  scopeDoc.set_allocator(xmlPoolAlloc, xmlPoolFree);
+  size_t moduleCount = 0;
+  size_t interfaceCount = 0;
+  size_t packageCount = 0;
+  bool seenRoot = false;
+  // A flat netlist is identified by the top scope of its module, as in the
+  // DOM reader, so the statements of the module that precede it are held
+  // until it is opened, or discarded when the module closes without one.
+  bool isFlat = false;
+  std::string moduleName;
+  std::vector<std::string> moduleStatements;
+  size_t moduleStatementBytes = 0;
+  XMLToken token;
+  XMLToken child;
+  std::string subtree;
+  auto closeContainer = [&]() {
+    switch (containers.back().first) {
+    case XMLContainer::TOP_SCOPE:
+    case XMLContainer::SCOPE:
+      currentScope = std::move(scopeParents.top());
+      scopeParents.pop();
+      break;
+    case XMLContainer::TYPE_TABLE:
+      resolvePendingDTypes();
+      BOOST_LOG_TRIVIAL(info) << boost::format("%d entries in type table") % dtypes.size();
+      break;
+    case XMLContainer::MODULE:
+      moduleStatements.clear();
+      moduleStatementBytes = 0;
+      break;
+    default:
+      break;
+    }
+    containers.pop_back();
+  };
+  while (tokenizer.next(token)) {
+    auto parent = containers.empty() ? XMLContainer::DOCUMENT
+                                     : containers.back().first;
+    if (token.kind == XMLTokenKind::OTHER) {
+      continue;
+    }
+    // Close a container.
+    if (token.kind == XMLTokenKind::END) {
+      if (containers.empty() || containers.back().second != token.name) {
+        throw XMLException(std::string("unexpected closing tag ")+token.name);
+      }
+      closeContainer();
+      continue;
+    }
+    // Open a container. Only the first module of a flat netlist is read.
+    auto container = resolveContainer(parent, token.name);
+    if (container == XMLContainer::MODULE && ++moduleCount > 1) {
+      container = XMLContainer::NONE;
+    }
+    if (container != XMLContainer::NONE) {
+      seenRoot = seenRoot || container == XMLContainer::VERILATOR_XML;
+      if (container == XMLContainer::TOP_SCOPE) {
+        if (moduleName != "TOP") {
+          throw XMLException("unexpected top module name");
+        }
+        isFlat = true;
+        for (auto &statement : moduleStatements) {
+          doc.clear();
+          doc.parse<0>(&statement[0]);
+          dispatchVisitor(doc.first_node());
+        }
+        moduleStatements.clear();
+        moduleStatementBytes = 0;
+      }
+      if (container == XMLContainer::MODULE ||
+          container == XMLContainer::TOP_SCOPE ||
+          container == XMLContainer::SCOPE) {
+        // Parse the start tag as an empty element to get its attributes.
+        subtree = token.markup;
+        if (token.kind == XMLTokenKind::START) {
+          subtree.insert(subtree.size() - 1, "/");
+        }
+        doc.clear();
+        doc.parse<0>(&subtree[0]);
+        auto node = doc.first_node();
+        if (container == XMLContainer::MODULE) {
+          moduleName = node->first_attribute("name")->value();
+        } else {
+          scopeParents.push(std::move(currentScope));
+          currentScope = std::make_unique<ScopeNode>(copyElement(scopeDoc, node));
+        }
+      }
+      containers.emplace_back(container, token.name);
+      if (token.kind == XMLTokenKind::EMPTY) {
+        closeContainer();
+      }
+      continue;
+    }
+    // Read the element as a complete subtree, only keeping the text of
+    // elements that are visited.
+    bool visit = false;
+    switch (parent) {
+    case XMLContainer::FILES:
+      visit = token.name == "file";
+      break;
+    case XMLContainer::MODULE:
+    case XMLContainer::TOP_SCOPE:
+    case XMLContainer::SCOPE:
+    case XMLContainer::TYPE_TABLE:
+      visit = true;
+      break;
+    case XMLContainer::NETLIST:
+      if (token.name == "iface")   { interfaceCount++; }
+      if (token.name == "package") { packageCount++; }
+      break;
+    default:
+      break;
+    }
+    subtree = token.markup;
+    if (token.kind == XMLTokenKind::START) {
+      size_t depth = 1;
+      while (depth > 0) {
+        if (!tokenizer.next(child)) {
+          throw XMLException("unexpected end of XML file");
+        }
+        if (child.kind == XMLTokenKind::START) { depth++; }
+        if (child.kind == XMLTokenKind::END)   { depth--; }
+        if (visit) {
+          subtree += child.data;
+          subtree += child.markup;
+        }
+      }
+    }
+    if (visit && parent == XMLContainer::MODULE && !isFlat &&
+        (token.name != "var" || !moduleStatements.empty())) {
+      // Variables do not need a scope and are read straight away, unless
+      // they follow a statement that is held.
+      moduleStatementBytes += subtree.capacity();
+      moduleStatements.push_back(std::move(subtree));
+      updatePeakMemory(tokenizer.getMemory() + moduleStatementBytes +
+                       sizeof(doc) + sizeof(scopeDoc) + xmlPoolBytes);
+      continue;
+    }
+    if (visit) {
+      // Clearing the document releases the memory of the previous subtree.
+      doc.clear();
+      doc.parse<0>(&subtree[0]);
+      updatePeakMemory(tokenizer.getMemory() + subtree.capacity() +
+                       sizeof(doc) + sizeof(scopeDoc) + xmlPoolBytes);
+      if (parent == XMLContainer::FILES) {
+        newFile(doc.first_node());
+      } else {
+        dispatchVisitor(doc.first_node());
+      }
+    }
+  }
+  if (!seenRoot) {
+    throw XMLException("no verilator_xml element");
+  }
+  if (!containers.empty()) {
+    throw XMLException("unexpected end of XML file");
+  }
+  // Any remaining variable dtypes refer to a typetable that was not present.
+  resolvePendingDTypes();
+  BOOST_LOG_TRIVIAL(info) << moduleCount    << " modules in netlist";
+  BOOST_LOG_TRIVIAL(info) << interfaceCount << " interfaces in netlist";
+  BOOST_LOG_TRIVIAL(info) << packageCount   << " packages in netlist";
+  if (isFlat && moduleCount == 1 && interfaceCount == 0) {
+    BOOST_LOG_TRIVIAL(info) << boost::format("Netlist contains %d vertices and %d edges")
+                                 % netlist.numVertices() % netlist.numEdges();
+  } else {
+    // Whether the netlist is flat is only known at the end of the file, so
+    // discard any part of it that has been read.
+    BOOST_LOG_TRIVIAL(info) << "Netlist is not flat, skipping modules";
+    netlist.clear();
+    vars.clear();
+  }
+  BOOST_LOG_TRIVIAL(info) << boost::format("Peak parser memory %d bytes") % peakMemory;
 }
 
 ReadVerilatorXML::ReadVerilatorXML(Graph &netlist,
@@ -651,6 +1212,13 @@ ReadVerilatorXML::ReadVerilatorXML(Graph &netlist,
     currentLogic(nullptr),
     currentScope(nullptr),
     isDelayedAssign(false),
-    isLValue(false) {
-  readXML(filename);
+    isLValue(false),
+    deferDTypeRefs(false),
+    peakMemory(0) {
+  ScopedTimer timer(netlist.getStats(), StatsPhase::READ_XML);
+  if (Options::getInstance().shouldStreamXML()) {
+    readXMLStream(filename);
+  } else {
+    readXML(filename);
+  }
 }
@@ -2,14 +2,18 @@
 #define NETLIST_PATHS_READ_VERILATOR_XML_HPP
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <stack>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <boost/algorithm/string/predicate.hpp>
 #include <rapidxml-1.13/rapidxml.hpp>
 
 #include "netlist_paths/Graph.hpp"
+#include "netlist_paths/StringPool.hpp"
 
 namespace netlist_paths {
 
@@ -49,9 +53,17 @@ private:
   Graph &netlist;
   std::vector<File> &files;
   std::vector<std::shared_ptr<DType>> &dtypes;
-  std::map<std::string, VertexID> vars;
-  std::map<std::string, std::shared_ptr<File>> fileIdMappings;
-  std::map<std::string, std::shared_ptr<DType>> dtypeMappings;
+  // The symbol tables are keyed by views of strings held in the key pool, so
+  // they can be looked up with views of the XML text without copying it.
+  StringPool keys;
+  std::unordered_map<std::string_view, VertexID> vars;
+  std::unordered_map<std::string_view, uint32_t> fileIdMappings;
+  std::unordered_map<std::string_view, std::shared_ptr<DType>> dtypeMappings;
+  // The indexes in the DTypeTable of the graph of the dtypes, once the
+  // typetable is read.
+  std::unordered_map<std::string_view, uint32_t> dtypeIndexes;
+  // A buffer for building prefixed names to look up.
+  std::string nameBuffer;
   std::stack<std::unique_ptr<LogicNode>> logicParents;
   std::stack<std::unique_ptr<ScopeNode>> scopeParents;
   std::unique_ptr<LogicNode> currentLogic;
@@ -59,22 +71,45 @@ private:
   std::string topName;
   bool isDelayedAssign;
   bool isLValue;
+  // Forward references to dtypes that are resolved once the whole typetable
+  // has been read, when streaming the XML file.
+  bool deferDTypeRefs;
+  std::vector<std::function<void()>> pendingDTypeRefs;
+  std::vector<std::pair<VertexID, std::string>> pendingVarDTypes;
+  size_t peakMemory;
 
-  std::shared_ptr<File> addFile(File file) {
+  uint32_t addFile(File file) {
     files.push_back(file);
-    return std::make_shared<File>(files.back());
+    return netlist.addFile(files.back());
   }
   void addDtype(std::shared_ptr<DType> dtype) {
     dtypes.push_back(dtype);
   }
+  void updatePeakMemory(size_t bytes) {
+    peakMemory = std::max(peakMemory, bytes);
+  }
   std::size_t numChildren(XMLNode *node);
   void dispatchVisitor(XMLNode *node);
   void iterateChildren(XMLNode *node);
-  Location parseLocation(const std::string location);
+  Location parseLocation(std::string_view location);
   std::string addTopPrefix(std::string name);
   std::string removeTopPrefix(std::string name);
-  VertexID lookupVarVertexExact(const std::string &name);
-  VertexID lookupVarVertex(const std::string &name);
+  std::string_view prefixName(const std::string &prefix, std::string_view name);
+  void addVar(std::string_view name, VertexID vertex);
+  VertexID lookupVarVertexExact(std::string_view name);
+  VertexID lookupVarVertex(std::string_view name);
+  void addDTypeMapping(std::string_view id, std::shared_ptr<DType> dtype);
+  std::shared_ptr<DType> lookupDType(std::string_view id);
+  uint32_t lookupDTypeIndex(std::string_view id);
+  template<typename T> void resolveSubDType(std::string_view id,
+                                            std::string_view subDTypeId,
+                                            const char *kind);
+  MemberDType newMemberDType(const std::string &name,
+                             Location location,
+                             std::string_view subDTypeId);
+  void finalizeDTypes();
+  void resolvePendingDTypes();
+  void newFile(XMLNode *node);
   void newVar(XMLNode *node);
   void newScope(XMLNode *node);
   void newVarScope(XMLNode *node);
@@ -109,6 +144,7 @@ private:
   EnumItem visitEnumItem(XMLNode *node);
   void visitEnumDType(XMLNode *node);
   void readXML(const std::string &filename);
+  void readXMLStream(const std::string &filename);
 
 public:
   ReadVerilatorXML() = delete;
@@ -116,6 +152,10 @@ public:
                    std::vector<File> &files,
                    std::vector<std::shared_ptr<DType>> &dtypes,
                    const std::string &filename);
+
+  /// Return the peak number of bytes used by the parser to hold the XML text
+  /// and its document trees.
+  size_t getPeakMemory() const { return peakMemory; }
 };
 
 } // End netlist_paths namespace.
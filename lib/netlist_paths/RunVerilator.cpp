@@ -6,6 +6,10 @@
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/process.hpp>
+#include "netlist_paths/CompileCache.hpp"
+#include "netlist_paths/Compression.hpp"
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/Netlist.hpp"
 #include "netlist_paths/RunVerilator.hpp"
 #include "netlist_paths/Options.hpp"
 
@@ -26,23 +30,44 @@ RunVerilator::RunVerilator(const std::string &binLocation) {
   verilatorExe = fs::path(binLocation) / fs::path("np-verilator_bin");
 }
 
-int RunVerilator::run(const std::vector<std::string> &includes,
-                      const std::vector<std::string> &defines,
-                      const std::vector<std::string> &inputFiles,
-                      const std::string &outputFile) const {
+std::vector<std::string>
+RunVerilator::getArgs(const std::vector<std::string> &includes,
+                      const std::vector<std::string> &defines) const {
   std::vector<std::string> args{"+1800-2012ext+.sv",
                                 "--bbox-sys",
                                 "--bbox-unsup",
                                 "--xml-only",
                                 "--flatten",
-                                "--error-limit", "10000",
-                                "--xml-output", outputFile};
+                                "--error-limit", "10000"};
   for (auto &path : includes) {
     args.push_back(std::string("+incdir+")+path);
   }
   for (auto &define : defines) {
     args.push_back(std::string("-D")+define);
   }
+  return args;
+}
+
+const std::string &RunVerilator::getVerilatorVersion() const {
+  if (verilatorVersion.empty()) {
+    bp::ipstream output;
+    bp::child child(verilatorExe, "--version", bp::std_out > output);
+    std::getline(output, verilatorVersion);
+    child.wait();
+  }
+  return verilatorVersion;
+}
+
+std::string RunVerilator::getCacheKey(const std::vector<std::string> &args,
+                                      const std::vector<std::string> &inputFiles) const {
+  return CompileCache::getKey(getVerilatorVersion(), args, inputFiles);
+}
+
+int RunVerilator::runVerilator(std::vector<std::string> args,
+                               const std::vector<std::string> &inputFiles,
+                               const std::string &outputFile) const {
+  args.push_back("--xml-output");
+  args.push_back(outputFile);
   for (auto &path : inputFiles) {
     args.push_back(path);
   }
@@ -54,8 +79,110 @@ int RunVerilator::run(const std::vector<std::string> &includes,
   return bp::system(verilatorExe, bp::args(args));
 }
 
+int RunVerilator::writeXML(const std::vector<std::string> &includes,
+                           const std::vector<std::string> &defines,
+                           const std::vector<std::string> &inputFiles,
+                           const std::string &outputFile) const {
+  auto args = getArgs(includes, defines);
+  auto &options = Options::getInstance();
+  if (!options.shouldUseCompileCache()) {
+    return runVerilator(args, inputFiles, outputFile);
+  }
+  CompileCache cache(options.getCompileCacheDirectory(),
+                     options.getCompileCacheMaxBytes());
+  auto key = getCacheKey(args, inputFiles);
+  auto cachedXML = cache.findXML(key);
+  if (!cachedXML.empty()) {
+    BOOST_LOG_TRIVIAL(info) << boost::format("Using cached compilation %s") % key;
+    fs::remove(outputFile);
+    fs::copy_file(cachedXML, outputFile);
+    return 0;
+  }
+  auto status = runVerilator(args, inputFiles, outputFile);
+  if (status == 0) {
+    cache.insertXML(key, outputFile);
+    cache.evict();
+  }
+  return status;
+}
+
+int RunVerilator::run(const std::vector<std::string> &includes,
+                      const std::vector<std::string> &defines,
+                      const std::vector<std::string> &inputFiles,
+                      const std::string &outputFile) const {
+  auto compression = getCompressionForFilename(outputFile);
+  if (compression == Compression::NONE) {
+    return writeXML(includes, defines, inputFiles, outputFile);
+  }
+  if (!isCompressionSupported(compression)) {
+    throw Exception("zstd compression is not supported by this build");
+  }
+  // Write the plain XML, which is also what the compile cache holds, and
+  // then compress it into the output file.
+  auto xmlTemp = fs::temp_directory_path() / fs::unique_path("netlist-%%%%-%%%%-%%%%.xml");
+  auto status = writeXML(includes, defines, inputFiles, xmlTemp.string());
+  if (status == 0) {
+    BOOST_LOG_TRIVIAL(info) << "Compressing output XML file";
+    try {
+      compressFile(xmlTemp.string(), outputFile, compression);
+    } catch (const Exception &) {
+      fs::remove(xmlTemp);
+      throw;
+    }
+  }
+  fs::remove(xmlTemp);
+  return status;
+}
+
 /// A specialistion of run used for testing.
 int RunVerilator::run(const std::string& inputFile, const std::string& outputFile) const {
   auto inputFiles = {inputFile};
   return run({}, {}, inputFiles, outputFile);
 }
+
+std::unique_ptr<Netlist>
+RunVerilator::compile(const std::vector<std::string> &includes,
+                      const std::vector<std::string> &defines,
+                      const std::vector<std::string> &inputFiles) const {
+  auto &options = Options::getInstance();
+  std::string key;
+  if (options.shouldUseCompileCache()) {
+    CompileCache cache(options.getCompileCacheDirectory(),
+                       options.getCompileCacheMaxBytes());
+    key = getCacheKey(getArgs(includes, defines), inputFiles);
+    auto cachedSnapshot = cache.findSnapshot(key);
+    if (!cachedSnapshot.empty()) {
+      try {
+        BOOST_LOG_TRIVIAL(info) << boost::format("Using cached netlist %s") % key;
+        return std::make_unique<Netlist>(cachedSnapshot.string());
+      } catch (const Exception &e) {
+        // Fall back to the XML, which replaces the snapshot.
+        BOOST_LOG_TRIVIAL(info) << "Cached netlist " << key << " is unreadable: " << e.what();
+      }
+    }
+  }
+  auto outTemp = fs::temp_directory_path() / fs::unique_path("netlist-%%%%-%%%%-%%%%.xml");
+  auto status = run(includes, defines, inputFiles, outTemp.string());
+  if (status != 0) {
+    fs::remove(outTemp);
+    throw Exception(std::string("Verilator failed with status ")+std::to_string(status));
+  }
+  auto netlist = std::make_unique<Netlist>(outTemp.string());
+  fs::remove(outTemp);
+  if (!key.empty()) {
+    CompileCache cache(options.getCompileCacheDirectory(),
+                       options.getCompileCacheMaxBytes());
+    if (!cache.findXML(key).empty()) {
+      auto snapshotTemp = fs::temp_directory_path() / fs::unique_path("netlist-%%%%-%%%%-%%%%.snapshot");
+      netlist->writeSnapshot(snapshotTemp.string());
+      cache.insertSnapshot(key, snapshotTemp.string());
+      fs::remove(snapshotTemp);
+      cache.evict();
+    }
+  }
+  return netlist;
+}
+
+std::unique_ptr<Netlist> RunVerilator::compile(const std::string &inputFile) const {
+  return compile({}, {}, {inputFile});
+}
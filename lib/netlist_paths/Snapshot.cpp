@@ -0,0 +1,585 @@
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/graph/iteration_macros.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/log/trivial.hpp>
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/Snapshot.hpp"
+
+using namespace netlist_paths;
+
+namespace bip = boost::interprocess;
+
+constexpr int32_t NO_INDEX = -1;
+
+enum VertexFlags : uint8_t {
+  VERTEX_FLAG_PARAM   = 1 << 0,
+  VERTEX_FLAG_PUBLIC  = 1 << 1,
+  VERTEX_FLAG_DELETED = 1 << 2,
+};
+
+//===----------------------------------------------------------------------===//
+// Writing.
+//===----------------------------------------------------------------------===//
+
+void WriteSnapshot::writeU8(uint8_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteSnapshot::writeU32(uint32_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteSnapshot::writeI32(int32_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteSnapshot::writeU64(uint64_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteSnapshot::writeString(std::string_view value) {
+  writeU32(static_cast<uint32_t>(value.size()));
+  out.write(value.data(), value.size());
+}
+
+/// Write the elements of a vector, which must be trivially copyable, as a
+/// count followed by their bytes.
+template<typename T>
+void WriteSnapshot::writeArray(const std::vector<T> &values) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "array elements must be trivially copyable");
+  writeU64(values.size());
+  out.write(reinterpret_cast<const char*>(values.data()),
+            values.size() * sizeof(T));
+}
+
+void WriteSnapshot::writeLocation(const Location &location) {
+  auto it = locationFileIndexes.find(location.getFileIndex());
+  writeI32(it != locationFileIndexes.end() ? it->second : NO_INDEX);
+  writeU32(location.getStartLine());
+  writeU32(location.getStartCol());
+  writeU32(location.getEndLine());
+  writeU32(location.getEndCol());
+}
+
+void WriteSnapshot::writeDTypeRef(const std::shared_ptr<DType> &dtype) {
+  auto it = dtypeIndexes.find(dtype.get());
+  writeI32(it != dtypeIndexes.end() ? it->second : NO_INDEX);
+}
+
+void WriteSnapshot::writeDTypeRef(uint32_t dtypeTableIndex) {
+  auto it = dtypeTableIndexes.find(dtypeTableIndex);
+  writeI32(it != dtypeTableIndexes.end() ? it->second : NO_INDEX);
+}
+
+void WriteSnapshot::writeDType(const DType &dtype) {
+  if (auto basic = dynamic_cast<const BasicDType*>(&dtype)) {
+    writeU8(static_cast<uint8_t>(SnapshotDTypeKind::BASIC));
+    writeString(dtype.getName());
+    writeLocation(dtype.getLocation());
+    writeU32(basic->getLeft());
+    writeU32(basic->getRight());
+    writeU8(basic->isRanged());
+  } else if (auto ref = dynamic_cast<const RefDType*>(&dtype)) {
+    writeU8(static_cast<uint8_t>(SnapshotDTypeKind::REF));
+    writeString(dtype.getName());
+    writeLocation(dtype.getLocation());
+    writeDTypeRef(ref->getSubDType());
+  } else if (auto array = dynamic_cast<const ArrayDType*>(&dtype)) {
+    writeU8(static_cast<uint8_t>(SnapshotDTypeKind::ARRAY));
+    writeString(dtype.getName());
+    writeLocation(dtype.getLocation());
+    writeDTypeRef(array->getSubDType());
+    writeU64(array->getStart());
+    writeU64(array->getEnd());
+    writeU8(array->isPacked());
+  } else if (dynamic_cast<const StructDType*>(&dtype) ||
+             dynamic_cast<const UnionDType*>(&dtype)) {
+    auto structDType = dynamic_cast<const StructDType*>(&dtype);
+    auto unionDType = dynamic_cast<const UnionDType*>(&dtype);
+    auto &members = structDType ? structDType->getMembers() : unionDType->getMembers();
+    writeU8(static_cast<uint8_t>(structDType ? SnapshotDTypeKind::STRUCT
+                                             : SnapshotDTypeKind::UNION));
+    writeString(dtype.getName());
+    writeLocation(dtype.getLocation());
+    writeU32(static_cast<uint32_t>(members.size()));
+    for (auto &member : members) {
+      writeString(member.getName());
+      writeLocation(member.getLocation());
+      writeDTypeRef(member.getSubDType());
+    }
+  } else if (auto enumDType = dynamic_cast<const EnumDType*>(&dtype)) {
+    writeU8(static_cast<uint8_t>(SnapshotDTypeKind::ENUM));
+    writeString(dtype.getName());
+    writeLocation(dtype.getLocation());
+    writeDTypeRef(enumDType->getSubDType());
+    writeU32(static_cast<uint32_t>(enumDType->getItems().size()));
+    for (auto &item : enumDType->getItems()) {
+      writeString(item.getName());
+      writeU64(item.getValue());
+    }
+  } else {
+    throw Exception("unsupported dtype in snapshot");
+  }
+}
+
+void WriteSnapshot::collectLocationFile(const Location &location,
+                                        std::vector<uint32_t> &locationFiles) {
+  auto file = location.getFileIndex();
+  if (file != FileTable::NO_FILE && locationFileIndexes.count(file) == 0) {
+    locationFileIndexes[file] = static_cast<int32_t>(locationFiles.size());
+    locationFiles.push_back(file);
+  }
+}
+
+void WriteSnapshot::writeReachabilityIndex(const ReachabilityIndex &index) {
+  auto &components = *index.componentGraph;
+  writeArray(components.components);
+  writeArray(components.outOffsets);
+  writeArray(components.outComponents);
+  writeArray(components.inOffsets);
+  writeArray(components.inComponents);
+  writeArray(index.labels);
+}
+
+WriteSnapshot::WriteSnapshot(const Graph &netlist,
+                             const std::vector<File> &files,
+                             const std::vector<std::shared_ptr<DType>> &dtypes,
+                             const std::string &filename) :
+    out(filename, std::ios::binary) {
+  BOOST_LOG_TRIVIAL(info) << "Writing snapshot " << filename;
+  if (!out.is_open()) {
+    throw Exception(std::string("unable to open ")+filename);
+  }
+  const InternalGraph &graph = netlist.graph;
+  // Locations refer to files in the FileTable of the graph, so collect the
+  // distinct ones.
+  std::vector<uint32_t> locationFiles;
+  for (auto &dtype : dtypes) {
+    collectLocationFile(dtype->getLocation(), locationFiles);
+  }
+  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
+    collectLocationFile(graph[v].getLocation(), locationFiles);
+  }
+  for (size_t i = 0; i < dtypes.size(); ++i) {
+    dtypeIndexes[dtypes[i].get()] = static_cast<int32_t>(i);
+  }
+  // Vertices refer to dtypes by their indexes in the DTypeTable of the graph,
+  // each entry of which is the first of the equivalent dtypes.
+  auto &table = netlist.getDTypeTable();
+  for (uint32_t i = 0; i < table.size(); ++i) {
+    auto it = dtypeIndexes.find(table.get(i).getDType().get());
+    if (it != dtypeIndexes.end()) {
+      dtypeTableIndexes.emplace(i, it->second);
+    }
+  }
+  // Header.
+  out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  writeU32(SNAPSHOT_VERSION);
+  // Files.
+  writeU32(static_cast<uint32_t>(files.size()));
+  for (auto &file : files) {
+    writeString(file.getFilename());
+    writeString(file.getLanguage());
+  }
+  writeU32(static_cast<uint32_t>(locationFiles.size()));
+  for (auto fileIndex : locationFiles) {
+    auto &file = netlist.tables.files.getFile(fileIndex);
+    writeString(file.getFilename());
+    writeString(file.getLanguage());
+  }
+  // Data types.
+  writeU32(static_cast<uint32_t>(dtypes.size()));
+  for (auto &dtype : dtypes) {
+    writeDType(*dtype);
+  }
+  // Vertices.
+  writeU64(boost::num_vertices(graph));
+  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
+    auto &vertex = graph[v];
+    writeU8(static_cast<uint8_t>(vertex.getAstType()));
+    writeU8(static_cast<uint8_t>(vertex.getDirection()));
+    writeU8((vertex.isParameter() ? VERTEX_FLAG_PARAM : 0) |
+            (vertex.isPublic() ? VERTEX_FLAG_PUBLIC : 0) |
+            (vertex.isDeleted() ? VERTEX_FLAG_DELETED : 0));
+    writeLocation(vertex.getLocation());
+    writeDTypeRef(vertex.getDType());
+    writeString(vertex.getName());
+    writeString(vertex.getParamValue());
+  }
+  // Edges, in the order of the graph's edge list. Since edges are appended
+  // to the edge list and to the in and out edge lists of their end points,
+  // re-adding them in this order reproduces the edge lists of every vertex
+  // and hence the results of traversals.
+  writeU64(boost::num_edges(graph));
+  BGL_FORALL_EDGES(e, graph, InternalGraph) {
+    writeU64(boost::source(e, graph));
+    writeU64(boost::target(e, graph));
+    writeU8(graph[e].isThroughRegister());
+  }
+  // Register alias mappings.
+  writeU32(static_cast<uint32_t>(netlist.aliasMap.size()));
+  for (auto &alias : netlist.aliasMap) {
+    writeString(alias.first);
+    writeU64(alias.second);
+  }
+  // Reachability indexes, for each setting of traverse registers.
+  for (auto &index : netlist.reachabilityIndexes) {
+    writeU8(index.isBuilt());
+    if (index.isBuilt()) {
+      writeReachabilityIndex(index);
+    }
+  }
+  if (!out) {
+    throw Exception(std::string("error writing snapshot ")+filename);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Reading.
+//===----------------------------------------------------------------------===//
+
+void ReadSnapshot::check(size_t bytes) const {
+  if (static_cast<size_t>(end - cursor) < bytes) {
+    throw Exception("truncated snapshot");
+  }
+}
+
+uint8_t ReadSnapshot::readU8() {
+  check(sizeof(uint8_t));
+  return static_cast<uint8_t>(*cursor++);
+}
+
+uint32_t ReadSnapshot::readU32() {
+  uint32_t value;
+  check(sizeof(value));
+  std::memcpy(&value, cursor, sizeof(value));
+  cursor += sizeof(value);
+  return value;
+}
+
+int32_t ReadSnapshot::readI32() {
+  int32_t value;
+  check(sizeof(value));
+  std::memcpy(&value, cursor, sizeof(value));
+  cursor += sizeof(value);
+  return value;
+}
+
+uint64_t ReadSnapshot::readU64() {
+  uint64_t value;
+  check(sizeof(value));
+  std::memcpy(&value, cursor, sizeof(value));
+  cursor += sizeof(value);
+  return value;
+}
+
+std::string ReadSnapshot::readString() {
+  auto size = readU32();
+  check(size);
+  std::string value(cursor, size);
+  cursor += size;
+  return value;
+}
+
+template<typename T>
+void ReadSnapshot::readArray(std::vector<T> &values) {
+  auto size = readU64();
+  if (size > static_cast<size_t>(end - cursor) / sizeof(T)) {
+    throw Exception("truncated snapshot");
+  }
+  values.resize(size);
+  std::memcpy(values.data(), cursor, size * sizeof(T));
+  cursor += size * sizeof(T);
+}
+
+Location ReadSnapshot::readLocation() {
+  auto fileIndex = readI32();
+  auto startLine = readU32();
+  auto startCol = readU32();
+  auto endLine = readU32();
+  auto endCol = readU32();
+  auto file = FileTable::NO_FILE;
+  if (fileIndex != NO_INDEX) {
+    if (fileIndex < 0 || static_cast<size_t>(fileIndex) >= locationFiles.size()) {
+      throw Exception("invalid file index in snapshot");
+    }
+    file = locationFiles[fileIndex];
+  }
+  return Location(file, startLine, startCol, endLine, endCol);
+}
+
+uint32_t ReadSnapshot::readDTypeRef() {
+  auto index = readI32();
+  if (index == NO_INDEX) {
+    return DTypeTable::NO_DTYPE;
+  }
+  if (index < 0 || static_cast<size_t>(index) >= dtypeTableIndexes.size()) {
+    throw Exception("invalid dtype index in snapshot");
+  }
+  return dtypeTableIndexes[index];
+}
+
+void ReadSnapshot::readDTypes(Graph &netlist,
+                              std::vector<std::shared_ptr<DType>> &dtypes) {
+  // Sub dtypes can refer forwards, so create all the dtypes before resolving
+  // the references between them.
+  struct PendingMember {
+    std::string name;
+    Location location;
+    int32_t subDType;
+  };
+  struct PendingDType {
+    SnapshotDTypeKind kind;
+    int32_t subDType;
+    std::vector<PendingMember> members;
+  };
+  auto count = readU32();
+  std::vector<PendingDType> pending(count);
+  dtypes.reserve(dtypes.size() + count);
+  auto base = dtypes.size();
+  for (auto &entry : pending) {
+    entry.kind = static_cast<SnapshotDTypeKind>(readU8());
+    entry.subDType = NO_INDEX;
+    auto name = readString();
+    auto location = readLocation();
+    switch (entry.kind) {
+    case SnapshotDTypeKind::BASIC: {
+      auto left = readU32();
+      auto right = readU32();
+      auto ranged = readU8();
+      dtypes.push_back(ranged ? std::make_shared<BasicDType>(name, location, left, right)
+                              : std::make_shared<BasicDType>(name, location));
+      break;
+    }
+    case SnapshotDTypeKind::REF:
+      entry.subDType = readI32();
+      dtypes.push_back(std::make_shared<RefDType>(name, location));
+      break;
+    case SnapshotDTypeKind::ARRAY: {
+      entry.subDType = readI32();
+      auto start = readU64();
+      auto end = readU64();
+      auto packed = readU8();
+      dtypes.push_back(std::make_shared<ArrayDType>(location, start, end, packed));
+      break;
+    }
+    case SnapshotDTypeKind::STRUCT:
+    case SnapshotDTypeKind::UNION: {
+      auto numMembers = readU32();
+      for (uint32_t i = 0; i < numMembers; ++i) {
+        auto memberName = readString();
+        auto memberLocation = readLocation();
+        entry.members.push_back({memberName, memberLocation, readI32()});
+      }
+      if (entry.kind == SnapshotDTypeKind::STRUCT) {
+        dtypes.push_back(std::make_shared<StructDType>(name, location));
+      } else {
+        dtypes.push_back(std::make_shared<UnionDType>(name, location));
+      }
+      break;
+    }
+    case SnapshotDTypeKind::ENUM: {
+      entry.subDType = readI32();
+      auto dtype = std::make_shared<EnumDType>(name, location);
+      auto numItems = readU32();
+      for (uint32_t i = 0; i < numItems; ++i) {
+        auto itemName = readString();
+        dtype->addItem(EnumItem(itemName, readU64()));
+      }
+      dtypes.push_back(dtype);
+      break;
+    }
+    default:
+      throw Exception("invalid dtype kind in snapshot");
+    }
+  }
+  // Resolve sub dtype references.
+  auto lookup = [&](int32_t index) {
+    if (index == NO_INDEX) {
+      return std::shared_ptr<DType>();
+    }
+    if (index < 0 || static_cast<size_t>(index) >= count) {
+      throw Exception("invalid dtype index in snapshot");
+    }
+    return dtypes[base + index];
+  };
+  for (size_t i = 0; i < pending.size(); ++i) {
+    auto &dtype = dtypes[base + i];
+    auto &entry = pending[i];
+    switch (entry.kind) {
+    case SnapshotDTypeKind::REF:
+      dynamic_cast<RefDType*>(dtype.get())->setSubDType(lookup(entry.subDType));
+      break;
+    case SnapshotDTypeKind::ARRAY:
+      dynamic_cast<ArrayDType*>(dtype.get())->setSubDType(lookup(entry.subDType));
+      break;
+    case SnapshotDTypeKind::ENUM:
+      dynamic_cast<EnumDType*>(dtype.get())->setSubDType(lookup(entry.subDType));
+      break;
+    case SnapshotDTypeKind::STRUCT:
+      for (auto &member : entry.members) {
+        dynamic_cast<StructDType*>(dtype.get())->addMemberDType(
+            MemberDType(member.name, member.location, lookup(member.subDType)));
+      }
+      break;
+    case SnapshotDTypeKind::UNION:
+      for (auto &member : entry.members) {
+        dynamic_cast<UnionDType*>(dtype.get())->addMemberDType(
+            MemberDType(member.name, member.location, lookup(member.subDType)));
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  // Vertices refer to the dtypes by their indexes in the DTypeTable.
+  for (size_t i = base; i < dtypes.size(); ++i) {
+    dtypeTableIndexes.push_back(netlist.addDType(dtypes[i]));
+  }
+}
+
+void ReadSnapshot::readGraph(Graph &netlist) {
+  InternalGraph &graph = netlist.graph;
+  // Vertices.
+  auto numVertices = readU64();
+  for (uint64_t i = 0; i < numVertices; ++i) {
+    auto astType = static_cast<VertexAstType>(readU8());
+    auto direction = static_cast<VertexDirection>(readU8());
+    auto flags = readU8();
+    auto location = readLocation();
+    auto dtype = readDTypeRef();
+    auto name = netlist.names.intern(readString());
+    auto paramValue = netlist.names.intern(readString());
+    // Only variable vertices are named.
+    auto vertex = name.empty()
+                    ? Vertex(astType, location)
+                    : Vertex(astType, direction, location, dtype, name,
+                             flags & VERTEX_FLAG_PARAM, paramValue,
+                             flags & VERTEX_FLAG_PUBLIC);
+    if (flags & VERTEX_FLAG_DELETED) {
+      vertex.setDeleted();
+    }
+    vertex.setTables(&netlist.tables);
+    boost::add_vertex(vertex, graph);
+  }
+  // Edges.
+  auto numEdges = readU64();
+  for (uint64_t i = 0; i < numEdges; ++i) {
+    auto src = readU64();
+    auto dst = readU64();
+    auto throughRegister = readU8();
+    if (src >= numVertices || dst >= numVertices) {
+      throw Exception("invalid edge in snapshot");
+    }
+    boost::add_edge(src, dst, Edge(throughRegister), graph);
+  }
+  // Register alias mappings.
+  auto numAliases = readU32();
+  for (uint32_t i = 0; i < numAliases; ++i) {
+    auto name = netlist.names.intern(readString());
+    netlist.aliasMap[name] = readU64();
+  }
+  // Reachability indexes.
+  for (auto traverseRegisters : {false, true}) {
+    if (readU8()) {
+      readReachabilityIndex(netlist.reachabilityIndexes[traverseRegisters],
+                            numVertices, traverseRegisters);
+    }
+  }
+}
+
+/// Return true if the offsets of an adjacency are consistent with its
+/// entries, which are all component numbers.
+static bool isValidAdjacency(const std::vector<size_t> &offsets,
+                             const std::vector<ReachabilityIndex::Index> &entries,
+                             size_t numComponents) {
+  if (offsets.size() != numComponents + 1 || offsets.front() != 0 ||
+      offsets.back() != entries.size() ||
+      !std::is_sorted(offsets.begin(), offsets.end())) {
+    return false;
+  }
+  return std::all_of(entries.begin(), entries.end(),
+                     [numComponents](ReachabilityIndex::Index c) {
+                       return c < numComponents; });
+}
+
+void ReadSnapshot::readReachabilityIndex(ReachabilityIndex &index,
+                                         size_t numVertices,
+                                         bool traverseRegisters) {
+  auto components = std::make_shared<ComponentGraph>();
+  readArray(components->components);
+  readArray(components->outOffsets);
+  readArray(components->outComponents);
+  readArray(components->inOffsets);
+  readArray(components->inComponents);
+  readArray(index.labels);
+  auto numComponents = index.labels.size();
+  if (components->components.size() != numVertices ||
+      !std::all_of(components->components.begin(), components->components.end(),
+                   [numComponents](ReachabilityIndex::Index c) {
+                     return c < numComponents; }) ||
+      !isValidAdjacency(components->outOffsets, components->outComponents, numComponents) ||
+      !isValidAdjacency(components->inOffsets, components->inComponents, numComponents)) {
+    throw Exception("invalid reachability index in snapshot");
+  }
+  components->componentCount = numComponents;
+  components->traverseRegisters = traverseRegisters;
+  components->buildMembers();
+  index.componentGraph = std::move(components);
+}
+
+ReadSnapshot::ReadSnapshot(Graph &netlist,
+                           std::vector<File> &files,
+                           std::vector<std::shared_ptr<DType>> &dtypes,
+                           const std::string &filename) {
+  BOOST_LOG_TRIVIAL(info) << "Reading snapshot " << filename;
+  if (boost::filesystem::file_size(filename) < sizeof(SNAPSHOT_MAGIC)) {
+    throw Exception("truncated snapshot");
+  }
+  bip::file_mapping mapping(filename.c_str(), bip::read_only);
+  bip::mapped_region region(mapping, bip::read_only);
+  cursor = static_cast<const char*>(region.get_address());
+  end = cursor + region.get_size();
+  // Header.
+  if (std::memcmp(cursor, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+    throw Exception("not a netlist snapshot");
+  }
+  cursor += sizeof(SNAPSHOT_MAGIC);
+  auto version = readU32();
+  if (version != SNAPSHOT_VERSION) {
+    throw Exception((boost::format("unsupported snapshot version %d (expected %d)")
+                       % version % SNAPSHOT_VERSION).str());
+  }
+  // Files.
+  auto numFiles = readU32();
+  for (uint32_t i = 0; i < numFiles; ++i) {
+    auto name = readString();
+    auto language = readString();
+    files.push_back(File(name, language));
+  }
+  auto numLocationFiles = readU32();
+  for (uint32_t i = 0; i < numLocationFiles; ++i) {
+    auto name = readString();
+    auto language = readString();
+    locationFiles.push_back(netlist.addFile(File(name, language)));
+  }
+  readDTypes(netlist, dtypes);
+  readGraph(netlist);
+  BOOST_LOG_TRIVIAL(info) << boost::format("Snapshot contains %d vertices and %d edges")
+                               % netlist.numVertices() % netlist.numEdges();
+}
+
+bool ReadSnapshot::isSnapshot(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  if (!file.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
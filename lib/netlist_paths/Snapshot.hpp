@@ -0,0 +1,110 @@
+#ifndef NETLIST_PATHS_SNAPSHOT_HPP
+#define NETLIST_PATHS_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "netlist_paths/DTypes.hpp"
+#include "netlist_paths/Graph.hpp"
+#include "netlist_paths/Location.hpp"
+#include "netlist_paths/ReachabilityIndex.hpp"
+
+namespace netlist_paths {
+
+/// Magic bytes identifying a netlist snapshot file.
+constexpr const char SNAPSHOT_MAGIC[8] = {'N', 'P', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+/// Version of the snapshot format, incremented on any change to the layout.
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+/// Kinds of data types stored in a snapshot.
+enum class SnapshotDTypeKind : uint8_t {
+  BASIC,
+  REF,
+  ARRAY,
+  STRUCT,
+  UNION,
+  ENUM
+};
+
+/// Write a binary snapshot of a post-processed netlist graph, its source files
+/// and its data types.
+///
+/// The snapshot records the graph after all of the post-processing passes have
+/// been applied, so loading one avoids the XML parse and the passes entirely.
+/// Edges are written in their original order so that the in and out edge
+/// lists of every vertex, and hence the results of traversals, are reproduced
+/// exactly.
+class WriteSnapshot {
+  std::ofstream out;
+  std::map<uint32_t, int32_t> locationFileIndexes;
+  std::map<const DType*, int32_t> dtypeIndexes;
+  std::map<uint32_t, int32_t> dtypeTableIndexes;
+
+  void writeU8(uint8_t value);
+  void writeU32(uint32_t value);
+  void writeI32(int32_t value);
+  void writeU64(uint64_t value);
+  void writeString(std::string_view value);
+  template<typename T>
+  void writeArray(const std::vector<T> &values);
+  void writeLocation(const Location &location);
+  void writeDTypeRef(const std::shared_ptr<DType> &dtype);
+  void writeDTypeRef(uint32_t dtypeTableIndex);
+  void writeDType(const DType &dtype);
+  void collectLocationFile(const Location &location,
+                           std::vector<uint32_t> &locationFiles);
+  void writeReachabilityIndex(const ReachabilityIndex &index);
+
+public:
+  WriteSnapshot() = delete;
+  WriteSnapshot(const Graph &netlist,
+                const std::vector<File> &files,
+                const std::vector<std::shared_ptr<DType>> &dtypes,
+                const std::string &filename);
+};
+
+/// Read a binary snapshot written by WriteSnapshot.
+///
+/// The snapshot file is memory mapped and decoded in a single forward pass
+/// directly from the mapped region.
+class ReadSnapshot {
+  const char *cursor;
+  const char *end;
+  std::vector<uint32_t> locationFiles;
+  // The indexes in the DTypeTable of the graph of the dtypes of the snapshot.
+  std::vector<uint32_t> dtypeTableIndexes;
+
+  void check(size_t bytes) const;
+  uint8_t readU8();
+  uint32_t readU32();
+  int32_t readI32();
+  uint64_t readU64();
+  std::string readString();
+  template<typename T>
+  void readArray(std::vector<T> &values);
+  Location readLocation();
+  uint32_t readDTypeRef();
+  void readDTypes(Graph &netlist, std::vector<std::shared_ptr<DType>> &dtypes);
+  void readGraph(Graph &netlist);
+  void readReachabilityIndex(ReachabilityIndex &index, size_t numVertices,
+                             bool traverseRegisters);
+
+public:
+  ReadSnapshot() = delete;
+  ReadSnapshot(Graph &netlist,
+               std::vector<File> &files,
+               std::vector<std::shared_ptr<DType>> &dtypes,
+               const std::string &filename);
+
+  /// Return true if the file starts with the snapshot magic bytes.
+  static bool isSnapshot(const std::string &filename);
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_SNAPSHOT_HPP
@@ -0,0 +1,68 @@
+#include "netlist_paths/Stats.hpp"
+
+using namespace netlist_paths;
+
+void Stats::clear() {
+  for (auto &record : records) {
+    record.count = 0;
+    record.nanoseconds = 0;
+    record.verticesVisited = 0;
+    record.edgesExamined = 0;
+    record.parentMapEntries = 0;
+    record.allocatedBytes = 0;
+  }
+  traversalCacheHits = 0;
+  traversalCacheMisses = 0;
+  traversalCacheEvictions = 0;
+}
+
+const char *Stats::getPhaseName(StatsPhase phase) {
+  switch (phase) {
+    case StatsPhase::READ_XML:                   return "read_xml";
+    case StatsPhase::PARSE_XML:                  return "parse_xml";
+    case StatsPhase::TYPE_TABLE_PASS_1:          return "type_table_pass_1";
+    case StatsPhase::TYPE_TABLE_PASS_2:          return "type_table_pass_2";
+    case StatsPhase::VISIT_MODULES:              return "visit_modules";
+    case StatsPhase::READ_SNAPSHOT:              return "read_snapshot";
+    case StatsPhase::MARK_ALIAS_REGISTERS:       return "mark_alias_registers";
+    case StatsPhase::SPLIT_REG_VERTICES:         return "split_reg_vertices";
+    case StatsPhase::UPDATE_VAR_ALIASES:         return "update_var_aliases";
+    case StatsPhase::BUILD_INDEXES:              return "build_indexes";
+    case StatsPhase::BUILD_REACHABILITY_INDEXES: return "build_reachability_indexes";
+    case StatsPhase::LOOKUP_VERTICES:            return "lookup_vertices";
+    case StatsPhase::FAN_OUT:                    return "fan_out";
+    case StatsPhase::FAN_IN:                     return "fan_in";
+    case StatsPhase::FAN_DEGREE:                 return "fan_degree";
+    case StatsPhase::ANY_PATH:                   return "any_path";
+    case StatsPhase::PATH_EXISTS:                return "path_exists";
+    case StatsPhase::ALL_PATHS:                  return "all_paths";
+    case StatsPhase::DEEPEST_PATHS:              return "deepest_paths";
+    case StatsPhase::EXPORT_SUBGRAPH:            return "export_subgraph";
+    default:                                     return "unknown";
+  }
+}
+
+std::vector<std::pair<std::string, double>> Stats::getValues() const {
+  std::vector<std::pair<std::string, double>> values;
+  for (size_t i = 0; i < records.size(); ++i) {
+    auto &record = records[i];
+    if (record.count == 0) {
+      continue;
+    }
+    std::string name = getPhaseName(static_cast<StatsPhase>(i));
+    values.emplace_back(name + ".count", record.count);
+    values.emplace_back(name + ".seconds", record.nanoseconds * 1e-9);
+    if (i >= static_cast<size_t>(StatsPhase::FAN_OUT)) {
+      values.emplace_back(name + ".vertices_visited", record.verticesVisited);
+      values.emplace_back(name + ".edges_examined", record.edgesExamined);
+      values.emplace_back(name + ".parent_map_entries", record.parentMapEntries);
+      values.emplace_back(name + ".allocated_bytes", record.allocatedBytes);
+    }
+  }
+  if (traversalCacheHits + traversalCacheMisses != 0) {
+    values.emplace_back("traversal_cache.hits", traversalCacheHits);
+    values.emplace_back("traversal_cache.misses", traversalCacheMisses);
+    values.emplace_back("traversal_cache.evictions", traversalCacheEvictions);
+  }
+  return values;
+}
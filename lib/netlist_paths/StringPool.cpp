@@ -0,0 +1,47 @@
+#include <cstring>
+#include "netlist_paths/StringPool.hpp"
+
+using namespace netlist_paths;
+
+char *StringPool::allocate(size_t size) {
+  if (size > remaining) {
+    // Strings larger than a chunk are given a chunk of their own, leaving the
+    // current chunk to be filled by smaller strings.
+    if (size > CHUNK_SIZE / 4) {
+      chunks.emplace_back(new char[size]);
+      bytes += size;
+      return chunks.back().get();
+    }
+    chunks.emplace_back(new char[CHUNK_SIZE]);
+    bytes += CHUNK_SIZE;
+    next = chunks.back().get();
+    remaining = CHUNK_SIZE;
+  }
+  auto result = next;
+  next += size;
+  remaining -= size;
+  return result;
+}
+
+std::string_view StringPool::intern(std::string_view value) {
+  if (value.empty()) {
+    return std::string_view("", 0);
+  }
+  auto it = strings.find(value);
+  if (it != strings.end()) {
+    return *it;
+  }
+  auto data = allocate(value.size());
+  std::memcpy(data, value.data(), value.size());
+  std::string_view pooled(data, value.size());
+  strings.insert(pooled);
+  return pooled;
+}
+
+void StringPool::clear() {
+  strings.clear();
+  chunks.clear();
+  next = nullptr;
+  remaining = 0;
+  bytes = 0;
+}
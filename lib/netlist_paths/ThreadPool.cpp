@@ -0,0 +1,153 @@
+#include <algorithm>
+#include "netlist_paths/ThreadPool.hpp"
+
+using namespace netlist_paths;
+
+ThreadPool::ThreadPool(size_t numThreads) :
+    body(nullptr), generation(0), numActive(0), stopping(false) {
+  if (numThreads == 0) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  ranges.reset(new Range[numThreads]);
+  for (size_t i = 0; i < numThreads; ++i) {
+    ranges[i].begin = ranges[i].end = 0;
+  }
+  // The calling thread is thread 0.
+  for (size_t i = 1; i < numThreads; ++i) {
+    workers.emplace_back(&ThreadPool::runWorker, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  startLoop.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+/// Take the next iteration from the front of the range of a thread.
+bool ThreadPool::takeIteration(size_t thread, size_t &iteration) {
+  auto &range = ranges[thread];
+  std::lock_guard<std::mutex> lock(range.mutex);
+  if (range.begin == range.end) {
+    return false;
+  }
+  iteration = range.begin++;
+  return true;
+}
+
+/// Move the back half of the largest range of another thread to the empty
+/// range of a thread, returning false if no iterations remain.
+bool ThreadPool::stealIterations(size_t thread) {
+  auto numThreads = getNumThreads();
+  while (true) {
+    size_t victim = thread;
+    size_t largest = 0;
+    for (size_t i = 0; i < numThreads; ++i) {
+      if (i == thread) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(ranges[i].mutex);
+      auto remaining = ranges[i].end - ranges[i].begin;
+      if (remaining > largest) {
+        largest = remaining;
+        victim = i;
+      }
+    }
+    if (victim == thread) {
+      return false;
+    }
+    size_t begin, end;
+    {
+      std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+      auto remaining = ranges[victim].end - ranges[victim].begin;
+      if (remaining == 0) {
+        // The victim finished its range in the meantime, so look again.
+        continue;
+      }
+      end = ranges[victim].end;
+      begin = end - (remaining + 1) / 2;
+      ranges[victim].end = begin;
+    }
+    std::lock_guard<std::mutex> lock(ranges[thread].mutex);
+    ranges[thread].begin = begin;
+    ranges[thread].end = end;
+    return true;
+  }
+}
+
+/// Run iterations until none remain in any range.
+void ThreadPool::runIterations(size_t thread) {
+  size_t iteration;
+  do {
+    while (takeIteration(thread, iteration)) {
+      try {
+        (*body)(iteration);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  } while (stealIterations(thread));
+}
+
+void ThreadPool::runWorker(size_t thread) {
+  size_t lastGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      startLoop.wait(lock, [&] { return stopping || generation != lastGeneration; });
+      if (stopping) {
+        return;
+      }
+      lastGeneration = generation;
+    }
+    runIterations(thread);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--numActive == 0) {
+        finishLoop.notify_one();
+      }
+    }
+  }
+}
+
+void ThreadPool::parallelFor(size_t numIterations,
+                             const std::function<void(size_t)> &loopBody) {
+  if (workers.empty() || numIterations < 2) {
+    for (size_t i = 0; i < numIterations; ++i) {
+      loopBody(i);
+    }
+    return;
+  }
+  // Divide the iterations between the threads. The workers are not running,
+  // so the ranges can be set without locking them.
+  auto numThreads = getNumThreads();
+  for (size_t i = 0; i < numThreads; ++i) {
+    ranges[i].begin = (numIterations * i) / numThreads;
+    ranges[i].end = (numIterations * (i + 1)) / numThreads;
+  }
+  error = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    body = &loopBody;
+    numActive = workers.size();
+    ++generation;
+  }
+  startLoop.notify_all();
+  runIterations(0);
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    finishLoop.wait(lock, [&] { return numActive == 0; });
+    body = nullptr;
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include "netlist_paths/TraversalCache.hpp"
+
+using namespace netlist_paths;
+
+//===----------------------------------------------------------------------===//
+// TraversalTree
+//===----------------------------------------------------------------------===//
+
+size_t TraversalTree::find(size_t vertex) const {
+  auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+  if (it == vertices.end() || *it != vertex) {
+    return vertices.size();
+  }
+  return it - vertices.begin();
+}
+
+std::vector<size_t> TraversalTree::getTreePath(size_t vertex) const {
+  std::vector<size_t> path;
+  auto position = find(vertex);
+  for (; vertices[position] != rootVertex; position = parents[position]) {
+    path.push_back(vertices[position]);
+  }
+  path.push_back(rootVertex);
+  return path;
+}
+
+//===----------------------------------------------------------------------===//
+// TraversalCache
+//===----------------------------------------------------------------------===//
+
+/// Discard the least recently used trees until the cache is within a number
+/// of bytes.
+///
+/// \returns The number of trees discarded.
+size_t TraversalCache::evict(size_t limit) {
+  size_t count = 0;
+  while (numBytes > limit) {
+    auto &entry = entries.back();
+    numBytes -= entry.second->numBytes();
+    index.erase(entry.first);
+    entries.pop_back();
+    ++count;
+  }
+  return count;
+}
+
+bool TraversalCache::isEnabled() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return maxBytes != 0;
+}
+
+void TraversalCache::setMaxBytes(size_t value) {
+  std::lock_guard<std::mutex> lock(mutex);
+  maxBytes = value;
+  evict(maxBytes);
+}
+
+size_t TraversalCache::getMaxBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return maxBytes;
+}
+
+std::shared_ptr<const TraversalTree> TraversalCache::get(const Key &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return nullptr;
+  }
+  entries.splice(entries.begin(), entries, it->second);
+  return it->second->second;
+}
+
+size_t TraversalCache::insert(const Key &key,
+                              std::shared_ptr<const TraversalTree> tree) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto bytes = tree->numBytes();
+  if (bytes > maxBytes || index.count(key)) {
+    // The tree does not fit, or another thread has added it.
+    return 0;
+  }
+  auto count = evict(maxBytes - bytes);
+  entries.emplace_front(key, std::move(tree));
+  index.emplace(key, entries.begin());
+  numBytes += bytes;
+  return count;
+}
+
+void TraversalCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  index.clear();
+  numBytes = 0;
+}
+
+size_t TraversalCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+size_t TraversalCache::getNumBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numBytes;
+}
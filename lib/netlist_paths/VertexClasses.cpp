@@ -0,0 +1,77 @@
+#include "netlist_paths/VertexClasses.hpp"
+
+using namespace netlist_paths;
+
+/// The number of vertex types, excluding ANY.
+constexpr size_t NUM_TYPES = static_cast<size_t>(VertexNetlistType::ANY);
+
+/// Indexes of the classes for the alternative option settings, which follow
+/// one class for each vertex type.
+constexpr size_t ANY_INDEX = NUM_TYPES;
+constexpr size_t UNRESTRICTED_START_POINT_INDEX = NUM_TYPES + 1;
+constexpr size_t UNRESTRICTED_END_POINT_INDEX = NUM_TYPES + 2;
+constexpr size_t TRAVERSE_REGISTERS_MID_POINT_INDEX = NUM_TYPES + 3;
+constexpr size_t NUM_CLASSES = NUM_TYPES + 4;
+
+size_t VertexClasses::getIndex(VertexNetlistType type,
+                               bool restrictStartPoints,
+                               bool restrictEndPoints,
+                               bool traverseRegisters) {
+  switch (type) {
+    case VertexNetlistType::START_POINT:
+      return restrictStartPoints ? static_cast<size_t>(type)
+                                 : UNRESTRICTED_START_POINT_INDEX;
+    case VertexNetlistType::END_POINT:
+      return restrictEndPoints ? static_cast<size_t>(type)
+                               : UNRESTRICTED_END_POINT_INDEX;
+    case VertexNetlistType::MID_POINT:
+      return traverseRegisters ? TRAVERSE_REGISTERS_MID_POINT_INDEX
+                               : static_cast<size_t>(type);
+    case VertexNetlistType::ANY:
+      return ANY_INDEX;
+    default:
+      return static_cast<size_t>(type);
+  }
+}
+
+void VertexClasses::build(const std::vector<const Vertex*> &vertices) {
+  classes.assign(NUM_CLASSES, VertexSet(vertices.size()));
+  auto add = [this](size_t index, size_t vertex, bool member) {
+    if (member) {
+      classes[index].add(vertex);
+    }
+  };
+  for (size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+    auto &v = *vertices[vertex];
+    classes[ANY_INDEX].add(vertex);
+    // Source registers and register aliases are duplicates of destination
+    // registers and their aliases, so exclude them from queries that can
+    // include registers.
+    bool isSrc = v.isSrcReg() || v.isSrcRegAlias();
+    for (size_t type = 0; type < NUM_TYPES; ++type) {
+      auto vertexType = static_cast<VertexNetlistType>(type);
+      switch (vertexType) {
+        case VertexNetlistType::REG:
+        case VertexNetlistType::PORT:
+        case VertexNetlistType::IS_NAMED:
+          add(type, vertex, !isSrc && v.isGraphType(vertexType));
+          break;
+        case VertexNetlistType::START_POINT:
+          add(type, vertex, v.isStartPoint(true));
+          add(UNRESTRICTED_START_POINT_INDEX, vertex, v.isStartPoint(false));
+          break;
+        case VertexNetlistType::END_POINT:
+          add(type, vertex, v.isEndPoint(true));
+          add(UNRESTRICTED_END_POINT_INDEX, vertex, v.isEndPoint(false));
+          break;
+        case VertexNetlistType::MID_POINT:
+          add(type, vertex, v.isMidPoint(false));
+          add(TRAVERSE_REGISTERS_MID_POINT_INDEX, vertex, v.isMidPoint(true));
+          break;
+        default:
+          add(type, vertex, v.isGraphType(vertexType));
+          break;
+      }
+    }
+  }
+}
@@ -1,9 +1,14 @@
+#include <map>
+#include <memory>
 #include <boost/python.hpp>
+#include <boost/python/stl_iterator.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Exception.hpp"
+#include "netlist_paths/FanDegree.hpp"
 #include "netlist_paths/Netlist.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/QueryResults.hpp"
 #include "netlist_paths/RunVerilator.hpp"
 #include "netlist_paths/Vertex.hpp"
 #include "netlist_paths/Waypoints.hpp"
@@ -16,23 +21,590 @@ void translateXMLException(const netlist_paths::XMLException& e) {
   PyErr_SetString(PyExc_RuntimeError, e.what());
 }
 
+/// Return the name of a vertex as a Python string, since the interned name is
+/// a view.
+std::string getVertexName(const netlist_paths::Vertex &vertex) {
+  return std::string(vertex.getName());
+}
+
+/// Release the GIL for the lifetime of the object, so other Python threads
+/// can run while a query executes.
+class ScopedGILRelease {
+  PyThreadState *state;
+
+public:
+  ScopedGILRelease() : state(PyEval_SaveThread()) {}
+  ~ScopedGILRelease() { PyEval_RestoreThread(state); }
+};
+
+/// Set a flag for the lifetime of a scope, clearing it on exceptions too.
+class ScopedFlag {
+  bool &flag;
+
+public:
+  ScopedFlag(bool &flag) : flag(flag) { flag = true; }
+  ~ScopedFlag() { flag = false; }
+};
+
+/// Return the options of a batch query, or the default if they are None.
+netlist_paths::QueryOptions getQueryOptions(const boost::python::object &options) {
+  if (options.is_none()) {
+    return netlist_paths::QueryOptions::getDefault();
+  }
+  return boost::python::extract<netlist_paths::QueryOptions>(options);
+}
+
+/// Convert a Python iterable to a vector.
+template<typename T>
+std::vector<T> toVector(const boost::python::object &iterable) {
+  return std::vector<T>(boost::python::stl_input_iterator<T>(iterable),
+                        boost::python::stl_input_iterator<T>());
+}
+
+boost::python::list pathExistsBatch(const netlist_paths::Netlist &netlist,
+                                    const boost::python::object &waypoints,
+                                    const boost::python::object &options) {
+  auto queries = toVector<netlist_paths::Waypoints>(waypoints);
+  auto queryOptions = getQueryOptions(options);
+  std::vector<bool> results;
+  {
+    ScopedGILRelease release;
+    results = netlist.pathExistsBatch(queries, queryOptions);
+  }
+  boost::python::list list;
+  for (bool result : results) {
+    list.append(result);
+  }
+  return list;
+}
+
+std::vector<std::vector<netlist_paths::Vertex*> >
+getAnyPathBatch(const netlist_paths::Netlist &netlist,
+                const boost::python::object &waypoints,
+                const boost::python::object &options) {
+  auto queries = toVector<netlist_paths::Waypoints>(waypoints);
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return netlist.getAnyPathBatch(queries, queryOptions);
+}
+
+std::vector<std::vector<netlist_paths::Vertex*> >
+getCombConnectivity(const netlist_paths::Netlist &netlist,
+                    const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return netlist.getCombConnectivity(queryOptions);
+}
+
+boost::python::list getAllFanOutBatch(const netlist_paths::Netlist &netlist,
+                                      const boost::python::object &startNames,
+                                      const boost::python::object &options) {
+  auto names = toVector<std::string>(startNames);
+  auto queryOptions = getQueryOptions(options);
+  std::vector<std::vector<std::vector<netlist_paths::Vertex*> > > results;
+  {
+    ScopedGILRelease release;
+    results = netlist.getAllFanOutBatch(names, queryOptions);
+  }
+  boost::python::list list;
+  for (auto &paths : results) {
+    list.append(paths);
+  }
+  return list;
+}
+
+/// A read-only array of unsigned 64-bit integers that is owned by a C++
+/// object, which Python can view without copying through the buffer protocol,
+/// for example with memoryview() or numpy.asarray().
+class UInt64Array {
+  std::shared_ptr<const void> owner;
+  const std::uint64_t *data;
+  Py_ssize_t size;
+  Py_ssize_t itemSize;
+
+public:
+  UInt64Array(std::shared_ptr<const void> owner,
+              const std::uint64_t *data, size_t size) :
+      owner(owner), data(data), size(size), itemSize(sizeof(std::uint64_t)) {}
+
+  size_t length() const { return size; }
+
+  std::uint64_t getItem(Py_ssize_t index) const {
+    if (index < 0) {
+      index += size;
+    }
+    if (index < 0 || index >= size) {
+      PyErr_SetString(PyExc_IndexError, "array index out of range");
+      boost::python::throw_error_already_set();
+    }
+    return data[index];
+  }
+
+  static int getBuffer(PyObject *self, Py_buffer *view, int flags);
+};
+
+int UInt64Array::getBuffer(PyObject *self, Py_buffer *view, int flags) {
+  static const std::uint64_t empty = 0;
+  view->obj = nullptr;
+  if (flags & PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "array is read only");
+    return -1;
+  }
+  UInt64Array *array = boost::python::extract<UInt64Array*>(self);
+  view->buf = const_cast<std::uint64_t*>(array->size > 0 ? array->data : &empty);
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = array->size * array->itemSize;
+  view->readonly = 1;
+  view->itemsize = array->itemSize;
+  view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("Q") : nullptr;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) ? &array->size : nullptr;
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &array->itemSize : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = nullptr;
+  return 0;
+}
+
+PyBufferProcs uint64ArrayBufferProcs = { &UInt64Array::getBuffer, nullptr };
+
+UInt64Array makeUInt64Array(std::shared_ptr<const void> owner,
+                            const std::vector<std::uint64_t> &values) {
+  return UInt64Array(owner, values.data(), values.size());
+}
+
+size_t getNumPaths(const netlist_paths::PathArray &paths) {
+  return paths.numPaths();
+}
+
+UInt64Array getPathArrayVertices(std::shared_ptr<netlist_paths::PathArray> paths) {
+  return makeUInt64Array(paths, paths->getVertices());
+}
+
+UInt64Array getPathArrayOffsets(std::shared_ptr<netlist_paths::PathArray> paths) {
+  return makeUInt64Array(paths, paths->getOffsets());
+}
+
+/// Return a view of the vertex IDs of one path of an array.
+UInt64Array getPathArrayPath(std::shared_ptr<netlist_paths::PathArray> paths,
+                             Py_ssize_t index) {
+  Py_ssize_t numPaths = paths->numPaths();
+  if (index < 0) {
+    index += numPaths;
+  }
+  if (index < 0 || index >= numPaths) {
+    PyErr_SetString(PyExc_IndexError, "path index out of range");
+    boost::python::throw_error_already_set();
+  }
+  auto path = paths->getPath(index);
+  return UInt64Array(paths, path.first, path.second - path.first);
+}
+
+/// Convert a Python object to a vector of vertex IDs, reading it directly if
+/// it provides a buffer of 64-bit integers, such as a UInt64Array or a numpy
+/// array, and otherwise iterating over it.
+std::vector<netlist_paths::PathArray::ID>
+toVertexIDVector(const boost::python::object &vertexIDs) {
+  using ID = netlist_paths::PathArray::ID;
+  if (PyObject_CheckBuffer(vertexIDs.ptr())) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(vertexIDs.ptr(), &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) == 0) {
+      std::string format(view.format ? view.format : "B");
+      if (!format.empty() && (format[0] == '@' || format[0] == '=')) {
+        format.erase(0, 1);
+      }
+      bool integers = view.itemsize == sizeof(ID) &&
+                      format.size() == 1 &&
+                      std::string("QqLlNn").find(format[0]) != std::string::npos;
+      std::vector<ID> result;
+      if (integers) {
+        auto data = static_cast<const ID*>(view.buf);
+        result.assign(data, data + view.len / view.itemsize);
+      }
+      PyBuffer_Release(&view);
+      if (integers) {
+        return result;
+      }
+    } else {
+      PyErr_Clear();
+    }
+  }
+  return toVector<ID>(vertexIDs);
+}
+
+/// Convert a vector of strings to a Python list.
+template<typename T>
+boost::python::list toStringList(const std::vector<T> &values) {
+  boost::python::list list;
+  for (auto &value : values) {
+    list.append(boost::python::object(boost::python::handle<>(
+        PyUnicode_FromStringAndSize(value.data(), value.size()))));
+  }
+  return list;
+}
+
+/// Convert a vector of static strings to a Python list, creating one Python
+/// string for each distinct value.
+boost::python::list toStaticStringList(const std::vector<const char*> &values) {
+  std::map<const char*, boost::python::object> strings;
+  boost::python::list list;
+  for (auto value : values) {
+    auto it = strings.find(value);
+    if (it == strings.end()) {
+      it = strings.emplace(value, boost::python::str(value)).first;
+    }
+    list.append(it->second);
+  }
+  return list;
+}
+
+std::shared_ptr<netlist_paths::PathArray>
+getAnyPathArray(const netlist_paths::Netlist &netlist,
+                const netlist_paths::Waypoints &waypoints,
+                const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return std::make_shared<netlist_paths::PathArray>(
+      netlist.getAnyPathArray(waypoints, queryOptions));
+}
+
+std::shared_ptr<netlist_paths::PathArray>
+getAllPathsArray(const netlist_paths::Netlist &netlist,
+                 const netlist_paths::Waypoints &waypoints,
+                 const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return std::make_shared<netlist_paths::PathArray>(
+      netlist.getAllPathsArray(waypoints, queryOptions));
+}
+
+std::shared_ptr<netlist_paths::PathArray>
+getAllFanOutArray(const netlist_paths::Netlist &netlist,
+                  const std::string &startName,
+                  const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return std::make_shared<netlist_paths::PathArray>(
+      netlist.getAllFanOutArray(startName, queryOptions));
+}
+
+std::shared_ptr<netlist_paths::PathArray>
+getAllFanInArray(const netlist_paths::Netlist &netlist,
+                 const std::string &endName,
+                 const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return std::make_shared<netlist_paths::PathArray>(
+      netlist.getAllFanInArray(endName, queryOptions));
+}
+
+/// An iterator over an enumeration of paths for Python, which yields the
+/// vertex IDs of each path as a UInt64Array.
+class PathIterator {
+  std::shared_ptr<netlist_paths::PathEnumerator> enumerator;
+  bool running;
+
+public:
+  PathIterator(netlist_paths::PathEnumerator &&enumerator) :
+      enumerator(std::make_shared<netlist_paths::PathEnumerator>(std::move(enumerator))),
+      running(false) {}
+
+  UInt64Array next() {
+    if (running) {
+      PyErr_SetString(PyExc_ValueError, "path iterator already executing");
+      boost::python::throw_error_already_set();
+    }
+    bool found;
+    {
+      // The flag is cleared once the GIL is held again, even if the
+      // enumeration throws.
+      ScopedFlag executing(running);
+      ScopedGILRelease release;
+      found = enumerator->next();
+    }
+    if (!found) {
+      PyErr_SetNone(PyExc_StopIteration);
+      boost::python::throw_error_already_set();
+    }
+    auto &path = enumerator->getPath();
+    auto vertices = std::make_shared<std::vector<std::uint64_t>>(path.begin(), path.end());
+    return makeUInt64Array(vertices, *vertices);
+  }
+
+  size_t getNumPaths() const { return enumerator->getNumPaths(); }
+  bool isTruncated() const { return enumerator->isTruncated(); }
+};
+
+boost::python::object identity(const boost::python::object &object) {
+  return object;
+}
+
+PathIterator iterateAllPaths(const netlist_paths::Netlist &netlist,
+                             const netlist_paths::Waypoints &waypoints,
+                             size_t maxPaths,
+                             size_t maxLength,
+                             double timeLimit,
+                             const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  auto limits = netlist_paths::PathLimits().withMaxPaths(maxPaths)
+                                           .withMaxLength(maxLength)
+                                           .withTimeLimit(timeLimit);
+  ScopedGILRelease release;
+  return PathIterator(netlist.enumerateAllPaths(waypoints, limits, queryOptions));
+}
+
+netlist_paths::ExportOptions getExportOptions(netlist_paths::ExportFormat format,
+                                              size_t maxDepth,
+                                              size_t maxVertices) {
+  return netlist_paths::ExportOptions().withFormat(format)
+                                       .withMaxDepth(maxDepth)
+                                       .withMaxVertices(maxVertices);
+}
+
+void exportFanOutCone(const netlist_paths::Netlist &netlist,
+                      const std::string &startName,
+                      const std::string &outputFilename,
+                      netlist_paths::ExportFormat format,
+                      size_t maxDepth,
+                      size_t maxVertices,
+                      const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  netlist.exportFanOutCone(startName, outputFilename,
+                           getExportOptions(format, maxDepth, maxVertices),
+                           queryOptions);
+}
+
+void exportFanInCone(const netlist_paths::Netlist &netlist,
+                     const std::string &endName,
+                     const std::string &outputFilename,
+                     netlist_paths::ExportFormat format,
+                     size_t maxDepth,
+                     size_t maxVertices,
+                     const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  netlist.exportFanInCone(endName, outputFilename,
+                          getExportOptions(format, maxDepth, maxVertices),
+                          queryOptions);
+}
+
+void exportPaths(const netlist_paths::Netlist &netlist,
+                 const netlist_paths::Waypoints &waypoints,
+                 const std::string &outputFilename,
+                 netlist_paths::ExportFormat format,
+                 size_t maxDepth,
+                 size_t maxVertices,
+                 const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  netlist.exportPaths(waypoints, outputFilename,
+                      getExportOptions(format, maxDepth, maxVertices),
+                      queryOptions);
+}
+
+/// Return the weights of a deepest paths query from a dictionary of vertex
+/// AST type names and weights, which change the default weights of those
+/// types, or the default weights if it is None.
+netlist_paths::PathWeights getPathWeights(const boost::python::object &weights) {
+  netlist_paths::PathWeights pathWeights;
+  if (weights.is_none()) {
+    return pathWeights;
+  }
+  boost::python::list items = boost::python::dict(weights).items();
+  for (boost::python::ssize_t i = 0; i < boost::python::len(items); ++i) {
+    std::string name = boost::python::extract<std::string>(items[i][0]);
+    double value = boost::python::extract<double>(items[i][1]);
+    auto type = netlist_paths::getVertexAstType(name);
+    if (type == netlist_paths::VertexAstType::INVALID) {
+      throw netlist_paths::Exception("unknown vertex type "+name);
+    }
+    pathWeights = pathWeights.withWeight(type, value);
+  }
+  return pathWeights;
+}
+
+std::vector<std::vector<netlist_paths::Vertex*> >
+getDeepestPaths(const netlist_paths::Netlist &netlist,
+                const netlist_paths::Waypoints &waypoints,
+                size_t numPaths,
+                const boost::python::object &weights,
+                const boost::python::object &options) {
+  auto pathWeights = getPathWeights(weights);
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return netlist.getDeepestPaths(waypoints, numPaths, pathWeights, queryOptions);
+}
+
+std::vector<std::vector<netlist_paths::Vertex*> >
+getDeepestFanOut(const netlist_paths::Netlist &netlist,
+                 const std::string &startName,
+                 size_t numPaths,
+                 const boost::python::object &weights,
+                 const boost::python::object &options) {
+  auto pathWeights = getPathWeights(weights);
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return netlist.getDeepestFanOut(startName, numPaths, pathWeights, queryOptions);
+}
+
+std::vector<std::vector<netlist_paths::Vertex*> >
+getDeepestFanIn(const netlist_paths::Netlist &netlist,
+                const std::string &endName,
+                size_t numPaths,
+                const boost::python::object &weights,
+                const boost::python::object &options) {
+  auto pathWeights = getPathWeights(weights);
+  auto queryOptions = getQueryOptions(options);
+  ScopedGILRelease release;
+  return netlist.getDeepestFanIn(endName, numPaths, pathWeights, queryOptions);
+}
+
+/// Return the depth of a path with the weights of a deepest paths query.
+double getPathDepth(const netlist_paths::Netlist&,
+                    const std::vector<netlist_paths::Vertex*> &path,
+                    const boost::python::object &weights) {
+  return getPathWeights(weights).getDepth(path);
+}
+
+/// Return the attributes of a list of vertex IDs as a dictionary of columns.
+boost::python::dict getVertexColumns(const netlist_paths::Netlist &netlist,
+                                     const boost::python::object &vertexIDs) {
+  auto ids = toVertexIDVector(vertexIDs);
+  std::shared_ptr<netlist_paths::VertexColumns> columns;
+  {
+    ScopedGILRelease release;
+    columns = std::make_shared<netlist_paths::VertexColumns>(netlist.getVertexColumns(ids));
+  }
+  boost::python::list isLogic;
+  for (bool value : columns->isLogic) {
+    isLogic.append(value);
+  }
+  boost::python::dict dict;
+  dict["name"]      = toStringList(columns->names);
+  dict["ast_type"]  = toStaticStringList(columns->astTypes);
+  dict["direction"] = toStaticStringList(columns->directions);
+  dict["dtype"]     = toStringList(columns->dtypes);
+  dict["width"]     = makeUInt64Array(columns, columns->widths);
+  dict["location"]  = toStringList(columns->locations);
+  dict["is_logic"]  = isLogic;
+  return dict;
+}
+
+/// Return the fan degrees of a list of vertices as a dictionary of columns.
+boost::python::dict toFanDegreeDict(netlist_paths::FanDegreeColumns &&degrees) {
+  auto columns = std::make_shared<netlist_paths::FanDegreeColumns>(std::move(degrees));
+  boost::python::dict dict;
+  dict["vertex"]     = makeUInt64Array(columns, columns->vertices);
+  dict["num_points"] = makeUInt64Array(columns, columns->numPoints);
+  dict["num_paths"]  = makeUInt64Array(columns, columns->numPaths);
+  dict["num_bits"]   = makeUInt64Array(columns, columns->numBits);
+  return dict;
+}
+
+boost::python::dict getFanOutDegrees(const netlist_paths::Netlist &netlist,
+                                     const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  netlist_paths::FanDegreeColumns degrees;
+  {
+    ScopedGILRelease release;
+    degrees = netlist.getFanOutDegrees(queryOptions);
+  }
+  return toFanDegreeDict(std::move(degrees));
+}
+
+boost::python::dict getFanInDegrees(const netlist_paths::Netlist &netlist,
+                                    const boost::python::object &options) {
+  auto queryOptions = getQueryOptions(options);
+  netlist_paths::FanDegreeColumns degrees;
+  {
+    ScopedGILRelease release;
+    degrees = netlist.getFanInDegrees(queryOptions);
+  }
+  return toFanDegreeDict(std::move(degrees));
+}
+
+/// Compile a source file and load its netlist, which Python takes ownership
+/// of.
+netlist_paths::Netlist *compileNetlist(const netlist_paths::RunVerilator &runVerilator,
+                                       const std::string &inputFile) {
+  return runVerilator.compile(inputFile).release();
+}
+
+/// Return the statistics of a netlist as a dictionary of figures.
+boost::python::dict getStats(const netlist_paths::Netlist &netlist) {
+  boost::python::dict dict;
+  for (auto &value : netlist.getStats().getValues()) {
+    dict[value.first] = value.second;
+  }
+  return dict;
+}
+
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_named_vertices_overloads,
-                                       getNamedVerticesPtr, 0, 1)
+                                       getNamedVerticesPtr, 0, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_reg_vertices_overloads,
-                                       getRegVerticesPtr, 0, 1)
+                                       getRegVerticesPtr, 0, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_net_vertices_overloads,
-                                       getNetVerticesPtr, 0, 1)
+                                       getNetVerticesPtr, 0, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_port_vertices_overloads,
-                                       getPortVerticesPtr, 0, 1)
+                                       getPortVerticesPtr, 0, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_vertex_dtype_str_overloads,
-                                       getVertexDTypeStr, 1, 2)
+                                       getVertexDTypeStr, 1, 3)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_vertex_dtype_width_overloads,
-                                       getVertexDTypeWidth, 1, 2)
+                                       getVertexDTypeWidth, 1, 3)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(reg_exists_overloads,
+                                       regExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(any_reg_exists_overloads,
+                                       anyRegExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(startpoint_exists_overloads,
+                                       startpointExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(endpoint_exists_overloads,
+                                       endpointExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(any_startpoint_exists_overloads,
+                                       anyStartpointExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(any_endpoint_exists_overloads,
+                                       anyEndpointExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(path_exists_overloads,
+                                       pathExists, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_any_path_overloads,
+                                       getAnyPath, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_all_paths_overloads,
+                                       getAllPaths, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_all_fanout_paths_overloads,
+                                       getAllFanOut, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_all_fanin_paths_overloads,
+                                       getAllFanIn, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_fanout_end_points_overloads,
+                                       getFanOutEndPoints, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_fanin_start_points_overloads,
+                                       getFanInStartPoints, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_fanout_degree_overloads,
+                                       getFanOutDegree, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_fanin_degree_overloads,
+                                       getFanInDegree, 1, 2)
+
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(dump_dot_file_overloads,
+                                       dumpDotFile, 1, 2)
 
 BOOST_PYTHON_MODULE(py_netlist_paths)
 {
@@ -49,12 +621,13 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
      .def("to_str",     &DType::toString);
 
   class_<Vertex, Vertex*, boost::noncopyable>("Vertex")
-     .def("get_name",          &Vertex::getName)
+     .def("get_name",          &getVertexName)
      .def("get_ast_type_str",  &Vertex::getSimpleAstTypeStr)
      .def("get_direction_str", &Vertex::getDirStr)
      .def("get_dtype",         &Vertex::getDTypePtr,
                                return_value_policy<reference_existing_object>())
-     .def("get_dtype_str",     &Vertex::getDTypeStr)
+     .def("get_dtype_str",     &Vertex::getDTypeStr,
+                               return_value_policy<copy_const_reference>())
      .def("get_dtype_width",   &Vertex::getDTypeWidth)
      .def("get_location_str",  &Vertex::getLocationStr)
      .def("is_top",            &Vertex::isTop)
@@ -63,9 +636,9 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
      .def("is_net",            &Vertex::isNet)
      .def("is_reg",            &Vertex::isReg)
      .def("is_port",           &Vertex::isPort)
-     .def("is_start_point",    &Vertex::isStartPoint)
-     .def("is_end_point",      &Vertex::isEndPoint)
-     .def("is_mid_point",      &Vertex::isMidPoint)
+     .def("is_start_point",    static_cast<bool (Vertex::*)() const>(&Vertex::isStartPoint))
+     .def("is_end_point",      static_cast<bool (Vertex::*)() const>(&Vertex::isEndPoint))
+     .def("is_mid_point",      static_cast<bool (Vertex::*)() const>(&Vertex::isMidPoint))
      .def("is_public",         &Vertex::isPublic)
      .def("can_ignore",        &Vertex::canIgnore);
 
@@ -75,6 +648,63 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
   class_<std::vector<std::vector<Vertex*> > >("PathList")
       .def(vector_indexing_suite<std::vector<std::vector<Vertex*> > >());
 
+  class_<UInt64Array> uint64Array("UInt64Array", no_init);
+  uint64Array
+    .def("__len__",     &UInt64Array::length)
+    .def("__getitem__", &UInt64Array::getItem);
+  // Let Python view the contents of the array through the buffer protocol.
+  reinterpret_cast<PyTypeObject*>(uint64Array.ptr())->tp_as_buffer = &uint64ArrayBufferProcs;
+
+  class_<PathArray, std::shared_ptr<PathArray> >("PathArray", no_init)
+    .def("__len__",           &getNumPaths)
+    .def("__getitem__",       &getPathArrayPath)
+    .add_property("vertices", &getPathArrayVertices)
+    .add_property("offsets",  &getPathArrayOffsets);
+
+  class_<PathIterator>("PathIterator", no_init)
+    .def("__iter__",     &identity)
+    .def("__next__",     &PathIterator::next)
+    .def("num_paths",    &PathIterator::getNumPaths)
+    .def("is_truncated", &PathIterator::isTruncated);
+
+  class_<FanDegree>("FanDegree", no_init)
+    .def_readonly("num_points", &FanDegree::numPoints)
+    .def_readonly("num_paths",  &FanDegree::numPaths)
+    .def_readonly("num_bits",   &FanDegree::numBits)
+    .def("is_saturated",        &FanDegree::isSaturated);
+
+  enum_<MatchType>("MatchType")
+    .value("EXACT",    MatchType::EXACT)
+    .value("REGEX",    MatchType::REGEX)
+    .value("WILDCARD", MatchType::WILDCARD);
+
+  enum_<ExportFormat>("ExportFormat")
+    .value("DOT",     ExportFormat::DOT)
+    .value("GRAPHML", ExportFormat::GRAPHML)
+    .value("JSON",    ExportFormat::JSON);
+
+  class_<QueryOptions>("QueryOptions")
+    .def("get_default",                    &QueryOptions::getDefault)
+    .staticmethod("get_default")
+    .def("is_match_exact",                 &QueryOptions::isMatchExact)
+    .def("is_match_regex",                 &QueryOptions::isMatchRegex)
+    .def("is_match_wildcard",              &QueryOptions::isMatchWildcard)
+    .def("is_match_one_vertex",            &QueryOptions::isMatchOneVertex)
+    .def("should_ignore_hierarchy_markers", &QueryOptions::shouldIgnoreHierarchyMarkers)
+    .def("should_traverse_registers",      &QueryOptions::shouldTraverseRegisters)
+    .def("is_restrict_start_points",       &QueryOptions::isRestrictStartPoints)
+    .def("is_restrict_end_points",         &QueryOptions::isRestrictEndPoints)
+    .def("should_search_bidirectional",    &QueryOptions::shouldSearchBidirectional)
+    .def("get_num_threads",                &QueryOptions::getNumThreads)
+    .def("with_match_type",                &QueryOptions::withMatchType)
+    .def("with_ignore_hierarchy_markers",  &QueryOptions::withIgnoreHierarchyMarkers)
+    .def("with_match_one_vertex",          &QueryOptions::withMatchOneVertex)
+    .def("with_traverse_registers",        &QueryOptions::withTraverseRegisters)
+    .def("with_restrict_start_points",     &QueryOptions::withRestrictStartPoints)
+    .def("with_restrict_end_points",       &QueryOptions::withRestrictEndPoints)
+    .def("with_bidirectional_search",      &QueryOptions::withBidirectionalSearch)
+    .def("with_num_threads",               &QueryOptions::withNumThreads);
+
   class_<Options, boost::noncopyable>("Options", no_init)
     .def("get_instance",       &Options::getInstancePtr,
                                return_value_policy<reference_existing_object>())
@@ -89,13 +719,21 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
     .def("set_traverse_registers",        &Options::setTraverseRegisters)
     .def("set_restrict_start_points",     &Options::setRestrictStartPoints)
     .def("set_restrict_end_points",       &Options::setRestrictEndPoints)
-    .def("set_ignore_hierarchy_markers",  &Options::setIgnoreHierarchyMarkers);
+    .def("set_stream_xml",                &Options::setStreamXML)
+    .def("set_bidirectional_search",      &Options::setBidirectionalSearch)
+    .def("set_reachability_index",        &Options::setReachabilityIndex)
+    .def("set_num_threads",               &Options::setNumThreads)
+    .def("set_compile_cache_directory",   &Options::setCompileCacheDirectory)
+    .def("set_compile_cache_max_bytes",   &Options::setCompileCacheMaxBytes)
+    .def("set_ignore_hierarchy_markers",  &Options::setIgnoreHierarchyMarkers)
+    .def("get_query_options",             &Options::getQueryOptions);
 
   int (RunVerilator::*run)(const std::string&, const std::string&) const = &RunVerilator::run;
 
   class_<RunVerilator, boost::noncopyable>("RunVerilator",
                                            init<const std::string&>())
-    .def("run", run);
+    .def("run", run)
+    .def("compile", compileNetlist, return_value_policy<manage_new_object>());
 
   class_<Waypoints>("Waypoints")
     .def(init<const std::string, const std::string>())
@@ -114,21 +752,108 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
                                    get_net_vertices_overloads())
     .def("get_port_vertices",      &Netlist::getPortVerticesPtr,
                                    get_port_vertices_overloads())
-    .def("reg_exists",             &Netlist::regExists)
-    .def("any_reg_exists",         &Netlist::anyRegExists)
-    .def("startpoint_exists",      &Netlist::startpointExists)
-    .def("endpoint_exists",        &Netlist::endpointExists)
-    .def("any_startpoint_exists",  &Netlist::anyStartpointExists)
-    .def("any_endpoint_exists",    &Netlist::anyEndpointExists)
-    .def("path_exists",            &Netlist::pathExists)
-    .def("get_any_path",           &Netlist::getAnyPath)
-    .def("get_all_paths",          &Netlist::getAllPaths)
-    .def("get_all_fanout_paths",   &Netlist::getAllFanOut)
-    .def("get_all_fanin_paths",    &Netlist::getAllFanIn)
+    .def("reg_exists",             &Netlist::regExists,
+                                   reg_exists_overloads())
+    .def("any_reg_exists",         &Netlist::anyRegExists,
+                                   any_reg_exists_overloads())
+    .def("startpoint_exists",      &Netlist::startpointExists,
+                                   startpoint_exists_overloads())
+    .def("endpoint_exists",        &Netlist::endpointExists,
+                                   endpoint_exists_overloads())
+    .def("any_startpoint_exists",  &Netlist::anyStartpointExists,
+                                   any_startpoint_exists_overloads())
+    .def("any_endpoint_exists",    &Netlist::anyEndpointExists,
+                                   any_endpoint_exists_overloads())
+    .def("path_exists",            &Netlist::pathExists,
+                                   path_exists_overloads())
+    .def("get_any_path",           &Netlist::getAnyPath,
+                                   get_any_path_overloads())
+    .def("get_all_paths",          &Netlist::getAllPaths,
+                                   get_all_paths_overloads())
+    .def("get_all_fanout_paths",   &Netlist::getAllFanOut,
+                                   get_all_fanout_paths_overloads())
+    .def("get_all_fanin_paths",    &Netlist::getAllFanIn,
+                                   get_all_fanin_paths_overloads())
+    .def("get_fanout_end_points",  &Netlist::getFanOutEndPoints,
+                                   get_fanout_end_points_overloads())
+    .def("get_fanin_start_points", &Netlist::getFanInStartPoints,
+                                   get_fanin_start_points_overloads())
+    .def("get_fanout_degree",      &Netlist::getFanOutDegree,
+                                   get_fanout_degree_overloads())
+    .def("get_fanin_degree",       &Netlist::getFanInDegree,
+                                   get_fanin_degree_overloads())
+    .def("get_comb_connectivity",  &getCombConnectivity,
+                                   (arg("options")=object()))
+    .def("get_comb_loops",         &Netlist::getCombLoops)
+    .def("path_exists_batch",      &pathExistsBatch,
+                                   (arg("waypoints"), arg("options")=object()))
+    .def("get_any_path_batch",     &getAnyPathBatch,
+                                   (arg("waypoints"), arg("options")=object()))
+    .def("get_all_fanout_paths_batch", &getAllFanOutBatch,
+                                   (arg("start_names"), arg("options")=object()))
+    .def("get_any_path_array",     &getAnyPathArray,
+                                   (arg("waypoints"), arg("options")=object()))
+    .def("get_all_paths_array",    &getAllPathsArray,
+                                   (arg("waypoints"), arg("options")=object()))
+    .def("iterate_all_paths",      &iterateAllPaths,
+                                   (arg("waypoints"), arg("max_paths")=0,
+                                    arg("max_length")=0, arg("time_limit")=0.0,
+                                    arg("options")=object()),
+                                   with_custodian_and_ward_postcall<0, 1>())
+    .def("export_fanout_cone",     &exportFanOutCone,
+                                   (arg("start_name"), arg("filename"),
+                                    arg("format")=ExportFormat::DOT,
+                                    arg("max_depth")=0, arg("max_vertices")=0,
+                                    arg("options")=object()))
+    .def("export_fanin_cone",      &exportFanInCone,
+                                   (arg("end_name"), arg("filename"),
+                                    arg("format")=ExportFormat::DOT,
+                                    arg("max_depth")=0, arg("max_vertices")=0,
+                                    arg("options")=object()))
+    .def("export_paths",           &exportPaths,
+                                   (arg("waypoints"), arg("filename"),
+                                    arg("format")=ExportFormat::DOT,
+                                    arg("max_depth")=0, arg("max_vertices")=0,
+                                    arg("options")=object()))
+    .def("get_deepest_paths",      &getDeepestPaths,
+                                   (arg("waypoints"), arg("num_paths"),
+                                    arg("weights")=object(),
+                                    arg("options")=object()))
+    .def("get_deepest_fanout_paths", &getDeepestFanOut,
+                                   (arg("start_name"), arg("num_paths"),
+                                    arg("weights")=object(),
+                                    arg("options")=object()))
+    .def("get_deepest_fanin_paths", &getDeepestFanIn,
+                                   (arg("end_name"), arg("num_paths"),
+                                    arg("weights")=object(),
+                                    arg("options")=object()))
+    .def("get_path_depth",         &getPathDepth,
+                                   (arg("path"), arg("weights")=object()))
+    .def("get_all_fanout_paths_array", &getAllFanOutArray,
+                                   (arg("start_name"), arg("options")=object()))
+    .def("get_all_fanin_paths_array", &getAllFanInArray,
+                                   (arg("end_name"), arg("options")=object()))
+    .def("get_fanout_degrees",     &getFanOutDegrees,
+                                   (arg("options")=object()))
+    .def("get_fanin_degrees",      &getFanInDegrees,
+                                   (arg("options")=object()))
+    .def("get_vertex",             &Netlist::getVertexPtr,
+                                   return_value_policy<reference_existing_object>())
+    .def("get_vertex_columns",     &getVertexColumns)
     .def("get_dtype_width",        &Netlist::getDTypeWidth)
     .def("get_vertex_dtype_str",   &Netlist::getVertexDTypeStr,
                                    get_vertex_dtype_str_overloads())
     .def("get_vertex_dtype_width", &Netlist::getVertexDTypeWidth,
                                    get_vertex_dtype_width_overloads())
-    .def("dump_dot_file",          &Netlist::dumpDotFile);
+    .def("dump_dot_file",          &Netlist::dumpDotFile,
+                                   dump_dot_file_overloads())
+    .def("write_snapshot",         &Netlist::writeSnapshot)
+    .def("get_parser_peak_memory", &Netlist::getParserPeakMemory)
+    .def("build_reachability_index", &Netlist::buildReachabilityIndex)
+    .def("has_reachability_index", &Netlist::hasReachabilityIndex)
+    .def("set_traversal_cache_max_bytes", &Netlist::setTraversalCacheMaxBytes)
+    .def("get_traversal_cache_max_bytes", &Netlist::getTraversalCacheMaxBytes)
+    .def("clear_traversal_cache",  &Netlist::clearTraversalCache)
+    .def("get_stats",              &getStats)
+    .def("clear_stats",            &Netlist::clearStats);
 }
@@ -98,3 +98,46 @@ BOOST_FIXTURE_TEST_CASE(dtype_widths, TestContext) {
   BOOST_CHECK_THROW(np->getVertexDTypeWidth("dtypes.foo"), netlist_paths::Exception);
   BOOST_CHECK_THROW(np->getDTypeWidth("dtypes.foo"), netlist_paths::Exception);
 }
+
+/// The DTypeTable holds the width and string of each data type, and holds
+/// equivalent types once.
+BOOST_AUTO_TEST_CASE(dtype_table) {
+  using netlist_paths::DTypeTable;
+  Location location;
+  auto logic = std::make_shared<netlist_paths::BasicDType>("logic", location, 3, 0);
+  auto array = std::make_shared<netlist_paths::ArrayDType>(location, 0, 1, true);
+  array->setSubDType(logic);
+  auto unpacked = std::make_shared<netlist_paths::ArrayDType>(location, 0, 2, false);
+  unpacked->setSubDType(array);
+  netlist_paths::VertexTables tables;
+  auto &table = tables.dtypes;
+  auto index = table.add(unpacked);
+  BOOST_TEST(table.get(index).getStr() == unpacked->toString());
+  BOOST_TEST(table.get(index).getStr() == "[1:0] [3:0] logic [2:0]");
+  BOOST_TEST(table.get(index).getWidth() == unpacked->getWidth());
+  BOOST_TEST(table.get(index).getDType() == unpacked);
+  BOOST_TEST(table.get(table.add(array)).getWidth() == 8);
+  // Adding a type again, or an equivalent one, returns the same index.
+  auto size = table.size();
+  auto other = std::make_shared<netlist_paths::ArrayDType>(location, 0, 2, false);
+  other->setSubDType(array);
+  BOOST_TEST(table.add(unpacked) == index);
+  BOOST_TEST(table.add(other) == index);
+  BOOST_TEST(table.size() == size);
+  // Each table holds its own types.
+  DTypeTable otherTable;
+  BOOST_TEST(otherTable.add(array) == 0);
+  BOOST_TEST(otherTable.size() == 1);
+  // Vertices refer to their data types by index into the table of their graph.
+  netlist_paths::Vertex vertex(netlist_paths::VertexAstType::VAR,
+                               netlist_paths::VertexDirection::NONE, location,
+                               table.add(array), "top.a", false, "", false);
+  vertex.setTables(&tables);
+  BOOST_TEST(vertex.getDTypeStr() == "[1:0] [3:0] logic");
+  BOOST_TEST(vertex.getDTypeWidth() == 8);
+  BOOST_TEST(vertex.getDTypePtr() == array.get());
+  vertex.setDType(DTypeTable::NO_DTYPE);
+  BOOST_TEST(vertex.getDTypeStr() == "-");
+  BOOST_TEST(vertex.getDTypeWidth() == 0);
+  BOOST_TEST(vertex.getDTypePtr() == nullptr);
+}
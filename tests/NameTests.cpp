@@ -6,6 +6,8 @@
 #include <boost/test/unit_test.hpp>
 #include "tests/definitions.hpp"
 #include "TestContext.hpp"
+#include "netlist_paths/NameIndex.hpp"
+#include "netlist_paths/Pattern.hpp"
 #include "netlist_paths/Utilities.hpp"
 
 //===----------------------------------------------------------------------===//
@@ -65,6 +67,7 @@ BOOST_AUTO_TEST_CASE(wildcard_matching) {
   BOOST_TEST(netlist_paths::wildcardMatch("mississippi", "*s*p*"));
   BOOST_TEST(netlist_paths::wildcardMatch("mississippi", "**s*p**"));
   BOOST_TEST(netlist_paths::wildcardMatch("mississippi", "mi*i*i*i"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("foo", "*x"));
 }
 
 /// Test matching of names by wildcards and regexes.
@@ -163,3 +166,177 @@ BOOST_FIXTURE_TEST_CASE(hierarchy_separators_pipeline_module, TestContext) {
   BOOST_TEST(np->anyRegExists("*/*/u_pipestage/data_q")); // Hier slash
   BOOST_TEST(np->anyRegExists("*_*_u_pipestage_data_q")); // Flat
 }
+
+//===----------------------------------------------------------------------===//
+// Test the name index.
+//===----------------------------------------------------------------------===//
+
+/// Test the literal prefixes used to narrow searches of the name index.
+BOOST_AUTO_TEST_CASE(name_index_prefixes) {
+  BOOST_TEST(netlist_paths::NameIndex::getWildcardPrefix("foo.bar") == "foo.bar");
+  BOOST_TEST(netlist_paths::NameIndex::getWildcardPrefix("foo.*") == "foo.");
+  BOOST_TEST(netlist_paths::NameIndex::getWildcardPrefix("fo?.*") == "fo");
+  BOOST_TEST(netlist_paths::NameIndex::getWildcardPrefix("*foo") == "");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("foo") == "");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("^foo") == "foo");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("^foo.bar") == "foo");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("^foo*") == "fo");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("^foo+") == "foo");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("^foo{0,1}") == "fo");
+  BOOST_TEST(netlist_paths::NameIndex::getRegexPrefix("^foo|bar") == "");
+}
+
+/// Test lookups through the name index.
+BOOST_FIXTURE_TEST_CASE(name_index_lookup, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  // Named vertices are reported in sorted order.
+  auto vertices = np->getNamedVertices();
+  BOOST_TEST(vertices.size() == 5);
+  for (size_t i = 1; i < vertices.size(); ++i) {
+    BOOST_TEST(!vertices[i].get().compareLessThan(vertices[i-1].get()));
+  }
+  // Exact.
+  BOOST_TEST(np->getNamedVertices("i_clk").size() == 1);
+  BOOST_TEST(np->getNamedVertices("i_cl").size() == 0);
+  BOOST_TEST(np->getNamedVertices("assign_alias_regs.sum.add.register_q").size() == 1);
+  // Wildcard.
+  netlist_paths::Options::getInstance().setMatchWildcard();
+  BOOST_TEST(np->getNamedVertices("i_*").size() == 3);
+  BOOST_TEST(np->getNamedVertices("assign_alias_regs.sum.*").size() == 2);
+  BOOST_TEST(np->getNamedVertices("assign_alias_regs.sum.add.p?_sum").size() == 1);
+  BOOST_TEST(np->anyRegExists("assign_alias_regs.sum.add.r*"));
+  // Regex.
+  netlist_paths::Options::getInstance().setMatchRegex();
+  BOOST_TEST(np->getNamedVertices("^i_").size() == 3);
+  BOOST_TEST(np->getNamedVertices("^assign_alias_regs\\.sum").size() == 2);
+  BOOST_TEST(np->getNamedVertices("^assign_alias_regs.*register_q$").size() == 1);
+  BOOST_TEST(np->getNamedVertices("^i_clk|register_q").size() == 2);
+  BOOST_TEST(np->getNamedVertices("register").size() == 1);
+  // Ignoring hierarchy markers.
+  netlist_paths::Options::getInstance().setIgnoreHierarchyMarkers(true);
+  BOOST_TEST(np->getNamedVertices("^assign_alias_regs/sum/add/register_q").size() == 1);
+  netlist_paths::Options::getInstance().setMatchWildcard();
+  BOOST_TEST(np->getNamedVertices("assign_alias_regs_sum_add_register_q").size() == 1);
+}
+
+//===----------------------------------------------------------------------===//
+// Test compiled patterns.
+//===----------------------------------------------------------------------===//
+
+/// Test compiled wildcard patterns give the same results as wildcardMatch.
+BOOST_AUTO_TEST_CASE(compiled_wildcard_patterns) {
+  using netlist_paths::MatchType;
+  std::vector<std::string> patterns = {
+    "foo", "fo?", "?o?", "???", "f*", "*o", "*", "**", "*x", "*do", "*sip*",
+    "*s?p*", "*s*p*", "**s*p**", "mi*i*i*i", "*a*b*c*", ""};
+  std::vector<std::string> texts = {
+    "foo", "dadadadado", "mississippi", "abc", "xaxbxcx", "acb", ""};
+  for (auto &pattern : patterns) {
+    netlist_paths::Pattern compiled(pattern, MatchType::WILDCARD, false);
+    for (auto &text : texts) {
+      BOOST_TEST(compiled.match(text) == netlist_paths::wildcardMatch(text, pattern),
+                 pattern << " " << text);
+    }
+  }
+  // Patterns longer than a machine word.
+  std::string longPattern = std::string(100, 'a') + "*b";
+  netlist_paths::Pattern longCompiled(longPattern, MatchType::WILDCARD, false);
+  BOOST_TEST(longCompiled.match(std::string(100, 'a') + "xxb"));
+  BOOST_TEST(!longCompiled.match(std::string(99, 'a') + "xxb"));
+  // Backtracking is exponential in the number of stars.
+  netlist_paths::Pattern stars("*a*a*a*a*a*a*a*a*a*a*b", MatchType::WILDCARD, false);
+  BOOST_TEST(!stars.match(std::string(1000, 'a')));
+  // Hierarchy markers.
+  netlist_paths::Pattern markers("a.b/c_d", MatchType::WILDCARD, true);
+  BOOST_TEST(markers.match("a/b_c.d"));
+  BOOST_TEST(markers.getPrefix() == "a");
+}
+
+/// Test compiled regular expressions give the same results as std::regex.
+BOOST_AUTO_TEST_CASE(compiled_regex_patterns) {
+  using netlist_paths::MatchType;
+  std::vector<std::string> patterns = {
+    "foo", "^foo$", "f.o", "o+", "^o*$", "^(ab|cd)+$", "(?:ab){2,3}", "a{2}",
+    "a{1,}", "[a-c]+x", "[^a-z]", "\\.", "\\w+\\d", "\\s", "^$", "x?y?z?$",
+    "(a|)b", "a|b|c", "^a.*b$", "[\\]\\-]"};
+  std::vector<std::string> texts = {
+    "foo", "abab", "ababab", "cdab", "aa", "abcx", "a.b", "ab1", "a b", "",
+    "xyz", "ACB", "a]-b", "b"};
+  for (auto &pattern : patterns) {
+    netlist_paths::Pattern compiled(pattern, MatchType::REGEX, false);
+    BOOST_TEST(compiled.isCompiled(), pattern);
+    std::regex regex(pattern);
+    for (auto &text : texts) {
+      BOOST_TEST(compiled.match(text) == std::regex_search(text, regex),
+                 pattern << " " << text);
+    }
+  }
+  // Unsupported syntax falls back to std::regex.
+  netlist_paths::Pattern backref("(a)\\1", MatchType::REGEX, false);
+  BOOST_TEST(!backref.isCompiled());
+  BOOST_TEST(backref.match("xaax"));
+  BOOST_TEST(!backref.match("xabx"));
+  // Malformed expressions.
+  BOOST_CHECK_THROW(netlist_paths::Pattern("(a", MatchType::REGEX, false),
+                    netlist_paths::Exception);
+  // Matching is linear in the length of the text.
+  netlist_paths::Pattern nested("^(a+)+b$", MatchType::REGEX, false);
+  BOOST_TEST(nested.isCompiled());
+  BOOST_TEST(!nested.match(std::string(1000, 'a')));
+  // Expressions with too many DFA states are run on the NFA.
+  for (auto pattern : {"(a|b)*a(a|b){4}$", "(a|b)*a(a|b){16}$"}) {
+    netlist_paths::Pattern compiled(pattern, MatchType::REGEX, false);
+    BOOST_TEST(compiled.isCompiled());
+    std::regex regex(pattern);
+    for (auto text : {"abbbb", "babababababababababa", "aaaaabbbbbbbbbbbbbbbb",
+                      "bbbbbabbbbbbbbbbbbbbb", "abbbbbbbbbbbbbbbbbbbb"}) {
+      BOOST_TEST(compiled.match(text) == std::regex_search(text, regex),
+                 pattern << " " << text);
+    }
+  }
+}
+
+/// Test compiled patterns are cached.
+BOOST_AUTO_TEST_CASE(pattern_cache) {
+  using netlist_paths::MatchType;
+  netlist_paths::PatternCache cache;
+  auto a = cache.get("a*", MatchType::WILDCARD, false);
+  BOOST_TEST(cache.get("a*", MatchType::WILDCARD, false) == a);
+  BOOST_TEST(cache.get("a*", MatchType::WILDCARD, true) != a);
+  BOOST_TEST(cache.get("a*", MatchType::REGEX, false) != a);
+  BOOST_TEST(cache.size() == 3);
+  BOOST_CHECK_THROW(cache.get("(a", MatchType::REGEX, false),
+                    netlist_paths::Exception);
+  BOOST_TEST(cache.size() == 3);
+  cache.clear();
+  BOOST_TEST(cache.size() == 0);
+}
+
+/// Test the patterns of a path query are resolved together.
+BOOST_FIXTURE_TEST_CASE(waypoint_patterns, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  netlist_paths::Options::getInstance().setMatchWildcard();
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("i_e?", "assign_alias_regs.sum.add.register_*")));
+  {
+    auto waypoints = netlist_paths::Waypoints("i_e?", "assign_alias_regs.sum.add.register_*");
+    waypoints.addAvoidPoint("assign_alias_regs.sum.add.p?_sum");
+    BOOST_TEST(np->pathExists(waypoints));
+  }
+  // Errors are reported for the patterns of each type of point.
+  BOOST_CHECK_EXCEPTION(np->pathExists(netlist_paths::Waypoints("i_e?", "*register_q")),
+                        netlist_paths::Exception,
+                        [](const netlist_paths::Exception &e) {
+                          return std::string(e.what()).find("multiple vertices matching end point pattern") == 0; });
+  BOOST_CHECK_EXCEPTION(np->pathExists(netlist_paths::Waypoints("foo*", "*register_q")),
+                        netlist_paths::Exception,
+                        [](const netlist_paths::Exception &e) {
+                          return std::string(e.what()) == "could not find start vertex matching foo*"; });
+  {
+    auto waypoints = netlist_paths::Waypoints("i_e?", "assign_alias_regs.sum.add.register_*");
+    waypoints.addAvoidPoint("foo*");
+    BOOST_CHECK_EXCEPTION(np->pathExists(waypoints),
+                          netlist_paths::Exception,
+                          [](const netlist_paths::Exception &e) {
+                            return std::string(e.what()) == "could not find vertex to avoid foo*"; });
+  }
+}
@@ -3,7 +3,28 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
+#include <regex>
+#include <set>
+#include <thread>
 #include <boost/test/unit_test.hpp>
+#include "netlist_paths/CSRGraph.hpp"
+#include "netlist_paths/ComponentGraph.hpp"
+#include "netlist_paths/ConnectivityMatrix.hpp"
+#include "netlist_paths/DeepestPaths.hpp"
+#include "netlist_paths/FanDegree.hpp"
+#include "netlist_paths/PathSearch.hpp"
+#include "netlist_paths/ReachabilityIndex.hpp"
+#include "netlist_paths/Snapshot.hpp"
+#include "netlist_paths/ThreadPool.hpp"
+#include "netlist_paths/TraversalCache.hpp"
 #include "tests/definitions.hpp"
 #include "TestContext.hpp"
 
@@ -88,6 +109,966 @@ BOOST_FIXTURE_TEST_CASE(path_exists_pipeline_module, TestContext) {
                     netlist_paths::Exception);
 }
 
+BOOST_FIXTURE_TEST_CASE(path_exists_search_modes, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  // Check the depth-first and bidirectional searches agree with each other
+  // and with the paths that are reported.
+  auto startPoints = {"i_clk", "i_rst", "i_en"};
+  auto endPoint = "assign_alias_regs.sum.add.register_q";
+  auto midPoint = "assign_alias_regs.sum.add.p1_sum";
+  for (auto s : startPoints) {
+    for (bool bidirectional : {false, true}) {
+      netlist_paths::Options::getInstance().setBidirectionalSearch(bidirectional);
+      auto waypoints = netlist_paths::Waypoints(s, endPoint);
+      BOOST_TEST(np->pathExists(waypoints));
+      BOOST_TEST(!np->getAnyPath(waypoints).empty());
+      waypoints.addAvoidPoint(midPoint);
+      BOOST_TEST(np->pathExists(waypoints) == !np->getAnyPath(waypoints).empty());
+    }
+  }
+  netlist_paths::Options::getInstance().setBidirectionalSearch(false);
+}
+
+/// Test the CSR form of a graph and searches of it.
+BOOST_FIXTURE_TEST_CASE(path_csr_graph_search, TestContext) {
+  using netlist_paths::CSRGraph;
+  using netlist_paths::DTypeTable;
+  using netlist_paths::Edge;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  using netlist_paths::VertexDirection;
+  using netlist_paths::VertexIDVec;
+  Location location;
+  netlist_paths::InternalGraph graph;
+  boost::add_vertex(Vertex(VertexAstType::VAR, VertexDirection::INPUT, location,
+                           DTypeTable::NO_DTYPE, "a", false, "", false), graph);
+  boost::add_vertex(Vertex(VertexAstType::LOGIC, location), graph);
+  boost::add_vertex(Vertex(VertexAstType::LOGIC, location), graph);
+  boost::add_vertex(Vertex(VertexAstType::VAR, VertexDirection::NONE, location,
+                           DTypeTable::NO_DTYPE, "b", false, "", false), graph);
+  boost::add_vertex(Vertex(VertexAstType::VAR, VertexDirection::OUTPUT, location,
+                           DTypeTable::NO_DTYPE, "c", false, "", false), graph);
+  boost::add_edge(0, 2, Edge(true), graph);
+  boost::add_edge(0, 1, graph);
+  boost::add_edge(1, 3, graph);
+  boost::add_edge(2, 3, graph);
+  boost::add_edge(3, 4, graph);
+  CSRGraph csrGraph;
+  csrGraph.build(graph);
+  BOOST_TEST(csrGraph.numVertices() == 5);
+  BOOST_TEST(csrGraph.numEdges() == 5);
+  // Edges are kept in the order of the adjacency list.
+  auto &outEdges = csrGraph.getOutEdges();
+  BOOST_TEST(outEdges.degree(0) == 2);
+  auto range = outEdges.getEdges(0);
+  BOOST_TEST(outEdges.getVertex(range.first) == 2);
+  BOOST_TEST(outEdges.isThroughRegister(range.first));
+  BOOST_TEST(outEdges.getVertex(range.first + 1) == 1);
+  BOOST_TEST(!outEdges.isThroughRegister(range.first + 1));
+  auto &inEdges = csrGraph.getInEdges();
+  BOOST_TEST(inEdges.degree(3) == 2);
+  BOOST_TEST(inEdges.getVertex(inEdges.getEdges(3).first) == 1);
+  // Searches follow the edges through registers only when the option is set.
+  netlist_paths::QueryOptions options;
+  {
+    netlist_paths::PathSearch search(csrGraph, nullptr,
+                                     options.withTraverseRegisters(true));
+    BOOST_TEST((search.findPath(0, 4) == VertexIDVec{0, 2, 3, 4}));
+    BOOST_TEST(search.pathExistsBidirectional(0, 4));
+    BOOST_TEST(search.findAllPaths(0, 4).size() == 2);
+  }
+  {
+    netlist_paths::PathSearch search(csrGraph, nullptr, options);
+    BOOST_TEST((search.findPath(0, 4) == VertexIDVec{0, 1, 3, 4}));
+    BOOST_TEST(search.findAllPaths(0, 4).size() == 1);
+    search.visitTree(4, true);
+    BOOST_TEST(search.isVisited(0));
+    BOOST_TEST(search.isVisited(2));
+    BOOST_TEST((search.getTreePath(0) == VertexIDVec{0, 1, 3, 4}));
+  }
+  {
+    VertexIDVec avoidPoints = {1};
+    netlist_paths::PathSearch search(csrGraph, &avoidPoints, options);
+    BOOST_TEST(search.findPath(0, 4).empty());
+    BOOST_TEST(!search.pathExistsBidirectional(0, 4));
+    BOOST_TEST(search.findAllPaths(0, 4).empty());
+  }
+  {
+    // Avoiding one of the two paths through a register leaves the other.
+    VertexIDVec avoidPoints = {1};
+    netlist_paths::PathSearch search(csrGraph, &avoidPoints,
+                                     options.withTraverseRegisters(true));
+    BOOST_TEST((search.findPath(0, 4) == VertexIDVec{0, 2, 3, 4}));
+    BOOST_TEST(search.pathExistsBidirectional(0, 4));
+    BOOST_TEST(search.findAllPaths(0, 4).size() == 1);
+    search.visitTree(4, true);
+    BOOST_TEST(search.isVisited(0));
+    BOOST_TEST(!search.isVisited(1));
+  }
+  {
+    // The avoid points of one search are not kept by the next.
+    VertexIDVec avoidPoints = {2};
+    netlist_paths::PathSearch search(csrGraph, &avoidPoints, options);
+    BOOST_TEST((search.findPath(0, 4) == VertexIDVec{0, 1, 3, 4}));
+    search.clearSelection();
+    search.selectBetween(0, 4, 0, 0);
+    BOOST_TEST(search.getSelection().size() == 4);
+  }
+}
+
+/// Test the reachability index agrees with searches of a graph with cycles,
+/// with and without traversing registers.
+BOOST_FIXTURE_TEST_CASE(path_reachability_index, TestContext) {
+  using netlist_paths::CSRGraph;
+  using netlist_paths::Edge;
+  using netlist_paths::ReachabilityIndex;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  using netlist_paths::VertexIDVec;
+  Location location;
+  netlist_paths::InternalGraph graph;
+  for (size_t i = 0; i < 8; ++i) {
+    boost::add_vertex(Vertex(VertexAstType::LOGIC, location), graph);
+  }
+  boost::add_edge(0, 1, graph);
+  boost::add_edge(1, 2, graph);
+  boost::add_edge(2, 1, graph);
+  boost::add_edge(2, 3, Edge(true), graph);
+  boost::add_edge(3, 4, graph);
+  boost::add_edge(4, 3, Edge(true), graph);
+  boost::add_edge(4, 5, graph);
+  boost::add_edge(0, 6, graph);
+  boost::add_edge(6, 5, graph);
+  CSRGraph csrGraph;
+  csrGraph.build(graph);
+  VertexIDVec allVertices(8);
+  std::iota(allVertices.begin(), allVertices.end(), 0);
+  for (auto traverseRegisters : {false, true}) {
+    ReachabilityIndex index;
+    index.build(csrGraph, traverseRegisters);
+    BOOST_TEST(index.isBuilt());
+    BOOST_TEST(index.numVertices() == 8);
+    // {1, 2} is a cycle, and so is {3, 4} when registers are traversed.
+    BOOST_TEST(index.numComponents() == (traverseRegisters ? 6 : 7));
+    BOOST_TEST(index.getComponent(1) == index.getComponent(2));
+    BOOST_TEST((index.getComponent(3) == index.getComponent(4)) == traverseRegisters);
+    auto options = netlist_paths::QueryOptions().withTraverseRegisters(traverseRegisters);
+    netlist_paths::PathSearch search(csrGraph, nullptr, options);
+    for (auto start : allVertices) {
+      for (auto finish : allVertices) {
+        BOOST_TEST(index.reaches(start, finish) == search.pathExists(start, finish));
+      }
+      for (auto reverse : {false, true}) {
+        search.visitTree(start, reverse);
+        VertexIDVec visited;
+        std::copy_if(allVertices.begin(), allVertices.end(),
+                     std::back_inserter(visited),
+                     [&search](size_t v) { return search.isVisited(v); });
+        BOOST_TEST(index.selectReachable(start, allVertices, reverse) == visited);
+      }
+    }
+  }
+}
+
+/// Test the condensation of a graph into components, which are numbered in
+/// reverse topological order, and the detection of components with cycles.
+BOOST_FIXTURE_TEST_CASE(path_component_graph, TestContext) {
+  using netlist_paths::ComponentGraph;
+  using netlist_paths::Edge;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  Location location;
+  netlist_paths::InternalGraph graph;
+  for (size_t i = 0; i < 8; ++i) {
+    boost::add_vertex(Vertex(VertexAstType::LOGIC, location), graph);
+  }
+  boost::add_edge(0, 1, graph);
+  boost::add_edge(1, 2, graph);
+  boost::add_edge(2, 1, graph);
+  boost::add_edge(2, 3, graph);
+  boost::add_edge(2, 3, graph);
+  boost::add_edge(3, 4, Edge(true), graph);
+  boost::add_edge(4, 3, graph);
+  boost::add_edge(4, 5, graph);
+  boost::add_edge(6, 6, graph);
+  boost::add_edge(6, 7, graph);
+  boost::add_edge(7, 7, Edge(true), graph);
+  netlist_paths::CSRGraph csrGraph;
+  csrGraph.build(graph);
+  for (auto traverseRegisters : {false, true}) {
+    ComponentGraph components;
+    components.build(csrGraph, traverseRegisters);
+    BOOST_TEST(components.shouldTraverseRegisters() == traverseRegisters);
+    BOOST_TEST(components.numVertices() == 8);
+    BOOST_TEST(components.numComponents() == (traverseRegisters ? 6 : 7));
+    // The parallel edges from 2 to 3 are a single edge of the DAG.
+    BOOST_TEST(components.numEdges() == (traverseRegisters ? 4 : 5));
+    size_t numMembers = 0;
+    std::vector<size_t> cycles;
+    for (ComponentGraph::Index c = 0; c < components.numComponents(); ++c) {
+      auto members = components.getMembers(c);
+      BOOST_TEST(std::is_sorted(members.first, members.second));
+      for (auto it = members.first; it != members.second; ++it) {
+        BOOST_TEST(components.getComponent(*it) == c);
+      }
+      numMembers += members.second - members.first;
+      auto successors = components.getSuccessors(c);
+      for (auto it = successors.first; it != successors.second; ++it) {
+        BOOST_TEST(*it < c);
+        auto predecessors = components.getPredecessors(*it);
+        BOOST_TEST((std::find(predecessors.first, predecessors.second, c) != predecessors.second));
+      }
+      if (components.isCycle(csrGraph, c)) {
+        cycles.push_back(*members.first);
+      }
+    }
+    BOOST_TEST(numMembers == 8);
+    // {1, 2} and 6 are cycles, and {3, 4} and 7 when registers are traversed.
+    BOOST_TEST((cycles.size() == (traverseRegisters ? 4 : 2)));
+    BOOST_TEST((std::find(cycles.begin(), cycles.end(), 1) != cycles.end()));
+    BOOST_TEST((std::find(cycles.begin(), cycles.end(), 6) != cycles.end()));
+    BOOST_TEST(components.getComponent(6) > components.getComponent(7));
+  }
+}
+
+/// Test the deepest paths of a graph with a cycle are its simple paths in
+/// order of depth, in either direction, and respect the weights of the
+/// vertices and avoid points.
+BOOST_FIXTURE_TEST_CASE(path_deepest_paths_search, TestContext) {
+  using netlist_paths::ComponentGraph;
+  using netlist_paths::DeepestPaths;
+  using netlist_paths::PathSearch;
+  using netlist_paths::PathWeights;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  using netlist_paths::VertexIDVec;
+  Location location;
+  netlist_paths::InternalGraph graph;
+  for (size_t i = 0; i < 8; ++i) {
+    auto type = i == 4 ? VertexAstType::ALWAYS : VertexAstType::LOGIC;
+    boost::add_vertex(Vertex(type, location), graph);
+  }
+  boost::add_edge(0, 1, graph);
+  boost::add_edge(1, 2, graph);
+  boost::add_edge(2, 3, graph);
+  boost::add_edge(3, 7, graph);
+  boost::add_edge(0, 4, graph);
+  boost::add_edge(4, 7, graph);
+  boost::add_edge(0, 5, graph);
+  boost::add_edge(0, 6, graph);
+  boost::add_edge(5, 6, graph);
+  boost::add_edge(6, 5, graph);
+  boost::add_edge(5, 7, graph);
+  boost::add_edge(6, 7, graph);
+  netlist_paths::CSRGraph csrGraph;
+  csrGraph.build(graph);
+  ComponentGraph components;
+  components.build(csrGraph, false);
+  netlist_paths::QueryOptions options;
+  auto findDeepest = [&](size_t numPaths, bool reverse,
+                         const VertexIDVec *avoidPoints,
+                         const PathWeights &weights) {
+    PathSearch search(csrGraph, avoidPoints, options);
+    search.clearSelection();
+    if (reverse) {
+      search.selectCone(7, true, 0, 0);
+    } else {
+      search.selectBetween(0, 7, 0, 0);
+    }
+    std::vector<double> vertexWeights;
+    for (auto vertex : search.getSelection()) {
+      vertexWeights.push_back(weights.getWeight(graph[vertex].getAstType()));
+    }
+    DeepestPaths paths(components, numPaths, reverse);
+    paths.start(reverse ? 7 : 0, 1);
+    paths.extend(search, vertexWeights, {reverse ? 0UL : 7UL});
+    return std::make_pair(paths.getPaths(), paths.getDepths());
+  };
+  std::set<VertexIDVec> allPaths;
+  {
+    PathSearch search(csrGraph, nullptr, options);
+    for (auto path : search.findAllPaths(0, 7)) {
+      std::reverse(path.begin(), path.end());
+      allPaths.insert(path);
+    }
+  }
+  BOOST_TEST(allPaths.size() == 6);
+  // With room for every path, all the simple paths are found, in either
+  // direction, including both of those around the cycle {5, 6}.
+  for (auto reverse : {false, true}) {
+    auto deepest = findDeepest(10, reverse, nullptr, PathWeights());
+    BOOST_TEST(std::set<VertexIDVec>(deepest.first.begin(), deepest.first.end()) == allPaths);
+    BOOST_TEST((deepest.second == std::vector<double>{5, 4, 4, 3, 3, 3}));
+    for (size_t i = 0; i < deepest.first.size(); ++i) {
+      BOOST_TEST(deepest.second[i] == deepest.first[i].size());
+    }
+  }
+  // Only the deepest paths are kept.
+  auto deepest = findDeepest(3, false, nullptr, PathWeights());
+  BOOST_TEST((deepest.second == std::vector<double>{5, 4, 4}));
+  BOOST_TEST((deepest.first.front() == VertexIDVec{0, 1, 2, 3, 7}));
+  // The weights of the types of vertices.
+  auto weights = PathWeights().withWeight(VertexAstType::ALWAYS, 10);
+  deepest = findDeepest(1, false, nullptr, weights);
+  BOOST_TEST((deepest.first == std::vector<VertexIDVec>{{0, 4, 7}}));
+  BOOST_TEST((deepest.second == std::vector<double>{12}));
+  // Avoid points.
+  VertexIDVec avoidPoints = {1};
+  deepest = findDeepest(2, false, &avoidPoints, PathWeights());
+  BOOST_TEST((std::set<VertexIDVec>(deepest.first.begin(), deepest.first.end()) ==
+              std::set<VertexIDVec>{{0, 5, 6, 7}, {0, 6, 5, 7}}));
+}
+
+/// Test queries answered by the reachability index of a netlist agree with
+/// searches, and that the index is saved in snapshots.
+BOOST_FIXTURE_TEST_CASE(path_reachability_index_queries, TestContext) {
+  auto &options = netlist_paths::Options::getInstance();
+  options.setReachabilityIndex(true);
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  BOOST_TEST(np->hasReachabilityIndex());
+  options.setMatchAnyVertex();
+  std::vector<std::string> startPoints;
+  std::vector<std::string> endPoints;
+  for (auto vertex : np->getNamedVerticesPtr()) {
+    std::string name(vertex->getName());
+    if (np->anyStartpointExists(name)) {
+      startPoints.push_back(name);
+    }
+    if (np->anyEndpointExists(name)) {
+      endPoints.push_back(name);
+    }
+  }
+  BOOST_TEST(!startPoints.empty());
+  BOOST_TEST(!endPoints.empty());
+  auto checkQueries = [&]() {
+    for (auto traverseRegisters : {false, true}) {
+      options.setTraverseRegisters(traverseRegisters);
+      for (auto &startPoint : startPoints) {
+        for (auto &endPoint : endPoints) {
+          netlist_paths::Waypoints waypoints(startPoint, endPoint);
+          BOOST_TEST(np->pathExists(waypoints) == !np->getAnyPath(waypoints).empty());
+        }
+        std::vector<netlist_paths::Vertex*> fanOutEnds;
+        for (auto &path : np->getAllFanOut(startPoint)) {
+          fanOutEnds.push_back(path.back());
+        }
+        BOOST_TEST(np->getFanOutEndPoints(startPoint) == fanOutEnds);
+      }
+      for (auto &endPoint : endPoints) {
+        std::vector<netlist_paths::Vertex*> fanInStarts;
+        for (auto &path : np->getAllFanIn(endPoint)) {
+          fanInStarts.push_back(path.front());
+        }
+        BOOST_TEST(np->getFanInStartPoints(endPoint) == fanInStarts);
+      }
+    }
+    options.setTraverseRegisters(false);
+  };
+  checkQueries();
+  // The index is read from a snapshot without the option being set.
+  options.setReachabilityIndex(false);
+  auto snapshotPath = fs::unique_path();
+  np->writeSnapshot(snapshotPath.native());
+  np = std::make_unique<netlist_paths::Netlist>(snapshotPath.native());
+  fs::remove(snapshotPath);
+  BOOST_TEST(np->hasReachabilityIndex());
+  checkQueries();
+}
+
+/// Test the bulk connectivity matrix agrees with the reachability index, with
+/// enough start points for several blocks.
+BOOST_FIXTURE_TEST_CASE(path_connectivity_matrix, TestContext) {
+  using netlist_paths::ConnectivityMatrix;
+  using netlist_paths::Edge;
+  using netlist_paths::ReachabilityIndex;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  Location location;
+  netlist_paths::InternalGraph graph;
+  const size_t numVertices = 1000;
+  for (size_t i = 0; i < numVertices; ++i) {
+    boost::add_vertex(Vertex(VertexAstType::LOGIC, location), graph);
+  }
+  // Mostly forward edges, with some backward edges to create cycles and some
+  // through registers.
+  std::mt19937 random(1);
+  for (size_t i = 0; i < 2000; ++i) {
+    size_t a = random() % numVertices;
+    size_t b = random() % numVertices;
+    if (a > b && random() % 8) {
+      std::swap(a, b);
+    }
+    boost::add_edge(a, b, Edge(random() % 4 == 0), graph);
+  }
+  netlist_paths::CSRGraph csrGraph;
+  csrGraph.build(graph);
+  std::vector<size_t> startPoints;
+  std::vector<size_t> endPoints;
+  for (size_t i = 0; i < numVertices; ++i) {
+    if (i % 3 != 2) {
+      startPoints.push_back(i);
+    }
+    if (i % 2) {
+      endPoints.push_back(i);
+    }
+  }
+  BOOST_TEST(startPoints.size() > 2 * ConnectivityMatrix::BLOCK_WIDTH);
+  for (auto traverseRegisters : {false, true}) {
+    ReachabilityIndex index;
+    index.build(csrGraph, traverseRegisters);
+    auto matrix = ConnectivityMatrix::build(index, startPoints, endPoints);
+    size_t numPairs = 0;
+    for (size_t row = 0; row < startPoints.size(); ++row) {
+      for (size_t column = 0; column < endPoints.size(); ++column) {
+        bool expected = startPoints[row] != endPoints[column] &&
+                        index.reaches(startPoints[row], endPoints[column]);
+        BOOST_TEST(matrix.test(row, column) == expected);
+        numPairs += expected;
+      }
+    }
+    BOOST_TEST(matrix.numPairs() == numPairs);
+    BOOST_TEST(matrix.getPairs().size() == numPairs);
+    BOOST_TEST(numPairs > 0);
+    // The blocks are independent of the number of threads.
+    BOOST_TEST((ConnectivityMatrix::build(index, startPoints, endPoints, 1).getPairs() ==
+                matrix.getPairs()));
+  }
+}
+
+/// Test the connectivity of a netlist agrees with the fan out of each start
+/// point.
+BOOST_FIXTURE_TEST_CASE(path_comb_connectivity, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto pairs = np->getCombConnectivity();
+  BOOST_TEST(!pairs.empty());
+  std::map<std::string, std::set<netlist_paths::Vertex*>> rows;
+  for (auto &pair : pairs) {
+    BOOST_TEST(pair.size() == 2);
+    BOOST_TEST(pair[0]->isCombStartPoint());
+    BOOST_TEST(pair[1]->isCombEndPoint());
+    rows[std::string(pair[0]->getName())].insert(pair[1]);
+  }
+  for (auto startPoint : {"i_clk", "i_rst", "i_en"}) {
+    auto endPoints = np->getFanOutEndPoints(startPoint);
+    BOOST_TEST(!endPoints.empty());
+    BOOST_TEST((rows[startPoint] ==
+                std::set<netlist_paths::Vertex*>(endPoints.begin(),
+                                                 endPoints.end())));
+  }
+}
+
+/// Test the fan degrees counted over the component DAG of a graph with a
+/// cycle, individually and in bulk, and that path counts saturate.
+BOOST_FIXTURE_TEST_CASE(path_fan_degree_counts, TestContext) {
+  using netlist_paths::FanDegree;
+  using netlist_paths::FanDegreeColumns;
+  using netlist_paths::ReachabilityIndex;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  Location location;
+  netlist_paths::InternalGraph graph;
+  for (size_t i = 0; i < 8; ++i) {
+    boost::add_vertex(Vertex(VertexAstType::LOGIC, location), graph);
+  }
+  boost::add_edge(0, 1, graph);
+  boost::add_edge(0, 2, graph);
+  boost::add_edge(1, 3, graph);
+  boost::add_edge(2, 3, graph);
+  boost::add_edge(3, 4, graph);
+  boost::add_edge(1, 4, graph);
+  boost::add_edge(4, 5, graph);
+  boost::add_edge(5, 6, graph);
+  boost::add_edge(6, 5, graph);
+  boost::add_edge(6, 7, graph);
+  netlist_paths::CSRGraph csrGraph;
+  csrGraph.build(graph);
+  ReachabilityIndex index;
+  index.build(csrGraph, false);
+  std::vector<size_t> startPoints = {0, 1, 5};
+  std::vector<uint64_t> startWidths = {1, 2, 4};
+  std::vector<size_t> endPoints = {3, 4, 7};
+  std::vector<uint64_t> endWidths = {8, 16, 32};
+  // From 0 there are two paths to 3, three to 4 and three to 7, since the
+  // cycle {5, 6} counts once.
+  auto fanOut = FanDegree::count(index, 0, endPoints, endWidths);
+  BOOST_TEST(fanOut.numPoints == 3);
+  BOOST_TEST(fanOut.numPaths == 8);
+  BOOST_TEST(fanOut.numBits == 56);
+  fanOut = FanDegree::count(index, 5, endPoints, endWidths);
+  BOOST_TEST(fanOut.numPoints == 1);
+  BOOST_TEST(fanOut.numPaths == 1);
+  BOOST_TEST(fanOut.numBits == 32);
+  // A root that is one of the points reaches itself.
+  fanOut = FanDegree::count(index, 4, endPoints, endWidths);
+  BOOST_TEST(fanOut.numPoints == 2);
+  BOOST_TEST(fanOut.numPaths == 2);
+  auto fanIn = FanDegree::count(index, 7, startPoints, startWidths, true);
+  BOOST_TEST(fanIn.numPoints == 3);
+  BOOST_TEST(fanIn.numPaths == 6);
+  BOOST_TEST(fanIn.numBits == 7);
+  // The bulk counts agree with the individual ones.
+  std::vector<size_t> allVertices(8);
+  std::iota(allVertices.begin(), allVertices.end(), 0);
+  for (auto reverse : {false, true}) {
+    auto &points = reverse ? startPoints : endPoints;
+    auto &widths = reverse ? startWidths : endWidths;
+    auto columns = FanDegreeColumns::count(index, allVertices, points, widths, reverse);
+    BOOST_TEST(columns.size() == allVertices.size());
+    for (size_t row = 0; row < columns.size(); ++row) {
+      BOOST_TEST(columns.vertices[row] == allVertices[row]);
+      auto degree = FanDegree::count(index, allVertices[row], points, widths, reverse);
+      BOOST_TEST(columns.numPoints[row] == degree.numPoints);
+      BOOST_TEST(columns.numPaths[row] == degree.numPaths);
+      BOOST_TEST(columns.numBits[row] == degree.numBits);
+    }
+  }
+  // A chain of 70 diamonds has 2^70 paths.
+  netlist_paths::InternalGraph diamonds;
+  const size_t numDiamonds = 70;
+  for (size_t i = 0; i < 3 * numDiamonds + 1; ++i) {
+    boost::add_vertex(Vertex(VertexAstType::LOGIC, location), diamonds);
+  }
+  for (size_t i = 0; i < numDiamonds; ++i) {
+    boost::add_edge(3 * i, 3 * i + 1, diamonds);
+    boost::add_edge(3 * i, 3 * i + 2, diamonds);
+    boost::add_edge(3 * i + 1, 3 * (i + 1), diamonds);
+    boost::add_edge(3 * i + 2, 3 * (i + 1), diamonds);
+  }
+  csrGraph.build(diamonds);
+  index.build(csrGraph, false);
+  std::vector<size_t> last = {3 * numDiamonds};
+  fanOut = FanDegree::count(index, 0, last, {1});
+  BOOST_TEST(fanOut.numPoints == 1);
+  BOOST_TEST(fanOut.isSaturated());
+  BOOST_TEST(FanDegreeColumns::count(index, {0}, last, {1}).numPaths[0] == FanDegree::MAX_PATHS);
+  fanOut = FanDegree::count(index, 3 * (numDiamonds - 10), last, {1});
+  BOOST_TEST(fanOut.numPaths == 1024);
+}
+
+/// Test the fan degrees of a netlist agree with the fan out end points, the
+/// widths of their data types and the number of distinct paths to each of
+/// them.
+BOOST_FIXTURE_TEST_CASE(path_fan_degree, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto options = netlist_paths::QueryOptions().withMatchOneVertex(false);
+  for (auto startPoint : {"i_clk", "i_rst", "i_en"}) {
+    auto endPoints = np->getFanOutEndPoints(startPoint, options);
+    BOOST_TEST(!endPoints.empty());
+    uint64_t numPaths = 0;
+    uint64_t numBits = 0;
+    for (auto endPoint : endPoints) {
+      netlist_paths::Waypoints waypoints(startPoint, std::string(endPoint->getName()));
+      // Parallel edges make getAllPaths() return some paths more than once.
+      auto paths = np->getAllPaths(waypoints, options);
+      numPaths += std::set<std::vector<netlist_paths::Vertex*>>(paths.begin(), paths.end()).size();
+      numBits += endPoint->getDTypeWidth();
+    }
+    auto degree = np->getFanOutDegree(startPoint, options);
+    BOOST_TEST(degree.numPoints == endPoints.size());
+    BOOST_TEST(degree.numPaths == numPaths);
+    BOOST_TEST(degree.numBits == numBits);
+    BOOST_TEST(numBits > 0);
+  }
+  // The bulk counts agree with the individual ones.
+  for (auto fanIn : {false, true}) {
+    auto degrees = fanIn ? np->getFanInDegrees(options)
+                         : np->getFanOutDegrees(options);
+    BOOST_TEST(degrees.size() > 0);
+    for (size_t row = 0; row < degrees.size(); ++row) {
+      auto name = std::string(np->getVertexPtr(degrees.vertices[row])->getName());
+      auto degree = fanIn ? np->getFanInDegree(name, options)
+                          : np->getFanOutDegree(name, options);
+      BOOST_TEST(degrees.numPoints[row] == degree.numPoints);
+      BOOST_TEST(degrees.numPaths[row] == degree.numPaths);
+      BOOST_TEST(degrees.numBits[row] == degree.numBits);
+    }
+  }
+  BOOST_CHECK_THROW(np->getFanOutDegree("foo", options), netlist_paths::Exception);
+  BOOST_CHECK_THROW(np->getFanInDegree("foo", options), netlist_paths::Exception);
+}
+
+/// Test a netlist whose loops all pass through registers has no
+/// combinational loops.
+BOOST_FIXTURE_TEST_CASE(path_comb_loops_none, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  BOOST_TEST(np->getCombLoops().empty());
+}
+
+/// Test the combinational loops of a netlist are reported with their named
+/// vertices, and loops through registers are not.
+BOOST_FIXTURE_TEST_CASE(path_comb_loops, TestContext) {
+  BOOST_CHECK_NO_THROW(compile("comb_loops.sv"));
+  auto loops = np->getCombLoops();
+  BOOST_TEST(loops.size() == 2);
+  std::set<std::vector<std::string>> names;
+  for (auto &loop : loops) {
+    std::vector<std::string> loopNames;
+    for (auto vertex : loop) {
+      loopNames.push_back(std::string(vertex->getName()));
+    }
+    names.insert(loopNames);
+  }
+  BOOST_TEST((names.count({"comb_loops.a", "comb_loops.b"}) == 1));
+  BOOST_TEST((names.count({"comb_loops.c"}) == 1));
+}
+
+/// Test enumerations of paths produce the paths of getAllPaths() in order,
+/// can be interleaved with other queries, and respect their limits.
+BOOST_FIXTURE_TEST_CASE(path_enumeration, TestContext) {
+  using netlist_paths::PathLimits;
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto options = netlist_paths::QueryOptions().withMatchOneVertex(false)
+                                              .withTraverseRegisters(true);
+  std::vector<netlist_paths::Waypoints> queries;
+  for (auto startPoint : {"i_clk", "i_rst", "i_en"}) {
+    for (auto endPoint : np->getFanOutEndPoints(startPoint, options)) {
+      queries.emplace_back(startPoint, std::string(endPoint->getName()));
+    }
+  }
+  BOOST_TEST(!queries.empty());
+  size_t numMultiplePaths = 0;
+  for (auto &waypoints : queries) {
+    auto paths = np->getAllPaths(waypoints, options);
+    BOOST_TEST(!paths.empty());
+    numMultiplePaths += paths.size() > 1;
+    // Advance two enumerations of the same paths alternately, with another
+    // query between each step.
+    auto first = np->enumerateAllPaths(waypoints, PathLimits(), options);
+    auto second = np->enumerateAllPaths(waypoints, PathLimits(), options);
+    for (auto &path : paths) {
+      BOOST_TEST(first.next());
+      BOOST_TEST(np->pathExists(waypoints, options));
+      BOOST_TEST(second.next());
+      BOOST_TEST(first.getPath().size() == path.size());
+      for (size_t i = 0; i < path.size(); ++i) {
+        BOOST_TEST(np->getVertexPtr(first.getPath()[i]) == path[i]);
+      }
+      BOOST_TEST((first.getPath() == second.getPath()));
+    }
+    BOOST_TEST(!first.next());
+    BOOST_TEST(!first.isTruncated());
+    BOOST_TEST(first.getNumPaths() == paths.size());
+    // The maximum number of paths.
+    auto limited = np->enumerateAllPaths(waypoints, PathLimits().withMaxPaths(1), options);
+    BOOST_TEST(std::distance(limited.begin(), limited.end()) == 1);
+    BOOST_TEST(limited.isTruncated() == (paths.size() > 1));
+    // The maximum length of paths.
+    auto maxLength = paths.front().size();
+    auto numShortPaths = std::count_if(paths.begin(), paths.end(),
+        [&](const std::vector<netlist_paths::Vertex*> &path) {
+          return path.size() <= maxLength; });
+    auto shortPaths = np->enumerateAllPaths(waypoints, PathLimits().withMaxLength(maxLength), options);
+    size_t numPaths = 0;
+    for (auto &path : shortPaths) {
+      BOOST_TEST(path.size() <= maxLength);
+      ++numPaths;
+    }
+    BOOST_TEST(numPaths == static_cast<size_t>(numShortPaths));
+  }
+  BOOST_TEST(numMultiplePaths > 0);
+}
+
+/// Test the deepest paths of a netlist are its paths in order of depth, and
+/// the deepest fan out and fan in paths are at least as deep as the others.
+BOOST_FIXTURE_TEST_CASE(path_deepest_paths, TestContext) {
+  using netlist_paths::PathWeights;
+  using netlist_paths::Vertex;
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto options = netlist_paths::QueryOptions().withMatchOneVertex(false)
+                                              .withTraverseRegisters(true);
+  PathWeights weights;
+  auto isOrdered = [&](const std::vector<std::vector<Vertex*>> &paths) {
+    return std::is_sorted(paths.begin(), paths.end(),
+                          [&](const std::vector<Vertex*> &a, const std::vector<Vertex*> &b) {
+                            return weights.getDepth(a) > weights.getDepth(b); });
+  };
+  auto getMaxDepth = [&](const std::vector<std::vector<Vertex*>> &paths) {
+    double maxDepth = 0;
+    for (auto &path : paths) {
+      maxDepth = std::max(maxDepth, weights.getDepth(path));
+    }
+    return maxDepth;
+  };
+  std::string endName;
+  for (auto startPoint : {"i_clk", "i_rst", "i_en"}) {
+    for (auto endPoint : np->getFanOutEndPoints(startPoint, options)) {
+      endName = std::string(endPoint->getName());
+      netlist_paths::Waypoints waypoints(startPoint, endName);
+      auto paths = np->getAllPaths(waypoints, options);
+      BOOST_TEST(paths.size() < 100);
+      // Paths over parallel edges are only found once.
+      std::set<std::vector<Vertex*>> distinctPaths(paths.begin(), paths.end());
+      auto deepest = np->getDeepestPaths(waypoints, 100, weights, options);
+      BOOST_TEST(deepest.size() == distinctPaths.size());
+      BOOST_TEST((std::set<std::vector<Vertex*>>(deepest.begin(), deepest.end()) ==
+                  distinctPaths));
+      BOOST_TEST(isOrdered(deepest));
+      deepest = np->getDeepestPaths(waypoints, 1, weights, options);
+      BOOST_TEST(deepest.size() == 1);
+      BOOST_TEST(weights.getDepth(deepest.front()) == getMaxDepth(paths));
+    }
+    auto fanOut = np->getDeepestFanOut(startPoint, 3, weights, options);
+    BOOST_TEST(!fanOut.empty());
+    BOOST_TEST(fanOut.size() <= 3);
+    BOOST_TEST(isOrdered(fanOut));
+    BOOST_TEST(weights.getDepth(fanOut.front()) >=
+               getMaxDepth(np->getAllFanOut(startPoint, options)));
+    for (auto &path : fanOut) {
+      BOOST_TEST(path.front()->getName() == startPoint);
+      BOOST_TEST(path.back()->isEndPoint());
+    }
+  }
+  auto fanIn = np->getDeepestFanIn(endName, 3, weights, options);
+  BOOST_TEST(!fanIn.empty());
+  BOOST_TEST(isOrdered(fanIn));
+  BOOST_TEST(weights.getDepth(fanIn.front()) >=
+             getMaxDepth(np->getAllFanIn(endName, options)));
+  for (auto &path : fanIn) {
+    BOOST_TEST(path.front()->isStartPoint());
+    BOOST_TEST(path.back()->getName() == endName);
+  }
+  BOOST_CHECK_THROW(np->getDeepestPaths(netlist_paths::Waypoints("i_clk", endName), 0),
+                    netlist_paths::Exception);
+}
+
+/// Test path arrays of vertex IDs contain the same paths as the vertex
+/// queries, and the columns of their vertices match the vertices.
+BOOST_FIXTURE_TEST_CASE(path_arrays, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  for (auto startPoint : {"i_clk", "i_rst", "i_en"}) {
+    auto paths = np->getAllFanOut(startPoint);
+    auto array = np->getAllFanOutArray(startPoint);
+    BOOST_TEST(!paths.empty());
+    BOOST_TEST(array.numPaths() == paths.size());
+    BOOST_TEST(array.getOffsets().size() == paths.size() + 1);
+    BOOST_TEST(array.getOffsets().back() == array.getVertices().size());
+    auto columns = np->getVertexColumns(array.getVertices());
+    BOOST_TEST(columns.names.size() == array.getVertices().size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      auto path = array.getPath(i);
+      BOOST_TEST(static_cast<size_t>(path.second - path.first) == paths[i].size());
+      for (size_t j = 0; j < paths[i].size(); ++j) {
+        auto vertex = paths[i][j];
+        auto row = array.getOffsets()[i] + j;
+        BOOST_TEST(np->getVertexPtr(path.first[j]) == vertex);
+        BOOST_TEST(columns.names[row] == vertex->getName());
+        BOOST_TEST(std::string(columns.astTypes[row]) == vertex->getSimpleAstTypeStr());
+        BOOST_TEST(std::string(columns.directions[row]) == vertex->getDirStr());
+        BOOST_TEST(columns.dtypes[row] == vertex->getDTypeStr());
+        BOOST_TEST(columns.widths[row] == vertex->getDTypeWidth());
+        BOOST_TEST(columns.locations[row] == vertex->getLocationStr());
+        BOOST_TEST(columns.isLogic[row] == vertex->isLogic());
+      }
+    }
+  }
+  auto endPoint = std::string(np->getFanOutEndPoints("i_clk").front()->getName());
+  auto waypoints = netlist_paths::Waypoints("i_clk", endPoint);
+  auto path = np->getAnyPath(waypoints);
+  auto array = np->getAnyPathArray(waypoints);
+  BOOST_TEST(array.numPaths() == 1);
+  BOOST_TEST(!path.empty());
+  BOOST_TEST(array.getVertices().size() == path.size());
+  BOOST_CHECK_THROW(np->getVertexPtr(array.getVertices().size() + 1000000),
+                    netlist_paths::Exception);
+}
+
+/// Test queries with different options running concurrently on one netlist
+/// agree with the same queries run one at a time.
+BOOST_FIXTURE_TEST_CASE(path_concurrent_query_options, TestContext) {
+  using netlist_paths::QueryOptions;
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto combOptions = QueryOptions().withMatchOneVertex(false);
+  auto allOptions = combOptions.withTraverseRegisters(true)
+                               .withRestrictStartPoints(false)
+                               .withRestrictEndPoints(false)
+                               .withBidirectionalSearch(true);
+  std::vector<std::string> names;
+  for (auto vertex : np->getNamedVerticesPtr()) {
+    names.emplace_back(vertex->getName());
+  }
+  BOOST_TEST(!names.empty());
+  // Return the results of path and fan out queries between all the names.
+  auto runQueries = [&](const QueryOptions &options) {
+    std::vector<size_t> results;
+    for (auto &startPoint : names) {
+      if (!np->anyStartpointExists(startPoint, options)) {
+        results.push_back(0);
+        continue;
+      }
+      for (auto &endPoint : names) {
+        if (np->anyEndpointExists(endPoint, options)) {
+          netlist_paths::Waypoints waypoints(startPoint, endPoint);
+          results.push_back(np->pathExists(waypoints, options));
+          results.push_back(np->getAnyPath(waypoints, options).size());
+        }
+      }
+      results.push_back(np->getFanOutEndPoints(startPoint, options).size());
+    }
+    return results;
+  };
+  auto combResults = runQueries(combOptions);
+  auto allResults = runQueries(allOptions);
+  BOOST_TEST((combResults != allResults));
+  // The global options are only the default.
+  BOOST_TEST(!np->anyStartpointExists("assign_alias_regs.sum.add.p1_sum"));
+  BOOST_TEST(np->anyStartpointExists("assign_alias_regs.sum.add.p1_sum", allOptions));
+  const size_t numThreads = 4;
+  std::vector<std::vector<size_t>> threadResults(numThreads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      threadResults[i] = runQueries(i % 2 ? allOptions : combOptions);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < numThreads; ++i) {
+    BOOST_TEST(threadResults[i] == (i % 2 ? allResults : combResults),
+               boost::test_tools::per_element());
+  }
+}
+
+/// Test a work-stealing loop runs every iteration once, with uneven amounts
+/// of work, and reports exceptions.
+BOOST_AUTO_TEST_CASE(thread_pool_parallel_for) {
+  netlist_paths::ThreadPool pool(4);
+  BOOST_TEST(pool.getNumThreads() == 4);
+  for (size_t numIterations : {0, 1, 3, 1000}) {
+    std::vector<std::atomic<int>> counts(numIterations);
+    pool.parallelFor(numIterations, [&](size_t i) {
+      // Make the iterations at the start much slower than the others.
+      volatile size_t work = 0;
+      for (size_t j = 0; j < (i < numIterations / 4 ? 10000 : 10); ++j) {
+        work += j;
+      }
+      ++counts[i];
+    });
+    BOOST_TEST(std::all_of(counts.begin(), counts.end(),
+                           [](const std::atomic<int> &count) { return count == 1; }));
+  }
+  BOOST_CHECK_THROW(pool.parallelFor(100, [](size_t i) {
+                      if (i == 50) {
+                        throw netlist_paths::Exception("iteration failed");
+                      }
+                    }), netlist_paths::Exception);
+}
+
+/// Test the passes over the graph after it is read produce the same graph on
+/// one thread as on several, with enough vertices to analyse them in parallel.
+BOOST_AUTO_TEST_CASE(graph_passes_threads) {
+  using netlist_paths::VertexAstType;
+  using netlist_paths::VertexDirection;
+  auto buildGraph = [](netlist_paths::Graph &graph) {
+    auto addVar = [&](const std::string &name) {
+      return graph.addVarVertex(VertexAstType::VAR, VertexDirection::NONE,
+                                Location(),
+                                netlist_paths::DTypeTable::NO_DTYPE, name,
+                                false, "", false);
+    };
+    auto addLogic = [&](VertexAstType type) {
+      return graph.addLogicVertex(type, Location());
+    };
+    netlist_paths::VertexID prev = addVar("top.in");
+    for (size_t i = 0; i < 1500; ++i) {
+      auto n = std::to_string(i);
+      // in -> LOGIC -> reg -> ASSIGN_ALIAS -> alias, reg -> LOGIC -> out.
+      auto reg = addVar("top.reg_" + n);
+      graph.setVertexDstReg(reg);
+      auto logicIn = addLogic(VertexAstType::LOGIC);
+      graph.addEdge(prev, logicIn);
+      graph.addEdge(logicIn, reg);
+      auto regAlias = addLogic(VertexAstType::ASSIGN_ALIAS);
+      auto alias = addVar("top.alias_" + n);
+      graph.addEdge(reg, regAlias);
+      graph.addEdge(regAlias, alias);
+      auto logicOut = addLogic(VertexAstType::LOGIC);
+      auto out = addVar("top.out_" + n);
+      graph.addEdge(reg, logicOut);
+      graph.addEdge(alias, logicOut);
+      graph.addEdge(logicOut, out);
+      // out -> ASSIGN_ALIAS -> var.
+      auto varAlias = addLogic(VertexAstType::ASSIGN_ALIAS);
+      auto var = addVar("top.var_" + n);
+      graph.addEdge(out, varAlias);
+      graph.addEdge(varAlias, var);
+      prev = var;
+    }
+  };
+  auto runPasses = [&](size_t numThreads) {
+    netlist_paths::Graph graph;
+    buildGraph(graph);
+    BOOST_TEST(graph.numVertices() > 2 * 4096);
+    graph.markAliasRegisters(numThreads);
+    graph.splitRegVertices(numThreads);
+    graph.updateVarAliases(numThreads);
+    // A snapshot records the vertices, the edges in order with their flags
+    // and the register aliases.
+    auto snapshotPath = fs::unique_path();
+    netlist_paths::WriteSnapshot(graph, {}, {}, snapshotPath.native());
+    std::ifstream file(snapshotPath.native(), std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+    fs::remove(snapshotPath);
+    return std::make_pair(graph.numVertices(), contents);
+  };
+  auto serial = runPasses(1);
+  // Each register is split, with a copy of its alias.
+  BOOST_TEST(serial.first == 1500 * 11 + 1);
+  for (size_t numThreads : {2, 4}) {
+    auto parallel = runPasses(numThreads);
+    BOOST_TEST(parallel.first == serial.first);
+    BOOST_TEST((parallel.second == serial.second));
+  }
+}
+
+/// Test batch queries agree with the same queries made one at a time.
+BOOST_FIXTURE_TEST_CASE(path_batch_queries, TestContext) {
+  using netlist_paths::Waypoints;
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto options = netlist_paths::QueryOptions().withMatchOneVertex(false);
+  std::vector<std::string> startPoints;
+  std::vector<std::string> endPoints;
+  for (auto vertex : np->getNamedVerticesPtr()) {
+    std::string name(vertex->getName());
+    if (np->anyStartpointExists(name, options)) {
+      startPoints.push_back(name);
+    }
+    if (np->anyEndpointExists(name, options)) {
+      endPoints.push_back(name);
+    }
+  }
+  std::vector<Waypoints> waypoints;
+  for (auto &startPoint : startPoints) {
+    for (auto &endPoint : endPoints) {
+      waypoints.emplace_back(startPoint, endPoint);
+    }
+  }
+  waypoints.emplace_back("i_en", "assign_alias_regs.sum.add.register_q");
+  waypoints.back().addAvoidPoint("assign_alias_regs.sum.add.p1_sum");
+  for (auto numThreads : {1, 3}) {
+    options = options.withNumThreads(numThreads);
+    auto exists = np->pathExistsBatch(waypoints, options);
+    auto paths = np->getAnyPathBatch(waypoints, options);
+    BOOST_TEST(exists.size() == waypoints.size());
+    BOOST_TEST(paths.size() == waypoints.size());
+    for (size_t i = 0; i < waypoints.size(); ++i) {
+      BOOST_TEST(exists[i] == np->pathExists(waypoints[i], options));
+      BOOST_TEST(paths[i] == np->getAnyPath(waypoints[i], options));
+    }
+    auto fanOuts = np->getAllFanOutBatch(startPoints, options);
+    BOOST_TEST(fanOuts.size() == startPoints.size());
+    for (size_t i = 0; i < startPoints.size(); ++i) {
+      BOOST_TEST(fanOuts[i] == np->getAllFanOut(startPoints[i], options));
+    }
+  }
+  // Unmatched patterns are reported before any searches are made.
+  waypoints.emplace_back("i_en", "no_such_vertex");
+  BOOST_CHECK_THROW(np->pathExistsBatch(waypoints, options), netlist_paths::Exception);
+  BOOST_CHECK_THROW(np->getAllFanOutBatch({"no_such_vertex"}, options),
+                    netlist_paths::Exception);
+}
+
 //===----------------------------------------------------------------------===//
 // Test reporting of the correct path components.
 //===----------------------------------------------------------------------===//
@@ -249,6 +1230,140 @@ BOOST_FIXTURE_TEST_CASE(path_fan_in, TestContext) {
   CHECK_VAR_REPORT(paths[2][2], "VAR", "logic", "out");
 }
 
+/// Test that repeated queries, which reuse the traversal state, give the same
+/// paths.
+BOOST_FIXTURE_TEST_CASE(path_fan_repeated_queries, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto endPoint = "assign_alias_regs.sum.add.register_q";
+  auto fanIn = np->getAllFanIn(endPoint);
+  BOOST_TEST(fanIn.size() == 3);
+  for (auto &path : fanIn) {
+    BOOST_TEST(path.back()->getName() == endPoint);
+  }
+  for (auto startPoint : {"i_clk", "i_rst", "i_en"}) {
+    auto fanOut = np->getAllFanOut(startPoint);
+    BOOST_TEST(fanOut.size() == 2);
+    BOOST_TEST(fanOut.front().front()->getName() == startPoint);
+    BOOST_TEST(fanOut.front().back()->getName() == endPoint);
+    auto waypoints = netlist_paths::Waypoints(startPoint, endPoint);
+    auto allPaths = np->getAllPaths(waypoints);
+    BOOST_TEST(!allPaths.empty());
+    BOOST_TEST((std::find(allPaths.begin(), allPaths.end(),
+                          np->getAnyPath(waypoints)) != allPaths.end()));
+    BOOST_TEST(np->getAllPaths(waypoints) == allPaths);
+    BOOST_TEST(np->getAllFanOut(startPoint) == fanOut);
+    BOOST_TEST(np->getAllFanIn(endPoint) == fanIn);
+  }
+}
+
+/// Test the least recently used trees are discarded from the traversal cache
+/// to keep it within its limit.
+BOOST_AUTO_TEST_CASE(traversal_cache_lru) {
+  using netlist_paths::TraversalCache;
+  using netlist_paths::TraversalTree;
+  // Trees of the path 2 -> 0 -> 1 and of the root alone.
+  auto path = std::make_shared<const TraversalTree>(
+      2, std::vector<uint32_t>{0, 1, 2}, std::vector<uint32_t>{2, 0, 2});
+  BOOST_TEST(path->isVisited(1));
+  BOOST_TEST(!path->isVisited(3));
+  BOOST_TEST(path->getTreePath(1) == std::vector<size_t>({1, 0, 2}),
+             boost::test_tools::per_element());
+  BOOST_TEST(path->getTreePath(2) == std::vector<size_t>({2}),
+             boost::test_tools::per_element());
+  auto makeRoot = [](size_t vertex) {
+    return std::make_shared<const TraversalTree>(
+        vertex, std::vector<uint32_t>{uint32_t(vertex)}, std::vector<uint32_t>{0});
+  };
+  TraversalCache cache;
+  BOOST_TEST(!cache.isEnabled());
+  BOOST_TEST(cache.insert(TraversalCache::getKey(0, false, false), makeRoot(0)) == 0);
+  BOOST_TEST(cache.size() == 0);
+  auto treeBytes = makeRoot(0)->numBytes();
+  cache.setMaxBytes(2 * treeBytes);
+  BOOST_TEST(cache.isEnabled());
+  for (size_t vertex : {0, 1}) {
+    BOOST_TEST(cache.insert(TraversalCache::getKey(vertex, false, false),
+                            makeRoot(vertex)) == 0);
+  }
+  BOOST_TEST(cache.size() == 2);
+  BOOST_TEST(cache.getNumBytes() == 2 * treeBytes);
+  // The keys include the direction and the traverse registers option.
+  BOOST_TEST(!cache.get(TraversalCache::getKey(0, true, false)));
+  BOOST_TEST(!cache.get(TraversalCache::getKey(0, false, true)));
+  BOOST_TEST(cache.get(TraversalCache::getKey(0, false, false))->getRoot() == 0);
+  // Vertex 1 is now the least recently used.
+  BOOST_TEST(cache.insert(TraversalCache::getKey(3, false, false), makeRoot(3)) == 1);
+  BOOST_TEST(cache.size() == 2);
+  BOOST_TEST(!cache.get(TraversalCache::getKey(1, false, false)));
+  BOOST_TEST(cache.get(TraversalCache::getKey(0, false, false)));
+  BOOST_TEST(cache.get(TraversalCache::getKey(3, false, false)));
+  cache.setMaxBytes(treeBytes);
+  BOOST_TEST(cache.size() == 1);
+  BOOST_TEST(cache.get(TraversalCache::getKey(3, false, false)));
+  cache.clear();
+  BOOST_TEST(cache.size() == 0);
+  BOOST_TEST(cache.getNumBytes() == 0);
+}
+
+/// Test that queries from the cached DFS trees of their start and finish
+/// points give the same paths as searches of the graph.
+BOOST_FIXTURE_TEST_CASE(path_traversal_cache, TestContext) {
+  using netlist_paths::Waypoints;
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto getStat = [this](const std::string &name) {
+    for (auto &value : np->getStats().getValues()) {
+      if (value.first == name) {
+        return value.second;
+      }
+    }
+    return -1.0;
+  };
+  auto endPoint = "assign_alias_regs.sum.add.register_q";
+  std::vector<std::string> startPoints = {"i_clk", "i_rst", "i_en"};
+  auto fanIn = np->getAllFanIn(endPoint);
+  std::vector<std::vector<std::vector<netlist_paths::Vertex*>>> fanOuts;
+  std::vector<std::vector<netlist_paths::Vertex*>> anyPaths;
+  for (auto &startPoint : startPoints) {
+    fanOuts.push_back(np->getAllFanOut(startPoint));
+    anyPaths.push_back(np->getAnyPath(Waypoints(startPoint, endPoint)));
+  }
+  auto avoidWaypoints = Waypoints(startPoints[0], endPoint);
+  avoidWaypoints.addAvoidPoint("assign_alias_regs.sum.add.p1_sum");
+  auto avoidPath = np->getAnyPath(avoidWaypoints);
+  BOOST_TEST(np->getTraversalCacheMaxBytes() == 0);
+  np->setTraversalCacheMaxBytes(1 << 20);
+  np->clearStats();
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    BOOST_TEST(np->getAllFanIn(endPoint) == fanIn);
+    for (size_t i = 0; i < startPoints.size(); ++i) {
+      BOOST_TEST(np->getAllFanOut(startPoints[i]) == fanOuts[i]);
+      BOOST_TEST(np->getAnyPath(Waypoints(startPoints[i], endPoint)) == anyPaths[i]);
+    }
+  }
+  if (netlist_paths::STATS_ENABLED) {
+    // The fan outs and paths from each start point share its tree.
+    BOOST_TEST(getStat("traversal_cache.misses") == 4);
+    BOOST_TEST(getStat("traversal_cache.hits") == 10);
+    BOOST_TEST(getStat("traversal_cache.evictions") == 0);
+  }
+  // Queries with avoid points search the graph.
+  np->clearStats();
+  BOOST_TEST(np->getAnyPath(avoidWaypoints) == avoidPath);
+  BOOST_TEST(getStat("traversal_cache.hits") == -1);
+  // Trees larger than the limit are not kept.
+  np->setTraversalCacheMaxBytes(1);
+  np->clearStats();
+  BOOST_TEST(np->getAllFanIn(endPoint) == fanIn);
+  BOOST_TEST(np->getAllFanIn(endPoint) == fanIn);
+  if (netlist_paths::STATS_ENABLED) {
+    BOOST_TEST(getStat("traversal_cache.misses") == 2);
+  }
+  np->setTraversalCacheMaxBytes(0);
+  np->clearStats();
+  BOOST_TEST(np->getAllFanIn(endPoint) == fanIn);
+  BOOST_TEST(getStat("traversal_cache.misses") == -1);
+}
+
 /// Test that invalid through points throw exceptions.
 BOOST_FIXTURE_TEST_CASE(path_fan_out_exceptions, TestContext) {
   BOOST_CHECK_NO_THROW(compile("fan_out_in.sv"));
@@ -315,6 +1430,118 @@ BOOST_FIXTURE_TEST_CASE(path_false_fan_in_out, TestContext) {
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Test exporting subgraphs.
+//===----------------------------------------------------------------------===//
+
+/// Call a function to export a subgraph to a temporary file and return the
+/// contents of the file.
+static std::string readExport(std::function<void(const std::string&)> write) {
+  auto exportPath = fs::unique_path();
+  write(exportPath.native());
+  std::ifstream file(exportPath.native());
+  std::string contents((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+  fs::remove(exportPath);
+  return contents;
+}
+
+/// Return the IDs of the vertices and the pairs of IDs of the edges of a
+/// subgraph exported as JSON.
+static std::pair<std::set<size_t>, std::vector<std::pair<size_t, size_t>>>
+parseExportJSON(const std::string &contents) {
+  std::set<size_t> vertices;
+  std::vector<std::pair<size_t, size_t>> edges;
+  std::smatch match;
+  std::regex vertexRegex("\\{\"id\": ([0-9]+)");
+  for (auto it = contents.cbegin();
+       std::regex_search(it, contents.cend(), match, vertexRegex);
+       it = match.suffix().first) {
+    vertices.insert(std::stoul(match[1]));
+  }
+  std::regex edgeRegex("\\[([0-9]+), ([0-9]+)\\]");
+  for (auto it = contents.cbegin();
+       std::regex_search(it, contents.cend(), match, edgeRegex);
+       it = match.suffix().first) {
+    edges.emplace_back(std::stoul(match[1]), std::stoul(match[2]));
+  }
+  return {vertices, edges};
+}
+
+/// Test the fan out and fan in cones are limited by registers, depth and
+/// number of vertices, and only contain edges between their vertices.
+BOOST_FIXTURE_TEST_CASE(export_cones, TestContext) {
+  using netlist_paths::ExportFormat;
+  using netlist_paths::ExportOptions;
+  BOOST_CHECK_NO_THROW(load("hierarchical.xml"));
+  auto json = ExportOptions().withFormat(ExportFormat::JSON);
+  auto contents = readExport([&](const std::string &filename) {
+    np->exportFanOutCone("i_a", filename, json); });
+  BOOST_TEST(contents.find("\"hierarchical.u0.q\"") != std::string::npos);
+  BOOST_TEST(contents.find("\"hierarchical.u1.q\"") == std::string::npos);
+  auto cone = parseExportJSON(contents);
+  BOOST_TEST(cone.first.size() > 2);
+  BOOST_TEST(cone.second.size() >= cone.first.size() - 1);
+  for (auto &edge : cone.second) {
+    BOOST_TEST(cone.first.count(edge.first) == 1);
+    BOOST_TEST(cone.first.count(edge.second) == 1);
+  }
+  // Traversing registers reaches the second register.
+  auto traverseRegisters = netlist_paths::QueryOptions().withTraverseRegisters(true);
+  contents = readExport([&](const std::string &filename) {
+    np->exportFanOutCone("i_a", filename, json, traverseRegisters); });
+  BOOST_TEST(contents.find("\"hierarchical.u1.q\"") != std::string::npos);
+  // The limits keep the vertices nearest to the start point.
+  contents = readExport([&](const std::string &filename) {
+    np->exportFanOutCone("i_a", filename, json.withMaxDepth(1)); });
+  auto depthLimited = parseExportJSON(contents);
+  BOOST_TEST(depthLimited.first.size() > 1);
+  BOOST_TEST(depthLimited.first.size() < cone.first.size());
+  contents = readExport([&](const std::string &filename) {
+    np->exportFanOutCone("i_a", filename, json.withMaxVertices(2)); });
+  BOOST_TEST(parseExportJSON(contents).first.size() == 2);
+  // The fan in cone contains the start point.
+  contents = readExport([&](const std::string &filename) {
+    np->exportFanInCone("o_c", filename, json); });
+  BOOST_TEST(contents.find("\"hierarchical.u1.q\"") != std::string::npos);
+  BOOST_TEST(contents.find("\"i_a\"") == std::string::npos);
+  BOOST_CHECK_THROW(np->exportFanOutCone("foo", "unused", json),
+                    netlist_paths::Exception);
+}
+
+/// Test the subgraph between waypoints contains only the vertices on paths
+/// between them, in each format.
+BOOST_FIXTURE_TEST_CASE(export_paths, TestContext) {
+  using netlist_paths::ExportFormat;
+  using netlist_paths::ExportOptions;
+  BOOST_CHECK_NO_THROW(load("hierarchical.xml"));
+  auto waypoints = netlist_paths::Waypoints("hierarchical.u0.q", "o_b");
+  auto contents = readExport([&](const std::string &filename) {
+    np->exportPaths(waypoints, filename,
+                    ExportOptions().withFormat(ExportFormat::JSON)); });
+  BOOST_TEST(contents.find("\"hierarchical.u0.q\"") != std::string::npos);
+  BOOST_TEST(contents.find("\"o_b\"") != std::string::npos);
+  BOOST_TEST(contents.find("\"o_c\"") == std::string::npos);
+  BOOST_TEST(parseExportJSON(contents).second.size() > 0);
+  // No path.
+  contents = readExport([&](const std::string &filename) {
+    np->exportPaths(netlist_paths::Waypoints("hierarchical.u1.q", "o_b"), filename,
+                    ExportOptions().withFormat(ExportFormat::JSON)); });
+  BOOST_TEST(contents == "{\"vertices\": [],\n \"edges\": []}\n");
+  contents = readExport([&](const std::string &filename) {
+    np->exportPaths(waypoints, filename); });
+  BOOST_TEST(boost::starts_with(contents, "digraph netlist {\n"));
+  BOOST_TEST(contents.find("[label=\"o_b VAR\"]") != std::string::npos);
+  BOOST_TEST(contents.find(" -> ") != std::string::npos);
+  contents = readExport([&](const std::string &filename) {
+    np->exportPaths(waypoints, filename,
+                    ExportOptions().withFormat(ExportFormat::GRAPHML)); });
+  BOOST_TEST(boost::starts_with(contents, "<?xml"));
+  BOOST_TEST(contents.find("<data key=\"name\">o_b</data>") != std::string::npos);
+  BOOST_TEST(contents.find("<edge source=\"n") != std::string::npos);
+  BOOST_TEST(boost::ends_with(contents, "</graphml>\n"));
+}
+
 //===----------------------------------------------------------------------===//
 // Test through points.
 //===----------------------------------------------------------------------===//
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include "netlist_paths/Netlist.hpp"
@@ -22,7 +23,7 @@ struct TestContext {
     auto vertices = np->getNamedVertices();
     std::vector<std::string> names;
     for (auto v : vertices) {
-      auto name = std::remove_reference<const netlist_paths::Vertex>::type(v).getName();
+      std::string name(std::remove_reference<const netlist_paths::Vertex>::type(v).getName());
       name += std::remove_reference<const netlist_paths::Vertex>::type(v).getAstTypeStr();
       names.push_back(name);
     }
@@ -34,7 +35,7 @@ struct TestContext {
   /// Check all hierarchical names are qualified with the top module name.
   void qualifiedNames(const std::string &topName) {
     for (auto v : np->getNamedVertices()) {
-      auto name = std::remove_reference<const netlist_paths::Vertex>::type(v).getName();
+      std::string name(std::remove_reference<const netlist_paths::Vertex>::type(v).getName());
       if (name.find('.') != std::string::npos &&
           name.rfind("__", 0) == std::string::npos) {
         BOOST_TEST(boost::starts_with(name, topName));
@@ -53,6 +54,9 @@ struct TestContext {
     netlist_paths::Options::getInstance().setTraverseRegisters(false);
     netlist_paths::Options::getInstance().setRestrictStartPoints(true);
     netlist_paths::Options::getInstance().setRestrictEndPoints(true);
+    netlist_paths::Options::getInstance().setBidirectionalSearch(false);
+    netlist_paths::Options::getInstance().setReachabilityIndex(false);
+    netlist_paths::Options::getInstance().setNumThreads(0);
   }
 
   /// Compile a test and create a netlist object.
@@ -64,13 +68,7 @@ struct TestContext {
     // Check the Verilator binary exists.
     BOOST_ASSERT(boost::filesystem::exists(installPrefix));
     netlist_paths::RunVerilator runVerilator(installPrefix);
-    auto outTemp = fs::unique_path();
-    runVerilator.run(includes,
-                     defines,
-                     inputFiles,
-                     outTemp.native());
-    np = std::make_unique<netlist_paths::Netlist>(outTemp.native());
-    fs::remove(outTemp);
+    np = runVerilator.compile(includes, defines, inputFiles);
     if (topName.empty()) {
       topName = boost::filesystem::change_extension(inFilename, "").string();
     }
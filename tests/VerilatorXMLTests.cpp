@@ -3,11 +3,28 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 
+#include <fstream>
 #include <boost/test/unit_test.hpp>
 #include "tests/definitions.hpp"
 #include "TestContext.hpp"
+#include "netlist_paths/CompileCache.hpp"
+#include "netlist_paths/Compression.hpp"
 #include "netlist_paths/Utilities.hpp"
 
+/// Check two netlists have the same named vertices.
+static void checkSameVertices(const netlist_paths::Netlist &a,
+                              const netlist_paths::Netlist &b) {
+  auto aVertices = a.getNamedVertices();
+  auto bVertices = b.getNamedVertices();
+  BOOST_TEST(aVertices.size() == bVertices.size());
+  for (size_t i = 0; i < std::min(aVertices.size(), bVertices.size()); ++i) {
+    BOOST_TEST(aVertices[i].get().getName() == bVertices[i].get().getName());
+    BOOST_TEST(aVertices[i].get().getAstTypeStr() == bVertices[i].get().getAstTypeStr());
+    BOOST_TEST(aVertices[i].get().getDTypeStr() == bVertices[i].get().getDTypeStr());
+    BOOST_TEST(aVertices[i].get().getDTypeWidth() == bVertices[i].get().getDTypeWidth());
+    BOOST_TEST(aVertices[i].get().getLocationStr() == bVertices[i].get().getLocationStr());
+  }
+}
 
 /// Verilator cannot inline packages with functions.
 BOOST_FIXTURE_TEST_CASE(orphan_package, TestContext) {
@@ -53,3 +70,252 @@ BOOST_FIXTURE_TEST_CASE(assign_alias_regs, TestContext) {
   BOOST_TEST(np->regExists("assign_alias_regs.sum.add.register_q"));
   BOOST_TEST(np->regExists("assign_alias_regs.__Vcellout__sum.add__register_q"));
 }
+
+/// The variables of each instance of a module in a flat netlist are named by
+/// its hierarchical instance name.
+BOOST_FIXTURE_TEST_CASE(hierarchical, TestContext) {
+  BOOST_CHECK_NO_THROW(load("hierarchical.xml"));
+  BOOST_TEST(np->startpointExists("i_a"));
+  BOOST_TEST(np->endpointExists("o_c"));
+  BOOST_TEST(np->regExists("hierarchical.u0.q"));
+  BOOST_TEST(np->regExists("hierarchical.u1.q"));
+  BOOST_TEST(!np->anyRegExists("hierarchical.q"));
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("i_a", "hierarchical.u0.q")));
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("hierarchical.u0.q", "hierarchical.u1.q")));
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("hierarchical.u0.q", "o_b")));
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("hierarchical.u1.q", "o_c")));
+  BOOST_TEST(!np->pathExists(netlist_paths::Waypoints("hierarchical.u0.q", "o_c")));
+  BOOST_TEST(!np->pathExists(netlist_paths::Waypoints("i_a", "hierarchical.u1.q")));
+}
+
+/// The modules of a netlist that is not flat are skipped by both XML readers.
+BOOST_FIXTURE_TEST_CASE(not_flat, TestContext) {
+  for (auto streamXML : {false, true}) {
+    netlist_paths::Options::getInstance().setStreamXML(streamXML);
+    BOOST_CHECK_NO_THROW(load("hierarchical_modules.xml"));
+    BOOST_TEST(np->isEmpty());
+  }
+  netlist_paths::Options::getInstance().setStreamXML(false);
+}
+
+/// A netlist loaded from a snapshot is identical to the one it was written
+/// from.
+BOOST_FIXTURE_TEST_CASE(snapshot_round_trip, TestContext) {
+  for (auto filename : {"assign_alias_regs.xml", "dtype_forward_refs.xml",
+                        "hierarchical.xml"}) {
+    BOOST_CHECK_NO_THROW(load(filename));
+    auto snapshotPath = fs::unique_path();
+    np->writeSnapshot(snapshotPath.native());
+    auto snapshot = netlist_paths::Netlist(snapshotPath.native());
+    fs::remove(snapshotPath);
+    checkSameVertices(*np, snapshot);
+  }
+}
+
+/// Queries on a netlist loaded from a snapshot give the same results.
+BOOST_FIXTURE_TEST_CASE(snapshot_queries, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto snapshotPath = fs::unique_path();
+  np->writeSnapshot(snapshotPath.native());
+  np = std::make_unique<netlist_paths::Netlist>(snapshotPath.native());
+  fs::remove(snapshotPath);
+  BOOST_TEST(np->regExists("assign_alias_regs.sum.add.register_q"));
+  BOOST_TEST(np->regExists("assign_alias_regs.__Vcellout__sum.add__register_q"));
+}
+
+/// Loading a truncated snapshot raises an exception.
+BOOST_FIXTURE_TEST_CASE(snapshot_truncated, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto snapshotPath = fs::unique_path();
+  np->writeSnapshot(snapshotPath.native());
+  fs::resize_file(snapshotPath, fs::file_size(snapshotPath) / 2);
+  BOOST_CHECK_THROW(netlist_paths::Netlist(snapshotPath.native()),
+                    netlist_paths::Exception);
+  fs::remove(snapshotPath);
+}
+
+/// The streaming XML reader produces the same netlist as the DOM reader.
+BOOST_FIXTURE_TEST_CASE(stream_xml, TestContext) {
+  for (auto filename : {"assign_alias_regs.xml", "dtype_forward_refs.xml",
+                        "hierarchical.xml"}) {
+    BOOST_CHECK_NO_THROW(load(filename));
+    auto xmlPath = fs::path(xmlPrefix) / filename;
+    netlist_paths::Options::getInstance().setStreamXML(true);
+    auto streamed = netlist_paths::Netlist(xmlPath.string());
+    netlist_paths::Options::getInstance().setStreamXML(false);
+    checkSameVertices(*np, streamed);
+    BOOST_TEST(streamed.getParserPeakMemory() > 0);
+    BOOST_TEST(np->getParserPeakMemory() > 0);
+  }
+  netlist_paths::Options::getInstance().setStreamXML(true);
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  netlist_paths::Options::getInstance().setStreamXML(false);
+  BOOST_TEST(np->regExists("assign_alias_regs.sum.add.register_q"));
+  BOOST_TEST(np->regExists("assign_alias_regs.__Vcellout__sum.add__register_q"));
+}
+
+/// Netlists compressed with gzip are decompressed as they are read by both
+/// XML readers, and produce the same netlist as the plain XML.
+BOOST_FIXTURE_TEST_CASE(compressed_xml, TestContext) {
+  using netlist_paths::Compression;
+  auto xmlPath = fs::path(xmlPrefix) / "hierarchical.xml";
+  auto gzipPath = fs::unique_path("%%%%-%%%%.xml.gz");
+  netlist_paths::compressFile(xmlPath.string(), gzipPath.string(), Compression::GZIP);
+  BOOST_TEST((netlist_paths::detectCompression(xmlPath.string()) == Compression::NONE));
+  BOOST_TEST((netlist_paths::detectCompression(gzipPath.string()) == Compression::GZIP));
+  BOOST_TEST(fs::file_size(gzipPath) < fs::file_size(xmlPath));
+  BOOST_CHECK_NO_THROW(load("hierarchical.xml"));
+  for (bool streamXML : {false, true}) {
+    netlist_paths::Options::getInstance().setStreamXML(streamXML);
+    auto compressed = netlist_paths::Netlist(gzipPath.string());
+    netlist_paths::Options::getInstance().setStreamXML(false);
+    checkSameVertices(*np, compressed);
+  }
+  // A truncated or corrupt file raises an exception.
+  auto size = fs::file_size(gzipPath);
+  fs::resize_file(gzipPath, size / 2);
+  for (bool streamXML : {false, true}) {
+    netlist_paths::Options::getInstance().setStreamXML(streamXML);
+    BOOST_CHECK_THROW(netlist_paths::Netlist(gzipPath.string()),
+                      netlist_paths::Exception);
+    netlist_paths::Options::getInstance().setStreamXML(false);
+  }
+  {
+    std::fstream file(gzipPath.string(), std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(size / 4);
+    file.write("corrupt", 7);
+  }
+  BOOST_CHECK_THROW(netlist_paths::Netlist(gzipPath.string()),
+                    netlist_paths::Exception);
+  fs::remove(gzipPath);
+  if (netlist_paths::isCompressionSupported(Compression::ZSTD)) {
+    auto zstdPath = fs::unique_path("%%%%-%%%%.xml.zst");
+    netlist_paths::compressFile(xmlPath.string(), zstdPath.string(), Compression::ZSTD);
+    BOOST_TEST((netlist_paths::detectCompression(zstdPath.string()) == Compression::ZSTD));
+    checkSameVertices(*np, netlist_paths::Netlist(zstdPath.string()));
+    fs::remove(zstdPath);
+  }
+}
+
+/// Return the value of a statistic of a netlist, or -1 if it is not recorded.
+static double getStat(const netlist_paths::Netlist &netlist,
+                      const std::string &name) {
+  for (auto &value : netlist.getStats().getValues()) {
+    if (value.first == name) {
+      return value.second;
+    }
+  }
+  return -1;
+}
+
+/// Each phase of loading a netlist and each query is timed, and the work of
+/// the searches of the queries is counted.
+BOOST_FIXTURE_TEST_CASE(stats, TestContext) {
+  if (!netlist_paths::STATS_ENABLED) {
+    return;
+  }
+  BOOST_CHECK_NO_THROW(load("hierarchical.xml"));
+  for (auto name : {"read_xml", "parse_xml", "type_table_pass_1",
+                    "type_table_pass_2", "visit_modules", "mark_alias_registers",
+                    "split_reg_vertices", "update_var_aliases", "build_indexes"}) {
+    BOOST_TEST(getStat(*np, std::string(name) + ".count") == 1);
+    BOOST_TEST(getStat(*np, std::string(name) + ".seconds") >= 0);
+  }
+  BOOST_TEST(getStat(*np, "path_exists.count") == -1);
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("i_a", "hierarchical.u0.q")));
+  BOOST_TEST(getStat(*np, "path_exists.count") == 1);
+  BOOST_TEST(getStat(*np, "path_exists.vertices_visited") > 0);
+  BOOST_TEST(getStat(*np, "path_exists.edges_examined") > 0);
+  BOOST_TEST(!np->getAllFanOut("i_a").empty());
+  BOOST_TEST(getStat(*np, "fan_out.parent_map_entries") > 0);
+  BOOST_TEST(getStat(*np, "fan_out.allocated_bytes") >= 0);
+  np->clearStats();
+  BOOST_TEST(np->getStats().getValues().empty());
+}
+
+/// Write a copy of a test XML netlist with one string replaced.
+static void copyXMLReplacing(const std::string &filename,
+                             const fs::path &xmlPath,
+                             const std::string &from,
+                             const std::string &to) {
+  std::ifstream input((fs::path(xmlPrefix) / filename).string());
+  std::ofstream output(xmlPath.string());
+  std::string line;
+  while (std::getline(input, line)) {
+    auto position = line.find(from);
+    if (position != std::string::npos) {
+      line.replace(position, from.size(), to);
+    }
+    output << line << "\n";
+  }
+}
+
+/// Write a copy of an XML netlist whose list of source files names one file.
+static void writeXMLWithSource(const fs::path &xmlPath,
+                               const fs::path &sourcePath,
+                               const std::string &sourceText) {
+  std::ofstream(sourcePath.string()) << sourceText;
+  copyXMLReplacing("hierarchical.xml", xmlPath, "filename=\"hierarchical.sv\"",
+                   "filename=\"" + sourcePath.string() + "\"");
+}
+
+/// Malformed locations and integers are reported as XML errors.
+BOOST_FIXTURE_TEST_CASE(invalid_attributes, TestContext) {
+  auto xmlPath = fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.xml");
+  for (auto streamXML : {false, true}) {
+    netlist_paths::Options::getInstance().setStreamXML(streamXML);
+    copyXMLReplacing("hierarchical.xml", xmlPath, "loc=\"c,7,33,7,38\"", "loc=\"c,7,x,7,38\"");
+    BOOST_CHECK_THROW(netlist_paths::Netlist(xmlPath.string()), netlist_paths::XMLException);
+    copyXMLReplacing("hierarchical.xml", xmlPath, "loc=\"c,7,33,7,38\"", "loc=\"c,7,33\"");
+    BOOST_CHECK_THROW(netlist_paths::Netlist(xmlPath.string()), netlist_paths::XMLException);
+    copyXMLReplacing("dtype_forward_refs.xml", xmlPath, "left=\"", "left=\"x");
+    BOOST_CHECK_THROW(netlist_paths::Netlist(xmlPath.string()), netlist_paths::XMLException);
+  }
+  netlist_paths::Options::getInstance().setStreamXML(false);
+  fs::remove(xmlPath);
+}
+
+/// Compilations are found in the cache until one of their source files
+/// changes, and the least recently used are evicted.
+BOOST_FIXTURE_TEST_CASE(compile_cache, TestContext) {
+  auto directory = fs::temp_directory_path() / fs::unique_path();
+  auto sourcePath = directory / "hierarchical.sv";
+  auto xmlPath = directory / "hierarchical.xml";
+  netlist_paths::CompileCache cache((directory / "cache").string(), 0);
+  writeXMLWithSource(xmlPath, sourcePath, "module hierarchical; endmodule\n");
+  // Keys depend on the version, the arguments and the inputs.
+  auto key = netlist_paths::CompileCache::getKey("v1", {"--flatten"}, {sourcePath.string()});
+  BOOST_TEST(key == netlist_paths::CompileCache::getKey("v1", {"--flatten"}, {sourcePath.string()}));
+  BOOST_TEST(key != netlist_paths::CompileCache::getKey("v2", {"--flatten"}, {sourcePath.string()}));
+  BOOST_TEST(key != netlist_paths::CompileCache::getKey("v1", {}, {sourcePath.string()}));
+  // Insert a compilation and its snapshot.
+  BOOST_TEST(cache.findXML(key).empty());
+  cache.insertXML(key, xmlPath.string());
+  auto cachedXML = cache.findXML(key);
+  BOOST_TEST(!cachedXML.empty());
+  BOOST_TEST(cache.findSnapshot(key).empty());
+  np = std::make_unique<netlist_paths::Netlist>(cachedXML.string());
+  auto snapshotPath = directory / "hierarchical.snapshot";
+  np->writeSnapshot(snapshotPath.string());
+  cache.insertSnapshot(key, snapshotPath.string());
+  auto cachedSnapshot = cache.findSnapshot(key);
+  BOOST_TEST(!cachedSnapshot.empty());
+  checkSameVertices(*np, netlist_paths::Netlist(cachedSnapshot.string()));
+  // Changing the source invalidates the entry.
+  std::ofstream(sourcePath.string()) << "module hierarchical(input i); endmodule\n";
+  BOOST_TEST(cache.findXML(key).empty());
+  BOOST_TEST(cache.findSnapshot(key).empty());
+  // Only the most recently used of two entries fits in a small cache.
+  auto otherKey = netlist_paths::CompileCache::getKey("v2", {}, {sourcePath.string()});
+  cache.insertXML(key, xmlPath.string());
+  cache.insertXML(otherKey, xmlPath.string());
+  for (auto &file : fs::directory_iterator(directory / "cache")) {
+    if (file.path().stem() == key) {
+      fs::last_write_time(file.path(), fs::last_write_time(file.path()) - 60);
+    }
+  }
+  netlist_paths::CompileCache((directory / "cache").string(), 1).evict();
+  BOOST_TEST(cache.findXML(key).empty());
+  BOOST_TEST(!cache.findXML(otherKey).empty());
+  fs::remove_all(directory);
+}
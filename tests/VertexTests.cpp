@@ -6,7 +6,9 @@
 #include <boost/test/unit_test.hpp>
 #include "tests/definitions.hpp"
 #include "TestContext.hpp"
+#include "netlist_paths/StringPool.hpp"
 #include "netlist_paths/Utilities.hpp"
+#include "netlist_paths/VertexClasses.hpp"
 
 //===----------------------------------------------------------------------===//
 // Test querying of vertex types.
@@ -75,3 +77,141 @@ BOOST_FIXTURE_TEST_CASE(port_register_nested, TestContext) {
   BOOST_TEST(np->getNetVerticesPtr("i_").size() == 2);
   BOOST_TEST(np->getNetVerticesPtr("o_").size() == 1);
 }
+
+//===----------------------------------------------------------------------===//
+// Test the precomputed vertex classes agree with the vertex predicates for
+// each setting of the options.
+//===----------------------------------------------------------------------===//
+
+BOOST_FIXTURE_TEST_CASE(vertex_classes, TestContext) {
+  using netlist_paths::DTypeTable;
+  using netlist_paths::Vertex;
+  using netlist_paths::VertexAstType;
+  using netlist_paths::VertexDirection;
+  using netlist_paths::VertexNetlistType;
+  Location location;
+  std::vector<Vertex> vertices;
+  vertices.emplace_back(VertexAstType::LOGIC, location);
+  vertices.emplace_back(VertexAstType::VAR, VertexDirection::INPUT, location,
+                        DTypeTable::NO_DTYPE, "top.i_a", false, "", false);
+  vertices.emplace_back(VertexAstType::VAR, VertexDirection::OUTPUT, location,
+                        DTypeTable::NO_DTYPE, "top.o_b", false, "", false);
+  vertices.emplace_back(VertexAstType::VAR, VertexDirection::NONE, location,
+                        DTypeTable::NO_DTYPE, "top.sub.c", false, "", false);
+  vertices.emplace_back(VertexAstType::VAR, VertexDirection::NONE, location,
+                        DTypeTable::NO_DTYPE, "top.__Vdly__d", false, "", false);
+  vertices.emplace_back(VertexAstType::VAR, VertexDirection::NONE, location,
+                        DTypeTable::NO_DTYPE, "top.e", true, "1", false);
+  for (auto srcReg : {true, false}) {
+    for (auto alias : {true, false}) {
+      Vertex reg(VertexAstType::VAR, VertexDirection::NONE, location,
+                 DTypeTable::NO_DTYPE, "top.reg", false, "", false);
+      if (alias) {
+        srcReg ? reg.setSrcRegAlias() : reg.setDstRegAlias();
+      } else {
+        srcReg ? reg.setSrcReg() : reg.setDstReg();
+      }
+      vertices.push_back(reg);
+    }
+  }
+  Vertex deleted(VertexAstType::VAR, VertexDirection::NONE, location,
+                 DTypeTable::NO_DTYPE, "top.f", false, "", false);
+  deleted.setDeleted();
+  vertices.push_back(deleted);
+  std::vector<const Vertex*> vertexPtrs;
+  for (auto &vertex : vertices) {
+    vertexPtrs.push_back(&vertex);
+  }
+  netlist_paths::VertexClasses classes;
+  classes.build(vertexPtrs);
+  auto &options = netlist_paths::Options::getInstance();
+  for (auto restrictStartPoints : {true, false}) {
+    for (auto restrictEndPoints : {true, false}) {
+      for (auto traverseRegisters : {true, false}) {
+        options.setRestrictStartPoints(restrictStartPoints);
+        options.setRestrictEndPoints(restrictEndPoints);
+        options.setTraverseRegisters(traverseRegisters);
+        auto queryOptions = options.getQueryOptions();
+        for (int type = 0; type <= static_cast<int>(VertexNetlistType::ANY); ++type) {
+          auto vertexType = static_cast<VertexNetlistType>(type);
+          std::vector<size_t> expected;
+          for (size_t i = 0; i < vertices.size(); ++i) {
+            bool isSrc = vertices[i].isSrcReg() || vertices[i].isSrcRegAlias();
+            bool excluded = isSrc && (vertexType == VertexNetlistType::REG ||
+                                      vertexType == VertexNetlistType::PORT ||
+                                      vertexType == VertexNetlistType::IS_NAMED);
+            if (vertexType == VertexNetlistType::ANY ||
+                (!excluded && vertices[i].isGraphType(vertexType))) {
+              expected.push_back(i);
+            }
+            BOOST_TEST(classes.test(i, vertexType, queryOptions) ==
+                       (!expected.empty() && expected.back() == i));
+          }
+          BOOST_TEST(classes.getVertices(vertexType, queryOptions) == expected,
+                     boost::test_tools::per_element());
+        }
+      }
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Test interning of vertex names and the compact representation of locations.
+//===----------------------------------------------------------------------===//
+
+BOOST_AUTO_TEST_CASE(string_pool_interning) {
+  netlist_paths::StringPool pool;
+  std::string name("top.u_core.u_lsu.data_q");
+  auto a = pool.intern(name);
+  auto b = pool.intern(std::string("top.u_core.u_lsu.data_q"));
+  BOOST_TEST(a == name);
+  BOOST_TEST(static_cast<const void*>(a.data()) ==
+             static_cast<const void*>(b.data()));
+  BOOST_TEST(static_cast<const void*>(a.data()) !=
+             static_cast<const void*>(name.data()));
+  BOOST_TEST(pool.intern("top.u_core.u_lsu.data_d") != a);
+  BOOST_TEST(pool.intern("").empty());
+  BOOST_TEST(pool.size() == 2);
+  // Strings larger than a chunk are pooled too.
+  std::string longName(100000, 'x');
+  BOOST_TEST(pool.intern(longName) == longName);
+  BOOST_TEST(static_cast<const void*>(pool.intern(longName).data()) ==
+             static_cast<const void*>(pool.intern(longName).data()));
+  BOOST_TEST(pool.size() == 3);
+  pool.clear();
+  BOOST_TEST(pool.size() == 0);
+  BOOST_TEST(pool.getBytes() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(compact_locations) {
+  netlist_paths::VertexTables tables;
+  auto &fileTable = tables.files;
+  auto fileIndex = fileTable.add(File("compact_locations.sv", "1800-2017"));
+  BOOST_TEST(fileTable.add(File("compact_locations.sv", "1800-2017")) == fileIndex);
+  Location location(fileIndex, 10, 3, 12, 100000);
+  BOOST_TEST(sizeof(Location) == 16);
+  BOOST_TEST(location.getFilename(fileTable) == "compact_locations.sv");
+  BOOST_TEST(location.getFile(fileTable) == &fileTable.getFile(fileIndex));
+  BOOST_TEST(location.getStartLine() == 10);
+  BOOST_TEST(location.getStartCol() == 3);
+  BOOST_TEST(location.getEndLine() == 12);
+  // Columns saturate.
+  BOOST_TEST(location.getEndCol() == UINT16_MAX);
+  BOOST_TEST(Location().getFilename(fileTable) == "unknown");
+  // Vertices share the interned name, including their copies.
+  netlist_paths::StringPool pool;
+  netlist_paths::Vertex vertex(netlist_paths::VertexAstType::VAR,
+                               netlist_paths::VertexDirection::NONE, location,
+                               netlist_paths::DTypeTable::NO_DTYPE,
+                               pool.intern("top.sub.data_q"), false,
+                               pool.intern(""), false);
+  netlist_paths::Vertex copy(vertex);
+  BOOST_TEST(static_cast<const void*>(copy.getName().data()) ==
+             static_cast<const void*>(vertex.getName().data()));
+  BOOST_TEST(vertex.getBasename() == "data_q");
+  BOOST_TEST(!vertex.isTop());
+  BOOST_TEST((copy.getLocation() == location));
+  // The file is resolved through the tables of the graph of the vertex.
+  vertex.setTables(&tables);
+  BOOST_TEST(netlist_paths::Vertex(vertex).getLocationStr() == "compact_locations.sv:10");
+}
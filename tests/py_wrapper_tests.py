@@ -1,9 +1,13 @@
+import json
 import os
+import shutil
 import sys
+import tempfile
 import unittest
 import definitions as defs
 sys.path.insert(0, os.path.join(defs.BINARY_DIR_PREFIX, 'lib', 'netlist_paths'))
-from py_netlist_paths import RunVerilator, Netlist, Waypoints, Options
+from py_netlist_paths import RunVerilator, Netlist, Waypoints, Options, QueryOptions, \
+                             ExportFormat
 
 class TestPyWrapper(unittest.TestCase):
     """
@@ -155,6 +159,47 @@ class TestPyWrapper(unittest.TestCase):
         paths = np.get_all_paths(Waypoints('in', 'out'))
         self.assertTrue(len(paths) == 3)
 
+    def test_path_all_iterate(self):
+        """
+        Test iterating over all paths with limits.
+        """
+        np = self.compile_test('multiple_paths.sv')
+        paths = [[v.get_name() for v in path] for path in np.get_all_paths(Waypoints('in', 'out'))]
+        iterator = np.iterate_all_paths(Waypoints('in', 'out'))
+        self.assertEqual([[np.get_vertex(x).get_name() for x in ids] for ids in iterator], paths)
+        self.assertEqual(iterator.num_paths(), 3)
+        self.assertFalse(iterator.is_truncated())
+        iterator = np.iterate_all_paths(Waypoints('in', 'out'), max_paths=2)
+        self.assertEqual(len(list(iterator)), 2)
+        self.assertTrue(iterator.is_truncated())
+        max_length = min(len(path) for path in paths)
+        iterator = np.iterate_all_paths(Waypoints('in', 'out'), max_length=max_length)
+        self.assertEqual(len(list(iterator)), len([p for p in paths if len(p) <= max_length]))
+
+    def test_deepest_paths(self):
+        """
+        Test querying of the deepest paths, with the weights of vertex types.
+        """
+        np = self.compile_test('multiple_paths.sv')
+        names = lambda paths: sorted([v.get_name() for v in path] for path in paths)
+        paths = np.get_deepest_paths(Waypoints('in', 'out'), 10)
+        self.assertEqual(names(paths), names(np.get_all_paths(Waypoints('in', 'out'))))
+        depths = [np.get_path_depth(path) for path in paths]
+        self.assertEqual(len(set(depths)), 1)
+        self.assertTrue(depths[0] > 0)
+        self.assertEqual(len(np.get_deepest_paths(Waypoints('in', 'out'), 2)), 2)
+        # Each path has three variables.
+        paths = np.get_deepest_paths(Waypoints('in', 'out'), 1, weights={'VAR': 1})
+        self.assertEqual(np.get_path_depth(paths[0], weights={'VAR': 1}), depths[0] + 3)
+        with self.assertRaises(RuntimeError):
+            np.get_deepest_paths(Waypoints('in', 'out'), 1, weights={'NOT_A_TYPE': 1})
+        with self.assertRaises(RuntimeError):
+            np.get_deepest_paths(Waypoints('in', 'out'), 0)
+        np = self.compile_test('fan_out_in.sv')
+        self.assertEqual(len(np.get_deepest_fanout_paths('in', 2)), 2)
+        self.assertEqual(names(np.get_deepest_fanin_paths('out', 5)),
+                         names(np.get_all_fanin_paths('out')))
+
     def test_path_all_fanout(self):
         """
         Test querying of all fanout paths.
@@ -194,6 +239,62 @@ class TestPyWrapper(unittest.TestCase):
       Options.get_instance().set_traverse_registers(True)
       self.assertTrue(np.path_exists(Waypoints('in', 'out')))
 
+    def test_query_options(self):
+      """
+      Test passing options to individual queries.
+      """
+      np = self.compile_test('basic_ff_chain.sv')
+      options = QueryOptions()
+      self.assertFalse(np.path_exists(Waypoints('in', 'out'), options))
+      self.assertTrue(np.path_exists(Waypoints('in', 'out'), options.with_traverse_registers(True)))
+      self.assertFalse(options.should_traverse_registers())
+      self.assertTrue(len(np.get_all_fanout_paths('in', options.with_traverse_registers(True))) > 0)
+
+    def test_batch_queries(self):
+      """
+      Test batch queries return the same results as individual queries.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      options = QueryOptions()
+      waypoints = [Waypoints('in', 'fan_out_in.a'), Waypoints('fan_out_in.a', 'out'),
+                   Waypoints('in', 'out')]
+      self.assertEqual(np.path_exists_batch(waypoints, options),
+                       [np.path_exists(w, options) for w in waypoints])
+      paths = np.get_any_path_batch(waypoints)
+      self.assertEqual([[v.get_name() for v in p] for p in paths],
+                       [[v.get_name() for v in np.get_any_path(w)] for w in waypoints])
+      fanouts = np.get_all_fanout_paths_batch(['in'])
+      self.assertEqual(len(fanouts), 1)
+      self.assertEqual(len(fanouts[0]), len(np.get_all_fanout_paths('in')))
+
+    def test_path_arrays(self):
+      """
+      Test paths returned as arrays of vertex IDs match the vertex paths.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      paths = np.get_all_fanout_paths('in')
+      array = np.get_all_fanout_paths_array('in')
+      self.assertEqual(len(array), len(paths))
+      vertices = memoryview(array.vertices)
+      offsets = memoryview(array.offsets)
+      self.assertEqual(vertices.format, 'Q')
+      self.assertTrue(vertices.readonly)
+      self.assertEqual(len(offsets), len(paths)+1)
+      self.assertEqual(offsets[-1], len(vertices))
+      columns = np.get_vertex_columns(array.vertices)
+      for i, path in enumerate(paths):
+          self.assertEqual(columns['name'][offsets[i]:offsets[i+1]], [v.get_name() for v in path])
+          self.assertEqual(columns['ast_type'][offsets[i]:offsets[i+1]], [v.get_ast_type_str() for v in path])
+          self.assertEqual(list(memoryview(columns['width'])[offsets[i]:offsets[i+1]]),
+                           [v.get_dtype_width() for v in path])
+          self.assertEqual([np.get_vertex(x).get_name() for x in memoryview(array[i])],
+                           [v.get_name() for v in path])
+      self.assertEqual(np.get_vertex_columns([array.vertices[0]])['name'], [paths[0][0].get_name()])
+      path = np.get_any_path_array(Waypoints('in', 'out'))
+      self.assertEqual(len(path), 1)
+      self.assertEqual(len(path[0]), len(np.get_any_path(Waypoints('in', 'out'))))
+      self.assertRaises(RuntimeError, np.get_vertex, len(vertices)+1000000)
+
     def test_restrict_start_end_points(self):
       """
       Test relaxation of path start/end point options.
@@ -204,6 +305,180 @@ class TestPyWrapper(unittest.TestCase):
       self.assertTrue(np.path_exists(Waypoints('aliases_sub_reg.u_a.out',       'aliases_sub_reg.u_b.in')))
       self.assertTrue(np.path_exists(Waypoints('aliases_sub_reg.u_a.out',       'aliases_sub_reg.u_b.client_out')))
 
+    def test_snapshot(self):
+      """
+      Test writing and loading a netlist snapshot.
+      """
+      np = self.compile_test('adder.sv')
+      np.write_snapshot('netlist.snapshot')
+      np = Netlist('netlist.snapshot')
+      self.assertTrue(np.path_exists(Waypoints('i_a', 'o_sum')))
+      self.assertTrue(len(np.get_named_vertices()) > 0)
+      os.remove('netlist.snapshot')
+
+    def test_compressed_xml(self):
+      """
+      Test writing and loading a netlist compressed with gzip.
+      """
+      comp = RunVerilator(defs.INSTALL_PREFIX)
+      path = os.path.join(defs.TEST_SRC_PREFIX, 'adder.sv')
+      self.assertEqual(comp.run(path, 'netlist.xml.gz'), 0)
+      with open('netlist.xml.gz', 'rb') as f:
+        self.assertEqual(f.read(2), b'\x1f\x8b')
+      np = Netlist('netlist.xml.gz')
+      self.assertTrue(np.path_exists(Waypoints('i_a', 'o_sum')))
+      os.remove('netlist.xml.gz')
+
+    def test_reachability_index(self):
+      """
+      Test path existence and fan out/in end points with a reachability index.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      self.assertFalse(np.has_reachability_index())
+      np.build_reachability_index()
+      self.assertTrue(np.has_reachability_index())
+      self.assertTrue(np.path_exists(Waypoints('in', 'out')))
+      end_points = [v.get_name() for v in np.get_fanout_end_points('in')]
+      self.assertEqual(end_points, [p[-1].get_name() for p in np.get_all_fanout_paths('in')])
+      start_points = [v.get_name() for v in np.get_fanin_start_points('out')]
+      self.assertEqual(start_points, [p[0].get_name() for p in np.get_all_fanin_paths('out')])
+
+    def test_traversal_cache(self):
+      """
+      Test fan out/in and any path queries from cached traversal trees.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      names = lambda paths: [[v.get_name() for v in path] for path in paths]
+      fanout = names(np.get_all_fanout_paths('in'))
+      fanin = names(np.get_all_fanin_paths('out'))
+      any_path = names([np.get_any_path(Waypoints('in', 'out'))])
+      self.assertEqual(np.get_traversal_cache_max_bytes(), 0)
+      np.set_traversal_cache_max_bytes(1 << 20)
+      self.assertEqual(np.get_traversal_cache_max_bytes(), 1 << 20)
+      np.clear_stats()
+      for _ in range(2):
+        self.assertEqual(names(np.get_all_fanout_paths('in')), fanout)
+        self.assertEqual(names(np.get_all_fanin_paths('out')), fanin)
+        self.assertEqual(names([np.get_any_path(Waypoints('in', 'out'))]), any_path)
+      stats = np.get_stats()
+      if 'fan_out.count' in stats:
+        self.assertEqual(stats['traversal_cache.misses'], 2)
+        self.assertEqual(stats['traversal_cache.hits'], 4)
+      np.clear_traversal_cache()
+      np.set_traversal_cache_max_bytes(0)
+
+    def test_comb_connectivity(self):
+      """
+      Test the connected pairs of start and end points.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      pairs = [(s.get_name(), e.get_name()) for s, e in np.get_comb_connectivity()]
+      self.assertTrue(('in', 'out') in pairs)
+      for start_point in set(s for s, _ in pairs):
+          end_points = [v.get_name() for v in np.get_fanout_end_points(start_point)]
+          self.assertEqual(sorted(e for s, e in pairs if s == start_point),
+                           sorted(end_points))
+
+
+    def test_fan_degree(self):
+      """
+      Test the fan out and fan in degrees, individually and in bulk.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      end_points = np.get_fanout_end_points('in')
+      degree = np.get_fanout_degree('in')
+      self.assertEqual(degree.num_points, len(end_points))
+      self.assertEqual(degree.num_bits, sum(v.get_dtype_width() for v in end_points))
+      num_paths = 0
+      for end_point in end_points:
+          paths = np.get_all_paths_array(Waypoints('in', end_point.get_name()))
+          num_paths += len(set(tuple(paths[i]) for i in range(len(paths))))
+      self.assertEqual(degree.num_paths, num_paths)
+      self.assertFalse(degree.is_saturated())
+      start_points = np.get_fanin_start_points('out')
+      self.assertEqual(np.get_fanin_degree('out').num_points, len(start_points))
+      for degrees, get_degree in ((np.get_fanout_degrees(), np.get_fanout_degree),
+                                  (np.get_fanin_degrees(), np.get_fanin_degree)):
+          names = np.get_vertex_columns(degrees['vertex'])['name']
+          self.assertTrue(len(names) > 0)
+          for i, name in enumerate(names):
+              degree = get_degree(name)
+              self.assertEqual(degrees['num_points'][i], degree.num_points)
+              self.assertEqual(degrees['num_paths'][i], degree.num_paths)
+              self.assertEqual(degrees['num_bits'][i], degree.num_bits)
+
+    def test_comb_loops(self):
+      """
+      Test the combinational loops are reported with their named vertices.
+      """
+      np = self.compile_test('comb_loops.sv')
+      loops = [[v.get_name() for v in loop] for loop in np.get_comb_loops()]
+      self.assertEqual(sorted(loops), [['comb_loops.a', 'comb_loops.b'],
+                                       ['comb_loops.c']])
+      np = self.compile_test('pipeline_loops.sv')
+      self.assertEqual(len(np.get_comb_loops()), 0)
+
+    def test_export(self):
+      """
+      Test exporting the fan out cone and the subgraph of the paths between
+      two points.
+      """
+      np = self.compile_test('fan_out_in.sv')
+      np.export_fanout_cone('in', 'cone.json', format=ExportFormat.JSON)
+      with open('cone.json') as fd:
+          cone = json.load(fd)
+      names = [v['name'] for v in cone['vertices']]
+      self.assertTrue('in' in names and 'out' in names)
+      ids = set(v['id'] for v in cone['vertices'])
+      self.assertTrue(len(cone['edges']) > 0)
+      self.assertTrue(all(s in ids and t in ids for s, t in cone['edges']))
+      np.export_fanout_cone('in', 'cone.json', format=ExportFormat.JSON, max_vertices=2)
+      with open('cone.json') as fd:
+          self.assertEqual(len(json.load(fd)['vertices']), 2)
+      os.remove('cone.json')
+      np.export_paths(Waypoints('in', 'out'), 'paths.dot')
+      with open('paths.dot') as fd:
+          self.assertTrue(fd.read().startswith('digraph netlist {'))
+      os.remove('paths.dot')
+
+    def test_stats(self):
+      """
+      Test the timings of loading a netlist and the counts of its queries.
+      """
+      np = self.compile_test('adder.sv')
+      stats = np.get_stats()
+      self.assertEqual(stats['read_xml.count'], 1)
+      self.assertTrue(stats['read_xml.seconds'] >= 0)
+      self.assertEqual(stats['build_indexes.count'], 1)
+      self.assertFalse('path_exists.count' in stats)
+      self.assertTrue(np.path_exists(Waypoints('i_a', 'o_sum')))
+      stats = np.get_stats()
+      self.assertEqual(stats['path_exists.count'], 1)
+      self.assertTrue(stats['path_exists.edges_examined'] > 0)
+      np.clear_stats()
+      self.assertEqual(len(np.get_stats()), 0)
+
+    def test_compile_cache(self):
+      """
+      Test a compilation is reused from the cache.
+      """
+      cache_dir = tempfile.mkdtemp()
+      Options.get_instance().set_compile_cache_directory(cache_dir)
+      Options.get_instance().set_ignore_hierarchy_markers(False)
+      Options.get_instance().set_match_exact()
+      comp = RunVerilator(defs.INSTALL_PREFIX)
+      path = os.path.join(defs.TEST_SRC_PREFIX, 'adder.sv')
+      np = comp.compile(path)
+      extensions = sorted(os.path.splitext(f)[1] for f in os.listdir(cache_dir))
+      self.assertEqual(extensions, ['.deps', '.snapshot', '.xml'])
+      cached = comp.compile(path)
+      self.assertEqual(len(cached.get_named_vertices()), len(np.get_named_vertices()))
+      self.assertTrue(cached.path_exists(Waypoints('i_a', 'o_sum')))
+      self.assertEqual(comp.run(path, 'netlist.xml'), 0)
+      self.assertEqual(len(Netlist('netlist.xml').get_named_vertices()),
+                       len(np.get_named_vertices()))
+      Options.get_instance().set_compile_cache_directory('')
+      shutil.rmtree(cache_dir)
 
 if __name__ == '__main__':
     unittest.main()
@@ -1,5 +1,7 @@
 import os
+import shutil
 import subprocess
+import tempfile
 import unittest
 import definitions as defs
 
@@ -10,9 +12,10 @@ class TestTool(unittest.TestCase):
     def setUp(self):
         pass
 
-    def run_np(self, args):
+    def run_np(self, args, stdin=None):
         command = [self.NETLIST_PATHS] + args
-        proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                              input=stdin.encode('utf-8') if stdin else None)
         if proc.returncode != 0:
             print('Error executing {}'.format(' '.join(proc.args)))
             print('Stdout:\n{}\nStderr:\n{}'.format(proc.stdout.decode('utf-8'),
@@ -22,6 +25,11 @@ class TestTool(unittest.TestCase):
     def test_netlist_paths_bin(self):
         self.assertTrue(os.path.exists(self.NETLIST_PATHS))
 
+    def test_help(self):
+        returncode, stdout = self.run_np(['--help'])
+        self.assertEqual(returncode, 0)
+        self.assertIn('%end', stdout)
+
     def test_xml_output(self):
         test_path = os.path.join(defs.TEST_SRC_PREFIX, 'adder.sv')
         xml_path = os.path.join(defs.CURRENT_BINARY_DIR, 'adder.xml')
@@ -70,6 +78,18 @@ class TestTool(unittest.TestCase):
         returncode, _ = self.run_np(['--compile', test_path, '--from', 'in', '--to', 'out', '--all-paths'])
         self.assertEqual(returncode, 0)
 
+    def test_dump_deepest_paths(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'multiple_paths.sv')
+        returncode, stdout = self.run_np(['--compile', test_path, '--from', 'in', '--to', 'out',
+                                          '--deepest-paths', '2'])
+        self.assertEqual(returncode, 0)
+        self.assertEqual(stdout.count('Path '), 2)
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'fan_out_in.sv')
+        returncode, stdout = self.run_np(['--compile', test_path, '--to', 'out',
+                                          '--deepest-paths', '5'])
+        self.assertEqual(returncode, 0)
+        self.assertEqual(stdout.count('Path '), 3)
+
     def test_dump_fan_out_paths(self):
         test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
         returncode, _ = self.run_np(['--compile', test_path, '--from', 'counter.counter_q'])
@@ -80,6 +100,76 @@ class TestTool(unittest.TestCase):
         returncode, _ = self.run_np(['--compile', test_path, '--to', 'counter.counter_q'])
         self.assertEqual(returncode, 0)
 
+    def test_export(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        export_path = os.path.join(defs.CURRENT_BINARY_DIR, 'counter.graphml')
+        returncode, _ = self.run_np(['--compile', test_path, '--from', 'counter.counter_q',
+                                     '--export', export_path, '--export-format', 'graphml',
+                                     '--max-depth', '4'])
+        self.assertEqual(returncode, 0)
+        with open(export_path) as fd:
+            self.assertTrue('counter.counter_q' in fd.read())
+        os.remove(export_path)
+
+    def test_stats(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        returncode, stdout = self.run_np(['--compile', test_path, '--from', 'counter.counter_q', '--stats'])
+        self.assertEqual(returncode, 0)
+        self.assertTrue('read_xml.count' in stdout)
+        self.assertTrue('fan_out.edges_examined' in stdout)
+
+    def test_compile_cache(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        cache_dir = tempfile.mkdtemp()
+        outputs = []
+        for _ in range(2):
+            returncode, stdout = self.run_np(['--compile', test_path, '--compile-cache', cache_dir,
+                                              '--dump-regs'])
+            self.assertEqual(returncode, 0)
+            outputs.append(stdout)
+        self.assertEqual(outputs[0], outputs[1])
+        self.assertTrue(any(f.endswith('.snapshot') for f in os.listdir(cache_dir)))
+        shutil.rmtree(cache_dir)
+
+    def test_server(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        requests = ['--dump-regs',
+                    '--from counter.counter_q --fan-degree',
+                    '--from counter.counter_q --fan-degree --traverse-registers',
+                    '--from no_such_point',
+                    '--from "counter.counter_q',
+                    '--from counter.counter_q --export out.dot',
+                    'quit',
+                    '--dump-names']
+        returncode, stdout = self.run_np(['--compile', test_path, '--server'],
+                                         '\n'.join(requests)+'\n')
+        self.assertEqual(returncode, 0)
+        responses = stdout.split('%end\n')
+        # Requests after quit are not answered.
+        self.assertEqual(len(responses), 7)
+        self.assertEqual(responses[-1], '')
+        self.assertEqual(len(responses[0].split('\n')), 4)
+        self.assertTrue(responses[1].startswith('End points: '))
+        self.assertTrue(responses[2].startswith('End points: '))
+        self.assertTrue(responses[3].startswith('Error: '))
+        self.assertTrue(responses[4].startswith('Error: invalid request'))
+        self.assertTrue(responses[5].startswith('Error: --export is'))
+
+
+    def test_server_traversal_cache(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        requests = ['--from counter.counter_q',
+                    '--from counter.counter_q',
+                    '--from counter.counter_q --to counter.counter_q']
+        returncode, stdout = self.run_np(['--compile', test_path, '--server',
+                                          '--traversal-cache-size', '1048576'],
+                                         '\n'.join(requests)+'\n')
+        self.assertEqual(returncode, 0)
+        responses = stdout.split('%end\n')
+        self.assertEqual(len(responses), 4)
+        self.assertEqual(responses[0], responses[1])
+        self.assertTrue('counter.counter_q' in responses[2])
+
 
 if __name__ == '__main__':
     unittest.main()
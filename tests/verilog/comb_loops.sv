@@ -0,0 +1,29 @@
+// Combinational loops through a and b, and through c alone, and a loop
+// through the register d, which is not combinational.
+module comb_loops
+  (
+    input  logic i_clk,
+    input  logic i_a,
+    input  logic i_en,
+    output logic o_a,
+    output logic o_c,
+    output logic o_d
+  );
+
+  logic a;
+  logic b;
+  logic c;
+  logic d;
+
+  assign a = i_a | b;
+  assign b = a & i_en;
+  assign c = c ^ i_en;
+
+  always_ff @(posedge i_clk)
+    d <= d ^ i_a;
+
+  assign o_a = a;
+  assign o_c = c;
+  assign o_d = d;
+
+endmodule
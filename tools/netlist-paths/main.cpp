@@ -7,12 +7,21 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include "netlist_paths/Exception.hpp"
+#include "netlist_paths/FanDegree.hpp"
 #include "netlist_paths/Netlist.hpp"
 #include "netlist_paths/Options.hpp"
 #include "netlist_paths/RunVerilator.hpp"
 
 namespace po = boost::program_options;
 
+/// Print the number of points, bits and paths of a fan out or fan in.
+void printFanDegree(std::ostream &os, const netlist_paths::FanDegree &degree,
+                    const std::string &pointsName) {
+  os << pointsName << ": " << degree.numPoints << "\n";
+  os << "Bits: " << degree.numBits << "\n";
+  os << "Paths: " << (degree.isSaturated() ? "at least " : "") << degree.numPaths << "\n";
+}
+
 int main(int argc, char **argv) {
   try {
     // Command line options.
@@ -86,9 +95,9 @@ int main(int argc, char **argv) {
     bool displayHelp   = vm.count("help") > 0;
     bool compile       = vm.count("compile") > 0;
     bool dumpNames     = vm.count("dumpnames") > 0;
+    bool fanOutDegree  = vm.count("fanout") > 0;
+    bool fanInDegree   = vm.count("fanin") > 0;
     //netlist_paths::Options::getInstance().dumpDotfile   = vm.count("dotfile") > 0;
-    //netlist_paths::Options::getInstance().fanOutDegree  = vm.count("fanout") > 0;
-    //netlist_paths::Options::getInstance().fanInDegree   = vm.count("fanin") > 0;
     //netlist_paths::Options::getInstance().allPaths      = vm.count("allpaths") > 0;
     //netlist_paths::Options::getInstance().startPoints   = vm.count("startpoints") > 0;
     //netlist_paths::Options::getInstance().endPoints     = vm.count("endpoints") > 0;
@@ -143,6 +152,24 @@ int main(int argc, char **argv) {
       return 0;
     }
 
+    // Report the fan out degree from startName.
+    if (fanOutDegree) {
+      if (startName.empty()) {
+        throw netlist_paths::Exception("no start point specified for the fan out degree");
+      }
+      printFanDegree(std::cout, netlistPaths.getFanOutDegree(startName), "End points");
+      return 0;
+    }
+
+    // Report the fan in degree to endName.
+    if (fanInDegree) {
+      if (endName.empty()) {
+        throw netlist_paths::Exception("no end point specified for the fan in degree");
+      }
+      printFanDegree(std::cout, netlistPaths.getFanInDegree(endName), "Start points");
+      return 0;
+    }
+
 //    return 0; // TEMPORARY EARLY EXIT
 //
 //    // A start or an endpoint must be specified.
@@ -4,14 +4,25 @@ import argparse
 import sys
 import os
 from itertools import zip_longest
-import tempfile
+import shlex
+import socketserver
+from concurrent.futures import ThreadPoolExecutor
 import definitions as defs
 sys.path.insert(0, os.path.join(defs.BINARY_DIR_PREFIX, 'lib', 'netlist_paths'))
-from py_netlist_paths import RunVerilator, Netlist, Waypoints, Options
+from py_netlist_paths import RunVerilator, Netlist, Waypoints, Options, \
+                             QueryOptions, MatchType, ExportFormat
 
 
 DEFAULT_DOT_FILE = 'graph.dot'
 
+# The formats of exported subgraphs.
+EXPORT_FORMATS = {'dot': ExportFormat.DOT,
+                  'graphml': ExportFormat.GRAPHML,
+                  'json': ExportFormat.JSON}
+
+# The line that ends each response of the query server.
+END_OF_RESPONSE = '%end'
+
 def write_table(rows, fd):
     """
     Write the table rows out to fd and calculate max widths for each column.
@@ -51,69 +62,142 @@ def dump_names(vertices, fd):
         # Write the table out.
         write_table(rows, fd)
     else:
-        print('No matching vertices.')
+        fd.write('No matching vertices.\n')
 
-def dump_path_report(netlist, path, fd):
+def dump_path_report(columns, begin, end, fd):
     """
-    Report the details of a path. Items in the path alternate between variable
-    and statement, starting and ending with a variable.
+    Report the details of a path, which is the rows begin to end of the columns
+    of vertex attributes. Items in the path alternate between variable and
+    statement, starting and ending with a variable.
     """
+    names = columns['name']
+    types = columns['ast_type']
+    dtypes = columns['dtype']
+    locations = columns['location']
+    is_logic = columns['is_logic']
     rows = []
     rows.append(('Name', 'Type', 'DType', 'Statement', 'Location'))
-    index = 0;
-    while index < len(path):
+    index = begin
+    while index < end:
         # Var reference and logic statement.
-        if index+1 < len(path) and \
-            not path[index].is_logic() and \
-            path[index+1].is_logic():
-            row = (path[index].get_name(), path[index].get_ast_type_str(), path[index].get_dtype_str(),
-                   path[index+1].get_ast_type_str(), path[index+1].get_location_str())
+        if index+1 < end and \
+            not is_logic[index] and \
+            is_logic[index+1]:
+            row = (names[index], types[index], dtypes[index],
+                   types[index+1], locations[index+1])
             index += 2
         # Var reference only.
-        elif not path[index].is_logic():
-            row = (path[index].get_name(), path[index].get_ast_type_str(), path[index].get_dtype_str(), '', '')
+        elif not is_logic[index]:
+            row = (names[index], types[index], dtypes[index], '', '')
             index += 1
         # Statement only.
         else:
-            row = ('', '', '', path[index].get_ast_type_str(), path[index].get_location_str())
+            row = ('', '', '', types[index], locations[index])
             index += 1
         rows.append(row)
     if len(rows) > 1:
         # Write the table out.
         write_table(rows, fd)
     else:
-        print('No matching paths.')
+        fd.write('No matching paths.\n')
 
 def dump_path_list_report(netlist, paths, fd):
     """
-    Report a list of paths.
+    Report a list of paths, given as an array of vertex IDs. The attributes of
+    the vertices of all the paths are fetched together.
+    """
+    if len(paths) == 0:
+        fd.write('No matching paths.\n')
+        return
+    columns = netlist.get_vertex_columns(paths.vertices)
+    offsets = memoryview(paths.offsets)
+    for i in range(len(paths)):
+        fd.write('\nPath {}\n'.format(i))
+        dump_path_report(columns, offsets[i], offsets[i+1], fd)
+
+def dump_deepest_paths_report(netlist, paths, fd):
+    """
+    Report a list of paths given as vertices, deepest first, with their depths.
     """
     if len(paths) == 0:
-        print('No matching paths.')
+        fd.write('No matching paths.\n')
         return
+    for i, path in enumerate(paths):
+        fd.write('\nPath {} (depth {:g})\n'.format(i, netlist.get_path_depth(path)))
+        columns = {'name': [v.get_name() for v in path],
+                   'ast_type': [v.get_ast_type_str() for v in path],
+                   'dtype': [v.get_dtype_str() for v in path],
+                   'location': [v.get_location_str() for v in path],
+                   'is_logic': [v.is_logic() for v in path]}
+        dump_path_report(columns, 0, len(path), fd)
+
+def dump_path_iterator_report(netlist, paths, fd):
+    """
+    Report the paths of an iterator as they are produced.
+    """
     for i, path in enumerate(paths):
         fd.write('\nPath {}\n'.format(i))
-        dump_path_report(netlist, path, fd)
+        columns = netlist.get_vertex_columns(path)
+        dump_path_report(columns, 0, len(path), fd)
+    if paths.num_paths() == 0:
+        fd.write('No matching paths.\n')
+    elif paths.is_truncated():
+        fd.write('\nFurther paths were not reported.\n')
 
-def main():
-    parser = argparse.ArgumentParser(description="Query a Verilog netlist")
-    parser.add_argument('files',
-                        nargs='+',
-                        help='Input files')
-    parser.add_argument('-c', '--compile',
-                        action='store_true',
-                        help='Run Verilator to compile a netlist')
-    parser.add_argument('-I',
-                        metavar='include_path',
-                        help='Add an source include path (only with --compile)')
-    parser.add_argument('-D',
-                        metavar='definition',
-                        help='Define a preprocessor macro (only with --compile)')
-    parser.add_argument('-o', '--output',
-                        default=None,
-                        dest='output_file',
-                        metavar='output file',
-                        help='Specify an output file')
+def dump_comb_loops(loops, fd):
+    """
+    Report the named vertices of each combinational loop.
+    """
+    if len(loops) == 0:
+        fd.write('No combinational loops.\n')
+        return
+    for i, loop in enumerate(loops):
+        fd.write('\nLoop {}\n'.format(i))
+        dump_names(loop, fd)
+
+def dump_fan_degree(degree, points_name, fd):
+    """
+    Report the number of points, bits and paths of a fan out or fan in.
+    """
+    num_paths = str(degree.num_paths)
+    if degree.is_saturated():
+        num_paths = 'at least ' + num_paths
+    fd.write('{}: {}\n'.format(points_name, degree.num_points))
+    fd.write('Bits: {}\n'.format(degree.num_bits))
+    fd.write('Paths: {}\n'.format(num_paths))
+
+def dump_stats(stats, fd):
+    """
+    Report the timings and counts of loading and querying the netlist.
+    """
+    if len(stats) == 0:
+        fd.write('No statistics recorded.\n')
+        return
+    rows = [('Statistic', 'Value')]
+    for name in sorted(stats):
+        value = stats[name]
+        if name.endswith('.seconds'):
+            rows.append((name, '{:.6f}'.format(value)))
+        else:
+            rows.append((name, str(int(value))))
+    write_table(rows, fd)
+
+class RequestParser(argparse.ArgumentParser):
+    """
+    An argument parser for the requests of the query server, which raises
+    errors rather than exiting.
+    """
+    def error(self, message):
+        raise RuntimeError(message)
+
+    def exit(self, status=0, message=None):
+        raise RuntimeError(message.strip() if message else 'invalid request')
+
+def add_query_arguments(parser):
+    """
+    Add the arguments that specify a query, which can be given on the command
+    line or in a request to the query server.
+    """
     parser.add_argument('--dump-names',
                         nargs='?',
                         default=None,
@@ -138,9 +222,9 @@ def main():
                         const='',
                         metavar='pattern',
                         help='Dump all registers, filter by regex')
-    parser.add_argument('--dump-dot',
+    parser.add_argument('--comb-loops',
                         action='store_true',
-                        help='Dump a dotfile of the netlist\'s graph')
+                        help='Report the combinational loops of the netlist')
     parser.add_argument('--from',
                         dest='start_point',
                         metavar='point',
@@ -162,38 +246,368 @@ def main():
                         metavar='point',
                         help='Specify a point for a path to avoid')
     parser.add_argument('--traverse-registers',
-                        action='store_const',
-                        const=lambda: Options.get_instance().set_traverse_registers(True),
-                        default=lambda *args: None,
+                        action='store_true',
                         help='Allow paths to traverse registers')
     parser.add_argument('--start-anywhere',
-                        action='store_const',
-                        const=lambda: Options.get_instance().set_restrict_start_points(False),
-                        default=lambda *args: None,
+                        action='store_true',
                         help='Allow paths to start on any variable')
     parser.add_argument('--end-anywhere',
-                        action='store_const',
-                        const=lambda: Options.get_instance().set_restrict_end_points(False),
-                        default=lambda *args: None,
+                        action='store_true',
                         help='Allow paths to end on any variable')
     parser.add_argument('--all-paths',
                         action='store_true',
                         help='Find all paths between two points (exponential time)')
+    parser.add_argument('--max-paths',
+                        type=int,
+                        default=0,
+                        metavar='number',
+                        help='Report at most a number of paths (with --all-paths)')
+    parser.add_argument('--max-path-length',
+                        type=int,
+                        default=0,
+                        metavar='number',
+                        help='Only report paths with at most a number of vertices (with --all-paths)')
+    parser.add_argument('--deepest-paths',
+                        type=int,
+                        default=0,
+                        metavar='number',
+                        help='Report a number of the deepest paths by their count of logic statements, between two points, or of a fan out or fan in (polynomial time)')
+    parser.add_argument('--fan-degree',
+                        action='store_true',
+                        help='Count the end points, bits and paths of a fan out, or the start points, bits and paths of a fan in, without enumerating the paths')
+    parser.add_argument('--export',
+                        dest='export_file',
+                        default=None,
+                        metavar='file',
+                        help='Write the subgraph of the fan out (with --from), the fan in (with --to) or the paths between the points to a file, instead of reporting paths')
+    parser.add_argument('--export-format',
+                        choices=sorted(EXPORT_FORMATS),
+                        default='dot',
+                        help='The format of the exported subgraph (with --export)')
+    parser.add_argument('--max-depth',
+                        type=int,
+                        default=0,
+                        metavar='number',
+                        help='Only export vertices within a number of edges of the points (with --export)')
+    parser.add_argument('--max-vertices',
+                        type=int,
+                        default=0,
+                        metavar='number',
+                        help='Export at most a number of vertices, the nearest to the points (with --export)')
     parser.add_argument('--regex',
-                        action='store_const',
-                        const=lambda: Options.get_instance().set_match_regex(),
-                        default=lambda *args: None,
+                        action='store_true',
                         help='Enable regular expression matching of names')
     parser.add_argument('--wildcard',
-                        action='store_const',
-                        const=lambda: Options.get_instance().set_match_wildcard(),
-                        default=lambda *args: None,
+                        action='store_true',
                         help='Enable wildcard matching of names')
     parser.add_argument('--ignore-hierarchy-markers',
+                        action='store_true',
+                        help='Ignore hierarchy markers: _ . /')
+
+def get_query_options(args):
+    """
+    Return the options of a query, so that queries with different options can
+    be run on the same netlist.
+    """
+    options = QueryOptions.get_default()
+    if args.traverse_registers:
+        options = options.with_traverse_registers(True)
+    if args.start_anywhere:
+        options = options.with_restrict_start_points(False)
+    if args.end_anywhere:
+        options = options.with_restrict_end_points(False)
+    if args.regex:
+        options = options.with_match_type(MatchType.REGEX)
+    if args.wildcard:
+        options = options.with_match_type(MatchType.WILDCARD)
+    if args.ignore_hierarchy_markers:
+        options = options.with_ignore_hierarchy_markers(True)
+    return options
+
+def get_export_args(args):
+    """
+    Return the format and limits of an exported subgraph.
+    """
+    return {'format': EXPORT_FORMATS[args.export_format],
+            'max_depth': args.max_depth,
+            'max_vertices': args.max_vertices}
+
+def run_query(netlist, args, fd):
+    """
+    Run the query specified by args on the netlist and write its report to fd.
+    Return False if args do not specify a query.
+    """
+    options = get_query_options(args)
+
+    # Dump all names
+    if args.dump_names != None:
+        dump_names(netlist.get_named_vertices(args.dump_names, options), fd)
+        return True
+
+    # Dump nets
+    if args.dump_nets != None:
+        dump_names(netlist.get_net_vertices(args.dump_nets, options), fd)
+        return True
+
+    # Dump ports
+    if args.dump_ports != None:
+        dump_names(netlist.get_port_vertices(args.dump_ports, options), fd)
+        return True
+
+    # Dump regs
+    if args.dump_regs != None:
+        dump_names(netlist.get_reg_vertices(args.dump_regs, options), fd)
+        return True
+
+    # Report combinational loops
+    if args.comb_loops:
+        dump_comb_loops(netlist.get_comb_loops(), fd)
+        return True
+
+    # Point-to-point path
+    if args.start_point and args.finish_point:
+        waypoints = Waypoints()
+        waypoints.add_start_point(args.start_point)
+        waypoints.add_finish_point(args.finish_point)
+        [waypoints.add_through_point(point) for point in args.through_points]
+        [waypoints.add_avoid_point(point) for point in args.avoid_points]
+        if args.export_file:
+            netlist.export_paths(waypoints, args.export_file,
+                                 options=options, **get_export_args(args))
+        elif args.deepest_paths:
+            paths = netlist.get_deepest_paths(waypoints, args.deepest_paths,
+                                              options=options)
+            dump_deepest_paths_report(netlist, paths, fd)
+        elif args.all_paths:
+            paths = netlist.iterate_all_paths(waypoints,
+                                              max_paths=args.max_paths,
+                                              max_length=args.max_path_length,
+                                              options=options)
+            dump_path_iterator_report(netlist, paths, fd)
+        else:
+            path = netlist.get_any_path_array(waypoints, options=options)
+            columns = netlist.get_vertex_columns(path.vertices)
+            dump_path_report(columns, 0, len(path.vertices), fd)
+        return True
+
+    # Fan out paths
+    if args.start_point and not args.finish_point:
+        if len(args.through_points) > 0:
+            raise RuntimeError('cannot specify through points with fanout paths')
+        if len(args.avoid_points) > 0:
+            raise RuntimeError('cannot specify avoid points with fanout paths')
+        if args.export_file:
+            netlist.export_fanout_cone(args.start_point, args.export_file,
+                                       options=options, **get_export_args(args))
+            return True
+        if args.fan_degree:
+            dump_fan_degree(netlist.get_fanout_degree(args.start_point, options), 'End points', fd)
+            return True
+        if args.deepest_paths:
+            paths = netlist.get_deepest_fanout_paths(args.start_point, args.deepest_paths,
+                                                     options=options)
+            dump_deepest_paths_report(netlist, paths, fd)
+            return True
+        paths = netlist.get_all_fanout_paths_array(args.start_point, options=options)
+        dump_path_list_report(netlist, paths, fd)
+        return True
+
+    # Fan in paths
+    if args.finish_point and not args.start_point:
+        if len(args.through_points) > 0:
+            raise RuntimeError('cannot specify through points with fanin paths')
+        if len(args.avoid_points) > 0:
+            raise RuntimeError('cannot specify avoid points with fanin paths')
+        if args.export_file:
+            netlist.export_fanin_cone(args.finish_point, args.export_file,
+                                      options=options, **get_export_args(args))
+            return True
+        if args.fan_degree:
+            dump_fan_degree(netlist.get_fanin_degree(args.finish_point, options), 'Start points', fd)
+            return True
+        if args.deepest_paths:
+            paths = netlist.get_deepest_fanin_paths(args.finish_point, args.deepest_paths,
+                                                    options=options)
+            dump_deepest_paths_report(netlist, paths, fd)
+            return True
+        paths = netlist.get_all_fanin_paths_array(args.finish_point, options=options)
+        dump_path_list_report(netlist, paths, fd)
+        return True
+
+    return False
+
+def serve_requests(netlist, parser, infd, outfd):
+    """
+    Answer the requests read from infd until it is closed or a 'quit' request
+    is read. Each request is a line of query arguments, and its report is
+    written to outfd followed by an END_OF_RESPONSE line.
+    """
+    for line in infd:
+        line = line.strip()
+        if len(line) == 0:
+            continue
+        if line == 'quit':
+            break
+        try:
+            try:
+                args = parser.parse_args(shlex.split(line))
+            except ValueError as e:
+                # An unbalanced quote.
+                raise RuntimeError('invalid request: '+str(e))
+            # Requests cannot write files, since clients of a socket need not
+            # be able to write where the server can.
+            if args.export_file:
+                raise RuntimeError('--export is not supported in server requests')
+            if not run_query(netlist, args, outfd):
+                raise RuntimeError('no query specified')
+        except RuntimeError as e:
+            outfd.write('Error: '+str(e)+'\n')
+        outfd.write(END_OF_RESPONSE+'\n')
+        outfd.flush()
+
+class QueryServer(socketserver.UnixStreamServer):
+    """
+    A server answering the requests of clients connected to a Unix socket,
+    with each connection served by a thread of a pool.
+    """
+    def __init__(self, path, netlist, num_threads):
+        self.netlist = netlist
+        self.parser = RequestParser(prog='request', add_help=False)
+        add_query_arguments(self.parser)
+        self.executor = ThreadPoolExecutor(max_workers=num_threads)
+        super().__init__(path, QueryHandler)
+
+    def process_request(self, request, client_address):
+        self.executor.submit(self.process_request_thread, request, client_address)
+
+    def process_request_thread(self, request, client_address):
+        try:
+            self.finish_request(request, client_address)
+        except Exception:
+            self.handle_error(request, client_address)
+        finally:
+            self.shutdown_request(request)
+
+    def server_close(self):
+        super().server_close()
+        self.executor.shutdown(wait=True)
+
+class QueryHandler(socketserver.StreamRequestHandler):
+    """
+    Answer the requests of one client of a QueryServer.
+    """
+    def handle(self):
+        infd = (line.decode('utf-8') for line in self.rfile)
+        outfd = Utf8Writer(self.wfile)
+        serve_requests(self.server.netlist, self.server.parser, infd, outfd)
+
+class Utf8Writer:
+    """
+    Write strings to a binary stream.
+    """
+    def __init__(self, stream):
+        self.stream = stream
+
+    def write(self, string):
+        self.stream.write(string.encode('utf-8'))
+
+    def flush(self):
+        self.stream.flush()
+
+def run_server(netlist, args):
+    """
+    Load the netlist indexes once and answer requests from a Unix socket, or
+    from stdin if no socket is given.
+    """
+    if not netlist.has_reachability_index():
+        netlist.build_reachability_index()
+    if args.socket_path:
+        if os.path.exists(args.socket_path):
+            os.remove(args.socket_path)
+        num_threads = args.server_threads or os.cpu_count()
+        with QueryServer(args.socket_path, netlist, num_threads) as server:
+            try:
+                server.serve_forever()
+            except KeyboardInterrupt:
+                pass
+        os.remove(args.socket_path)
+    else:
+        parser = RequestParser(prog='request', add_help=False)
+        add_query_arguments(parser)
+        serve_requests(netlist, parser, sys.stdin, sys.stdout)
+    return 0
+
+def main():
+    parser = argparse.ArgumentParser(description="Query a Verilog netlist")
+    parser.add_argument('files',
+                        nargs='+',
+                        help='Input files')
+    parser.add_argument('-c', '--compile',
+                        action='store_true',
+                        help='Run Verilator to compile a netlist')
+    parser.add_argument('-I',
+                        metavar='include_path',
+                        help='Add an source include path (only with --compile)')
+    parser.add_argument('-D',
+                        metavar='definition',
+                        help='Define a preprocessor macro (only with --compile)')
+    parser.add_argument('--compile-cache',
+                        metavar='directory',
+                        action='store',
+                        type=lambda path: lambda: Options.get_instance().set_compile_cache_directory(path),
+                        default=lambda *args: None,
+                        help='Reuse the compilations held in a directory when their sources have not changed (only with --compile)')
+    parser.add_argument('--compile-cache-size',
+                        metavar='bytes',
+                        action='store',
+                        type=lambda size: lambda: Options.get_instance().set_compile_cache_max_bytes(int(size)),
+                        default=lambda *args: None,
+                        help='The size the compile cache is limited to, or 0 for no limit (only with --compile-cache)')
+    parser.add_argument('-o', '--output',
+                        default=None,
+                        dest='output_file',
+                        metavar='output file',
+                        help='Specify an output file')
+    parser.add_argument('--dump-dot',
+                        action='store_true',
+                        help='Dump a dotfile of the netlist\'s graph')
+    parser.add_argument('--write-snapshot',
+                        metavar='file',
+                        dest='snapshot_file',
+                        default=None,
+                        help='Write a binary snapshot of the netlist that can be loaded in place of the XML')
+    parser.add_argument('--server',
+                        action='store_true',
+                        help='Load the netlist once and answer requests, each a line of query arguments, from stdin or --socket, with each response followed by a line '+END_OF_RESPONSE.replace('%', '%%'))
+    parser.add_argument('--socket',
+                        dest='socket_path',
+                        metavar='path',
+                        default=None,
+                        help='Answer the requests of clients connecting to a Unix socket (with --server)')
+    parser.add_argument('--server-threads',
+                        type=int,
+                        default=0,
+                        metavar='number',
+                        help='The number of clients served at once, by default the number of CPUs (with --socket)')
+    parser.add_argument('--traversal-cache-size',
+                        type=int,
+                        default=0,
+                        metavar='bytes',
+                        help='The size of the cache of the searches of fan outs, fan ins and any paths, which answers later queries from the same points, or 0 for no cache')
+    add_query_arguments(parser)
+    parser.add_argument('--stats',
+                        action='store_true',
+                        help='Report the time spent loading the netlist and answering the query, and the work done by its searches')
+    parser.add_argument('--stream-xml',
                         action='store_const',
-                        const=lambda: Options.ignore_hierarchy_markers(),
+                        const=lambda: Options.get_instance().set_stream_xml(True),
                         default=lambda *args: None,
-                        help='Ignore hierarchy markers: _ . /')
+                        help='Read the netlist XML in a single pass to reduce memory usage')
+    parser.add_argument('--reachability-index',
+                        action='store_const',
+                        const=lambda: Options.get_instance().set_reachability_index(True),
+                        default=lambda *args: None,
+                        help='Index the reachability of the netlist, which is saved in any snapshot')
     parser.add_argument('-v', '--verbose',
                         action='store_const',
                         const=lambda: Options.get_instance().set_verbose(),
@@ -207,12 +621,10 @@ def main():
     args = parser.parse_args()
 
     # Setup options.
-    args.traverse_registers()
-    args.regex()
-    args.wildcard()
-    args.ignore_hierarchy_markers()
-    args.start_anywhere()
-    args.end_anywhere()
+    args.compile_cache()
+    args.compile_cache_size()
+    args.stream_xml()
+    args.reachability_index()
     args.verbose()
     args.debug()
 
@@ -221,84 +633,42 @@ def main():
         # Verilator compilation
         # (Only supports one source file currently, useful for testing.)
         if args.compile:
+            comp = RunVerilator(defs.INSTALL_PREFIX)
             if args.output_file == None:
-                output_filename = next(tempfile._get_candidate_names())
+                netlist = comp.compile(args.files[0])
             else:
-                output_filename = args.output_file
-            comp = RunVerilator(defs.INSTALL_PREFIX)
-            if comp.run(args.files[0], output_filename) > 0:
-                raise RuntimeError('error compiling design')
+                if comp.run(args.files[0], args.output_file) > 0:
+                    raise RuntimeError('error compiling design')
+                netlist = Netlist(args.output_file)
         else:
             if len(args.files) != 1:
                 raise RuntimeError('cannot specify multiple netlist XML files')
-            output_filename = args.files[0]
+            netlist = Netlist(args.files[0])
 
-        # Create the netlist
-        netlist = Netlist(output_filename)
+        netlist.set_traversal_cache_max_bytes(args.traversal_cache_size)
 
-        # Delete the temporary XML output file.
-        if args.compile and args.output_file == None:
-            os.remove(output_filename)
-
-        # Dump all names
-        if args.dump_names != None:
-            dump_names(netlist.get_named_vertices(args.dump_names), sys.stdout)
-            return 0
-
-        # Dump nets
-        if args.dump_nets != None:
-            dump_names(netlist.get_net_vertices(args.dump_nets), sys.stdout)
-            return 0
-
-        # Dump ports
-        if args.dump_ports != None:
-            dump_names(netlist.get_port_vertices(args.dump_ports), sys.stdout)
-            return 0
-
-        # Dump regs
-        if args.dump_regs != None:
-            dump_names(netlist.get_reg_vertices(args.dump_regs), sys.stdout)
-            return 0
+        # Answer requests
+        if args.server:
+            return run_server(netlist, args)
 
         # Dump graph dotfile
         if args.dump_dot:
-            netlist.dump_dot_file(args.output_file if args.output_file else DEFAULT_DOT_FILE)
+            netlist.dump_dot_file(args.output_file if args.output_file else DEFAULT_DOT_FILE,
+                                  get_query_options(args))
             return 0
 
-        # Point-to-point path
-        if args.start_point and args.finish_point:
-            waypoints = Waypoints()
-            waypoints.add_start_point(args.start_point)
-            waypoints.add_finish_point(args.finish_point)
-            [waypoints.add_through_point(point) for point in args.through_points]
-            [waypoints.add_avoid_point(point) for point in args.avoid_points]
-            if args.all_paths:
-                path = netlist.get_all_paths(waypoints)
-                dump_path_list_report(netlist, path, sys.stdout)
-            else:
-                path = netlist.get_any_path(waypoints)
-                dump_path_report(netlist, path, sys.stdout)
+        # Write a netlist snapshot
+        if args.snapshot_file:
+            netlist.write_snapshot(args.snapshot_file)
             return 0
 
-        # Fan out paths
-        if args.start_point and not args.finish_point:
-            if len(args.through_points) > 0:
-                raise RuntimeError('cannot specify through points with fanout paths')
-            if len(args.avoid_points) > 0:
-                raise RuntimeError('cannot specify avoid points with fanout paths')
-            paths = netlist.get_all_fanout_paths(args.start_point)
-            dump_path_list_report(netlist, paths, sys.stdout)
-            return 0
+        run_query(netlist, args, sys.stdout)
 
-        # Fan in paths
-        if args.finish_point and not args.start_point:
-            if len(args.through_points) > 0:
-                raise RuntimeError('cannot specify through points with fanin paths')
-            if len(args.avoid_points) > 0:
-                raise RuntimeError('cannot specify avoid points with fanin paths')
-            paths = netlist.get_all_fanin_paths(args.finish_point)
-            dump_path_list_report(netlist, paths, sys.stdout)
-            return 0
+        # Report statistics
+        if args.stats:
+            sys.stdout.write('\nStatistics\n')
+            dump_stats(netlist.get_stats(), sys.stdout)
+        return 0
 
     except RuntimeError as e:
         print('Error: '+str(e))